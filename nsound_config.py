@@ -64,6 +64,7 @@ class NsoundConfig(SConfBase):
         env['NS_DISABLE_OPENMP'] = GetOption("disable_openmp")
         env['NS_DISABLE_PYTHON'] = GetOption("disable_python")
         env['NS_EXTRA_WARNINGS'] = GetOption("extra_warnings")
+        env['NS_ENABLE_PROFILING'] = GetOption("enable_profiling")
 
         # There was a bug in either openMP or matplotlib that caused
         # segmentation faults when used together, last tried in 2010.
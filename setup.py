@@ -126,6 +126,7 @@ def process_nsound_h():
         'matplotlib' : 'no',
         'openmp' : 'no',
         'portaudio' : 'no',
+        'profiling' : 'no',
         'real-time-audio' : 'no',
     }
 
@@ -160,6 +161,9 @@ def process_nsound_h():
         elif '#define NSOUND_LIBPORTAUDIO 1' in l:
             d['portaudio'] = 'yes'
 
+        elif '#define NSOUND_PROFILE 1' in l:
+            d['profiling'] = 'yes'
+
         elif '#define PACKAGE_RELEASE' in l:
             release = l.strip().split()[-1]
             release = release.replace('"', '')
@@ -77,6 +77,8 @@ bool AudioPlaybackRt::use_jack_ = false;
 
     AudioPlaybackRt::~AudioPlaybackRt() {}
     void AudioPlaybackRt::setBufferUnderrunMode(BufferUnderrunMode) {}
+    void AudioPlaybackRt::setInstrumentation(bool, uint32, float64) {}
+    std::string AudioPlaybackRt::getTimingSummary() const { return "nsound was compiled without rt playback"; }
     std::string AudioPlaybackRt::getInfo() { return "nsound was compiled without rt playback"; }
     void AudioPlaybackRt::play(const AudioStream &) {}
     void AudioPlaybackRt::play(const Buffer &) {}
@@ -85,7 +87,12 @@ bool AudioPlaybackRt::use_jack_ = false;
     void AudioPlaybackRt::stop() {}
     std::string AudioPlaybackRt::debug_print() { return "nsound was compiled without rt playback"; }
 
-    AudioPlaybackRtDebug AudioPlaybackRt::get_debug_info() const { return AudioPlaybackRtDebug(); }
+    AudioPlaybackRtDebug AudioPlaybackRt::get_debug_info() const
+    {
+        AudioPlaybackRtDebug info = AudioPlaybackRtDebug();
+        info.is_instrumented = false;
+        return info;
+    }
 
 
 //-----------------------------------------------------------------------------
@@ -119,7 +126,6 @@ AudioPlaybackRt(
     stop_error_count_(0),
     pa_underrun_count_(0),
     pa_overrun_count_(0),
-    n_history_(),
     sine_(new Sine(sample_rate)),
     pool_(),
     pool_size_(n_buffers),
@@ -130,7 +136,14 @@ AudioPlaybackRt(
     wr_ptr_(),
     wr_index_(0),
     driver_(),
-    actual_latency_sec_(0)
+    actual_latency_sec_(0),
+    instrument_(false),
+    period_ns_(0),
+    summary_period_ns_(0),
+    timing_(),
+    has_last_start_(false),
+    last_start_(),
+    last_summary_()
 {
     M_ASSERT_VALUE(channels_, >,  0);
     M_ASSERT_VALUE(channels_, <=, 2);
@@ -138,8 +151,6 @@ AudioPlaybackRt(
 
     my_atomic_init(n_ready_, 0u);
 
-    n_history_.reserve(16);
-
 //~    std::cerr << "lock free? " << n_ready_.is_lock_free() << "\n";
 
     PaError ecode = Pa_Initialize();
@@ -252,6 +263,9 @@ AudioPlaybackRt(
 
     driver_.n_samples_per_buffer_ = driver_.n_frames_per_buffer_ * channels_;
 
+    period_ns_ = static_cast<int64>(
+        1e9 * driver_.n_frames_per_buffer_ / sample_rate_);
+
     if(driver_.n_frames_per_buffer_ < 16)
     {
         Pa_Terminate();
@@ -402,15 +416,16 @@ _callback(
     const PaStreamCallbackTimeInfo * time_info,
     PaStreamCallbackFlags            status_flags)
 {
+    Clock::time_point t_start;
+
+    if(instrument_) t_start = Clock::now();
+
     if(frames_per_buffer != driver_.n_frames_per_buffer_) ++unknown_error_count_;
 
     int16 * dst_ptr = reinterpret_cast<int16 *>(output);
 
     uint32 n = n_ready_.load();
 
-//~    DEBUG
-//~    if(n_history_.size() < n_history_.capacity()) n_history_.push_back(n);
-
     BufferUnderrunMode bum = underrun_mode_;
 
     int16 * src = (*rd_ptr_)->data();
@@ -494,16 +509,111 @@ _callback(
         ++pa_overrun_count_;
     }
 
+    if(instrument_) _recordCallback(t_start, n, time_info);
+
     return paContinue;
 }
 
+
+void
+AudioPlaybackRt::
+_recordCallback(
+    const Clock::time_point & t_start,
+    const uint32 n_ready,
+    const PaStreamCallbackTimeInfo * time_info)
+{
+    Clock::time_point t_end = Clock::now();
+
+    int64 duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        t_end - t_start).count();
+
+    // The deadline is when this buffer reaches the DAC, if the host api
+    // doesn't report stream times use one buffer period.
+    int64 deadline = period_ns_;
+
+    if(time_info != nullptr
+        && time_info->outputBufferDacTime > time_info->currentTime)
+    {
+        deadline = static_cast<int64>(
+            1e9 * (time_info->outputBufferDacTime - time_info->currentTime));
+    }
+
+    int64 jitter = 0;
+
+    if(has_last_start_)
+    {
+        int64 interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            t_start - last_start_).count();
+
+        jitter = interval - period_ns_;
+    }
+
+    has_last_start_ = true;
+    last_start_ = t_start;
+
+    timing_.recordCallback(duration, deadline, jitter, n_ready);
+}
+
+
+void
+AudioPlaybackRt::
+_recordProducerWait(const Clock::time_point & t_start)
+{
+    Clock::time_point t_end = Clock::now();
+
+    int64 wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        t_end - t_start).count();
+
+    timing_.recordProducerWait(wait);
+
+    if(summary_period_ns_ > 0)
+    {
+        int64 since = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            t_end - last_summary_).count();
+
+        if(since >= summary_period_ns_)
+        {
+            last_summary_ = t_end;
+            std::cerr << getTimingSummary();
+        }
+    }
+}
+
+
+void
+AudioPlaybackRt::
+setInstrumentation(bool flag, uint32 n_history, float64 summary_period_sec)
+{
+    M_ASSERT_VALUE(1, ==, Pa_IsStreamStopped(driver_.stream_));
+    M_ASSERT_VALUE(n_history, >, 0);
+
+    instrument_ = false;
+
+    summary_period_ns_ = static_cast<int64>(1e9 * summary_period_sec);
+
+    timing_.reset(n_history, period_ns_);
+
+    has_last_start_ = false;
+    last_summary_ = Clock::now();
+
+    instrument_ = flag;
+}
+
+
+std::string
+AudioPlaybackRt::
+getTimingSummary() const
+{
+    return get_debug_info().summary();
+}
+
 void
 AudioPlaybackRt::
 _start()
 {
     if(0 == Pa_IsStreamStopped(driver_.stream_)) return;
 
-    n_history_.clear();
+    has_last_start_ = false;
 
     PaError ecode  = Pa_StartStream( driver_.stream_ );
 
@@ -625,6 +735,10 @@ play(float64 sample)
     {
         uint32 n = n_ready_.load();
 
+        Clock::time_point t_wait;
+
+        if(instrument_) t_wait = Clock::now();
+
         if(n == pool_size_)
         {
             _start();
@@ -637,6 +751,8 @@ play(float64 sample)
             n = n_ready_.load();
         }
 
+        if(instrument_) _recordProducerWait(t_wait);
+
         n_ready_.fetch_add(1);
 
         wr_index_ = 0;
@@ -666,6 +782,10 @@ play(float64 left, float64 right)
     {
         uint32 n = n_ready_.load();
 
+        Clock::time_point t_wait;
+
+        if(instrument_) t_wait = Clock::now();
+
         if(n == pool_size_)
         {
             _start();
@@ -678,6 +798,8 @@ play(float64 left, float64 right)
             n = n_ready_.load();
         }
 
+        if(instrument_) _recordProducerWait(t_wait);
+
         n_ready_.fetch_add(1);
 
         wr_index_ = 0;
@@ -813,7 +935,7 @@ AudioPlaybackRtDebug
 AudioPlaybackRt::
 get_debug_info() const
 {
-    AudioPlaybackRtDebug info;
+    AudioPlaybackRtDebug info = AudioPlaybackRtDebug();
 
     info.unknown_error_count = unknown_error_count_;
     info.overrun_count = overrun_count_;
@@ -823,7 +945,6 @@ get_debug_info() const
     info.pool_size = static_cast<uint32>(pool_.size());
     info.n_ready = n_ready_.load();
     info.wr_index = wr_index_;
-    info.n_history = n_history_;
 
     info.wr_ptr = 0;
 
@@ -861,6 +982,13 @@ get_debug_info() const
 
     info.is_streaming = 1 == Pa_IsStreamActive(driver_.stream_);
 
+    info.is_instrumented = instrument_;
+    info.period_us = 1e-3 * period_ns_;
+    info.histogram_bin_us =
+        2e-3 * period_ns_ / AudioPlaybackRtTiming::N_HISTOGRAM_BINS;
+
+    if(instrument_) timing_.snapshot(info);
+
     return info;
 }
 
@@ -868,6 +996,218 @@ get_debug_info() const
 //
 //-----------------------------------------------------------------------------
 
+#ifdef NSOUND_CPP11
+
+// Single writer updates of the running statistics, plain load and store is
+// enough since only one thread ever writes each of them.
+
+template <typename T>
+static inline void atomic_max(std::atomic<T> & a, T v)
+{
+    if(v > a.load(std::memory_order_relaxed)) a.store(v, std::memory_order_relaxed);
+}
+
+template <typename T>
+static inline void atomic_min(std::atomic<T> & a, T v)
+{
+    if(v < a.load(std::memory_order_relaxed)) a.store(v, std::memory_order_relaxed);
+}
+
+template <typename T>
+static inline void atomic_add(std::atomic<T> & a, T v)
+{
+    a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+
+// Copies the newest ring.size() - 1 entries of a single writer ring, oldest
+// first, the spare slot is the one the writer may be storing.  Entries that
+// may have been overwritten while copying are dropped.
+template <typename T>
+static std::vector<T>
+ring_snapshot(const std::vector<T> & ring, const std::atomic<uint64> & head)
+{
+    std::vector<T> out;
+
+    uint64 size = ring.size();
+
+    if(size < 2) return out;
+
+    uint64 end = head.load(std::memory_order_acquire);
+    uint64 begin = end > size - 1 ? end - (size - 1) : 0;
+
+    out.reserve(static_cast<std::size_t>(end - begin));
+
+    for(uint64 i = begin; i < end; ++i) out.push_back(ring[i % size]);
+
+    uint64 end2 = head.load(std::memory_order_acquire);
+
+    // Entries with index < end2 - size were overwritten during the copy and
+    // entry end2 - size may be, the writer could be storing entry end2.
+    if(end2 + 1 > begin + size)
+    {
+        uint64 n_stale = end2 + 1 - size - begin;
+
+        if(n_stale > out.size()) n_stale = out.size();
+
+        out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(n_stale));
+    }
+
+    return out;
+}
+
+
+const uint32 AudioPlaybackRtTiming::N_HISTOGRAM_BINS;
+
+
+AudioPlaybackRtTiming::
+AudioPlaybackRtTiming()
+    :
+    period_ns_(0),
+    callback_ring_(),
+    callback_head_(),
+    wait_ring_(),
+    wait_head_(),
+    callback_ns_sum_(),
+    callback_ns_max_(),
+    margin_ns_min_(),
+    jitter_ns_max_(),
+    wait_ns_sum_(),
+    wait_ns_max_()
+{
+    reset(1, 1);
+}
+
+
+void
+AudioPlaybackRtTiming::
+reset(uint32 n_history, int64 period_ns)
+{
+    M_ASSERT_VALUE(n_history, >, 0);
+    M_ASSERT_VALUE(period_ns, >, 0);
+
+    period_ns_ = period_ns;
+
+    callback_ring_.assign(n_history + 1, Entry());
+    wait_ring_.assign(n_history + 1, 0.0f);
+
+    callback_head_ = 0;
+    wait_head_ = 0;
+
+    callback_ns_sum_ = 0;
+    callback_ns_max_ = 0;
+    margin_ns_min_ = std::numeric_limits<int64>::max();
+    jitter_ns_max_ = 0;
+    wait_ns_sum_ = 0;
+    wait_ns_max_ = 0;
+
+    for(uint32 i = 0; i < N_HISTOGRAM_BINS; ++i) histogram_[i] = 0;
+}
+
+
+void
+AudioPlaybackRtTiming::
+recordCallback(
+    int64 duration_ns,
+    int64 deadline_ns,
+    int64 jitter_ns,
+    uint32 n_ready)
+{
+    int64 margin_ns = deadline_ns - duration_ns;
+
+    atomic_add<uint64>(callback_ns_sum_, static_cast<uint64>(duration_ns));
+    atomic_max<int64>(callback_ns_max_, duration_ns);
+    atomic_min<int64>(margin_ns_min_, margin_ns);
+    atomic_max<int64>(jitter_ns_max_, jitter_ns < 0 ? -jitter_ns : jitter_ns);
+
+    uint32 bin = static_cast<uint32>(
+        duration_ns * static_cast<int64>(N_HISTOGRAM_BINS) / (2 * period_ns_));
+
+    if(bin >= N_HISTOGRAM_BINS) bin = N_HISTOGRAM_BINS - 1;
+
+    histogram_[bin].fetch_add(1, std::memory_order_relaxed);
+
+    uint64 head = callback_head_.load(std::memory_order_relaxed);
+
+    Entry & e = callback_ring_[head % callback_ring_.size()];
+
+    e.callback_us = static_cast<float32>(1e-3 * duration_ns);
+    e.margin_us   = static_cast<float32>(1e-3 * margin_ns);
+    e.jitter_us   = static_cast<float32>(1e-3 * jitter_ns);
+    e.n_ready     = n_ready;
+
+    callback_head_.store(head + 1, std::memory_order_release);
+}
+
+
+void
+AudioPlaybackRtTiming::
+recordProducerWait(int64 wait_ns)
+{
+    atomic_add<uint64>(wait_ns_sum_, static_cast<uint64>(wait_ns));
+    atomic_max<int64>(wait_ns_max_, wait_ns);
+
+    uint64 head = wait_head_.load(std::memory_order_relaxed);
+
+    wait_ring_[head % wait_ring_.size()] = static_cast<float32>(1e-3 * wait_ns);
+
+    wait_head_.store(head + 1, std::memory_order_release);
+}
+
+
+void
+AudioPlaybackRtTiming::
+snapshot(AudioPlaybackRtDebug & info) const
+{
+    info.n_history.clear();
+    info.callback_us.clear();
+    info.margin_us.clear();
+    info.jitter_us.clear();
+    info.producer_wait_us.clear();
+    info.callback_histogram.clear();
+
+    for(const auto & e : ring_snapshot(callback_ring_, callback_head_))
+    {
+        info.n_history.push_back(e.n_ready);
+        info.callback_us.push_back(e.callback_us);
+        info.margin_us.push_back(e.margin_us);
+        info.jitter_us.push_back(e.jitter_us);
+    }
+
+    for(auto w : ring_snapshot(wait_ring_, wait_head_))
+    {
+        info.producer_wait_us.push_back(w);
+    }
+
+    info.n_callbacks = 0;
+
+    for(uint32 i = 0; i < N_HISTOGRAM_BINS; ++i)
+    {
+        uint32 count = histogram_[i].load(std::memory_order_relaxed);
+        info.callback_histogram.push_back(count);
+        info.n_callbacks += count;
+    }
+
+    info.callback_us_mean = 0.0;
+
+    if(info.n_callbacks > 0)
+    {
+        info.callback_us_mean = 1e-3 * callback_ns_sum_.load() / info.n_callbacks;
+    }
+
+    int64 margin_min = margin_ns_min_.load();
+
+    if(info.n_callbacks == 0) margin_min = 0;
+
+    info.callback_us_max = 1e-3 * callback_ns_max_.load();
+    info.margin_us_min = 1e-3 * margin_min;
+    info.jitter_us_max = 1e-3 * jitter_ns_max_.load();
+    info.producer_wait_us_total = 1e-3 * wait_ns_sum_.load();
+    info.producer_wait_us_max = 1e-3 * wait_ns_max_.load();
+}
+
+#endif
+
 void
 operator>>(const AudioStream & lhs, AudioPlaybackRt & rhs)
 {
@@ -918,6 +1258,55 @@ __str__() const
         ss << "        " << n << "\n";
     }
 
+    if(is_instrumented) ss << summary();
+
+    return ss.str();
+}
+
+
+std::string
+AudioPlaybackRtDebug::
+summary() const
+{
+    std::stringstream ss;
+
+    if(!is_instrumented)
+    {
+        ss << "AudioPlaybackRt timing: instrumentation disabled\n";
+        return ss.str();
+    }
+
+    ss
+        << "AudioPlaybackRt timing (us):\n"
+        << "    n_callbacks         = " << n_callbacks << "\n"
+        << "    period              = " << period_us << "\n"
+        << "    callback mean       = " << callback_us_mean << "\n"
+        << "    callback max        = " << callback_us_max << "\n"
+        << "    min deadline margin = " << margin_us_min << "\n"
+        << "    max jitter          = " << jitter_us_max << "\n"
+        << "    producer wait total = " << producer_wait_us_total << "\n"
+        << "    producer wait max   = " << producer_wait_us_max << "\n"
+        << "    underrun_count      = " << underrun_count << "\n"
+        << "    callback duration histogram:\n";
+
+    for(uint32 i = 0; i < callback_histogram.size(); ++i)
+    {
+        if(callback_histogram[i] == 0) continue;
+
+        ss << "        [" << i * histogram_bin_us << ", ";
+
+        if(i + 1 < callback_histogram.size())
+        {
+            ss << (i + 1) * histogram_bin_us << ")";
+        }
+        else
+        {
+            ss << "inf)";
+        }
+
+        ss << " " << callback_histogram[i] << "\n";
+    }
+
     return ss.str();
 }
 
@@ -48,6 +48,7 @@
 
 #ifdef NSOUND_CPP11
     #include <atomic>
+    #include <chrono>
 #endif
 
 namespace Nsound
@@ -84,9 +85,112 @@ struct AudioPlaybackRtDebug
 
     std::vector<uint32> n_history;
 
+    // Timing instrumentation, only filled in when enabled with
+    // AudioPlaybackRt::setInstrumentation().  All times are in microseconds.
+
+    bool    is_instrumented;
+    uint32  n_callbacks;
+    float64 period_us;               // nominal time between callbacks
+    float64 callback_us_mean;
+    float64 callback_us_max;
+    float64 margin_us_min;           // smallest time left before the deadline
+    float64 jitter_us_max;           // largest |callback interval - period|
+    float64 producer_wait_us_total;  // time play() spent blocked on a full pool
+    float64 producer_wait_us_max;
+
+    // Callback duration histogram, bin i counts durations in
+    // [i * histogram_bin_us, (i + 1) * histogram_bin_us), the last bin also
+    // counts everything longer.
+    float64 histogram_bin_us;
+    std::vector<uint32> callback_histogram;
+
+    // The most recent callbacks and buffer writes, oldest first.
+    std::vector<float64> callback_us;
+    std::vector<float64> margin_us;
+    std::vector<float64> jitter_us;
+    std::vector<float64> producer_wait_us;
+
     std::string __str__() const;
+
+    //! Returns just the timing statistics.
+    std::string summary() const;
 };
 
+#if defined(NSOUND_CPP11) && !defined(SWIG)
+
+//! The timing statistics of AudioPlaybackRt::setInstrumentation().
+//
+//! Samples are kept in preallocated rings of n_history entries.  Only the
+//! callback thread calls recordCallback() and only the producer thread calls
+//! recordProducerWait(), so every ring and statistic has a single writer and
+//! snapshot() may be called from any thread while they are recording.
+class AudioPlaybackRtTiming
+{
+    public:
+
+    static const uint32 N_HISTOGRAM_BINS = 32;
+
+    AudioPlaybackRtTiming();
+
+    //! Clears the statistics, no thread may be recording.
+    //
+    //! \param n_history the number of most recent entries to keep
+    //! \param period_ns the nominal time between callbacks, the histogram
+    //! spans two periods
+    void reset(uint32 n_history, int64 period_ns);
+
+    //! Records one callback.
+    //
+    //! \param duration_ns the time spent in the callback
+    //! \param deadline_ns the time the callback had before the buffer is due
+    //! \param jitter_ns the callback start interval minus the period
+    //! \param n_ready the number of buffers ready when the callback started
+    void
+    recordCallback(
+        int64 duration_ns,
+        int64 deadline_ns,
+        int64 jitter_ns,
+        uint32 n_ready);
+
+    //! Records the time play() was blocked waiting for a free buffer.
+    void recordProducerWait(int64 wait_ns);
+
+    //! Copies the statistics and the history, oldest first, into info.
+    void snapshot(AudioPlaybackRtDebug & info) const;
+
+    private:
+
+    AudioPlaybackRtTiming(const AudioPlaybackRtTiming & copy);
+    AudioPlaybackRtTiming & operator=(const AudioPlaybackRtTiming & rhs);
+
+    struct Entry
+    {
+        float32 callback_us;
+        float32 margin_us;
+        float32 jitter_us;
+        uint32  n_ready;
+    };
+
+    int64 period_ns_;
+
+    std::vector<Entry>   callback_ring_;
+    std::atomic<uint64>  callback_head_;
+
+    std::vector<float32> wait_ring_;
+    std::atomic<uint64>  wait_head_;
+
+    std::atomic<uint64> callback_ns_sum_;
+    std::atomic<int64>  callback_ns_max_;
+    std::atomic<int64>  margin_ns_min_;
+    std::atomic<int64>  jitter_ns_max_;
+    std::atomic<uint64> wait_ns_sum_;
+    std::atomic<int64>  wait_ns_max_;
+
+    std::atomic<uint32> histogram_[N_HISTOGRAM_BINS];
+};
+
+#endif
+
 class AudioPlaybackRt
 {
     public:
@@ -106,6 +210,23 @@ class AudioPlaybackRt
 
     void setBufferUnderrunMode(BufferUnderrunMode bum);
 
+    //! Enables per-callback timing instrumentation, the stream must be stopped.
+    //
+    //! When enabled, each callback records its duration, the margin left
+    //! before the buffer deadline and the jitter of its start time, and each
+    //! completed buffer written by play() records how long the producer was
+    //! blocked.  Samples are kept in preallocated lock-free rings of
+    //! n_history entries and are returned by get_debug_info().  When
+    //! summary_period_sec > 0, play() prints getTimingSummary() to stderr at
+    //! that interval.  When disabled the callback only tests a flag.
+    void setInstrumentation(
+        bool flag,
+        uint32 n_history = 4096,
+        float64 summary_period_sec = 0.0);
+
+    //! Returns the timing statistics collected so far.
+    std::string getTimingSummary() const;
+
     //! Returns information about the backend driver.
     std::string getInfo();
 
@@ -156,6 +277,20 @@ class AudioPlaybackRt
 
     void _start();
 
+    #ifdef NSOUND_CPP11
+
+        typedef std::chrono::steady_clock Clock;
+
+        void
+        _recordCallback(
+            const Clock::time_point & t_start,
+            const uint32 n_ready,
+            const PaStreamCallbackTimeInfo * time_info);
+
+        void _recordProducerWait(const Clock::time_point & t_start);
+
+    #endif
+
     typedef std::vector< int16 > Int16Vector;
     typedef std::vector< Int16Vector * > Pool;
 
@@ -175,8 +310,6 @@ class AudioPlaybackRt
     uint32 pa_underrun_count_;
     uint32 pa_overrun_count_;
 
-    std::vector<uint32> n_history_;
-
     Sine * sine_; // used to generate noise or tones on buffer underrun
 
     Pool pool_;
@@ -221,6 +354,23 @@ class AudioPlaybackRt
 
     float64 actual_latency_sec_;
 
+    #ifdef NSOUND_CPP11
+
+        // Timing instrumentation.
+
+        bool instrument_;
+
+        int64 period_ns_;
+        int64 summary_period_ns_;
+
+        AudioPlaybackRtTiming timing_;
+
+        bool              has_last_start_;
+        Clock::time_point last_start_;
+        Clock::time_point last_summary_;
+
+    #endif
+
     static bool use_jack_;
 
 }; // AudioPlaybackRt
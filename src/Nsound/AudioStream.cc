@@ -34,11 +34,15 @@
 #include <Nsound/Sine.h>
 #include <Nsound/Wavefile.h>
 #include <Nsound/StreamOperators.h>
+#include <Nsound/ThreadPool.h>
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <sstream>
+#include <vector>
 
 using namespace Nsound;
 
@@ -47,6 +51,60 @@ using std::cout;
 using std::endl;
 using std::flush;
 
+// The samples per task when an element wise operation splits a channel.
+static const uint32 CHUNK_SIZE = 65536;
+
+// Runs function(i) for every channel i, on the shared ThreadPool.
+template <typename Function>
+static
+void
+forEachChannel(const uint32 n_channels, const Function & function)
+{
+    ThreadPool::getInstance().run(n_channels, function);
+}
+
+// Runs function(x, n) over every channel in chunks of up to CHUNK_SIZE
+// samples, the chunks run on the shared ThreadPool.
+template <typename Function>
+static
+void
+forEachChunk(const std::vector<Buffer *> & buffers, const Function & function)
+{
+    ThreadPool & pool = ThreadPool::getInstance();
+
+    if(pool.getNThreads() == 1)
+    {
+        for(auto * ptr : buffers) function(ptr->getPointer(), ptr->getLength());
+
+        return;
+    }
+
+    // The first task of each channel.
+    std::vector<uint32> first(1, 0);
+
+    for(auto * ptr : buffers)
+    {
+        uint32 n_chunks = (ptr->getLength() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+        first.push_back(first.back() + n_chunks);
+    }
+
+    pool.run(
+        first.back(),
+        [&](uint32 task)
+        {
+            uint32 c = static_cast<uint32>(
+                std::upper_bound(first.begin(), first.end(), task)
+                - first.begin() - 1);
+
+            uint32 offset = (task - first[c]) * CHUNK_SIZE;
+
+            uint32 n = std::min(CHUNK_SIZE, buffers[c]->getLength() - offset);
+
+            function(buffers[c]->getPointer() + offset, n);
+        });
+}
+
 
 AudioStream::
 AudioStream()
@@ -113,7 +171,12 @@ void
 AudioStream::
 abs()
 {
-    for(auto * ptr : buffers_) ptr->abs();
+    forEachChunk(
+        buffers_,
+        [](float64 * x, uint32 n)
+        {
+            for(uint32 i = 0; i < n; ++i) x[i] = ::fabs(x[i]);
+        });
 }
 
 void
@@ -153,21 +216,21 @@ void
 AudioStream::
 convolve(const Buffer & b)
 {
-    for(auto * ptr : buffers_) ptr->convolve(b);
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->convolve(b); });
 }
 
 void
 AudioStream::
 dB()
 {
-    for(auto * ptr : buffers_) ptr->dB();
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->dB(); });
 }
 
 void
 AudioStream::
 derivative(uint32 n)
 {
-    for(auto * ptr : buffers_) ptr->derivative(n);
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->derivative(n); });
 }
 
 
@@ -175,7 +238,7 @@ void
 AudioStream::
 downSample(uint32 n)
 {
-    for(auto * ptr : buffers_) ptr->downSample(n);
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->downSample(n); });
 }
 
 float64
@@ -210,14 +273,27 @@ void
 AudioStream::
 limit(float64 min, float64 max)
 {
-    for(auto * ptr : buffers_) ptr->limit(min, max);
+    forEachChunk(
+        buffers_,
+        [&](float64 * x, uint32 n)
+        {
+            for(uint32 i = 0; i < n; ++i)
+            {
+                float64 s = x[i];
+
+                if(s > max) s = max;
+                if(s < min) s = min;
+
+                x[i] = s;
+            }
+        });
 }
 
 void
 AudioStream::
 limit(const Buffer & min, const Buffer & max)
 {
-    for(auto * ptr : buffers_) ptr->limit(min, max);
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->limit(min, max); });
 }
 
 float64
@@ -226,7 +302,13 @@ getMax() const
 {
     float64 max = std::numeric_limits<float64>::min();
 
-    for(auto * ptr : buffers_)  max = std::max(max, ptr->getMax());
+    std::vector<float64> values(channels_);
+
+    forEachChannel(
+        channels_,
+        [&](uint32 i) { values[i] = buffers_[i]->getMax(); });
+
+    for(auto v : values) max = std::max(max, v);
 
     return max;
 }
@@ -237,7 +319,13 @@ getMaxMagnitude() const
 {
     float64 max = std::numeric_limits<float64>::min();
 
-    for(auto * ptr : buffers_) max = std::max(max, ptr->getMaxMagnitude());
+    std::vector<float64> values(channels_);
+
+    forEachChannel(
+        channels_,
+        [&](uint32 i) { values[i] = buffers_[i]->getMaxMagnitude(); });
+
+    for(auto v : values) max = std::max(max, v);
 
     return max;
 }
@@ -248,7 +336,13 @@ getMin() const
 {
     float64 min = std::numeric_limits<float64>::max();
 
-    for(auto * ptr : buffers_) min = std::min(min, ptr->getMin());
+    std::vector<float64> values(channels_);
+
+    forEachChannel(
+        channels_,
+        [&](uint32 i) { values[i] = buffers_[i]->getMin(); });
+
+    for(auto v : values) min = std::min(min, v);
 
     return min;
 }
@@ -410,10 +504,7 @@ operator+=(const AudioStream & rhs)
 
     M_ASSERT_VALUE(channels_, ==, rhs.getNChannels());
 
-    for(uint32 i = 0; i < channels_; ++i)
-    {
-        (*this)[i] += rhs[i];
-    }
+    forEachChannel(channels_, [&](uint32 i) { (*this)[i] += rhs[i]; });
     return *this;
 }
 
@@ -421,7 +512,7 @@ AudioStream &
 AudioStream::
 operator+=(const Buffer & rhs)
 {
-    for(auto * ptr : buffers_) *ptr += rhs;
+    forEachChannel(channels_, [&](uint32 i) { *buffers_[i] += rhs; });
     return *this;
 }
 
@@ -433,10 +524,7 @@ operator-=(const AudioStream & rhs)
 
     M_ASSERT_VALUE(channels_, ==, rhs.channels_);
 
-    for(uint32 i = 0; i < channels_; ++i)
-    {
-        (*this)[i] -= rhs[i];
-    }
+    forEachChannel(channels_, [&](uint32 i) { (*this)[i] -= rhs[i]; });
     return *this;
 }
 
@@ -444,7 +532,7 @@ AudioStream &
 AudioStream::
 operator-=(const Buffer & rhs)
 {
-    for(auto * ptr : buffers_) *ptr -= rhs;
+    forEachChannel(channels_, [&](uint32 i) { *buffers_[i] -= rhs; });
     return *this;
 }
 
@@ -456,10 +544,7 @@ operator*=(const AudioStream & rhs)
 
     M_ASSERT_VALUE(channels_, ==, rhs.channels_);
 
-    for(uint32 i = 0; i < channels_; ++i)
-    {
-        (*this)[i] *= rhs[i];
-    }
+    forEachChannel(channels_, [&](uint32 i) { (*this)[i] *= rhs[i]; });
     return *this;
 }
 
@@ -467,7 +552,7 @@ AudioStream &
 AudioStream::
 operator*=(const Buffer & rhs)
 {
-    for(auto * ptr : buffers_) *ptr *= rhs;
+    forEachChannel(channels_, [&](uint32 i) { *buffers_[i] *= rhs; });
     return *this;
 }
 
@@ -480,10 +565,7 @@ operator/=(const AudioStream & rhs)
 
     M_ASSERT_VALUE(channels_, ==, rhs.channels_);
 
-    for(uint32 i = 0; i < channels_; ++i)
-    {
-        (*this)[i] /= rhs[i];
-    }
+    forEachChannel(channels_, [&](uint32 i) { (*this)[i] /= rhs[i]; });
     return *this;
 }
 
@@ -492,7 +574,7 @@ AudioStream &
 AudioStream::
 operator/=(const Buffer & rhs)
 {
-    for(auto * ptr : buffers_) *ptr /= rhs;
+    forEachChannel(channels_, [&](uint32 i) { *buffers_[i] /= rhs; });
     return *this;
 }
 
@@ -505,10 +587,7 @@ operator^=(const AudioStream & rhs)
 
     M_ASSERT_VALUE(channels_, ==, rhs.channels_);
 
-    for(uint32 i = 0; i < channels_; ++i)
-    {
-        (*this)[i] ^= rhs[i];
-    }
+    forEachChannel(channels_, [&](uint32 i) { (*this)[i] ^= rhs[i]; });
     return *this;
 }
 
@@ -517,7 +596,7 @@ AudioStream &
 AudioStream::
 operator^=(const Buffer & rhs)
 {
-    for(auto * ptr : buffers_) *ptr ^= rhs;
+    forEachChannel(channels_, [&](uint32 i) { *buffers_[i] ^= rhs; });
     return *this;
 }
 
@@ -534,7 +613,12 @@ AudioStream &
 AudioStream::
 operator+=(float64 d)
 {
-    for(auto * ptr : buffers_) *ptr += d;
+    forEachChunk(
+        buffers_,
+        [d](float64 * x, uint32 n)
+        {
+            for(uint32 i = 0; i < n; ++i) x[i] += d;
+        });
     return *this;
 }
 
@@ -542,7 +626,12 @@ AudioStream &
 AudioStream::
 operator-=(float64 d)
 {
-    for(auto * ptr : buffers_) *ptr -= d;
+    forEachChunk(
+        buffers_,
+        [d](float64 * x, uint32 n)
+        {
+            for(uint32 i = 0; i < n; ++i) x[i] -= d;
+        });
     return *this;
 }
 
@@ -550,7 +639,12 @@ AudioStream &
 AudioStream::
 operator*=(float64 d)
 {
-    for(auto * ptr : buffers_) *ptr *= d;
+    forEachChunk(
+        buffers_,
+        [d](float64 * x, uint32 n)
+        {
+            for(uint32 i = 0; i < n; ++i) x[i] *= d;
+        });
     return *this;
 }
 
@@ -558,7 +652,12 @@ AudioStream &
 AudioStream::
 operator/=(float64 d)
 {
-    for(auto * ptr : buffers_) *ptr /= d;
+    forEachChunk(
+        buffers_,
+        [d](float64 * x, uint32 n)
+        {
+            for(uint32 i = 0; i < n; ++i) x[i] /= d;
+        });
     return *this;
 }
 
@@ -566,7 +665,12 @@ AudioStream &
 AudioStream::
 operator^=(float64 d)
 {
-    for(auto * ptr : buffers_) *ptr ^= d;
+    forEachChunk(
+        buffers_,
+        [d](float64 * x, uint32 n)
+        {
+            for(uint32 i = 0; i < n; ++i) x[i] = std::pow(x[i], d);
+        });
     return *this;
 }
 
@@ -705,14 +809,14 @@ void
 AudioStream::
 resample(float64 factor)
 {
-    for(auto * ptr : buffers_) ptr->resample(factor);
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->resample(factor); });
 }
 
 void
 AudioStream::
 resample(const Buffer & factor)
 {
-    for(auto * ptr : buffers_) ptr->resample(factor);
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->resample(factor); });
 }
 
 void
@@ -732,7 +836,7 @@ void
 AudioStream::
 reverse()
 {
-    for(auto * ptr : buffers_) ptr->reverse();
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->reverse(); });
 }
 
 AudioStreamSelection
@@ -796,28 +900,37 @@ void
 AudioStream::
 smooth(uint32 n_passes, uint32 n_samples_per_average)
 {
-    for(auto * ptr : buffers_) ptr->smooth(n_passes, n_samples_per_average);
+    forEachChannel(
+        channels_,
+        [&](uint32 i)
+        {
+            buffers_[i]->smooth(n_passes, n_samples_per_average);
+        });
 }
 
 void
 AudioStream::
 speedUp(float32 step_size)
 {
-    for(auto * ptr : buffers_) ptr->speedUp(step_size);
+    forEachChannel(
+        channels_,
+        [&](uint32 i) { buffers_[i]->speedUp(step_size); });
 }
 
 void
 AudioStream::
 speedUp(const Buffer & step_buffer)
 {
-    for(auto * ptr : buffers_) ptr->speedUp(step_buffer);
+    forEachChannel(
+        channels_,
+        [&](uint32 i) { buffers_[i]->speedUp(step_buffer); });
 }
 
 void
 AudioStream::
 sqrt()
 {
-    for(auto * ptr : buffers_) ptr->sqrt();
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->sqrt(); });
 }
 
 AudioStream
@@ -894,55 +1007,180 @@ void
 AudioStream::
 upSample(uint32 n)
 {
-    for(auto * ptr : buffers_) ptr->upSample(n);
+    forEachChannel(channels_, [&](uint32 i) { buffers_[i]->upSample(n); });
+}
+
+//-----------------------------------------------------------------------------
+// Serialized AudioStream, all values are little endian:
+//
+//     offset  size  value
+//          0     8  'AUDIOSTR'
+//          8     2  uint16 format version
+//         10     2  uint16 reserved, 0
+//         12     4  uint32 number of channels C
+//         16     8  float64 sample rate
+//         24        C serialized Buffers, see Buffer.cc
+//
+// The legacy format is 'audiostr', host endian float64 sample rate, uint32
+// C, C legacy Buffers.
+
+static const char   AUDIO_STREAM_ID[8] = {'A','U','D','I','O','S','T','R'};
+static const uint16 SERIAL_VERSION = 1;
+static const uint32 HEADER_SIZE = 24;
+
+std::size_t
+AudioStream::
+getSerializedSize(uint32 flags) const
+{
+    std::size_t n_bytes = HEADER_SIZE;
+
+    for(auto * ptr : buffers_) n_bytes += ptr->getSerializedSize(flags);
+
+    return n_bytes;
+}
+
+char *
+AudioStream::
+serialize(char * dst, uint32 flags) const
+{
+    std::memcpy(dst, AUDIO_STREAM_ID, 8);
+
+    dst = writeLittleEndian(dst + 8, SERIAL_VERSION);
+    dst = writeLittleEndian(dst, static_cast<uint16>(0));
+    dst = writeLittleEndian(dst, getNChannels());
+    dst = writeLittleEndian(dst, sample_rate_);
+
+    for(auto * ptr : buffers_) dst = ptr->serialize(dst, flags);
+
+    return dst;
+}
+
+std::size_t
+AudioStream::
+deserialize(const void * data, std::size_t size)
+{
+    const char * src = static_cast<const char *>(data);
+
+    float64 sr = 0.0;
+    uint32 n_channels = 0;
+    std::size_t offset = 0;
+
+    if(size >= 20 && std::memcmp(src, "audiostr", 8) == 0)
+    {
+        std::memcpy(&sr, src + 8, 8);
+        std::memcpy(&n_channels, src + 16, 4);
+
+        offset = 20;
+    }
+    else if(size >= HEADER_SIZE && std::memcmp(src, AUDIO_STREAM_ID, 8) == 0)
+    {
+        uint16 version = 0;
+
+        readLittleEndian(src + 8, version);
+        readLittleEndian(src + 12, n_channels);
+        readLittleEndian(src + 16, sr);
+
+        if(version != SERIAL_VERSION)
+        {
+            M_THROW("AudioStream data has unsupported version " << version);
+        }
+
+        offset = HEADER_SIZE;
+    }
+    else
+    {
+        M_THROW("Did not find any Nsound AudioStream data in input stream!");
+    }
+
+    // Every channel takes at least 8 bytes.
+    if((size - offset) / 8 < n_channels)
+    {
+        M_THROW("AudioStream data is truncated!");
+    }
+
+    sample_rate_ = sr;
+
+    setNChannels(n_channels);
+
+    for(auto * ptr : buffers_)
+    {
+        offset += ptr->deserialize(src + offset, size - offset);
+    }
+
+    return offset;
 }
 
 std::ostream &
 AudioStream::
-write(std::ostream & out) const
+write(std::ostream & out, uint32 flags) const
 {
-    out & 'a' & 'u' & 'd' & 'i' & 'o' & 's' & 't' & 'r'
-        & getSampleRate()
-        & getNChannels();
+    std::string bytes = write(flags);
 
-    for(auto * ptr : buffers_) ptr->write(out);
+    out.write(bytes.data(), bytes.size());
 
     return out;
 }
 
 std::string
 AudioStream::
-write() const
+write(uint32 flags) const
 {
-    std::stringstream ss;
-    write(ss);
-    return ss.str();
+    std::string bytes(getSerializedSize(flags), '\0');
+
+    serialize(&bytes[0], flags);
+
+    return bytes;
 }
 
 std::istream &
 AudioStream::
 read(std::istream & in)
 {
-    char id[8];
+    char header[HEADER_SIZE];
+
+    in.read(header, 8);
+
     float64 sr = 0;
     uint32 n_channels = 0;
 
-    in
-        & id[0] & id[1] & id[2] & id[3] & id[4] & id[5] & id[6] & id[7]
-        & sr & n_channels;
+    if(in && std::memcmp(header, "audiostr", 8) == 0)
+    {
+        in & sr & n_channels;
+    }
+    else if(in && std::memcmp(header, AUDIO_STREAM_ID, 8) == 0)
+    {
+        in.read(header + 8, HEADER_SIZE - 8);
+
+        uint16 version = 0;
+
+        readLittleEndian(header + 8, version);
+        readLittleEndian(header + 12, n_channels);
+        readLittleEndian(header + 16, sr);
 
-    if(
-        id[0] != 'a' || id[1] != 'u' || id[2] != 'd' || id[3] != 'i' ||
-        id[4] != 'o' || id[5] != 's' || id[6] != 't' || id[7] != 'r')
+        if(version != SERIAL_VERSION)
+        {
+            M_THROW("AudioStream data has unsupported version " << version);
+        }
+    }
+    else
     {
         M_THROW("Did not find any Nsound AudioStream data in input stream!");
     }
 
     sample_rate_ = sr;
 
-    setNChannels(n_channels);
+    // Add the channels as they are read, a corrupt n_channels ends with the
+    // stream instead of allocating every channel up front.
+    setNChannels(0);
 
-    for(auto * ptr : buffers_) ptr->read(in);
+    for(uint32 i = 0; i < n_channels; ++i)
+    {
+        buffers_.push_back(new Buffer());
+
+        ++channels_;
+
+        buffers_.back()->read(in);
+    }
 
     return in;
 }
@@ -951,9 +1189,7 @@ void
 AudioStream::
 read(const void * data, std::size_t size)
 {
-    std::string in(reinterpret_cast<const char *>(data), size);
-    std::stringstream ss(in);
-    read(ss);
+    deserialize(data, size);
 }
 
 void
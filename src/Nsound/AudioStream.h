@@ -49,6 +49,9 @@ namespace Nsound
 //  Class AudioStream
 //
 //-----------------------------------------------------------------------------
+//! Methods that work on each channel on its own run the channels, or chunks
+//! of them for element wise math, on the shared ThreadPool once it has more
+//! than one thread, see ThreadPool::setNThreads().
 class AudioStream
 {
 
@@ -458,15 +461,24 @@ public:
     AudioStreamSelection
     select(const uint32 start_index, const uint32 stop_index);
 
-    //! Serializes the AudioStream to output stream, no endian checks.
+    //! Serializes the AudioStream to output stream.
     //
+    //! Each channel is stored as a serialized Buffer, see Buffer::write().
+    //!
     //! \param out the std::ostream to write bytes to
+    //! \param flags 0 or a combination of Buffer::FLOAT32 and
+    //!        Buffer::CHECKSUM
     //
     std::ostream &
-    write(std::ostream & out) const;
+    write(std::ostream & out, uint32 flags = 0) const;
 
+    //! Serializes the AudioStream, this is what pickling uses.
     bytearray
-    write() const;
+    write(uint32 flags = 0) const;
+
+    //! Returns the number of bytes write() produces.
+    std::size_t
+    getSerializedSize(uint32 flags = 0) const;
 
     #ifndef SWIG
         //! Constructs an AudioStream from seralized data in the inputstream.
@@ -475,6 +487,15 @@ public:
         //
         std::istream &
         read(std::istream & stream_in);
+
+        //! Serializes into dst, which must hold getSerializedSize(flags)
+        //! bytes, returns the end of the written bytes.
+        char *
+        serialize(char * dst, uint32 flags = 0) const;
+
+        //! Reads serialized data, returns the number of bytes used.
+        std::size_t
+        deserialize(const void * data, std::size_t size);
     #endif
 
     void
@@ -37,13 +37,17 @@
 #include <Nsound/Generator.h>
 #include <Nsound/Nsound.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/SlidingWindow.h>
 #include <Nsound/StreamOperators.h>
 #include <Nsound/Wavefile.h>
 
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <limits>
 #include <sstream>
 
 using std::cerr;
@@ -226,6 +230,8 @@ add(const Buffer & b,
     uint32 offset,
     uint32 n_samples)
 {
+    M_PROFILE_SAMPLES("Buffer::add", b.getLength());
+
     uint32 a_length = getLength();
     uint32 b_length = b.getLength();
 
@@ -526,6 +532,8 @@ Buffer
 Buffer::
 getConvolve(const Buffer & H) const
 {
+    M_PROFILE_SAMPLES("Buffer::getConvolve", getLength());
+
     // Alocate the output Buffer will all zeros.
     Buffer y = *this * 0.0;
 
@@ -624,60 +632,15 @@ findPeaks(
     uint32 window_size,
     float64 min_height) const
 {
+    M_PROFILE_SAMPLES("Buffer::findPeaks", getLength());
+
     Uint32Vector peaks;
     peaks.reserve(128);
 
-    uint32 h_window_size = window_size / 2 + 1;  // half window size
-
-    uint32 n_samples = getLength();
-
-    for(uint32 i = 1; i < n_samples - 1; ++i)
-    {
-        boolean is_peak = false;
-
-        float64 sample = data_[i];
-
-        if(window_size <= 2)
-        {
-            if( sample > data_[i - 1] &&
-                sample > data_[i + 1])
-            {
-                is_peak = true;
-            }
-        }
-        else
-        {
-            // Assume it's a peak.
-
-            is_peak = true;
+    PeakFinder finder(window_size, min_height);
 
-            for(uint32 j = 1; j < h_window_size; ++j)
-            {
-                if(j < i)
-                {
-                    if(data_[i - j] > sample)
-                    {
-                        is_peak = false;
-                        break;
-                    }
-                }
-
-                if(i + j < n_samples)
-                {
-                    if(data_[i + j] > sample)
-                    {
-                        is_peak = false;
-                        break;
-                    }
-                }
-            }
-        }
-
-        if(is_peak && sample > min_height)
-        {
-            peaks.push_back(i);
-        }
-    }
+    finder.find(getPointer(), getLength(), peaks);
+    finder.flush(peaks);
 
     return peaks;
 }
@@ -689,6 +652,8 @@ Buffer
 Buffer::
 findPitch(float64 sample_rate)
 {
+    M_PROFILE_SAMPLES("Buffer::findPitch", getLength());
+
     // This is based on the YIN pitch estimation algorithm.
 
     // Create a window size that will fit 2 cycles of 20 Hz, our minimum
@@ -1020,10 +985,47 @@ getMin() const
     return min;
 }
 
+Buffer
+Buffer::
+getMovingSum(uint32 window_size) const
+{
+    return SlidingWindow(SlidingWindow::SUM, window_size).filter(*this);
+}
+
+Buffer
+Buffer::
+getMovingMean(uint32 window_size) const
+{
+    return SlidingWindow(SlidingWindow::MEAN, window_size).filter(*this);
+}
+
+Buffer
+Buffer::
+getMovingRms(uint32 window_size) const
+{
+    return SlidingWindow(SlidingWindow::RMS, window_size).filter(*this);
+}
+
+Buffer
+Buffer::
+getMovingMax(uint32 window_size) const
+{
+    return SlidingWindow(SlidingWindow::MAX, window_size).filter(*this);
+}
+
+Buffer
+Buffer::
+getMovingMin(uint32 window_size) const
+{
+    return SlidingWindow(SlidingWindow::MIN, window_size).filter(*this);
+}
+
 void
 Buffer::
 mul(const Buffer & buffer, uint32 offset, uint32 n_samples)
 {
+    M_PROFILE_SAMPLES("Buffer::mul", buffer.getLength());
+
     M_ASSERT_VALUE(offset, >=, 0);
     M_ASSERT_VALUE(offset, <, getLength());
 
@@ -1076,27 +1078,31 @@ Buffer
 Buffer::
 getSignalEnergy(uint32 N) const
 {
-    float64 n = static_cast<float64>(N);
+    M_PROFILE_SAMPLES("Buffer::getSignalEnergy", getLength());
 
-    Buffer y;
+    M_ASSERT_VALUE(N, >, 0);
+
+    float64 n = static_cast<float64>(N);
 
     uint32 length = getLength();
 
-    for(uint32 i = 0; i < length; ++i)
+    Buffer y(*this);
+
+    float64 * out = y.getPointer();
+
+    // y[i] = sum(|x[i]| ... |x[i + N - 1]|) / N, a moving sum delayed by
+    // N - 1 samples.  The last sample isn't included.
+    SlidingWindow window(SlidingWindow::SUM, N);
+
+    for(uint32 k = 0; k + 1 < length + N; ++k)
     {
-        float64 sum = 0.0;
+        float64 a = 0.0;
 
-        for(uint32 j = 0; j < N; ++j)
-        {
-            if(i + j < length - 1)
-            {
-                sum += ::fabs(data_[i + j]);
-            }
-        }
-        sum /= n;
+        if(k + 1 < length) a = ::fabs(data_[k]);
 
-        y << sum;
+        float64 sum = window.filter(a);
 
+        if(k + 1 >= N) out[k + 1 - N] = sum / n;
     }
 
     return y;
@@ -1253,6 +1259,8 @@ Buffer &
 Buffer::
 operator+=(const Buffer & rhs)
 {
+    M_PROFILE_SAMPLES("Buffer::operator+=", getLength());
+
     std::size_t N = std::min(getLength(), rhs.getLength());
     for(std::size_t i = 0; i < N; ++i) data_[i] += rhs.data_[i];
     return *this;
@@ -1262,6 +1270,8 @@ Buffer &
 Buffer::
 operator-=(const Buffer & rhs)
 {
+    M_PROFILE_SAMPLES("Buffer::operator-=", getLength());
+
     std::size_t N = std::min(getLength(), rhs.getLength());
     for(std::size_t i = 0; i < N; ++i) data_[i] -= rhs.data_[i];
     return *this;
@@ -1271,6 +1281,8 @@ Buffer &
 Buffer::
 operator*=(const Buffer & rhs)
 {
+    M_PROFILE_SAMPLES("Buffer::operator*=", getLength());
+
     std::size_t N = std::min(getLength(), rhs.getLength());
     for(std::size_t i = 0; i < N; ++i) data_[i] *= rhs.data_[i];
     return *this;
@@ -1280,6 +1292,8 @@ Buffer &
 Buffer::
 operator/=(const Buffer & rhs)
 {
+    M_PROFILE_SAMPLES("Buffer::operator/=", getLength());
+
     std::size_t N = std::min(getLength(), rhs.getLength());
     for(std::size_t i = 0; i < N; ++i) data_[i] /= rhs.data_[i];
     return *this;
@@ -1687,6 +1701,8 @@ _get_resample(
     const uint32 N,
     float64 beta) const
 {
+    M_PROFILE_SAMPLES("Buffer::getResample", getLength());
+
     if(L == 1 && M == 1)
     {
         return *this;
@@ -1917,53 +1933,302 @@ select(const uint32 start_index, const uint32 stop_index)
     return BufferSelection(*this, bv);
 }
 
-std::ostream &
+//-----------------------------------------------------------------------------
+// Serialized Buffer, all values are little endian:
+//
+//     offset  size  value
+//          0     4  'BUFF'
+//          4     2  uint16 format version
+//          6     2  uint16 flags, FLOAT32 | CHECKSUM
+//          8     8  uint64 number of samples N
+//         16  4N or 8N  samples, float32 if FLOAT32 else float64
+//   16 + 4N or 8N    8  uint64 FNV-1a of the sample bytes if CHECKSUM
+//
+// The legacy format is 'buff', uint32 N, N host endian float64 samples.
+
+static const char   BUFFER_ID[4] = {'B', 'U', 'F', 'F'};
+static const uint16 SERIAL_VERSION = 1;
+static const uint32 HEADER_SIZE = 16;
+
+static
+uint64
+checksum(const char * data, std::size_t n_bytes)
+{
+    static const uint64 FNV_PRIME = 1099511628211ULL;
+
+    uint64 h = 14695981039346656037ULL;
+    uint64 w = 0;
+
+    std::size_t i = 0;
+
+    for(; i + 8 <= n_bytes; i += 8)
+    {
+        readLittleEndian(data + i, w);
+        h = (h ^ w) * FNV_PRIME;
+    }
+
+    if(i < n_bytes)
+    {
+        char tail[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+        std::memcpy(tail, data + i, n_bytes - i);
+
+        readLittleEndian(tail, w);
+        h = (h ^ w) * FNV_PRIME;
+    }
+
+    return h;
+}
+
+std::size_t
 Buffer::
-write(std::ostream & out) const
+getSerializedSize(uint32 flags) const
 {
-    out & 'b' & 'u' & 'f' & 'f' & getLength();
+    std::size_t sample_size = (flags & FLOAT32) ? 4 : 8;
 
-    for(uint32 i = 0; i < getLength(); ++i)
+    return HEADER_SIZE
+        + sample_size * getLength()
+        + ((flags & CHECKSUM) ? 8 : 0);
+}
+
+char *
+Buffer::
+serialize(char * dst, uint32 flags) const
+{
+    M_ASSERT_MSG((flags & ~(FLOAT32 | CHECKSUM)) == 0, "unknown flags");
+
+    uint64 n = getLength();
+
+    std::memcpy(dst, BUFFER_ID, 4);
+
+    dst = writeLittleEndian(dst + 4, SERIAL_VERSION);
+    dst = writeLittleEndian(dst, static_cast<uint16>(flags));
+    dst = writeLittleEndian(dst, n);
+
+    char * samples = dst;
+
+    if(flags & FLOAT32)
+    {
+        for(uint64 i = 0; i < n; ++i)
+        {
+            dst = writeLittleEndian(dst, static_cast<float32>(data_[i]));
+        }
+    }
+    else
+    {
+        #ifdef NSOUND_BIG_ENDIAN
+            for(uint64 i = 0; i < n; ++i)
+            {
+                dst = writeLittleEndian(dst, data_[i]);
+            }
+        #else
+            std::memcpy(dst, data_.data(), sizeof(float64) * n);
+            dst += sizeof(float64) * n;
+        #endif
+    }
+
+    if(flags & CHECKSUM)
+    {
+        dst = writeLittleEndian(dst, checksum(samples, dst - samples));
+    }
+
+    return dst;
+}
+
+std::size_t
+Buffer::
+deserialize(const void * data, std::size_t size)
+{
+    const char * src = static_cast<const char *>(data);
+
+    if(size >= 8 && std::memcmp(src, "buff", 4) == 0)
+    {
+        uint32 n = 0;
+
+        std::memcpy(&n, src + 4, 4);
+
+        if((size - 8) / sizeof(float64) < n)
+        {
+            M_THROW("Buffer data is truncated!");
+        }
+
+        data_.resize(n);
+
+        std::memcpy(data_.data(), src + 8, sizeof(float64) * n);
+
+        return 8 + sizeof(float64) * n;
+    }
+
+    if(size < HEADER_SIZE || std::memcmp(src, BUFFER_ID, 4) != 0)
+    {
+        M_THROW("Did not find any Nsound Buffer data in input stream!");
+    }
+
+    uint16 version = 0;
+    uint16 flags = 0;
+    uint64 n = 0;
+
+    src = readLittleEndian(src + 4, version);
+    src = readLittleEndian(src, flags);
+    src = readLittleEndian(src, n);
+
+    if(version != SERIAL_VERSION)
+    {
+        M_THROW("Buffer data has unsupported version " << version);
+    }
+
+    if((flags & ~(FLOAT32 | CHECKSUM)) != 0)
+    {
+        M_THROW("Buffer data has unknown flags " << flags);
+    }
+
+    std::size_t sample_size = (flags & FLOAT32) ? 4 : 8;
+    std::size_t tail = (flags & CHECKSUM) ? 8 : 0;
+
+    if(size < HEADER_SIZE + tail
+        || (size - HEADER_SIZE - tail) / sample_size < n)
+    {
+        M_THROW("Buffer data is truncated!");
+    }
+
+    std::size_t n_bytes = sample_size * n;
+
+    if(flags & CHECKSUM)
+    {
+        uint64 expected = 0;
+
+        readLittleEndian(src + n_bytes, expected);
+
+        if(checksum(src, n_bytes) != expected)
+        {
+            M_THROW("Buffer data checksum mismatch!");
+        }
+    }
+
+    data_.resize(n);
+
+    if(flags & FLOAT32)
     {
-        out & data_[i];
+        float32 x = 0.0f;
+
+        for(uint64 i = 0; i < n; ++i)
+        {
+            src = readLittleEndian(src, x);
+            data_[i] = x;
+        }
     }
+    else
+    {
+        #ifdef NSOUND_BIG_ENDIAN
+            for(uint64 i = 0; i < n; ++i)
+            {
+                src = readLittleEndian(src, data_[i]);
+            }
+        #else
+            std::memcpy(data_.data(), src, n_bytes);
+        #endif
+    }
+
+    return HEADER_SIZE + n_bytes + tail;
+}
+
+std::ostream &
+Buffer::
+write(std::ostream & out, uint32 flags) const
+{
+    std::string bytes = write(flags);
+
+    out.write(bytes.data(), bytes.size());
 
     return out;
 }
 
 std::string
 Buffer::
-write() const
+write(uint32 flags) const
 {
-    std::stringstream ss;
-    write(ss);
-    return ss.str();
+    M_PROFILE_SAMPLES("Buffer::write", getLength());
+
+    std::string bytes(getSerializedSize(flags), '\0');
+
+    serialize(&bytes[0], flags);
+
+    return bytes;
 }
 
 std::istream &
 Buffer::
 read(std::istream & in)
 {
-    char id[4];
-    uint32 size = 0;
+    char header[HEADER_SIZE];
 
-    in & id[0] & id[1] & id[2] & id[3] & size;
+    in.read(header, 4);
 
-    if(id[0] != 'b' || id[1] != 'u' || id[2] != 'f' || id[3] != 'f')
+    if(in && std::memcmp(header, "buff", 4) == 0)
+    {
+        in.read(header + 4, 4);
+
+        uint32 size = 0;
+
+        std::memcpy(&size, header + 4, 4);
+
+        std::string bytes(header, 8);
+
+        if(!in || !readBytes(in, bytes, sizeof(float64) * uint64(size)))
+        {
+            M_THROW("Buffer data is truncated!");
+        }
+
+        deserialize(bytes.data(), bytes.size());
+
+        return in;
+    }
+
+    if(!in || std::memcmp(header, BUFFER_ID, 4) != 0)
     {
         M_THROW("Did not find any Nsound Buffer data in input stream!");
     }
 
-    data_.clear();
-    data_.reserve(size);
+    in.read(header + 4, HEADER_SIZE - 4);
+
+    if(!in) M_THROW("Buffer data is truncated!");
+
+    uint16 version = 0;
+    uint16 flags = 0;
+    uint64 n = 0;
+
+    readLittleEndian(header + 4, version);
+    readLittleEndian(header + 6, flags);
+    readLittleEndian(header + 8, n);
+
+    // Check the header before n sizes anything.
+    if(version != SERIAL_VERSION)
+    {
+        M_THROW("Buffer data has unsupported version " << version);
+    }
 
-    for(uint32 i = 0; i < size; ++i)
+    if((flags & ~(FLOAT32 | CHECKSUM)) != 0)
     {
-        float64 d;
-        in & d;
-        data_.push_back(d);
+        M_THROW("Buffer data has unknown flags " << flags);
     }
 
+    uint64 sample_size = (flags & FLOAT32) ? 4 : 8;
+    uint64 tail = (flags & CHECKSUM) ? 8 : 0;
+
+    if(n > (std::numeric_limits<uint64>::max() - tail) / sample_size)
+    {
+        M_THROW("Buffer data is truncated!");
+    }
+
+    std::string bytes(header, HEADER_SIZE);
+
+    if(!readBytes(in, bytes, sample_size * n + tail))
+    {
+        M_THROW("Buffer data is truncated!");
+    }
+
+    deserialize(bytes.data(), bytes.size());
+
     return in;
 }
 
@@ -1971,16 +2236,17 @@ void
 Buffer::
 read(const void * data, std::size_t size)
 {
-    std::string in(reinterpret_cast<const char *>(data), size);
-    std::stringstream ss(in);
+    M_PROFILE_SAMPLES("Buffer::read", size / sizeof(float64));
 
-    read(ss);
+    deserialize(data, size);
 }
 
 void
 Buffer::
 smooth(uint32 n_passes, uint32 n_samples_to_average)
 {
+    M_PROFILE_SAMPLES("Buffer::smooth", n_passes * getLength());
+
     if(n_samples_to_average < 2)
     {
         return;
@@ -2008,6 +2274,8 @@ void
 Buffer::
 speedUp(float64 step_size)
 {
+    M_PROFILE_SAMPLES("Buffer::speedUp", getLength());
+
     Buffer new_buffer;
 
     float64 n_samples = static_cast<float64>(data_.size());
@@ -2024,6 +2292,8 @@ void
 Buffer::
 speedUp(const Buffer & step_buffer)
 {
+    M_PROFILE_SAMPLES("Buffer::speedUp", getLength());
+
     Buffer new_buffer;
 
     float64 n_samples = static_cast<float64>(getLength());
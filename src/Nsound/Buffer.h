@@ -795,6 +795,85 @@ class Buffer
     float64
     getMin() const;
 
+    //! Returns the sum of the last window_size samples at every sample.
+    //
+    //! All of the moving statistics are O(length) and causal, output i
+    //! covers samples i - window_size + 1 through i, see SlidingWindow for
+    //! processing a signal one block at a time.
+    //!
+    //! \par Example:
+    //! \code
+    //! // C++
+    //! Buffer b1("california.wav");
+    //! Buffer sum = b1.getMovingSum(1024);
+    //!
+    //! // Python
+    //! b1 = Buffer("california.wav")
+    //! s = b1.getMovingSum(1024)
+    //! \endcode
+    Buffer
+    getMovingSum(uint32 window_size) const;
+
+    //! Returns the mean of the last window_size samples at every sample.
+    //
+    //! \par Example:
+    //! \code
+    //! // C++
+    //! Buffer b1("california.wav");
+    //! Buffer mean = b1.getMovingMean(1024);
+    //!
+    //! // Python
+    //! b1 = Buffer("california.wav")
+    //! m = b1.getMovingMean(1024)
+    //! \endcode
+    Buffer
+    getMovingMean(uint32 window_size) const;
+
+    //! Returns the RMS of the last window_size samples at every sample.
+    //
+    //! \par Example:
+    //! \code
+    //! // C++
+    //! Buffer b1("california.wav");
+    //! Buffer rms = b1.getMovingRms(1024);
+    //!
+    //! // Python
+    //! b1 = Buffer("california.wav")
+    //! rms = b1.getMovingRms(1024)
+    //! \endcode
+    Buffer
+    getMovingRms(uint32 window_size) const;
+
+    //! Returns the maximum of the last window_size samples at every sample.
+    //
+    //! \par Example:
+    //! \code
+    //! // C++
+    //! Buffer b1("california.wav");
+    //! Buffer max = b1.getMovingMax(1024);
+    //!
+    //! // Python
+    //! b1 = Buffer("california.wav")
+    //! m = b1.getMovingMax(1024)
+    //! \endcode
+    Buffer
+    getMovingMax(uint32 window_size) const;
+
+    //! Returns the minimum of the last window_size samples at every sample.
+    //
+    //! \par Example:
+    //! \code
+    //! // C++
+    //! Buffer b1("california.wav");
+    //! Buffer min = b1.getMovingMin(1024);
+    //!
+    //! // Python
+    //! b1 = Buffer("california.wav")
+    //! m = b1.getMovingMin(1024)
+    //! \endcode
+    Buffer
+    getMovingMin(uint32 window_size) const;
+
 
     // mul()
     //
@@ -1614,15 +1693,32 @@ class Buffer
     BufferSelection
     select(const uint32 start_index, const uint32 stop_index);
 
-    //! Serializes the Buffer to output stream, no endian checks.
+    //! Flags for write().
+    enum SerializeFlags
+    {
+        FLOAT32  = 1, //!< Store the samples as float32, half the size.
+        CHECKSUM = 2  //!< Append a checksum that read() verifies.
+    };
+
+    //! Serializes the Buffer to output stream.
     //
+    //! The samples are written little endian after a small versioned
+    //! header.  Data written by earlier versions of Nsound can still be
+    //! read.
+    //!
     //! \param out the std::ostream to write bytes to
+    //! \param flags 0 or a combination of FLOAT32 and CHECKSUM
     //
     std::ostream &
-    write(std::ostream & out) const;
+    write(std::ostream & out, uint32 flags = 0) const;
 
+    //! Serializes the Buffer, this is what pickling uses.
     bytearray
-    write() const;
+    write(uint32 flags = 0) const;
+
+    //! Returns the number of bytes write() produces.
+    std::size_t
+    getSerializedSize(uint32 flags = 0) const;
 
     #ifndef SWIG
         //! Constructs a Buffer from seralized data in the inputstream.
@@ -1631,6 +1727,15 @@ class Buffer
         //
         std::istream &
         read(std::istream & stream_in);
+
+        //! Serializes into dst, which must hold getSerializedSize(flags)
+        //! bytes, returns the end of the written bytes.
+        char *
+        serialize(char * dst, uint32 flags = 0) const;
+
+        //! Reads serialized data, returns the number of bytes used.
+        std::size_t
+        deserialize(const void * data, std::size_t size);
     #endif
 
     void
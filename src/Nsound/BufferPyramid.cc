@@ -0,0 +1,243 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: BufferPyramid.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/Buffer.h>
+#include <Nsound/BufferPyramid.h>
+#include <Nsound/Profiler.h>
+
+#include <algorithm>
+
+using namespace Nsound;
+
+BufferPyramid::
+BufferPyramid(const Buffer & x, const uint32 factor)
+    :
+    factor_(factor),
+    samples_(x),
+    min_(),
+    max_()
+{
+    M_ASSERT_VALUE(factor, >=, 2);
+
+    M_PROFILE_SAMPLES("BufferPyramid::BufferPyramid", x.getLength());
+
+    const float64 * lo = samples_.getPointer();
+    const float64 * hi = lo;
+
+    uint32 n = samples_.getLength();
+
+    while(n > 1)
+    {
+        uint32 m = (n + factor_ - 1) / factor_;
+
+        FloatVector mins(m);
+        FloatVector maxs(m);
+
+        for(uint32 p = 0; p < m; ++p)
+        {
+            uint32 i = p * factor_;
+            uint32 end = std::min(n, i + factor_);
+
+            float64 a = lo[i];
+            float64 b = hi[i];
+
+            for(++i; i < end; ++i)
+            {
+                if(lo[i] < a) a = lo[i];
+                if(hi[i] > b) b = hi[i];
+            }
+
+            mins[p] = a;
+            maxs[p] = b;
+        }
+
+        min_.push_back(std::move(mins));
+        max_.push_back(std::move(maxs));
+
+        lo = min_.back().data();
+        hi = max_.back().data();
+
+        n = m;
+    }
+}
+
+uint64
+BufferPyramid::
+getSamplesPerPoint(const uint32 level) const
+{
+    M_ASSERT_VALUE(level, <, getNLevels());
+
+    uint64 spp = 1;
+
+    for(uint32 i = 0; i < level; ++i) spp *= factor_;
+
+    return spp;
+}
+
+uint32
+BufferPyramid::
+getLevel(const uint32 n_samples, const uint32 n_points) const
+{
+    uint64 n = std::max(n_points, 1u);
+
+    uint32 level = 0;
+    uint64 spp = factor_;
+
+    while(level + 1 < getNLevels() && n_samples / spp >= n)
+    {
+        ++level;
+        spp *= factor_;
+    }
+
+    return level;
+}
+
+void
+BufferPyramid::
+_addExact(
+    const uint32 start,
+    const uint32 stop,
+    Buffer & x,
+    Buffer & min,
+    Buffer & max) const
+{
+    const float64 * y = samples_.getPointer();
+
+    float64 a = y[start];
+    float64 b = y[start];
+
+    for(uint32 i = start + 1; i < stop; ++i)
+    {
+        if(y[i] < a) a = y[i];
+        if(y[i] > b) b = y[i];
+    }
+
+    x << static_cast<float64>(start);
+    min << a;
+    max << b;
+}
+
+void
+BufferPyramid::
+getEnvelope(
+    const uint32 start,
+    const uint32 stop_index,
+    const uint32 n_points,
+    Buffer & x,
+    Buffer & min,
+    Buffer & max) const
+{
+    const uint32 stop = std::min(stop_index, getLength());
+
+    x = Buffer();
+    min = Buffer();
+    max = Buffer();
+
+    if(start >= stop) return;
+
+    const uint32 level = getLevel(stop - start, n_points);
+
+    if(level == 0)
+    {
+        const float64 * y = samples_.getPointer();
+
+        for(uint32 i = start; i < stop; ++i)
+        {
+            x << static_cast<float64>(i);
+            min << y[i];
+            max << y[i];
+        }
+
+        return;
+    }
+
+    const uint64 spp = getSamplesPerPoint(level);
+
+    // The points fully inside the range come from the level, the partial
+    // points at either end are computed from the samples.
+    const uint32 first = static_cast<uint32>((start + spp - 1) / spp);
+    const uint32 last = static_cast<uint32>(stop / spp);
+
+    x = Buffer(last - first + 2);
+    min = Buffer(last - first + 2);
+    max = Buffer(last - first + 2);
+
+    const uint32 first_sample = static_cast<uint32>(first * spp);
+    const uint32 last_sample = static_cast<uint32>(last * spp);
+
+    if(start < first_sample) _addExact(start, first_sample, x, min, max);
+
+    const FloatVector & lo = min_[level - 1];
+    const FloatVector & hi = max_[level - 1];
+
+    for(uint32 p = first; p < last; ++p)
+    {
+        x << static_cast<float64>(p * spp);
+        min << lo[p];
+        max << hi[p];
+    }
+
+    if(last_sample < stop) _addExact(last_sample, stop, x, min, max);
+}
+
+void
+BufferPyramid::
+getPlotData(
+    const uint32 start,
+    const uint32 stop,
+    const uint32 n_points,
+    Buffer & x,
+    Buffer & y) const
+{
+    Buffer t;
+    Buffer lo;
+    Buffer hi;
+
+    getEnvelope(start, stop, n_points, t, lo, hi);
+
+    uint32 n = t.getLength();
+
+    // One sample per point, the samples themselves.
+    if(n == 0 || n == std::min(stop, getLength()) - start)
+    {
+        x = t;
+        y = lo;
+        return;
+    }
+
+    x = Buffer(2 * n);
+    y = Buffer(2 * n);
+
+    for(uint32 i = 0; i < n; ++i)
+    {
+        x << t[i] << t[i];
+        y << lo[i] << hi[i];
+    }
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,154 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: BufferPyramid.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_BUFFER_PYRAMID_H_
+#define _NSOUND_BUFFER_PYRAMID_H_
+
+#include <Nsound/Nsound.h>
+#include <Nsound/Buffer.h>
+
+#include <vector>
+
+namespace Nsound
+{
+
+//-----------------------------------------------------------------------------
+//! A min/max decimation pyramid of a Buffer for drawing long signals.
+//
+//! Level 0 holds the samples, each following level holds the minimum and
+//! maximum of factor points of the level below.  The pyramid is built once
+//! in O(length) and takes about 2 / (factor - 1) times the memory of the
+//! samples.  getEnvelope() then returns the exact minimum and maximum of
+//! any range in O(n_points) by picking the level whose points cover the
+//! most samples without dropping below the requested number of points, so
+//! peaks are never lost however far the view is zoomed out.
+//!
+//! Plotter::plot() uses this automatically for Buffers much longer than
+//! the plot's pixel width, keep a BufferPyramid to redraw a long signal
+//! at different zooms without rebuilding it.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! Buffer b("one_hour.wav");
+//! BufferPyramid pyramid(b);
+//!
+//! Plotter pylab;
+//! pylab.plot(pyramid, 0, b.getLength());
+//! pylab.plot(pyramid, 44100 * 60, 44100 * 61);
+//!
+//! // Python
+//! b = Buffer("one_hour.wav")
+//! pyramid = BufferPyramid(b)
+//! pylab = Plotter()
+//! pylab.plot(pyramid, 0, b.getLength())
+//! \endcode
+class BufferPyramid
+{
+    public:
+
+    //! Builds the pyramid.
+    //
+    //! \param x the samples, they are copied
+    //! \param factor the number of points of a level that make one point
+    //!        of the next level, at least 2
+    BufferPyramid(const Buffer & x, const uint32 factor = 4);
+
+    uint32 getFactor() const { return factor_; }
+
+    //! The number of samples in level 0.
+    uint32 getLength() const { return samples_.getLength(); }
+
+    uint32 getNLevels() const
+    { return static_cast<uint32>(min_.size()) + 1; }
+
+    //! The number of samples one point of the level covers.
+    uint64 getSamplesPerPoint(const uint32 level) const;
+
+    //! Returns the coarsest level with at least n_points points over
+    //! n_samples samples.
+    uint32 getLevel(const uint32 n_samples, const uint32 n_points) const;
+
+    //! Returns the envelope of the samples in [start, stop).
+    //
+    //! \param start the first sample
+    //! \param stop one past the last sample, clipped to getLength()
+    //! \param n_points the envelope has at least this many points, or one
+    //!        point per sample if the range is shorter
+    //! \param x returns the first sample index each point covers
+    //! \param min returns the smallest sample each point covers
+    //! \param max returns the largest sample each point covers
+    void
+    getEnvelope(
+        const uint32 start,
+        const uint32 stop,
+        const uint32 n_points,
+        Buffer & x,
+        Buffer & min,
+        Buffer & max) const;
+
+    //! Returns a line that alternates between the minimum and maximum of
+    //! each point of getEnvelope(), drawn it fills in the envelope.  Ranges
+    //! of n_points samples or less are returned as is.
+    void
+    getPlotData(
+        const uint32 start,
+        const uint32 stop,
+        const uint32 n_points,
+        Buffer & x,
+        Buffer & y) const;
+
+    private:
+
+    //! Adds the min and max of samples [start, stop) at level 0.
+    void
+    _addExact(
+        const uint32 start,
+        const uint32 stop,
+        Buffer & x,
+        Buffer & min,
+        Buffer & max) const;
+
+    uint32 factor_;
+
+    Buffer samples_;
+
+    // Levels 1 and up.
+    std::vector<FloatVector> min_;
+    std::vector<FloatVector> max_;
+
+}; // class BufferPyramid
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
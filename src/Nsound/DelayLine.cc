@@ -27,6 +27,8 @@
 //-----------------------------------------------------------------------------
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
@@ -37,19 +39,98 @@ namespace Nsound
 {
 
 
+// Number of samples delayed per pass with a constant delay.
+static const uint32 BLOCK_SIZE = 256;
+
+// Windowed sinc interpolator: taps and fractional phases in the table.
+static const uint32 SINC_TAPS = 16;
+static const uint32 SINC_HALF = SINC_TAPS / 2;
+static const uint32 SINC_PHASES = 256;
+
+
+// Row p holds the taps for a fractional delay of p / SINC_PHASES, the extra
+// last row lets every phase be interpolated with the next one.
+static
+const std::vector<float64> &
+sincTable()
+{
+    static const std::vector<float64> table = []
+    {
+        std::vector<float64> t((SINC_PHASES + 1) * SINC_TAPS);
+
+        for(uint32 p = 0; p <= SINC_PHASES; ++p)
+        {
+            float64 f = static_cast<float64>(p) / SINC_PHASES;
+            float64 * h = t.data() + p * SINC_TAPS;
+            float64 sum = 0.0;
+
+            for(uint32 k = 0; k < SINC_TAPS; ++k)
+            {
+                // Distance of the tap from the delay, in samples.
+                float64 x = static_cast<float64>(k) - (SINC_HALF - 1) - f;
+                float64 u = x / SINC_HALF;
+
+                float64 sinc = 1.0;
+
+                if(x != 0.0) sinc = std::sin(M_PI * x) / (M_PI * x);
+
+                // Exact zeros at whole samples keep integer delays exact.
+                if(x != 0.0 && x == std::floor(x)) sinc = 0.0;
+
+                float64 window = 0.42
+                               + 0.50 * std::cos(M_PI * u)
+                               + 0.08 * std::cos(2.0 * M_PI * u);
+
+                h[k] = sinc * window;
+                sum += h[k];
+            }
+
+            for(uint32 k = 0; k < SINC_TAPS; ++k) h[k] /= sum;
+        }
+
+        return t;
+    }();
+
+    return table;
+}
+
+
 DelayLine::
 DelayLine(float64 sample_rate, float64 max_delay_in_seconds)
     :
     sample_rate_(sample_rate),
     max_delay_time_(max_delay_in_seconds),
     delay_time_(max_delay_in_seconds),
-    buffer_(
-        static_cast<uint64>(sample_rate * max_delay_in_seconds + 1),
-        0.0),
-    wr_idx_(0)
+    buffer_(),
+    mask_(0),
+    wr_idx_(0),
+    is_realtime_(false),
+    interpolation_(NEAREST),
+    allpass_y_(0.0)
 {
     M_ASSERT_VALUE(sample_rate, >, 0.0);
     M_ASSERT_VALUE(max_delay_in_seconds, >, 0.0);
+
+    // Room for the longest delay, the interpolator taps and a block.
+    uint64 n = static_cast<uint64>(std::ceil(sample_rate * max_delay_in_seconds))
+             + 1 + SINC_TAPS + BLOCK_SIZE;
+
+    uint64 size = 1;
+
+    while(size < n) size <<= 1;
+
+    mask_ = static_cast<uint32>(size - 1);
+
+    buffer_.resize(2 * size, 0.0);
+}
+
+
+void
+DelayLine::
+setInterpolation(Interpolation type)
+{
+    interpolation_ = type;
+    allpass_y_ = 0.0;
 }
 
 
@@ -59,6 +140,15 @@ delay(const Buffer & x, const Buffer & delay_time)
 {
     if(!is_realtime_) reset();
 
+    if(delay_time.getLength() == 1)
+    {
+        Buffer y(x);
+
+        delay(y.getPointer(), y.getPointer(), y.getLength(), delay_time[0]);
+
+        return y;
+    }
+
     Buffer y;
 
     auto dt = delay_time.cbegin();
@@ -82,16 +172,179 @@ delay(float64 x, float64 delay_time)
 }
 
 
+void
+DelayLine::
+delay(
+    const float64 * x,
+    float64 * y,
+    const uint32 n_samples,
+    const float64 delay_time)
+{
+    M_ASSERT_MSG(delay_time > 0.0, "delay must be > 0.0, got " << delay_time);
+
+    delay_time_ = std::min(delay_time, max_delay_time_);
+
+    if(interpolation_ == ALLPASS)
+    {
+        for(uint32 i = 0; i < n_samples; ++i)
+        {
+            write(x[i]);
+            y[i] = readAllpass(delay_time_);
+        }
+
+        return;
+    }
+
+    float64 taps[SINC_TAPS];
+    uint32 first_age = 0;
+
+    const uint32 n_taps = makeTaps(delay_time_, taps, first_age);
+
+    for(uint32 n = 0; n < n_samples; n += BLOCK_SIZE)
+    {
+        const uint32 n_block = std::min(BLOCK_SIZE, n_samples - n);
+        const uint32 w0 = wr_idx_;
+
+        // Write the whole block first, the ring has room for it.
+        for(uint32 i = 0; i < n_block; ++i) write(x[n + i]);
+
+        float64 * out = y + n;
+
+        // Every tap reads a contiguous window thanks to the mirrored ring.
+        if(interpolation_ == NEAREST)
+        {
+            const float64 * src = buffer_.data() + ((w0 - first_age) & mask_);
+
+            std::memcpy(out, src, sizeof(float64) * n_block);
+
+            continue;
+        }
+
+        std::fill(out, out + n_block, 0.0);
+
+        for(uint32 k = 0; k < n_taps; ++k)
+        {
+            const float64 h = taps[k];
+            const float64 * src = buffer_.data()
+                                + ((w0 - first_age - k) & mask_);
+
+            for(uint32 i = 0; i < n_block; ++i) out[i] += h * src[i];
+        }
+    }
+}
+
+
 void
 DelayLine::
 reset()
 {
     wr_idx_ = 0;
     delay_time_ = max_delay_time_;
+    allpass_y_ = 0.0;
     std::fill(buffer_.begin(), buffer_.end(), 0.0);
 }
 
 
+uint32
+DelayLine::
+makeTaps(const float64 delay, float64 * taps, uint32 & first_age) const
+{
+    if(interpolation_ == NEAREST)
+    {
+        uint32 offset = static_cast<uint32>(sample_rate_ * delay + 0.5);
+
+        first_age = offset > 0 ? offset - 1 : 0;
+        taps[0] = 1.0;
+
+        return 1;
+    }
+
+    float64 age = sample_rate_ * delay - 1.0;
+
+    if(age < 0.0) age = 0.0;
+
+    uint32 i = static_cast<uint32>(age);
+    float64 f = age - static_cast<float64>(i);
+
+    if(interpolation_ == LINEAR)
+    {
+        first_age = i;
+        taps[0] = 1.0 - f;
+        taps[1] = f;
+
+        return 2;
+    }
+
+    if(interpolation_ == SINC && i >= SINC_HALF - 1)
+    {
+        const std::vector<float64> & table = sincTable();
+
+        float64 u = f * SINC_PHASES;
+        uint32 p = std::min(static_cast<uint32>(u), SINC_PHASES - 1);
+        float64 g = u - static_cast<float64>(p);
+
+        const float64 * h0 = table.data() + p * SINC_TAPS;
+        const float64 * h1 = h0 + SINC_TAPS;
+
+        for(uint32 k = 0; k < SINC_TAPS; ++k)
+        {
+            taps[k] = (1.0 - g) * h0[k] + g * h1[k];
+        }
+
+        first_age = i - (SINC_HALF - 1);
+
+        return SINC_TAPS;
+    }
+
+    // 3rd order Lagrange, centered on the delay when there's history before
+    // it, d is the delay relative to the first tap.
+    float64 d = f;
+
+    first_age = 0;
+
+    if(i >= 1)
+    {
+        first_age = i - 1;
+        d = f + 1.0;
+    }
+
+    taps[0] = -(d - 1.0) * (d - 2.0) * (d - 3.0) / 6.0;
+    taps[1] =  d * (d - 2.0) * (d - 3.0) / 2.0;
+    taps[2] = -d * (d - 1.0) * (d - 3.0) / 2.0;
+    taps[3] =  d * (d - 1.0) * (d - 2.0) / 6.0;
+
+    return 4;
+}
+
+
+float64
+DelayLine::
+readAllpass(const float64 delay)
+{
+    float64 age = sample_rate_ * delay - 1.0;
+
+    if(age < 0.0) age = 0.0;
+
+    // Keep the fractional part in [0.5, 1.5) where the allpass is best.
+    uint32 m = 0;
+
+    if(age >= 0.5) m = static_cast<uint32>(age - 0.5);
+
+    float64 frac = age - static_cast<float64>(m);
+
+    float64 eta = (1.0 - frac) / (1.0 + frac);
+
+    const uint32 last = wr_idx_ - 1;
+
+    float64 x0 = buffer_[(last - m) & mask_];
+    float64 x1 = buffer_[(last - m - 1) & mask_];
+
+    allpass_y_ = eta * x0 + x1 - eta * allpass_y_;
+
+    return allpass_y_;
+}
+
+
 float64
 DelayLine::
 read()
@@ -101,14 +354,25 @@ read()
         "delay time exceeds maximum ("
         << delay_time_ << " > " << max_delay_time_ << ")");
 
-    uint32 offset = static_cast<uint32>(sample_rate_ * delay_time_ + 0.5);
+    if(interpolation_ == ALLPASS) return readAllpass(delay_time_);
+
+    float64 taps[SINC_TAPS];
+    uint32 first_age = 0;
 
-    if(offset > wr_idx_)
+    const uint32 n_taps = makeTaps(delay_time_, taps, first_age);
+
+    const uint32 last = wr_idx_ - 1 - first_age;
+
+    if(interpolation_ == NEAREST) return buffer_[last & mask_];
+
+    float64 y = 0.0;
+
+    for(uint32 k = 0; k < n_taps; ++k)
     {
-        return buffer_[buffer_.size() - (offset - wr_idx_)];
+        y += taps[k] * buffer_[(last - k) & mask_];
     }
 
-    return buffer_[wr_idx_ - offset];
+    return y;
 }
 
 
@@ -132,12 +396,10 @@ void
 DelayLine::
 write(float64 x)
 {
-    buffer_[wr_idx_++] = x;
+    buffer_[wr_idx_] = x;
+    buffer_[wr_idx_ + mask_ + 1] = x;
 
-    if(wr_idx_ >= buffer_.size())
-    {
-        wr_idx_ = 0;
-    }
+    wr_idx_ = (wr_idx_ + 1) & mask_;
 }
 
 
@@ -45,19 +45,58 @@ class AudioStream;
 class Buffer;
 
 
+//-----------------------------------------------------------------------------
+//! A circular delay line with optional fractional delay interpolation.
+//
+//! The ring buffer is a power of 2 long and stored twice, back to back, so
+//! indexing is a mask and any window of past samples is contiguous in
+//! memory.  Reading with a constant delay over a Buffer is done a block at a
+//! time as a short FIR over those windows.
+//!
+//! A delay of d seconds reads the sample written round(d * sample_rate) - 1
+//! writes ago with NEAREST interpolation (the default), the other
+//! interpolations read d * sample_rate - 1 writes ago.
 class DelayLine
 {
 
 public:
 
+    enum Interpolation
+    {
+        NEAREST,   //!< Nearest sample, no interpolation
+        LINEAR,    //!< 2 point linear
+        LAGRANGE,  //!< 4 point, 3rd order Lagrange
+        ALLPASS,   //!< 1st order Thiran allpass, keeps state between reads
+        SINC       //!< 16 point Blackman windowed sinc
+    };
+
     DelayLine(float64 sample_rate, float64 max_delay_in_seconds);
 
     void setRealtime(bool flag) {is_realtime_ = flag;}
 
+    //! Selects how fractional delays are read.
+    //
+    //! ALLPASS is recursive, it should be read exactly once per write.  SINC
+    //! needs 7 samples of history past the delay, shorter delays are read
+    //! with LAGRANGE.
+    void setInterpolation(Interpolation type);
+
+    Interpolation getInterpolation() const { return interpolation_; }
+
     Buffer delay(const Buffer & x, const Buffer & delay_time);
 
     float64 delay(float64 x, float64 delay_time);
 
+    #ifndef SWIG
+    //! Delays n_samples of x by the constant delay_time into y.
+    void
+    delay(
+        const float64 * x,
+        float64 * y,
+        const uint32 n_samples,
+        const float64 delay_time);
+    #endif
+
     float64 read();
     float64 read(float64 delay);
 
@@ -67,16 +106,34 @@ public:
 
 protected:
 
+    //! Computes the FIR taps that read the given delay.
+    //
+    //! The taps weight the samples written first_age, first_age + 1, ...
+    //! writes before the last write.  Returns the number of taps.
+    uint32
+    makeTaps(const float64 delay, float64 * taps, uint32 & first_age) const;
+
+    //! Reads the delay with the allpass interpolator, updating its state.
+    float64
+    readAllpass(const float64 delay);
+
     float64 sample_rate_;
     float64 max_delay_time_;
     float64 delay_time_;
 
+    // 2 * (mask_ + 1) samples, every write goes to both halves.
     std::vector<float64> buffer_;
 
+    uint32 mask_;
     uint32 wr_idx_;
 
     bool is_realtime_;
 
+    Interpolation interpolation_;
+
+    // The allpass interpolator's last output.
+    float64 allpass_y_;
+
 private:
 
     DelayLine(const DelayLine & copy);
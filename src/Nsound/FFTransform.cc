@@ -31,7 +31,9 @@
 #include <Nsound/FFTransform.h>
 #include <Nsound/Generator.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
 
+#include <algorithm>
 #include <cmath>
 
 using namespace Nsound;
@@ -74,6 +76,8 @@ FFTChunkVector
 FFTransform::
 fft(const Buffer & input, int32 n_order, int32 n_overlap) const
 {
+    M_PROFILE_SAMPLES("FFTransform::fft", input.getLength());
+
     const int32 N = roundUp2(n_order);
 
     const int32 input_length = input.getLength();
@@ -129,6 +133,15 @@ void
 FFTransform::
 fft(Buffer & real, Buffer & img, const int32 N) const
 {
+    radix2(real.getPointer(), img.getPointer(), N);
+}
+
+void
+FFTransform::
+radix2(float64 * real, float64 * img, const int32 N)
+{
+    M_PROFILE_SAMPLES("FFTransform::radix2", N);
+
     const float64 pi = M_PI;
     const int32 n_minus_1 = N - 1;
     const int32 n_devide_2 = N / 2;
@@ -202,10 +215,126 @@ fft(Buffer & real, Buffer & img, const int32 N) const
     }
 }
 
+FFTransform::Plan::
+Plan(const int32 n)
+    :
+    N(n),
+    swaps(),
+    cosine(),
+    sine()
+{
+    if(N == 0) return;
+
+    M_ASSERT_MSG(roundUp2(N) == N, "N must be a power of 2 (" << N << ")");
+
+    // Same bit reversal sort as radix2().
+    int32 j = N / 2;
+
+    for(int32 i = 1; i <= N - 2; ++i)
+    {
+        if(i < j)
+        {
+            swaps.push_back(i);
+            swaps.push_back(j);
+        }
+
+        int32 k = N / 2;
+
+        while(k <= j)
+        {
+            j -= k;
+            k /= 2;
+        }
+        j += k;
+    }
+
+    // Stage by stage, so the butterflies read the twiddles contiguously.
+    for(int32 le = 2; le <= N; le *= 2)
+    {
+        for(int32 k = 0; k < le / 2; ++k)
+        {
+            float64 phase = 2.0 * M_PI * k / le;
+
+            cosine.push_back(std::cos(phase));
+            sine.push_back(-std::sin(phase));
+        }
+    }
+}
+
+void
+FFTransform::
+radix2(const Plan & plan, float64 * real, float64 * img)
+{
+    const int32 N = plan.N;
+
+    M_PROFILE_SAMPLES("FFTransform::radix2", N);
+
+    const int32 * swaps = plan.swaps.data();
+    const int32 n_swaps = static_cast<int32>(plan.swaps.size());
+
+    for(int32 s = 0; s < n_swaps; s += 2)
+    {
+        std::swap(real[swaps[s]], real[swaps[s + 1]]);
+        std::swap(img[swaps[s]], img[swaps[s + 1]]);
+    }
+
+    // The first stage only adds and subtracts.
+    for(int32 i = 0; i + 1 < N; i += 2)
+    {
+        float64 temp_real = real[i + 1];
+        float64 temp_img  = img[i + 1];
+
+        real[i + 1] = real[i] - temp_real;
+        img[i + 1]  = img[i]  - temp_img;
+
+        real[i] += temp_real;
+        img[i]  += temp_img;
+    }
+
+    const float64 * cosine = plan.cosine.data();
+    const float64 * sine = plan.sine.data();
+
+    // Loop for each fft stage.
+    for(int32 le = 4; le <= N; le *= 2)
+    {
+        const int32 le2 = le / 2;
+
+        // This stage's twiddles.
+        cosine += le2 / 2;
+        sine += le2 / 2;
+
+        // Loop for each sub DFT, then for each butterfly.
+        for(int32 i = 0; i < N; i += le)
+        {
+            float64 * r0 = real + i;
+            float64 * i0 = img + i;
+            float64 * r1 = r0 + le2;
+            float64 * i1 = i0 + le2;
+
+            for(int32 j = 0; j < le2; ++j)
+            {
+                const float64 ur = cosine[j];
+                const float64 ui = sine[j];
+
+                float64 temp_real = ur * r1[j] - ui * i1[j];
+                float64 temp_img  = ui * r1[j] + ur * i1[j];
+
+                r1[j] = r0[j] - temp_real;
+                i1[j] = i0[j] - temp_img;
+
+                r0[j] += temp_real;
+                i0[j] += temp_img;
+            }
+        }
+    }
+}
+
 Buffer
 FFTransform::
 ifft(const FFTChunkVector & vec) const
 {
+    M_PROFILE("FFTransform::ifft");
+
     Buffer output;
 
     FFTChunkVector::const_iterator itor = vec.begin();
@@ -37,6 +37,8 @@
 #include <Nsound/FFTChunk.h>
 #include <Nsound/WindowType.h>
 
+#include <vector>
+
 namespace Nsound
 {
 
@@ -205,6 +207,44 @@ class FFTransform
     Buffer
     ifft(const Buffer & frequency_domain) const;
 
+    #ifndef SWIG
+    //! Performs the FFT in place on N complex samples, N must be a power of 2.
+    //
+    //! This is the transform behind fft() and ifft(), without the windowing
+    //! or any allocation.  The inverse is obtained by negating imag before
+    //! and after the call and dividing by N.
+    static
+    void
+    radix2(float64 * real, float64 * imag, const int32 N);
+
+    //! The bit reversal and twiddle tables for radix2() of one size.
+    //
+    //! Building the tables costs about as much as one transform, keep the
+    //! Plan around when transforming many frames of the same size.
+    struct Plan
+    {
+        Plan(const int32 N = 0);
+
+        int32 N;
+
+        //! Pairs of indices swapped by the bit reversal sort.
+        std::vector<int32> swaps;
+
+        //! The twiddle factors of each stage, cos(2 pi k / L) and
+        //! -sin(2 pi k / L) for k < L / 2, stored from L = 2 up to L = N.
+        std::vector<float64> cosine;
+        std::vector<float64> sine;
+    };
+
+    //! Performs the FFT in place on plan.N complex samples.
+    //
+    //! Same as radix2(real, imag, N), but the tables are precomputed and
+    //! the butterflies of a stage run over contiguous samples.
+    static
+    void
+    radix2(const Plan & plan, float64 * real, float64 * imag);
+    #endif
+
     //! Returns nearest power of 2 >= raw.
     static
     int32
@@ -31,12 +31,105 @@
 #include <Nsound/FFTransform.h>
 #include <Nsound/Filter.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/ThreadPool.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 using namespace Nsound;
 
+// Evaluates p(z) = c0 + sign * (c[1] z^-1 + ... + c[n_c - 1] z^-(n_c - 1))
+// with Horner's rule.  The coefficient loop is outermost so the inner loop
+// runs across frequencies and vectorizes.
+static
+void
+horner(
+    const float64 * c,
+    const uint32 n_c,
+    const float64 c0,
+    const float64 sign,
+    const uint32 n,
+    const float64 * zr,
+    const float64 * zi,
+    float64 * pr,
+    float64 * pi)
+{
+    if(n_c <= 1)
+    {
+        for(uint32 i = 0; i < n; ++i)
+        {
+            pr[i] = c0;
+            pi[i] = 0.0;
+        }
+
+        return;
+    }
+
+    const float64 c_last = sign * c[n_c - 1];
+
+    for(uint32 i = 0; i < n; ++i)
+    {
+        pr[i] = c_last;
+        pi[i] = 0.0;
+    }
+
+    for(uint32 k = n_c - 1; k-- > 0;)
+    {
+        const float64 ck = (k == 0) ? c0 : sign * c[k];
+
+        for(uint32 i = 0; i < n; ++i)
+        {
+            float64 r  = pr[i] * zr[i] - pi[i] * zi[i] + ck;
+            float64 im = pr[i] * zi[i] + pi[i] * zr[i];
+
+            pr[i] = r;
+            pi[i] = im;
+        }
+    }
+}
+
+bool
+Filter::
+filterChannels(
+    const AudioStream & x,
+    AudioStream & y,
+    const std::function<Buffer (Filter &, const Buffer &)> & function)
+{
+    ThreadPool & pool = ThreadPool::getInstance();
+
+    uint32 n_channels = x.getNChannels();
+
+    if(pool.getNThreads() == 1 || n_channels < 2) return false;
+
+    std::vector<std::unique_ptr<Filter> > copies;
+
+    for(uint32 channel = 0; channel + 1 < n_channels; ++channel)
+    {
+        Filter * copy = clone();
+
+        if(copy == NULL) return false;
+
+        copy->setControlPeriod(getControlPeriod());
+
+        copies.push_back(std::unique_ptr<Filter>(copy));
+    }
+
+    pool.run(
+        n_channels,
+        [&](uint32 channel)
+        {
+            Filter & f = channel < copies.size() ? *copies[channel] : *this;
+
+            y[channel] = function(f, x[channel]);
+        });
+
+    return true;
+}
+
 Filter::
 Filter(const float64 & sample_rate)
     :
@@ -44,10 +137,30 @@ Filter(const float64 & sample_rate)
     two_pi_over_sample_rate_(2.0 * M_PI / sample_rate),
     sample_time_(1.0 / sample_rate),
     kernel_size_(0),
+    control_period_(1),
     is_realtime_(false)
 {
 }
 
+void
+Filter::
+setControlPeriod(const uint32 n_samples)
+{
+    M_ASSERT_VALUE(n_samples, >, 0);
+
+    control_period_ = n_samples;
+}
+
+bool
+Filter::
+interpolateKernel(
+    const float64 & f_begin,
+    const float64 & f_end,
+    const float64 & t)
+{
+    return false;
+}
+
 AudioStream
 Filter::
 filter(const AudioStream & x)
@@ -63,6 +176,10 @@ filter(const AudioStream & x)
 
     AudioStream y(x.getSampleRate(), n_channels);
 
+    auto function = [](Filter & f, const Buffer & b) { return f.filter(b); };
+
+    if(filterChannels(x, y, function)) return y;
+
     for(uint32 channel = 0; channel < n_channels; ++channel)
     {
         y[channel] = filter(x[channel]);
@@ -86,6 +203,13 @@ filter(const AudioStream & x, const float64 & frequency)
 
     AudioStream y(x.getSampleRate(), n_channels);
 
+    auto function = [&](Filter & f, const Buffer & b)
+    {
+        return f.filter(b, frequency);
+    };
+
+    if(filterChannels(x, y, function)) return y;
+
     for(uint32 channel = 0; channel < n_channels; ++channel)
     {
         y[channel] = filter(x[channel], frequency);
@@ -109,6 +233,13 @@ filter(const AudioStream & x, const Buffer & frequency)
 
     AudioStream y(x.getSampleRate(), n_channels);
 
+    auto function = [&](Filter & f, const Buffer & b)
+    {
+        return f.filter(b, frequency);
+    };
+
+    if(filterChannels(x, y, function)) return y;
+
     for(uint32 channel = 0; channel < n_channels; ++channel)
     {
         y[channel] = filter(x[channel], frequency);
@@ -121,6 +252,8 @@ Buffer
 Filter::
 filter(const Buffer & x)
 {
+    M_PROFILE_SAMPLES("Filter::filter", x.getLength());
+
     if(!is_realtime_) reset();
 
     Buffer y(x.getLength());
@@ -139,6 +272,8 @@ Buffer
 Filter::
 filter(const Buffer & x, const float64 & frequency)
 {
+    M_PROFILE_SAMPLES("Filter::filter", x.getLength());
+
     if(!is_realtime_) reset();
 
     Buffer::const_iterator itor = x.begin();
@@ -160,8 +295,56 @@ Buffer
 Filter::
 filter(const Buffer & x, const Buffer & frequencies)
 {
+    M_PROFILE_SAMPLES("Filter::filter", x.getLength());
+
     if(!is_realtime_) reset();
 
+    if(control_period_ > 1)
+    {
+        uint32 n = x.getLength();
+        uint32 n_freqs = frequencies.getLength();
+
+        M_ASSERT_VALUE(n_freqs, >, 0);
+
+        Buffer y(n);
+
+        for(uint32 i = 0; i < n; i += control_period_)
+        {
+            uint32 n_block = std::min(control_period_, n - i);
+
+            // The last control point is clamped to the last sample.
+            uint32 i_end = std::min(i + control_period_, n - 1);
+
+            float64 dt = 1.0 / static_cast<float64>(std::max(i_end - i, 1u));
+
+            // Frequencies wrap around like the circular iterator below.
+            float64 f_begin = frequencies[i % n_freqs];
+            float64 f_end = frequencies[i_end % n_freqs];
+
+            if(interpolateKernel(f_begin, f_end, 0.0))
+            {
+                y << filter(x[i]);
+
+                for(uint32 j = 1; j < n_block; ++j)
+                {
+                    interpolateKernel(f_begin, f_end, dt * j);
+                    y << filter(x[i + j]);
+                }
+            }
+            else
+            {
+                y << filter(x[i], f_begin);
+
+                for(uint32 j = 1; j < n_block; ++j)
+                {
+                    y << filter(x[i + j]);
+                }
+            }
+        }
+
+        return y;
+    }
+
     Buffer::const_circular_iterator freq = frequencies.cbegin();
 
     Buffer::const_iterator itor = x.begin();
@@ -205,6 +388,152 @@ getFrequencyAxis(const uint32 n_fft)
     return f_axis;
 };
 
+Buffer
+Filter::
+getFrequencyAxisLog(
+    const float64 & f_min,
+    const float64 & f_max,
+    const uint32 n_points)
+{
+    M_ASSERT_VALUE(f_min, >, 0.0);
+    M_ASSERT_VALUE(f_max, >, f_min);
+    M_ASSERT_VALUE(n_points, >, 1);
+
+    Buffer f_axis(n_points);
+
+    float64 log_min = std::log(f_min);
+    float64 log_step = (std::log(f_max) - log_min) / (n_points - 1);
+
+    for(uint32 i = 0; i < n_points; ++i)
+    {
+        f_axis << std::exp(log_min + log_step * i);
+    }
+
+    return f_axis;
+}
+
+Buffer
+Filter::
+getFrequencyResponse(const Buffer & frequencies)
+{
+    Buffer real;
+    Buffer imag;
+
+    getResponse(frequencies, real, imag);
+
+    uint32 n = frequencies.getLength();
+
+    Buffer y(n);
+
+    for(uint32 i = 0; i < n; ++i)
+    {
+        y << std::sqrt(real[i] * real[i] + imag[i] * imag[i]);
+    }
+
+    return y;
+}
+
+void
+Filter::
+getResponse(const Buffer & frequencies, Buffer & real, Buffer & imag)
+{
+    M_PROFILE_SAMPLES("Filter::getResponse", frequencies.getLength());
+
+    uint32 n = frequencies.getLength();
+
+    real = Buffer::ones(n);
+    imag = Buffer::zeros(n);
+
+    if(n == 0 || evaluateResponse(frequencies, real, imag)) return;
+
+    // No closed form, treat the impulse response as an FIR.
+    Buffer h = Filter::getImpulseResponse();
+
+    multiplyResponse(
+        frequencies,
+        h.getPointer(),
+        h.getLength(),
+        NULL,
+        0,
+        real,
+        imag);
+}
+
+bool
+Filter::
+evaluateResponse(const Buffer & frequencies, Buffer & real, Buffer & imag)
+{
+    return false;
+}
+
+void
+Filter::
+multiplyResponse(
+    const Buffer & frequencies,
+    const float64 * b,
+    const uint32 n_b,
+    const float64 * a,
+    const uint32 n_a,
+    Buffer & real,
+    Buffer & imag) const
+{
+    uint32 n = frequencies.getLength();
+
+    M_ASSERT_VALUE(real.getLength(), ==, n);
+    M_ASSERT_VALUE(imag.getLength(), ==, n);
+
+    if(n == 0) return;
+
+    std::vector<float64> zr(n);
+    std::vector<float64> zi(n);
+    std::vector<float64> br(n);
+    std::vector<float64> bi(n);
+
+    // z^-1 = e^-jw
+    for(uint32 i = 0; i < n; ++i)
+    {
+        float64 w = two_pi_over_sample_rate_ * frequencies[i];
+
+        zr[i] =  std::cos(w);
+        zi[i] = -std::sin(w);
+    }
+
+    float64 b0 = (n_b > 0) ? b[0] : 0.0;
+
+    horner(b, n_b, b0, 1.0, n, zr.data(), zi.data(), br.data(), bi.data());
+
+    if(a != NULL)
+    {
+        // B(z) / A(z) is formed in place in br & bi.
+        std::vector<float64> ar(n);
+        std::vector<float64> ai(n);
+
+        horner(a, n_a, 1.0, -1.0, n, zr.data(), zi.data(), ar.data(), ai.data());
+
+        for(uint32 i = 0; i < n; ++i)
+        {
+            float64 mag2 = ar[i] * ar[i] + ai[i] * ai[i];
+            float64 r    = (br[i] * ar[i] + bi[i] * ai[i]) / mag2;
+            float64 im   = (bi[i] * ar[i] - br[i] * ai[i]) / mag2;
+
+            br[i] = r;
+            bi[i] = im;
+        }
+    }
+
+    float64 * y_r = real.getPointer();
+    float64 * y_i = imag.getPointer();
+
+    for(uint32 i = 0; i < n; ++i)
+    {
+        float64 r  = y_r[i] * br[i] - y_i[i] * bi[i];
+        float64 im = y_r[i] * bi[i] + y_i[i] * br[i];
+
+        y_r[i] = r;
+        y_i[i] = im;
+    }
+}
+
 Buffer
 Filter::
 getFrequencyResponse(const uint32 n_fft)
@@ -257,6 +586,27 @@ getPhaseResponse()
     return phase.subbuffer(0, phase.getLength() / 2 + 1);
 }
 
+Buffer
+Filter::
+getPhaseResponse(const Buffer & frequencies)
+{
+    Buffer real;
+    Buffer imag;
+
+    getResponse(frequencies, real, imag);
+
+    uint32 n = frequencies.getLength();
+
+    Buffer y(n);
+
+    for(uint32 i = 0; i < n; ++i)
+    {
+        y << std::atan2(imag[i], real[i]);
+    }
+
+    return y;
+}
+
 void
 Filter::
 plot(boolean show_phase)
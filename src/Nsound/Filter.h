@@ -36,6 +36,7 @@
 
 #include <Nsound/Nsound.h>
 
+#include <functional>
 #include <string>
 
 namespace Nsound
@@ -56,6 +57,30 @@ class Filter
 
     void setRealtime(bool flag) {is_realtime_ = flag;}
 
+    //! Returns a new copy of this filter, or NULL if it can't be copied.
+    //
+    //! filter(AudioStream) filters each channel with its own copy on the
+    //! shared ThreadPool when the pool has more than one thread, filters
+    //! that return NULL filter the channels one after another.
+    virtual
+    Filter *
+    clone() const { return NULL; }
+
+    //! Returns the number of samples between coefficient updates.
+    uint32 getControlPeriod() const { return control_period_; }
+
+    //! Sets the number of samples between coefficient updates.
+    //
+    //! By default filter(x, frequencies) recomputes the filter coefficients
+    //! for every sample.  With n_samples > 1 the frequencies are only read
+    //! every n_samples, filters that can interpolate their coefficients
+    //! (FilterStageIIR) ramp them linearly between these control points, all
+    //! others hold them.  Slow sweeps (LFOs, envelopes) lose very little
+    //! accuracy but run much faster.
+    virtual
+    void
+    setControlPeriod(const uint32 n_samples);
+
     AudioStream
     filter(const AudioStream & x);
 
@@ -85,9 +110,28 @@ class Filter
     Buffer
     getFrequencyAxis(const uint32 n_fft = 8192);
 
+    //! Returns n_points frequencies in Hz, logarithmically spaced from f_min to f_max.
+    Buffer
+    getFrequencyAxisLog(
+        const float64 & f_min,
+        const float64 & f_max,
+        const uint32 n_points = 512);
+
     Buffer
     getFrequencyResponse(const uint32 n_fft = 8192);
 
+    //! Returns the magnitude of H(e^jw) evaluated at each frequency in Hz.
+    //
+    //! Filters that expose their coefficients evaluate the transfer function
+    //! in closed form, without touching the filter state.  Other filters
+    //! fall back to evaluating the DTFT of their impulse response.
+    Buffer
+    getFrequencyResponse(const Buffer & frequencies);
+
+    //! Evaluates H(e^jw) at each frequency in Hz, see getFrequencyResponse().
+    void
+    getResponse(const Buffer & frequencies, Buffer & real, Buffer & imag);
+
     Buffer
     getImpulseResponse(const uint32 n_samples = 8192);
 
@@ -98,6 +142,10 @@ class Filter
     Buffer
     getPhaseResponse();
 
+    //! Returns the phase of H(e^jw) in radians at each frequency in Hz.
+    Buffer
+    getPhaseResponse(const Buffer & frequencies);
+
     float64
     getSampleRate() const { return sample_rate_; };
 
@@ -110,10 +158,62 @@ class Filter
 
     protected:
 
+    //! Filters the channels of x into y on the shared ThreadPool.
+    //
+    //! Every channel but the last gets its own clone() so no state is
+    //! shared, the last channel is filtered by this filter.  Like the serial
+    //! loop, this filter is left in the state after the last channel.
+    //! Returns false, leaving y alone, when the pool has one thread, x has
+    //! one channel or clone() returns NULL.
+    bool
+    filterChannels(
+        const AudioStream & x,
+        AudioStream & y,
+        const std::function<Buffer (Filter &, const Buffer &)> & function);
+
+    //! Multiplies this filter's H(e^jw) into real & imag.
+    //
+    //! Returns false if the filter can't evaluate its transfer function from
+    //! coefficients, in which case real & imag must be left untouched.
+    virtual
+    bool
+    evaluateResponse(
+        const Buffer & frequencies,
+        Buffer & real,
+        Buffer & imag);
+
+    //! Control rate hook, makes the kernel at t in [0, 1] from f_begin to f_end.
+    //
+    //! Returns false if the filter can't interpolate its coefficients, the
+    //! control rate loop then holds f_begin for the whole control period.
+    virtual
+    bool
+    interpolateKernel(
+        const float64 & f_begin,
+        const float64 & f_end,
+        const float64 & t);
+
+    //! Multiplies B(z) / A(z) into real & imag, z = e^jw.
+    //
+    //! The numerator is b[0] + b[1] z^-1 + ... + b[n_b - 1] z^-(n_b - 1).
+    //! The denominator follows the feedback convention used by the IIR
+    //! filters here, y[n] += a[k] * y[n - k], so A(z) = 1 - sum(a[k] z^-k)
+    //! for k >= 1 and a[0] is ignored.  Pass a = NULL for an FIR.
+    void
+    multiplyResponse(
+        const Buffer & frequencies,
+        const float64 * b,
+        const uint32 n_b,
+        const float64 * a,
+        const uint32 n_a,
+        Buffer & real,
+        Buffer & imag) const;
+
     float64 sample_rate_;
     float64 two_pi_over_sample_rate_;
     float64 sample_time_; // 1.0 / sample_rate_
     uint32 kernel_size_;
+    uint32 control_period_;
 
     bool is_realtime_;
 
@@ -55,6 +55,8 @@ class FilterAllPass : public Filter
 
     FilterAllPass(const FilterAllPass & copy);
 
+    Filter * clone() const { return new FilterAllPass(*this); }
+
     virtual
     ~FilterAllPass();
 
@@ -114,6 +114,10 @@ class FilterBandPassFIR : public Filter
         const float64 & frequency_Hz_high);
 
 
+    //! Sets the control period of both stages.
+    void
+    setControlPeriod(const uint32 n_samples);
+
     void
     plot(boolean show_fc = true, boolean show_phase = false);
 
@@ -124,6 +128,12 @@ class FilterBandPassFIR : public Filter
 
     protected:
 
+    bool
+    evaluateResponse(
+        const Buffer & frequencies,
+        Buffer & real,
+        Buffer & imag);
+
     // Band Pass must cascade two stages in series.
     FilterLowPassFIR  * low_;
     FilterHighPassFIR * high_;
@@ -71,7 +71,9 @@ FilterBandPassIIR(
 
     kernel_size_ = low_->getKernelSize() * 2;
 
-    Buffer response = Filter::getFrequencyResponse();
+    // The stage kernels come from the shared cache, evaluating the response
+    // from them is much cheaper than filtering an impulse.
+    Buffer response = Filter::getFrequencyResponse(Filter::getFrequencyAxis());
 
     gain_ = 1.0 / response.getMax();
 }
@@ -234,6 +236,56 @@ plot(boolean show_fc, boolean show_phase)
     }
 }
 
+bool
+FilterBandPassIIR::
+evaluateResponse(const Buffer & frequencies, Buffer & real, Buffer & imag)
+{
+    // The stages are in series, H = gain * H_low * H_high.
+    Buffer low_r, low_i;
+    Buffer high_r, high_i;
+
+    low_->getResponse(frequencies, low_r, low_i);
+    high_->getResponse(frequencies, high_r, high_i);
+
+    for(uint32 i = 0; i < frequencies.getLength(); ++i)
+    {
+        float64 hr = gain_ * (low_r[i] * high_r[i] - low_i[i] * high_i[i]);
+        float64 hi = gain_ * (low_r[i] * high_i[i] + low_i[i] * high_r[i]);
+
+        float64 r = real[i] * hr - imag[i] * hi;
+
+        imag[i] = real[i] * hi + imag[i] * hr;
+        real[i] = r;
+    }
+
+    return true;
+}
+
+void
+FilterBandPassIIR::
+setFrequencyResolution(const float64 & resolution_Hz)
+{
+    low_->setFrequencyResolution(resolution_Hz);
+    high_->setFrequencyResolution(resolution_Hz);
+}
+
+void
+FilterBandPassIIR::
+setInterpolation(bool flag)
+{
+    low_->setInterpolation(flag);
+    high_->setInterpolation(flag);
+}
+
+void
+FilterBandPassIIR::
+setControlPeriod(const uint32 n_samples)
+{
+    Filter::setControlPeriod(n_samples);
+    low_->setControlPeriod(n_samples);
+    high_->setControlPeriod(n_samples);
+}
+
 void
 FilterBandPassIIR::
 reset()
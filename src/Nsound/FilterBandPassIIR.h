@@ -122,9 +122,21 @@ class FilterBandPassIIR : public Filter
         const float64 & frequency_Hz_low,
         const float64 & frequency_Hz_high);
 
+    //! Sets the control period of both stages.
+    void
+    setControlPeriod(const uint32 n_samples);
+
     void
     plot(boolean show_fc = true, boolean show_phase = false);
 
+    //! Sets the kernel cache resolution of both stages, see FilterStageIIR.
+    void
+    setFrequencyResolution(const float64 & resolution_Hz);
+
+    //! Enables kernel interpolation in both stages, see FilterStageIIR.
+    void
+    setInterpolation(bool flag);
+
     //! Resets interal history buffer and sets the cut off frequency to the one
     //! used at declaration.
     void
@@ -132,6 +144,14 @@ class FilterBandPassIIR : public Filter
 
     protected:
 
+    friend class FilterBank;
+
+    bool
+    evaluateResponse(
+        const Buffer & frequencies,
+        Buffer & real,
+        Buffer & imag);
+
     FilterLowPassIIR  * low_;
     FilterHighPassIIR * high_;
     float64 gain_;
@@ -132,11 +132,19 @@ filter(
     Buffer::const_circular_iterator low  = frequencies_Hz_low.cbegin();
     Buffer::const_circular_iterator high = frequencies_Hz_high.cbegin();
 
-    Buffer y;
+    Buffer y(x.getLength());
 
     for(uint32 i = 0; i < x.getLength(); ++i, ++low, ++high)
     {
-        y << FilterBandPassVocoder::filter(x[i], *low, *high);
+        // Only update the kernel once per control period.
+        if(i % control_period_ == 0)
+        {
+            y << FilterBandPassVocoder::filter(x[i], *low, *high);
+        }
+        else
+        {
+            y << FilterBandPassVocoder::filter(x[i]);
+        }
     }
 
     return y;
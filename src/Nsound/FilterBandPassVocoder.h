@@ -109,6 +109,8 @@ class FilterBandPassVocoder : public Filter
 
     protected:
 
+    friend class FilterBank;
+
     void
     makeKernel(const float64 & f_low, const float64 & f_high);
 
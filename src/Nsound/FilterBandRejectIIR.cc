@@ -259,6 +259,40 @@ plot(boolean show_fc, boolean show_phase)
     }
 }
 
+bool
+FilterBandRejectIIR::
+evaluateResponse(const Buffer & frequencies, Buffer & real, Buffer & imag)
+{
+    // The stages are in parallel, H = H_low + H_high.
+    Buffer low_r, low_i;
+    Buffer high_r, high_i;
+
+    low_->getResponse(frequencies, low_r, low_i);
+    high_->getResponse(frequencies, high_r, high_i);
+
+    for(uint32 i = 0; i < frequencies.getLength(); ++i)
+    {
+        float64 hr = low_r[i] + high_r[i];
+        float64 hi = low_i[i] + high_i[i];
+
+        float64 r = real[i] * hr - imag[i] * hi;
+
+        imag[i] = real[i] * hi + imag[i] * hr;
+        real[i] = r;
+    }
+
+    return true;
+}
+
+void
+FilterBandRejectIIR::
+setControlPeriod(const uint32 n_samples)
+{
+    Filter::setControlPeriod(n_samples);
+    low_->setControlPeriod(n_samples);
+    high_->setControlPeriod(n_samples);
+}
+
 void
 FilterBandRejectIIR::
 reset()
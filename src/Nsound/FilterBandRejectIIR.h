@@ -122,6 +122,10 @@ class FilterBandRejectIIR : public Filter
         const float64 & frequency_Hz_low,
         const float64 & frequency_Hz_high);
 
+    //! Sets the control period of both stages.
+    void
+    setControlPeriod(const uint32 n_samples);
+
     void
     plot(boolean show_fc = true, boolean show_phase = false);
 
@@ -132,6 +136,12 @@ class FilterBandRejectIIR : public Filter
 
     protected:
 
+    bool
+    evaluateResponse(
+        const Buffer & frequencies,
+        Buffer & real,
+        Buffer & imag);
+
     FilterLowPassIIR  * low_;
     FilterHighPassIIR * high_;
 
@@ -0,0 +1,356 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: FilterBank.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterBandPassIIR.h>
+#include <Nsound/FilterBandPassVocoder.h>
+#include <Nsound/FilterBank.h>
+#include <Nsound/FilterHighPassIIR.h>
+#include <Nsound/FilterLowPassIIR.h>
+#include <Nsound/Profiler.h>
+
+#include <algorithm>
+
+using namespace Nsound;
+
+// Number of samples filtered per pass when filtering a Buffer.
+static const uint32 BLOCK_SIZE = 256;
+
+// IIR bands are filtered in groups of this many, the inner loops have a
+// fixed trip count so the compiler keeps a group in vector registers.
+static const uint32 LANES = 4;
+
+// Appends a column to the n_rows x n_bands row major matrix stored with
+// n_padded columns, the result is stored with n_padded_out columns.
+static
+void
+appendColumn(
+    std::vector<float64> & m,
+    const uint32 n_rows,
+    const uint32 n_bands,
+    const uint32 n_padded,
+    const uint32 n_padded_out,
+    const float64 * column)
+{
+    std::vector<float64> out(n_rows * n_padded_out, 0.0);
+
+    for(uint32 r = 0; r < n_rows; ++r)
+    {
+        std::copy(
+            m.begin() + r * n_padded,
+            m.begin() + r * n_padded + n_bands,
+            out.begin() + r * n_padded_out);
+
+        out[r * n_padded_out + n_bands] = column[r];
+    }
+
+    m.swap(out);
+}
+
+//-----------------------------------------------------------------------------
+FilterBank::
+FilterBank(const float64 & sample_rate)
+    :
+    sample_rate_(sample_rate),
+    kind_(NONE),
+    n_bands_(0),
+    n_stages_(0),
+    order_(0),
+    n_padded_(0),
+    index_(0),
+    rows_(),
+    a_(),
+    b_(),
+    x_history_(),
+    y_history_(),
+    gain_(),
+    omega2_(),
+    f_(),
+    att_(),
+    low1_(),
+    mid1_(),
+    low2_(),
+    mid2_()
+{
+    M_ASSERT_VALUE(sample_rate_, >, 0.0);
+}
+
+void
+FilterBank::
+addBand(const FilterBandPassIIR & band)
+{
+    M_ASSERT_MSG(
+        kind_ != VOCODER,
+        "Can't mix FilterBandPassIIR and FilterBandPassVocoder bands");
+
+    // FilterBandPassIIR::filter() runs the high pass stage first.
+    const FilterStageIIR * stages[2] = {band.high_, band.low_};
+
+    const uint32 order = band.low_->n_poles_ + 1;
+
+    if(kind_ == NONE)
+    {
+        kind_ = IIR;
+        n_stages_ = 2;
+        order_ = order;
+    }
+
+    M_ASSERT_VALUE(order, ==, order_);
+    M_ASSERT_VALUE(band.high_->n_poles_ + 1, ==, order_);
+
+    const uint32 n_rows = n_stages_ * order_;
+
+    std::vector<float64> a(n_rows);
+    std::vector<float64> b(n_rows);
+
+    for(uint32 s = 0; s < n_stages_; ++s)
+    {
+        for(uint32 k = 0; k < order_; ++k)
+        {
+            a[s * order_ + k] = stages[s]->a_[k];
+            b[s * order_ + k] = stages[s]->b_[k];
+        }
+    }
+
+    const uint32 n_padded = (n_bands_ + LANES) / LANES * LANES;
+
+    appendColumn(a_, n_rows, n_bands_, n_padded_, n_padded, a.data());
+    appendColumn(b_, n_rows, n_bands_, n_padded_, n_padded, b.data());
+
+    gain_.resize(n_padded, 0.0);
+
+    gain_[n_bands_] = band.gain_;
+
+    ++n_bands_;
+
+    n_padded_ = n_padded;
+
+    x_history_.resize(n_rows * n_padded_);
+    y_history_.resize(n_rows * n_padded_);
+    rows_.resize(order_);
+
+    reset();
+}
+
+void
+FilterBank::
+addBand(const FilterBandPassVocoder & band)
+{
+    M_ASSERT_MSG(
+        kind_ != IIR,
+        "Can't mix FilterBandPassIIR and FilterBandPassVocoder bands");
+
+    kind_ = VOCODER;
+
+    omega2_.push_back(band.omega2_);
+    f_.push_back(band.f_);
+    att_.push_back(band.att_);
+
+    ++n_bands_;
+
+    low1_.resize(n_bands_);
+    mid1_.resize(n_bands_);
+    low2_.resize(n_bands_);
+    mid2_.resize(n_bands_);
+
+    reset();
+}
+
+AudioStream
+FilterBank::
+filter(const Buffer & x)
+{
+    M_PROFILE_SAMPLES("FilterBank::filter", x.getLength());
+
+    reset();
+
+    const uint32 n = x.getLength();
+
+    AudioStream y(sample_rate_, n_bands_);
+
+    for(uint32 b = 0; b < n_bands_; ++b) y[b] = Buffer(n);
+
+    std::vector<float64> block(BLOCK_SIZE * n_bands_);
+
+    for(uint32 i = 0; i < n; i += BLOCK_SIZE)
+    {
+        uint32 n_block = std::min(BLOCK_SIZE, n - i);
+
+        filter(x.getPointer() + i, block.data(), n_block);
+
+        // Transpose into the channels.
+        for(uint32 b = 0; b < n_bands_; ++b)
+        {
+            Buffer & out = y[b];
+
+            for(uint32 j = 0; j < n_block; ++j)
+            {
+                out << block[j * n_bands_ + b];
+            }
+        }
+    }
+
+    return y;
+}
+
+void
+FilterBank::
+filter(const float64 * x, float64 * y, const uint32 n_samples)
+{
+    if(kind_ == IIR)          filterIIR(x, y, n_samples);
+    else if(kind_ == VOCODER) filterVocoder(x, y, n_samples);
+}
+
+void
+FilterBank::
+filterIIR(const float64 * x, float64 * y, const uint32 n_samples)
+{
+    const uint32 nb = n_bands_;
+    const uint32 np = n_padded_;
+    const uint32 order = order_;
+    const uint32 stride = order * np;
+
+    uint32 * rows = rows_.data();
+
+    for(uint32 i = 0; i < n_samples; ++i)
+    {
+        const uint32 w = index_;
+
+        for(uint32 k = 0; k < order; ++k)
+        {
+            rows[k] = (w >= k ? w - k : w + order - k) * np;
+        }
+
+        for(uint32 g = 0; g < np; g += LANES)
+        {
+            // The first stage sees the input, the others the previous stage.
+            float64 in[LANES];
+
+            for(uint32 l = 0; l < LANES; ++l) in[l] = x[i];
+
+            for(uint32 s = 0; s < n_stages_; ++s)
+            {
+                const float64 * a = a_.data() + s * stride + g;
+                const float64 * b = b_.data() + s * stride + g;
+
+                float64 * xh = x_history_.data() + s * stride + g;
+                float64 * yh = y_history_.data() + s * stride + g;
+
+                for(uint32 l = 0; l < LANES; ++l) xh[rows[0] + l] = in[l];
+
+                // The same sum, term for term, as FilterStageIIR::filter().
+                float64 acc[LANES] = {0.0};
+
+                for(uint32 k = 0; k < order; ++k)
+                {
+                    const float64 * bk = b + k * np;
+                    const float64 * xk = xh + rows[k];
+
+                    for(uint32 l = 0; l < LANES; ++l) acc[l] += bk[l] * xk[l];
+                }
+
+                for(uint32 k = 1; k < order; ++k)
+                {
+                    const float64 * ak = a + k * np;
+                    const float64 * yk = yh + rows[k];
+
+                    for(uint32 l = 0; l < LANES; ++l) acc[l] += ak[l] * yk[l];
+                }
+
+                for(uint32 l = 0; l < LANES; ++l)
+                {
+                    yh[rows[0] + l] = acc[l];
+                    in[l] = acc[l];
+                }
+            }
+
+            float64 * out = y + i * nb + g;
+
+            uint32 n_lanes = std::min(LANES, nb - g);
+
+            for(uint32 l = 0; l < n_lanes; ++l) out[l] = gain_[g + l] * in[l];
+        }
+
+        if(++index_ >= order) index_ = 0;
+    }
+}
+
+void
+FilterBank::
+filterVocoder(const float64 * x, float64 * y, const uint32 n_samples)
+{
+    const uint32 nb = n_bands_;
+
+    const float64 * omega2 = omega2_.data();
+    const float64 * f      = f_.data();
+    const float64 * att    = att_.data();
+
+    float64 * low1 = low1_.data();
+    float64 * mid1 = mid1_.data();
+    float64 * low2 = low2_.data();
+    float64 * mid2 = mid2_.data();
+
+    for(uint32 i = 0; i < n_samples; ++i)
+    {
+        const float64 xi = x[i];
+
+        float64 * out = y + i * nb;
+
+        // The same state variable filter as FilterBandPassVocoder::filter().
+        for(uint32 j = 0; j < nb; ++j)
+        {
+            float64 high1 = xi - f[j] * mid1[j] - low1[j];
+            mid1[j] += high1 * omega2[j];
+            low1[j] += mid1[j];
+
+            float64 high2 = low1[j] - f[j] * mid2[j] - low2[j];
+            mid2[j] += high2 * omega2[j];
+            low2[j] += mid2[j];
+
+            out[j] = high2 * att[j];
+        }
+    }
+}
+
+void
+FilterBank::
+reset()
+{
+    index_ = 0;
+
+    std::fill(x_history_.begin(), x_history_.end(), 0.0);
+    std::fill(y_history_.begin(), y_history_.end(), 0.0);
+
+    std::fill(low1_.begin(), low1_.end(), 0.0);
+    std::fill(mid1_.begin(), mid1_.end(), 0.0);
+    std::fill(low2_.begin(), low2_.end(), 0.0);
+    std::fill(mid2_.begin(), mid2_.end(), 0.0);
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: FilterBank.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_FILTER_BANK_H_
+#define _NSOUND_FILTER_BANK_H_
+
+#include <Nsound/Nsound.h>
+
+#include <vector>
+
+namespace Nsound
+{
+
+class AudioStream;
+class Buffer;
+class FilterBandPassIIR;
+class FilterBandPassVocoder;
+
+//-----------------------------------------------------------------------------
+//! Filters one input through many band pass filters at once.
+//
+//! The coefficients and histories of all bands are stored band-contiguous,
+//! so every multiply-accumulate of the difference equation runs across all
+//! bands in one tight loop the compiler can vectorize.  The output of each
+//! band is bit-for-bit identical to filtering with the band's own Filter
+//! object.
+//!
+//! All bands must be of the same kind: either FilterBandPassIIR filters with
+//! the same number of poles, or FilterBandPassVocoder filters.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! FilterBank bank(44100.0);
+//!
+//! bank.addBand(FilterBandPassIIR(44100.0, 6,  200.0,  400.0, 0.01));
+//! bank.addBand(FilterBandPassIIR(44100.0, 6,  400.0,  800.0, 0.01));
+//! bank.addBand(FilterBandPassIIR(44100.0, 6,  800.0, 1600.0, 0.01));
+//!
+//! // One channel per band.
+//! AudioStream bands = bank.filter(Buffer("california.wav"));
+//!
+//! // Python
+//! bank = FilterBank(44100.0)
+//! bank.addBand(FilterBandPassIIR(44100.0, 6,  200.0,  400.0, 0.01))
+//! bands = bank.filter(Buffer("california.wav"))
+//! \endcode
+class FilterBank
+{
+    public:
+
+    FilterBank(const float64 & sample_rate);
+
+    //! Appends a band using the filter's current coefficients, then resets.
+    void
+    addBand(const FilterBandPassIIR & band);
+
+    //! Appends a band using the filter's current coefficients, then resets.
+    void
+    addBand(const FilterBandPassVocoder & band);
+
+    uint32
+    getNBands() const { return n_bands_; };
+
+    float64
+    getSampleRate() const { return sample_rate_; };
+
+    //! Filters x through every band, returns one channel per band.
+    AudioStream
+    filter(const Buffer & x);
+
+    #ifndef SWIG
+    //! Filters n_samples of x, band b of sample i is written to
+    //! y[i * getNBands() + b].
+    void
+    filter(const float64 * x, float64 * y, const uint32 n_samples);
+    #endif
+
+    //! Clears the history of every band.
+    void
+    reset();
+
+    protected:
+
+    enum Kind
+    {
+        NONE,
+        IIR,
+        VOCODER
+    };
+
+    void
+    filterIIR(const float64 * x, float64 * y, const uint32 n_samples);
+
+    void
+    filterVocoder(const float64 * x, float64 * y, const uint32 n_samples);
+
+    float64 sample_rate_;
+    Kind    kind_;
+    uint32  n_bands_;
+
+    // IIR bands: n_stages_ cascaded stages of n_poles_ + 1 coefficients,
+    // element [(stage * order_ + k) * n_padded_ + band].  The bands are
+    // padded with zero coefficients to a whole number of lanes.
+    uint32  n_stages_;
+    uint32  order_;
+    uint32  n_padded_;
+    uint32  index_;
+
+    // The history row of x[n - k], updated every sample.
+    std::vector<uint32> rows_;
+
+    std::vector<float64> a_;
+    std::vector<float64> b_;
+    std::vector<float64> x_history_;
+    std::vector<float64> y_history_;
+    std::vector<float64> gain_;
+
+    // Vocoder bands: state variable filter coefficients and state.
+    std::vector<float64> omega2_;
+    std::vector<float64> f_;
+    std::vector<float64> att_;
+    std::vector<float64> low1_;
+    std::vector<float64> mid1_;
+    std::vector<float64> low2_;
+    std::vector<float64> mid2_;
+
+}; // class FilterBank
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -57,6 +57,8 @@ class FilterCombLowPassFeedback : public Filter
 
     FilterCombLowPassFeedback(const FilterCombLowPassFeedback & copy);
 
+    Filter * clone() const { return new FilterCombLowPassFeedback(*this); }
+
     virtual
     ~FilterCombLowPassFeedback();
 
@@ -29,6 +29,7 @@
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
 #include <Nsound/FilterDC.h>
+#include <Nsound/Profiler.h>
 
 using namespace Nsound;
 
@@ -63,6 +64,8 @@ Buffer
 FilterDC::
 filter(const Buffer & x)
 {
+    M_PROFILE_SAMPLES("FilterDC::filter", x.getLength());
+
     uint32 n_samples = x.getLength();
 
     Buffer y;
@@ -30,7 +30,9 @@
 #include <Nsound/Buffer.h>
 #include <Nsound/FilterDelay.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <string.h>
@@ -97,14 +99,37 @@ AudioStream
 FilterDelay::
 filter(const AudioStream & x)
 {
-    return Filter::filter(x);
+    return FilterDelay::filter(x, delay_);
 }
 
 AudioStream
 FilterDelay::
 filter(const AudioStream & x, const float64 & delay)
 {
-    return Filter::filter(x, delay);
+    if(!is_realtime_) reset();
+
+    uint32 n_channels = x.getNChannels();
+
+    if(is_realtime_ && n_channels > 1)
+    {
+        M_THROW("In real-time mode, a filter per audio channel must be used!");
+    }
+
+    AudioStream y(x.getSampleRate(), n_channels);
+
+    auto function = [&](Filter & f, const Buffer & b)
+    {
+        return static_cast<FilterDelay &>(f).filter(b, delay);
+    };
+
+    if(filterChannels(x, y, function)) return y;
+
+    for(uint32 channel = 0; channel < n_channels; ++channel)
+    {
+        y[channel] = FilterDelay::filter(x[channel], delay);
+    }
+
+    return y;
 }
 
 AudioStream
@@ -118,14 +143,68 @@ Buffer
 FilterDelay::
 filter(const Buffer & x)
 {
-    return Filter::filter(x);
+    return FilterDelay::filter(x, delay_);
 }
 
 Buffer
 FilterDelay::
 filter(const Buffer & x, const float64 & delay)
 {
-    return Filter::filter(x, delay);
+    M_PROFILE_SAMPLES("FilterDelay::filter", x.getLength());
+
+    if(!is_realtime_) reset();
+
+    float64 del = delay;
+
+    // limit delay
+    if(del > delay_)   del = delay_;
+    else if(del < 0.0) del = 0.0;
+
+    const uint32 d = static_cast<uint32>(sample_rate_ * del);
+    const uint32 n = x.getLength();
+
+    if(n == 0) return Buffer();
+
+    Buffer y(x);
+
+    const float64 * in = x.getPointer();
+    float64 * out = y.getPointer();
+
+    // A constant delay is a shift: the first d samples come out of the
+    // ring, the rest straight from the input.
+    if(d < n) memcpy(out + d, in, sizeof(float64) * (n - d));
+
+    uint32 w = static_cast<uint32>(write_ptr_ - buffer_);
+
+    uint32 n_history = std::min(d, n);
+
+    uint32 rd = (w + n_samples_ - d) % n_samples_;
+
+    for(uint32 i = 0; i < n_history; ++i)
+    {
+        out[i] = buffer_[rd];
+
+        if(++rd == n_samples_) rd = 0;
+    }
+
+    // Push the tail of the block into the ring.
+    uint32 n_keep = std::min(n, n_samples_);
+
+    uint32 wr = static_cast<uint32>(
+        (static_cast<uint64>(w) + n - n_keep) % n_samples_);
+
+    for(uint32 i = n - n_keep; i < n; ++i)
+    {
+        buffer_[wr] = in[i];
+
+        if(++wr == n_samples_) wr = 0;
+    }
+
+    write_ptr_ = buffer_ + wr;
+
+    read_ptr_ = buffer_ + (wr + n_samples_ - d - 1) % n_samples_;
+
+    return y;
 }
 
 Buffer
@@ -54,6 +54,8 @@ class FilterDelay : public Filter
 
     FilterDelay(const FilterDelay & copy);
 
+    Filter * clone() const { return new FilterDelay(*this); }
+
     ~FilterDelay();
 
     AudioStream
@@ -28,17 +28,15 @@
 
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
-#include <Nsound/FilterDelay.h>
 #include <Nsound/FilterFlanger.h>
-#include <Nsound/Generator.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
 #include <Nsound/Sine.h>
-#include <Nsound/Triangle.h>
-
 
+#include <algorithm>
+#include <cmath>
 #include <stdio.h>
 #include <iostream>
-//~#include <string.h>
 
 using namespace Nsound;
 
@@ -46,6 +44,9 @@ using std::cerr;
 using std::cout;
 using std::endl;
 
+// Number of samples the LFO is rendered ahead.
+static const uint32 BLOCK_SIZE = 256;
+
 //-----------------------------------------------------------------------------
 FilterFlanger::
 FilterFlanger(
@@ -56,19 +57,27 @@ FilterFlanger(
     Filter(sample_rate),
     frequency_(frequency),
     max_delay_(max_delay_time_seconds),
-    delay_(NULL),
-    gen_(NULL)
+    n_history_(0),
+    write_index_(0),
+    history_(),
+    waveform_(),
+    lfo_position_(0.0),
+    delays_(BLOCK_SIZE, 0)
 {
     M_ASSERT_VALUE(frequency_, >, 0.0);
     M_ASSERT_VALUE(max_delay_, >, 0.0);
 
-    delay_ = new FilterDelay(sample_rate_, max_delay_);
+    n_history_ = static_cast<uint32>(std::ceil(sample_rate_ * max_delay_)) + 1;
+
+    history_.resize(n_history_);
 
     Sine sin(sample_rate_);
 
     Buffer waveform = (1.0 + sin.generate(1.0, 1.0)) / 2.0;
 
-    gen_ = new Generator(sample_rate_, waveform);
+    waveform_.assign(waveform.begin(), waveform.end());
+
+    reset();
 }
 
 //-----------------------------------------------------------------------------
@@ -78,40 +87,34 @@ FilterFlanger(const FilterFlanger & copy)
     Filter(copy.sample_rate_),
     frequency_(copy.frequency_),
     max_delay_(copy.max_delay_),
-    delay_(NULL),
-    gen_(NULL)
+    n_history_(copy.n_history_),
+    write_index_(copy.write_index_),
+    history_(copy.history_),
+    waveform_(copy.waveform_),
+    lfo_position_(copy.lfo_position_),
+    delays_(copy.delays_)
 {
-    delay_ = new FilterDelay(sample_rate_, max_delay_);
-
-    Sine sin(sample_rate_);
-
-    Buffer waveform = (1.0 + sin.generate(1.0, 1.0)) / 2.0;
-
-    gen_ = new Generator(sample_rate_, waveform);
-
-    *this = copy;
+    reset();
 }
 
 //-----------------------------------------------------------------------------
 FilterFlanger::
 ~FilterFlanger()
 {
-    delete delay_;
-    delete gen_;
 }
 
 AudioStream
 FilterFlanger::
 filter(const AudioStream & x)
 {
-    return Filter::filter(x);
+    return filter(x, frequency_, max_delay_);
 }
 
 AudioStream
 FilterFlanger::
 filter(const AudioStream & x, const float64 & frequency)
 {
-    return Filter::filter(x, frequency);
+    return filter(x, frequency, max_delay_);
 }
 
 AudioStream
@@ -125,6 +128,13 @@ filter(
 
     AudioStream y(x.getSampleRate(), n_channels);
 
+    auto function = [&](Filter & f, const Buffer & b)
+    {
+        return static_cast<FilterFlanger &>(f).filter(b, frequency, delay);
+    };
+
+    if(filterChannels(x, y, function)) return y;
+
     for(uint32 channel = 0; channel < n_channels; ++channel)
     {
         y[channel] = filter(x[channel], frequency, delay);
@@ -144,6 +154,13 @@ filter(
 
     AudioStream y(x.getSampleRate(), n_channels);
 
+    auto function = [&](Filter & f, const Buffer & b)
+    {
+        return static_cast<FilterFlanger &>(f).filter(b, frequency, delay);
+    };
+
+    if(filterChannels(x, y, function)) return y;
+
     for(uint32 channel = 0; channel < n_channels; ++channel)
     {
         y[channel] = filter(x[channel], frequency, delay);
@@ -156,51 +173,36 @@ Buffer
 FilterFlanger::
 filter(const Buffer & x)
 {
-    reset();
-
-    Buffer y(x.getLength());
-
-    uint32 x_samples = x.getLength();
-
-    for(uint32 i = 0; i < x_samples; ++i)
-    {
-        y << filter(x[i], frequency_, max_delay_);
-    }
-
-    return y;
+    return filter(x, frequency_, max_delay_);
 }
 
 Buffer
 FilterFlanger::
 filter(const Buffer & x, const float64 & frequency)
 {
-    reset();
-
-    Buffer y(x.getLength());
-
-    uint32 x_samples = x.getLength();
-
-    for(uint32 i = 0; i < x_samples; ++i)
-    {
-        y << filter(x[i], frequency, max_delay_);
-    }
-
-    return y;
+    return filter(x, frequency, max_delay_);
 }
 
 Buffer
 FilterFlanger::
 filter(const Buffer & x, const float64 & frequency, const float64 & delay)
 {
+    M_PROFILE_SAMPLES("FilterFlanger::filter", x.getLength());
+
     reset();
 
-    Buffer y(x.getLength());
+    uint32 n = x.getLength();
 
-    uint32 x_samples = x.getLength();
+    // Filtered in place, filterBlock() reads each sample before writing it.
+    Buffer y(x);
 
-    for(uint32 i = 0; i < x_samples; ++i)
+    for(uint32 i = 0; i < n; i += BLOCK_SIZE)
     {
-        y << filter(x[i], frequency, delay);
+        uint32 n_block = std::min(BLOCK_SIZE, n - i);
+
+        renderDelays(n_block, frequency, delay);
+
+        filterBlock(y.getPointer() + i, y.getPointer() + i, n_block);
     }
 
     return y;
@@ -210,16 +212,18 @@ Buffer
 FilterFlanger::
 filter(const Buffer & x, const Buffer & frequency, const Buffer & delay)
 {
+    M_PROFILE_SAMPLES("FilterFlanger::filter", x.getLength());
+
     reset();
 
-    Buffer y(x.getLength());
+    uint32 n = x.getLength();
 
-    uint32 x_samples = x.getLength();
+    Buffer y(n);
 
     Buffer::const_circular_iterator f = frequency.cbegin();
     Buffer::const_circular_iterator d = delay.cbegin();
 
-    for(uint32 i = 0; i < x_samples; ++i)
+    for(uint32 i = 0; i < n; ++i, ++f, ++d)
     {
         y << filter(x[i], *f, *d);
     }
@@ -232,7 +236,6 @@ FilterFlanger::
 filter(const float64 & x)
 {
     return filter(x, frequency_, max_delay_);
-
 }
 
 float64
@@ -240,18 +243,95 @@ FilterFlanger::
 filter(const float64 & x, const float64 & frequency)
 {
     return filter(x, frequency, max_delay_);
-
 }
 
 float64
 FilterFlanger::
 filter(const float64 & x, const float64 & frequency, const float64 & delay)
 {
-    float64 f = gen_->generate(frequency);
+    float64 y = 0.0;
+
+    renderDelays(1, frequency, delay);
+
+    filterBlock(&x, &y, 1);
+
+    return y;
+}
+
+void
+FilterFlanger::
+renderDelays(
+    const uint32 n_samples,
+    const float64 & frequency,
+    const float64 & delay)
+{
+    const float64 sr = sample_rate_;
+    const float64 max_delay = max_delay_;
+    const float64 f = frequency;
+    const float64 depth = delay;
+
+    const float64 * waveform = waveform_.data();
+    const uint32 n_waveform = static_cast<uint32>(waveform_.size());
+
+    uint32 * d = delays_.data();
+
+    float64 position = lfo_position_;
+
+    for(uint32 i = 0; i < n_samples; ++i)
+    {
+        // Same lookup as Generator::generate(), but wrapped in O(1).
+        float64 pos = position + 0.5;
+
+        if(pos >= sr || pos < 0.0)
+        {
+            pos = std::fmod(pos, sr);
+
+            if(pos < 0.0) pos += sr;
+        }
+
+        uint32 index = static_cast<uint32>(pos);
+
+        if(index >= n_waveform) index -= n_waveform;
+
+        position += f;
+
+        float64 del = waveform[index] * depth;
+
+        if(del > max_delay) del = max_delay;
+        else if(del < 0.0)  del = 0.0;
+
+        d[i] = static_cast<uint32>(sr * del);
+    }
+
+    lfo_position_ = position;
+}
+
+void
+FilterFlanger::
+filterBlock(const float64 * x, float64 * y, const uint32 n_samples)
+{
+    float64 * history = history_.data();
+
+    const uint32 * delays = delays_.data();
+    const uint32 n_history = n_history_;
+
+    uint32 w = write_index_;
+
+    for(uint32 i = 0; i < n_samples; ++i)
+    {
+        const float64 xn = x[i];
+        const uint32 d = delays[i];
 
-    float64 y = delay_->filter(x, f*delay);
+        history[w] = xn;
 
-    return (y+x) / 2.0;
+        float64 yd = history[w >= d ? w - d : w + n_history - d];
+
+        y[i] = (yd + xn) / 2.0;
+
+        if(++w >= n_history) w = 0;
+    }
+
+    write_index_ = w;
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -264,11 +344,13 @@ operator=(const FilterFlanger & rhs)
         return *this;
     }
 
-    sample_rate_ = rhs.sample_rate_;
-    frequency_   = rhs.frequency_;
-    max_delay_   = rhs.max_delay_;
-    *delay_      = *rhs.delay_;
-    *gen_        = *rhs.gen_;
+    sample_rate_  = rhs.sample_rate_;
+    frequency_    = rhs.frequency_;
+    max_delay_    = rhs.max_delay_;
+    n_history_    = rhs.n_history_;
+    history_      = rhs.history_;
+    waveform_     = rhs.waveform_;
+    delays_       = rhs.delays_;
 
     reset();
 
@@ -310,6 +392,8 @@ void
 FilterFlanger::
 reset()
 {
-    delay_->reset();
-    gen_->reset();
+    std::fill(history_.begin(), history_.end(), 0.0);
+
+    write_index_ = 0;
+    lfo_position_ = 0.0;
 }
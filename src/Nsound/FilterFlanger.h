@@ -35,17 +35,21 @@
 
 #include <Nsound/Filter.h>
 
+#include <vector>
+
 namespace Nsound
 {
 
 // Forward class declarations
 class AudioStream;
 class Buffer;
-class FilterDelay;
-class Generator;
 
 //-----------------------------------------------------------------------------
 //! A class for filtering audio in the frequecy domain.
+//
+//! The delay line and the sine LFO are owned directly by the flanger.  When
+//! filtering a Buffer the LFO delays are rendered a block at a time ahead of
+//! the delay line pass.
 class FilterFlanger : public Filter
 {
     public:
@@ -57,6 +61,8 @@ class FilterFlanger : public Filter
 
     FilterFlanger(const FilterFlanger & copy);
 
+    Filter * clone() const { return new FilterFlanger(*this); }
+
     ~FilterFlanger();
 
     AudioStream
@@ -124,10 +130,31 @@ class FilterFlanger : public Filter
 
     protected:
 
-    float64       frequency_;
-    float64       max_delay_;
-    FilterDelay * delay_;
-    Generator *   gen_;
+    //! Renders the delay in samples for the next n_samples LFO steps.
+    void
+    renderDelays(
+        const uint32 n_samples,
+        const float64 & frequency,
+        const float64 & delay);
+
+    //! Runs the delay line over n_samples using the rendered delays.
+    void
+    filterBlock(const float64 * x, float64 * y, const uint32 n_samples);
+
+    float64 frequency_;
+    float64 max_delay_;
+
+    // Same layout and length as a FilterDelay with max_delay_.
+    uint32               n_history_;
+    uint32               write_index_;
+    std::vector<float64> history_;
+
+    // The LFO, position_ is accumulated like Generator::position_.
+    std::vector<float64> waveform_;
+    float64              lfo_position_;
+
+    // Block scratch, one delay per sample.
+    std::vector<uint32>  delays_;
 
 };
 
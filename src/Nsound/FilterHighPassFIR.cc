@@ -30,6 +30,7 @@
 #include <Nsound/Buffer.h>
 #include <Nsound/FilterHighPassFIR.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
 
 #include <cmath>
 #include <cstdio>
@@ -101,6 +102,8 @@ Buffer
 FilterHighPassFIR::
 filter(const Buffer & x, const float64 & f)
 {
+    M_PROFILE_SAMPLES("FilterHighPassFIR::filter", x.getLength());
+
     // Instead of calling Filter::filter(x,f), we implement this function here
     // to avoid calling makeKernel(f) for each sample.
 
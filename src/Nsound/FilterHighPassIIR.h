@@ -49,6 +49,8 @@ class FilterHighPassIIR : public FilterStageIIR
         const float64 & frequency,
         const float64 & percent_ripple = 0.0);
 
+    Filter * clone() const { return new FilterHighPassIIR(*this); }
+
     AudioStream
     filter(const AudioStream & x);
 
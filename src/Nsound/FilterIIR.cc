@@ -33,11 +33,12 @@
 #include <Nsound/Kernel.h>
 #include <Nsound/Plotter.h>
 #include <Nsound/RngTausworthe.h>
+#include <Nsound/ThreadPool.h>
 
+#include <algorithm>
 //~#include <cmath>
 #include <cstdio>
 #include <cstring>
-#include <iomanip>
 #include <iostream>
 
 #include <stdlib.h>
@@ -46,7 +47,6 @@
 using namespace Nsound;
 
 using std::cerr;
-using std::cout;
 using std::endl;
 
 //~using std::isnan;
@@ -69,7 +69,9 @@ FilterIIR(
     y_history_(NULL),
     y_ptr_(NULL),
     y_end_ptr_(NULL),
-    rng_(NULL)
+    rng_(NULL),
+    seed_(0),
+    design_callback_()
 {
     kernel_ = new Kernel(n_poles_, n_poles_);
 
@@ -83,6 +85,8 @@ FilterIIR(
 
     rng_ = new RngTausworthe();
 
+    seed_ = rng_->get();
+
     reset();
 }
 
@@ -99,10 +103,17 @@ FilterIIR(const FilterIIR & copy)
     y_history_(NULL),
     y_ptr_(NULL),
     y_end_ptr_(NULL),
-    rng_(NULL)
+    rng_(NULL),
+    seed_(0),
+    design_callback_()
 {
-    x_history_ = new float64 [n_poles_];
-    y_history_ = new float64 [n_poles_];
+    kernel_ = new Kernel(*copy.kernel_);
+
+    x_history_ = new float64 [n_poles_ + 1];
+    x_end_ptr_ = x_history_ + n_poles_ + 1;
+
+    y_history_ = new float64 [n_poles_ + 1];
+    y_end_ptr_ = y_history_ + n_poles_ + 1;
 
     rng_ = new RngTausworthe();
 
@@ -242,260 +253,420 @@ getRMS(
     return rms;
 }
 
-//-----------------------------------------------------------------------------
-//! This method is VERY EXPERMENTAL!  Use at your own risk!
-Buffer
+float64
 FilterIIR::
-designKernel(
-    const Buffer  &  ref_response,
-    const float64 &  max_rms_error,
-    const int32      max_iterations,
-    const SignalType type)
+getRMS(
+    const Kernel &   k,
+    const Buffer &   ref_response,
+    const SignalType type,
+    DesignScratch &  scratch) const
 {
-    // The reference response curve must be a power of two to guarentee correct
-    // comparision to the designed kernel response.
+    // Mirrors getRMS() above: the response is compared over the length of
+    // the reference, the frequency response comes from the first N samples of
+    // getImpulseResponse()'s default 8192 sample impulse.
 
-    uint32 p2 = 2;
-    uint32 ref_size = ref_response.getLength();
+    const uint32 n_ref = ref_response.getLength();
+    const uint32 N = 2 * n_ref;
 
-    while( p2 < ref_size )
+    uint32 n_impulse = n_ref;
+
+    if(type == FREQUENCY_RESSPONSE) n_impulse = std::min<uint32>(N, 8192);
+
+    if(scratch.impulse.size() < n_impulse) scratch.impulse.resize(n_impulse);
+
+    float64 * y = scratch.impulse.data();
+
+    const float64 * b = k.getB();
+    const float64 * a = k.getA();
+
+    // The impulse response of filter(), term for term.
+    for(uint32 n = 0; n < n_impulse; ++n)
     {
-        p2 <<= 1;
-    }
+        float64 sum = n < n_poles_ ? b[n] : 0.0;
 
-    M_ASSERT_VALUE(ref_size, ==, p2);
+        uint32 k_end = std::min(n_poles_, n + 1);
 
-    if(ref_size != p2) ::exit(1);
+        for(uint32 j = 1; j < k_end; ++j)
+        {
+            sum += a[j] * y[n - j];
+        }
 
-    // Create the initial 2 parents
-    Kernel * mom = new Kernel(n_poles_, n_poles_);
+        y[n] = sum;
+    }
 
-    float64 LARGE_RMS = 1.0;
-    float64 STALE_RMS = 0.001;
+    float64 rms = 0.0;
 
-    float64 rms_error = LARGE_RMS;
-    int32 dead_count = 0;
-    while(rms_error > LARGE_RMS && dead_count < 1000)
+    if(type == IMPULSE_RESPONSE)
     {
-        mom->randomize(-0.1, 0.1);
-        rms_error = getRMS(*mom, ref_response, type);
-        dead_count++;
+        for(uint32 i = 0; i < n_ref; ++i)
+        {
+            float64 delta = ref_response[i] - y[i];
+            rms += delta * delta;
+        }
+
+        return ::sqrt(rms / static_cast<float64>(n_ref));
     }
 
-    M_ASSERT_VALUE(rms_error, <=, LARGE_RMS);
+    scratch.real.resize(N);
+    scratch.imag.resize(N);
 
-    if(rms_error > LARGE_RMS) ::exit(1);
+    float64 * real = scratch.real.data();
+    float64 * img  = scratch.imag.data();
 
-    Kernel * dad = new Kernel(n_poles_, n_poles_);
+    std::memcpy(real, y, sizeof(float64) * n_impulse);
+    std::memset(real + n_impulse, 0, sizeof(float64) * (N - n_impulse));
+    std::memset(img, 0, sizeof(float64) * N);
 
-    dad->randomize(-0.1, 0.1);
+    // The same radix 2 fft as FFTransform, so the scores match exactly.
 
-    int32 N_CHILDREN = 14;
+    const float64 pi = M_PI;
+    const int32 n_minus_1 = N - 1;
+    const int32 n_devide_2 = N / 2;
+    const int32 m = static_cast<uint32>(
+        std::log10(static_cast<float64>(N)) / std::log10(2.0) + 0.5);
 
-    // Allocate N children
-    Kernel ** child = new Kernel * [N_CHILDREN];
+    int32 j = n_devide_2;
 
-    for(int32 i = 0; i < N_CHILDREN; ++i)
+    for(int32 i = 1; i <= static_cast<int32>(N) - 2 ; ++i)
     {
-        child[i] = new Kernel(n_poles_, n_poles_);
-    }
+        if(i < j)
+        {
+            std::swap(real[i], real[j]);
+            std::swap(img[i], img[j]);
+        }
 
-    Buffer rms_history;
+        int32 kk = n_devide_2;
 
-    rms_history << rms_error;
+        while(kk <= j)
+        {
+            j -= kk;
+            kk /= 2;
+        }
+        j += kk;
+    }
 
-    float64 dad_rms_error = getRMS(*dad, ref_response, type);
+    for(int32 l = 1; l <= m; ++l)
+    {
+        int32 le = static_cast<int32>(std::pow(2.0, l) + 0.5);
+        int32 le2 = le / 2;
 
-    cout << std::setprecision(10)
-         << "mom's RMS = " << rms_error << endl
-         << "dad's RMS = " << dad_rms_error << endl;
+        float64 ur = 1.0;
+        float64 ui = 0.0;
 
-    float64 rms_error1 = LARGE_RMS;
-    float64 rms_error2 = LARGE_RMS;
+        float64 sr = std::cos(pi / static_cast<float64>(le2));
+        float64 si = -1.0 * std::sin(pi / static_cast<float64>(le2));
 
-    Kernel * low1 = NULL;
-    Kernel * low2 = NULL;
+        for(j = 1; j <= le2; ++j)
+        {
+            for(int32 i = j - 1; i <= n_minus_1; i += le)
+            {
+                int32 ip = i + le2;
 
-    float64 last_rms_error = rms_error;
-    int32 stale_count = 0;
-    int32 major_stale_count = 0;
-    int32 count = 0;
+                float64 temp_real = ur * real[ip] - ui * img[ip];
+                float64 temp_img  = ui * real[ip] + ur * img[ip];
 
-    while(count < max_iterations && rms_error > max_rms_error)
-    {
-        ++count;
+                real[ip] = real[i] - temp_real;
+                img[ip]  = img[i]  - temp_img;
 
-        // First two children just swap mom & dads a & b coeffs;
-        *child[0] = *mom;
-        *child[1] = *dad;
-        child[0]->ga_swap_ab(*child[1]);
+                real[i] += temp_real;
+                img[i]  += temp_img;
+            }
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl << endl;
-        #endif
+            float64 temp = ur;
+            ur = temp * sr - ui * si;
+            ui = temp * si + ui * sr;
+        }
+    }
 
-        // Next two children interleave coeffs
-        *child[2] = *mom;
-        *child[3] = *dad;
+    for(uint32 i = 0; i < n_ref; ++i)
+    {
+        float64 delta = ref_response[i]
+            - std::sqrt(real[i] * real[i] + img[i] * img[i]);
 
-        child[2]->ga_interleave(*child[3]);
+        rms += delta * delta;
+    }
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl << endl;
-        #endif
+    return ::sqrt(rms / static_cast<float64>(n_ref));
+}
 
-        // The next two children randomly mutate one coeff from mom & dad
-        *child[4] = *mom;
-        *child[5] = *dad;
+void
+FilterIIR::
+setSeed(const uint32 seed)
+{
+    seed_ = seed;
+}
 
-        for(uint32 i = 4; i < 6; ++i)
-        {
-            float64 delta = rng_->get(-0.1f, 0.1f);
+// Sets all coefs to random values, like Kernel::randomize() but with the
+// caller's generator.
+static
+void
+randomize(Kernel & k, const float64 & min, const float64 & max, RngTausworthe & rng)
+{
+    float64 * b = k.getB();
+    float64 * a = k.getA();
 
-            uint32 index = rng_->get(0, n_poles_);
+    for(uint32 i = 0; i < k.getBLength(); ++i) b[i] = rng.get(min, max);
+    for(uint32 i = 0; i < k.getALength(); ++i) a[i] = rng.get(min, max);
+}
 
-            child[i]->setB(child[i]->getB(index) + delta, index);
+// Breeds the pair of children c0, c1 from mom & dad, each pair uses a
+// different strategy.
+static
+void
+breed(
+    const uint32    pair,
+    const uint32    n_poles,
+    const Kernel &  mom,
+    const Kernel &  dad,
+    Kernel &        c0,
+    Kernel &        c1,
+    RngTausworthe & rng)
+{
+    c0 = mom;
+    c1 = dad;
 
-            delta = rng_->get(-0.1f, 0.1f);
+    Kernel * child[2] = {&c0, &c1};
 
-            index = rng_->get(0, n_poles_);
+    switch(pair)
+    {
+        // Swap mom & dads a & b coeffs.
+        case 0:
+        {
+            c0.setB(dad.getA());
+            c0.setA(dad.getB());
+            c1.setB(mom.getA());
+            c1.setA(mom.getB());
+            break;
+        }
 
-            child[i]->setA(child[i]->getA(index) + delta, index);
+        // Interleave coeffs.
+        case 1:
+        {
+            for(uint32 i = 1; i < n_poles; i += 2)
+            {
+                std::swap(c0.getB()[i], c1.getB()[i]);
+                std::swap(c0.getA()[i], c1.getA()[i]);
+            }
+            break;
         }
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl << endl;
-        #endif
+        // Randomly mutate one coeff.
+        case 2:
+        {
+            for(Kernel * c : child)
+            {
+                float64 delta = rng.get(-0.1f, 0.1f);
+                uint32 index = rng.get(0, n_poles);
 
-        // The next two children randomly mutate sign
-        *child[6] = *mom;
-        *child[7] = *dad;
+                c->setB(c->getB(index) + delta, index);
 
-        for(uint32 i = 6; i < 8; ++i)
-        {
-            uint32 index = rng_->get(0, n_poles_);
+                delta = rng.get(-0.1f, 0.1f);
+                index = rng.get(0, n_poles);
 
-            float64 a_or_b = rng_->get(-1.0f, 1.0f);
+                c->setA(c->getA(index) + delta, index);
+            }
+            break;
+        }
 
-            if(a_or_b > 0.0)
+        // Randomly mutate sign.
+        case 3:
+        {
+            for(Kernel * c : child)
             {
-                child[i]->setB(child[i]->getB(index) * -1.0, index);
+                uint32 index = rng.get(0, n_poles);
+
+                if(rng.get(-1.0f, 1.0f) > 0.0)
+                {
+                    c->setB(c->getB(index) * -1.0, index);
+                }
+                else
+                {
+                    c->setA(c->getA(index) * -1.0, index);
+                }
             }
-            else
+            break;
+        }
+
+        // Randomly multiply one coef.
+        case 4:
+        {
+            for(Kernel * c : child)
             {
-                child[i]->setA(child[i]->getA(index) * -1.0, index);
+                uint32 index = rng.get(0, n_poles);
+                float64 a_or_b = rng.get(-1.0f, 1.0f);
+                float64 delta = rng.get(-0.1f, 0.1f);
+
+                if(a_or_b > 0.0)
+                {
+                    c->setB(c->getB(index) * delta, index);
+                }
+                else
+                {
+                    c->setA(c->getA(index) * delta, index);
+                }
             }
+            break;
         }
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl << endl;
-        #endif
+        // Swap a random range of mom & dad coeffs.
+        case 5:
+        {
+            for(uint32 ab = 0; ab < 2; ++ab)
+            {
+                uint32 start_index = rng.get(0, n_poles);
+                uint32 stop_index  = rng.get(0, n_poles);
 
-        // These two children randomly multiply one coef.
-        *child[8] = *mom;
-        *child[9] = *dad;
+                if(stop_index >= n_poles) stop_index = n_poles - 1;
 
-        for(uint32 i = 8; i < 10; ++i)
-        {
-            uint32 index = rng_->get(0, n_poles_);
+                if(start_index > stop_index) std::swap(start_index, stop_index);
 
-            float64 a_or_b = rng_->get(-1.0f, 1.0f);
+                const float64 * m = ab == 0 ? mom.getB() : mom.getA();
+                const float64 * d = ab == 0 ? dad.getB() : dad.getA();
 
-            float64 delta = rng_->get(-0.1f, 0.1f);
+                float64 * y0 = ab == 0 ? c0.getB() : c0.getA();
+                float64 * y1 = ab == 0 ? c1.getB() : c1.getA();
 
-            if(a_or_b > 0.0)
-            {
-                child[i]->setB(child[i]->getB(index) * delta, index);
+                for(uint32 j = start_index; j < stop_index; ++j)
+                {
+                    y0[j] = d[j];
+                    y1[j] = m[j];
+                }
             }
-            else
+            break;
+        }
+
+        // Randomly add to all coeffs.
+        default:
+        {
+            for(Kernel * c : child)
             {
-                child[i]->setA(child[i]->getA(index) * delta, index);
+                for(uint32 j = 0; j < n_poles; ++j)
+                {
+                    c->setB(c->getB(j) + rng.get(-0.1f, 0.1f), j);
+                    c->setA(c->getA(j) + rng.get(-0.1f, 0.1f), j);
+                }
             }
+            break;
         }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//! This method is VERY EXPERMENTAL!  Use at your own risk!
+Buffer
+FilterIIR::
+designKernel(
+    const Buffer  &  ref_response,
+    const float64 &  max_rms_error,
+    const int32      max_iterations,
+    const SignalType type)
+{
+    // The reference response curve must be a power of two to guarentee correct
+    // comparision to the designed kernel response.
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl << endl;
-        #endif
+    uint32 p2 = 2;
+    uint32 ref_size = ref_response.getLength();
 
-        // These two children randomly swap mom & dad coeffs
-        *child[10] = *mom;
-        *child[11] = *dad;
+    while( p2 < ref_size )
+    {
+        p2 <<= 1;
+    }
 
-        uint32 start_index = rng_->get(0, n_poles_);
-        uint32 stop_index  = rng_->get(0, n_poles_);
+    M_ASSERT_VALUE(ref_size, ==, p2);
 
-        if(stop_index >= n_poles_) stop_index = n_poles_ - 1;
+    if(ref_size != p2) ::exit(1);
 
-        if(start_index > stop_index)
-        {
-            uint32 temp = start_index;
-            start_index = stop_index;
-            stop_index = temp;
-        }
+    const int32 N_CHILDREN = 14;
+    const int32 N_PAIRS = N_CHILDREN / 2;
 
-        for(uint32 j = start_index; j < stop_index; ++j)
-        {
-            child[10]->setB(dad->getB(j), j);
-            child[11]->setB(mom->getB(j), j);
-        }
+    // Each pair of children gets its own generator and scratch space, the
+    // search is deterministic regardless of the number of threads.
+    rng_->setSeed(seed_);
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl << endl;
-        #endif
+    std::vector<RngTausworthe> pair_rng(N_PAIRS);
 
-        start_index = rng_->get(0, n_poles_);
-        stop_index  = rng_->get(0, n_poles_);
+    for(int32 i = 0; i < N_PAIRS; ++i)
+    {
+        pair_rng[i].setSeed(seed_ ^ (0x9e3779b9u * static_cast<uint32>(i + 1)));
+    }
 
-        if(stop_index >= n_poles_) stop_index = n_poles_ - 1;
+    std::vector<DesignScratch> scratch(N_PAIRS);
 
-        if(start_index > stop_index)
-        {
-            int32 temp = start_index;
-            start_index = stop_index;
-            stop_index = temp;
-        }
+    // Create the initial 2 parents
+    Kernel * mom = new Kernel(n_poles_, n_poles_);
 
-        for(uint32 j = start_index; j < stop_index; ++j)
-        {
-            child[10]->setA(dad->getA(j), j);
-            child[11]->setA(mom->getA(j), j);
-        }
+    float64 LARGE_RMS = 1.0;
+    float64 STALE_RMS = 0.001;
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl << endl;
-        #endif
+    // Mom's coeffs start out uninitialized, randomize at least once.
+    float64 rms_error = LARGE_RMS;
+    int32 dead_count = 0;
+    do
+    {
+        randomize(*mom, -0.1, 0.1, *rng_);
+        rms_error = getRMS(*mom, ref_response, type, scratch[0]);
+        dead_count++;
+    }
+    while(rms_error > LARGE_RMS && dead_count < 1000);
 
-        // These two children randomly add mom & dad coeffs
-        *child[12] = *mom;
-        *child[13] = *dad;
+    M_ASSERT_VALUE(rms_error, <=, LARGE_RMS);
 
-        for(uint32 i = 12; i < 14; ++i)
-        {
-            for(uint32 j = 0; j < n_poles_; ++j)
+    if(rms_error > LARGE_RMS) ::exit(1);
+
+    Kernel * dad = new Kernel(n_poles_, n_poles_);
+
+    randomize(*dad, -0.1, 0.1, *rng_);
+
+    // Allocate N children
+    std::vector<Kernel *> child(N_CHILDREN);
+    std::vector<float64> child_rms(N_CHILDREN);
+
+    for(int32 i = 0; i < N_CHILDREN; ++i)
+    {
+        child[i] = new Kernel(n_poles_, n_poles_);
+    }
+
+    Buffer rms_history;
+
+    rms_history << rms_error;
+
+    float64 dad_rms_error = getRMS(*dad, ref_response, type, scratch[0]);
+
+    float64 last_rms_error = rms_error;
+    int32 stale_count = 0;
+    int32 major_stale_count = 0;
+    int32 count = 0;
+
+    while(count < max_iterations && rms_error > max_rms_error)
+    {
+        ++count;
+
+        // Breed and score the kiddies, one pair per task.
+        ThreadPool::getInstance().run(
+            N_PAIRS,
+            [&](uint32 p)
             {
-                child[i]->setB(child[i]->getB(j) + rng_->get(-0.1f, 0.1f), j);
-                child[i]->setA(child[i]->getA(j) + rng_->get(-0.1f, 0.1f), j);
-            }
-        }
+                Kernel & c0 = *child[2 * p];
+                Kernel & c1 = *child[2 * p + 1];
+
+                breed(p, n_poles_, *mom, *dad, c0, c1, pair_rng[p]);
 
-        // Score the kiddies.
+                child_rms[2 * p] =
+                    getRMS(c0, ref_response, type, scratch[p]);
 
-        rms_error1 = getRMS(*mom, ref_response, type);
-        rms_error2 = getRMS(*dad, ref_response, type);
+                child_rms[2 * p + 1] =
+                    getRMS(c1, ref_response, type, scratch[p]);
+            });
 
-        low1 = mom;
-        low2 = dad;
+        float64 rms_error1 = rms_error;
+        float64 rms_error2 = dad_rms_error;
+
+        Kernel * low1 = mom;
+        Kernel * low2 = dad;
 
         for(int32 i = 0; i < N_CHILDREN; ++i)
         {
-            float64 rms = getRMS(*child[i], ref_response, type);
+            float64 rms = child_rms[i];
 
             if(rms > LARGE_RMS) continue;
 
@@ -511,29 +682,19 @@ designKernel(
             }
         }
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl << endl;
-        #endif
-
         *mom = *low1;
         *dad = *low2;
 
-        rms_error     = getRMS(*mom, ref_response, type);
-        dad_rms_error = getRMS(*dad, ref_response, type);
+        rms_error     = rms_error1;
+        dad_rms_error = rms_error2;
 
         rms_history << rms_error;
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl;
-        #endif
-
         // Check if dad is unstable.
         if(dad_rms_error > LARGE_RMS)
         {
-            cout << PRINT_LINE << "dad's RMS > 10, ballistic!" << endl;
-            dad->randomize(-0.01f, 0.01f);
+            randomize(*dad, -0.01f, 0.01f, *rng_);
+            dad_rms_error = getRMS(*dad, ref_response, type, scratch[0]);
         }
 
         // Check if our evolution is getting stale
@@ -548,14 +709,6 @@ designKernel(
 
         last_rms_error = rms_error;
 
-        if(count % 200 == 0)
-        {
-            cout << "Generation " << count << endl
-                 << "    1st maximum RMS = " << rms_error     << endl
-                 << "    2nd maximum RMS = " << dad_rms_error << endl;
-//~                  << "    major_stale_count = " << major_stale_count << endl;
-        }
-
         if(stale_count > 6)
         {
             for(uint32 i = 0; i < n_poles_; ++i)
@@ -577,17 +730,13 @@ designKernel(
 
                 major_stale_count = 0;
             }
-        }
 
-        #ifdef GA_DEBUG
-            cout << __LINE__ << "\tmom.getSum() = " << mom->getSum()
-                 << "\terror = " << error << endl;
-        #endif
+            dad_rms_error = getRMS(*dad, ref_response, type, scratch[0]);
+        }
 
+        if(design_callback_ && !design_callback_(count, rms_error)) break;
     }
 
-    cout << "count = " << count << "  RMS = " << rms_error << endl;
-
     // copy mom into the filter.
     *kernel_ = *mom;
 
@@ -596,7 +745,6 @@ designKernel(
         delete child[i];
     }
 
-    delete [] child;
     delete mom;
     delete dad;
 
@@ -696,16 +844,25 @@ operator=(const FilterIIR & rhs)
 
         n_poles_ = rhs.n_poles_;
 
-        x_history_ = new float64 [n_poles_];
-        y_history_ = new float64 [n_poles_];
+        x_history_ = new float64 [n_poles_ + 1];
+        x_end_ptr_ = x_history_ + n_poles_ + 1;
+
+        y_history_ = new float64 [n_poles_ + 1];
+        y_end_ptr_ = y_history_ + n_poles_ + 1;
     }
 
-    memcpy(x_history_, rhs.x_history_, sizeof(float64) * n_poles_);
-    memcpy(y_history_, rhs.y_history_, sizeof(float64) * n_poles_);
+    memcpy(x_history_, rhs.x_history_, sizeof(float64) * (n_poles_ + 1));
+    memcpy(y_history_, rhs.y_history_, sizeof(float64) * (n_poles_ + 1));
+
+    x_ptr_ = x_history_ + (rhs.x_ptr_ - rhs.x_history_);
+    y_ptr_ = y_history_ + (rhs.y_ptr_ - rhs.y_history_);
 
     *kernel_ = *rhs.kernel_;
     *rng_ = *rhs.rng_;
 
+    seed_ = rhs.seed_;
+    design_callback_ = rhs.design_callback_;
+
     return *this;
 }
 
@@ -719,6 +876,24 @@ operator<<(std::ostream & out,const FilterIIR & rhs)
     return out << *rhs.kernel_;
 }
 
+bool
+FilterIIR::
+evaluateResponse(const Buffer & frequencies, Buffer & real, Buffer & imag)
+{
+    if(kernel_ == NULL) return false;
+
+    multiplyResponse(
+        frequencies,
+        kernel_->getB(),
+        n_poles_,
+        kernel_->getA(),
+        n_poles_,
+        real,
+        imag);
+
+    return true;
+}
+
 void
 FilterIIR::
 reset()
@@ -35,7 +35,9 @@
 
 #include <Nsound/Filter.h>
 
+#include <functional>
 #include <set>
+#include <vector>
 
 namespace Nsound
 {
@@ -59,8 +61,28 @@ class FilterIIR : public Filter
 
     FilterIIR(const FilterIIR & copy);
 
+    Filter * clone() const { return new FilterIIR(*this); }
+
     virtual ~FilterIIR();
 
+    #ifndef SWIG
+    //! Called after every generation with the generation count and best RMS error, returning false stops the design early.
+    typedef std::function<bool (uint32 generation, float64 rms_error)> DesignCallback;
+
+    //! Sets the function called after every generation of designFrequencyResponse() and designImpulseResponse().
+    void
+    setDesignCallback(const DesignCallback & callback)
+    { design_callback_ = callback; };
+    #endif
+
+    //! Seeds the random number generators used by the design methods.
+    //
+    //! Every child of a generation is bred and scored independently with its
+    //! own generator derived from this seed, so the same seed always designs
+    //! the same kernel no matter how many threads evaluate the population.
+    void
+    setSeed(const uint32 seed);
+
     //! Designs a filter kernel using a genetic algorithm that trys to match the provided frequency response.
     //
     //! Designs a filter kernel that trys to match the provide frequency
@@ -129,6 +151,12 @@ class FilterIIR : public Filter
 
     protected:
 
+    bool
+    evaluateResponse(
+        const Buffer & frequencies,
+        Buffer & real,
+        Buffer & imag);
+
     enum SignalType
     {
         FREQUENCY_RESSPONSE = 0,
@@ -154,6 +182,22 @@ class FilterIIR : public Filter
         const Buffer &   response,
         const SignalType type);
 
+    //! Preallocated work space for scoring one kernel.
+    struct DesignScratch
+    {
+        std::vector<float64> impulse;
+        std::vector<float64> real;
+        std::vector<float64> imag;
+    };
+
+    //! Same as getRMS() above but simulates the kernel directly in scratch, it doesn't touch the filter state and doesn't allocate, so it may be called concurrently.
+    float64
+    getRMS(
+        const Kernel &   kernel,
+        const Buffer &   response,
+        const SignalType type,
+        DesignScratch &  scratch) const;
+
     void
     savePlot(
         const Kernel &  k,
@@ -175,6 +219,12 @@ class FilterIIR : public Filter
 
     RngTausworthe * rng_;
 
+    uint32 seed_;
+
+    #ifndef SWIG
+    DesignCallback design_callback_;
+    #endif
+
 };
 
 std::ostream &
@@ -692,6 +692,22 @@ plot(boolean show_fc, boolean show_phase)
     }
 }
 
+bool
+FilterLeastSquaresFIR::
+evaluateResponse(const Buffer & frequencies, Buffer & real, Buffer & imag)
+{
+    multiplyResponse(
+        frequencies,
+        b_,
+        kernel_size_,
+        NULL,
+        0,
+        real,
+        imag);
+
+    return true;
+}
+
 void
 FilterLeastSquaresFIR::
 reset()
@@ -58,6 +58,8 @@ class FilterLeastSquaresFIR : public Filter
 
     FilterLeastSquaresFIR(const FilterLeastSquaresFIR & copy);
 
+    Filter * clone() const { return new FilterLeastSquaresFIR(*this); }
+
     virtual ~FilterLeastSquaresFIR();
 
     Buffer
@@ -133,6 +135,12 @@ class FilterLeastSquaresFIR : public Filter
 
     protected:
 
+    bool
+    evaluateResponse(
+        const Buffer & frequencies,
+        Buffer & real,
+        Buffer & imag);
+
     float64 * b_;
     float64 * window_;
 
@@ -30,6 +30,7 @@
 #include <Nsound/Buffer.h>
 #include <Nsound/FilterLowPassFIR.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
 
 #include <cmath>
 #include <cstring>
@@ -151,6 +152,8 @@ Buffer
 FilterLowPassFIR::
 filter(const Buffer & x, const float64 & f)
 {
+    M_PROFILE_SAMPLES("FilterLowPassFIR::filter", x.getLength());
+
     // Instead of calling Filter::filter(x,f), we implement this function here
     // to avoid calling makeKernel(f) for each sample.
 
@@ -351,6 +354,22 @@ makeKernel(const float64 & cutoff_frequency_Hz)
 //~    }
 }
 
+bool
+FilterLowPassFIR::
+evaluateResponse(const Buffer & frequencies, Buffer & real, Buffer & imag)
+{
+    multiplyResponse(
+        frequencies,
+        b_,
+        kernel_size_,
+        NULL,
+        0,
+        real,
+        imag);
+
+    return true;
+}
+
 void
 FilterLowPassFIR::
 reset()
@@ -98,6 +98,12 @@ class FilterLowPassFIR : public Filter
 
     protected:
 
+    bool
+    evaluateResponse(
+        const Buffer & frequencies,
+        Buffer & real,
+        Buffer & imag);
+
     void
     makeKernel(const float64 & frequency1);
 
@@ -54,6 +54,8 @@ class FilterLowPassIIR : public FilterStageIIR
         const float64 & frequency,
         const float64 & percent_ripple = 0.0);
 
+    Filter * clone() const { return new FilterLowPassIIR(*this); }
+
     AudioStream
     filter(const AudioStream & x);
 
@@ -53,6 +53,8 @@ public:
 
     virtual ~FilterLowPassMoogVcf() {}
 
+    using Filter::filter;
+
     virtual
     float64
     filter(const float64 & x);
@@ -29,6 +29,7 @@
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
 #include <Nsound/FilterMedian.hpp>
+#include <Nsound/Profiler.h>
 
 
 namespace Nsound
@@ -44,14 +45,33 @@ uint32 keep_odd(uint32 n)
 
 
 FilterMedian::
-FilterMedian(uint32 n_samples_in_pool)
+FilterMedian(uint32 n_samples_in_pool, float64 percentile)
     :
     _h_ptr(0),
-    _median(n_samples_in_pool / 2),
+    _rank(0),
+    _percentile(percentile),
     _history(keep_odd(n_samples_in_pool), 0.0),
-    _pool(keep_odd(n_samples_in_pool), 0.0)
+    _lo(),
+    _hi(),
+    _heap_index(keep_odd(n_samples_in_pool), 0),
+    _in_lo(keep_odd(n_samples_in_pool), 0)
 {
     M_ASSERT_MSG(n_samples_in_pool >= 3, "n_samples_in_pool < 3! (" << n_samples_in_pool << ")");
+
+    M_ASSERT_MSG(
+        percentile >= 0.0 && percentile <= 100.0,
+        "percentile must be in [0, 100], got " << percentile);
+
+    uint32 n = static_cast<uint32>(_history.size());
+
+    _rank = static_cast<uint32>(percentile / 100.0 * (n - 1) + 0.5);
+
+    if(_rank > n - 1) _rank = n - 1;
+
+    _lo.resize(_rank + 1);
+    _hi.resize(n - _rank - 1);
+
+    fill(0.0);
 }
 
 
@@ -73,13 +93,20 @@ Buffer
 FilterMedian::
 filter(const Buffer & in)
 {
+    M_PROFILE_SAMPLES("FilterMedian::filter", in.getLength());
+
     M_ASSERT_MSG(in.getLength() > 0, "Oops, Buffer is empty!");
 
     fill(in[0]); // offline rendering only!
 
-    Buffer out(in.getLength());
+    uint32 n = in.getLength();
+
+    Buffer out = Buffer::zeros(n);
+
+    const float64 * x = in.getPointer();
+    float64 * y = out.getPointer();
 
-    for(auto x : in) out << filter(x);
+    for(uint32 i = 0; i < n; ++i) y[i] = filter(x[i]);
 
     return out;
 }
@@ -91,7 +118,90 @@ fill(float64 x)
 {
     _h_ptr = 0;
     std::fill(_history.begin(), _history.end(), x);
-    std::fill(_pool.begin(), _pool.end(), x);
+
+    // All values are equal, any assignment of slots is a valid heap.
+
+    uint32 slot = 0;
+
+    for(uint32 i = 0; i < _lo.size(); ++i, ++slot)
+    {
+        _lo[i] = slot;
+        _heap_index[slot] = i;
+        _in_lo[slot] = 1;
+    }
+
+    for(uint32 i = 0; i < _hi.size(); ++i, ++slot)
+    {
+        _hi[i] = slot;
+        _heap_index[slot] = i;
+        _in_lo[slot] = 0;
+    }
+}
+
+
+void
+FilterMedian::
+_sift_up(std::vector<uint32> & heap, uint32 i, bool is_max)
+{
+    uint32 slot = heap[i];
+    float64 value = _history[slot];
+
+    while(i > 0)
+    {
+        uint32 parent = (i - 1) / 2;
+
+        float64 pv = _history[heap[parent]];
+
+        if(is_max ? !(value > pv) : !(value < pv)) break;
+
+        heap[i] = heap[parent];
+        _heap_index[heap[i]] = i;
+
+        i = parent;
+    }
+
+    heap[i] = slot;
+    _heap_index[slot] = i;
+}
+
+
+void
+FilterMedian::
+_sift_down(std::vector<uint32> & heap, uint32 i, bool is_max)
+{
+    uint32 n = static_cast<uint32>(heap.size());
+    uint32 slot = heap[i];
+    float64 value = _history[slot];
+
+    while(true)
+    {
+        uint32 child = 2 * i + 1;
+
+        if(child >= n) break;
+
+        float64 cv = _history[heap[child]];
+
+        if(child + 1 < n)
+        {
+            float64 rv = _history[heap[child + 1]];
+
+            if(is_max ? rv > cv : rv < cv)
+            {
+                ++child;
+                cv = rv;
+            }
+        }
+
+        if(is_max ? !(cv > value) : !(cv < value)) break;
+
+        heap[i] = heap[child];
+        _heap_index[heap[i]] = i;
+
+        i = child;
+    }
+
+    heap[i] = slot;
+    _heap_index[slot] = i;
 }
 
 
@@ -99,31 +209,49 @@ float64
 FilterMedian::
 filter(const float64 & in)
 {
-    // _pool is always sorted
+    // Invariant: every value in _lo <= every value in _hi, so the top of
+    // _lo is the requested rank.
 
-    // step 1, remove oldest vaule from the pool.
+    // step 1, overwrite the oldest value with the new one.
 
-    auto last = _history[_h_ptr];
+    uint32 slot = _h_ptr;
 
-    auto last_pos = std::lower_bound(_pool.begin(), _pool.end(), last);
+    _history[slot] = in;
 
-    _pool.erase(last_pos);
+    _h_ptr = (_h_ptr + 1) % _history.size();
 
-    // step 2, insert new value into pool
+    // step 2, restore the heap the slot lives in.
 
-    auto insert_pos = std::lower_bound(_pool.begin(), _pool.end(), in);
+    if(_in_lo[slot])
+    {
+        _sift_up(_lo, _heap_index[slot], true);
+        _sift_down(_lo, _heap_index[slot], true);
+    }
+    else
+    {
+        _sift_up(_hi, _heap_index[slot], false);
+        _sift_down(_hi, _heap_index[slot], false);
+    }
 
-    _pool.insert(insert_pos, in);
+    // step 3, only the changed value can break the invariant, a single
+    // exchange of the two tops restores it.
 
-    // step 3, write input value into history.
+    if(!_hi.empty() && _history[_lo[0]] > _history[_hi[0]])
+    {
+        uint32 a = _lo[0];
+        uint32 b = _hi[0];
 
-    _history[_h_ptr] = in;
+        _lo[0] = b;
+        _in_lo[b] = 1;
 
-    _h_ptr = (_h_ptr + 1) % _history.size();
+        _hi[0] = a;
+        _in_lo[a] = 0;
 
-    // median is always the middle of the pool.
+        _sift_down(_lo, 0, true);
+        _sift_down(_hi, 0, false);
+    }
 
-    return _pool[_median];
+    return _history[_lo[0]];
 }
 
 
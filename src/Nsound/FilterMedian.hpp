@@ -43,11 +43,38 @@ class AudioStream;
 class Buffer;
 
 
+//-----------------------------------------------------------------------------
+//! A sliding window median (or any percentile) filter.
+//
+//! The window is kept in two indexed heaps, a max-heap holding the samples
+//! at or below the requested rank and a min-heap holding the rest.  Each new
+//! sample replaces the oldest one in place, so the per-sample cost is
+//! O(log N) and nothing is allocated after construction.  This makes windows
+//! of many thousands of samples practical.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! FilterMedian median(4097);             // median of 4097 samples
+//! FilterMedian lower(4097, 10.0);        // 10th percentile
+//!
+//! Buffer y = median.filter(x);
+//!
+//! // Python
+//! median = FilterMedian(4097)
+//! y = median.filter(x)
+//! \endcode
 class FilterMedian
 {
 public:
 
-    FilterMedian(uint32 n_samples_in_pool);
+    //! Creates the filter.
+    //
+    //! \param n_samples_in_pool the window length, even lengths are rounded
+    //!        up to the next odd length
+    //! \param percentile the rank to output in the range [0, 100], the
+    //!        default of 50 is the median
+    FilterMedian(uint32 n_samples_in_pool, float64 percentile = 50.0);
 
     AudioStream filter(const AudioStream & x);
 
@@ -57,13 +84,27 @@ public:
 
     void fill(float64 x);
 
+    float64 getPercentile() const { return _percentile; }
+
 protected:
 
+    void _sift_up(std::vector<uint32> & heap, uint32 i, bool is_max);
+    void _sift_down(std::vector<uint32> & heap, uint32 i, bool is_max);
+
     uint32               _h_ptr;
-    uint32               _median;
+    uint32               _rank;
+    float64              _percentile;
 
+    // The window, indexed by slot.
     std::vector<float64> _history;
-    std::vector<float64> _pool;
+
+    // Heaps of slots, _lo is a max-heap holding _rank + 1 slots.
+    std::vector<uint32>  _lo;
+    std::vector<uint32>  _hi;
+
+    // Position of each slot in its heap and which heap it is in.
+    std::vector<uint32>  _heap_index;
+    std::vector<uint8>   _in_lo;
 };
 
 
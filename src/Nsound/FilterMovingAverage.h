@@ -54,6 +54,8 @@ class FilterMovingAverage : public Filter
 
     FilterMovingAverage(const FilterMovingAverage & copy);
 
+    Filter * clone() const { return new FilterMovingAverage(*this); }
+
     //////////////////////////////////////////////////////////////////////////
     ~FilterMovingAverage();
 
@@ -30,6 +30,7 @@
 #include <Nsound/Buffer.h>
 #include <Nsound/FilterParametricEqualizer.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
 
 #include <cmath>
 #include <cstdio>
@@ -161,6 +162,8 @@ Buffer
 FilterParametricEqualizer::
 filter(const Buffer & x)
 {
+    M_PROFILE_SAMPLES("FilterParametricEqualizer::filter", x.getLength());
+
     reset();
 
     uint32 n_samples = x.getLength();
@@ -179,6 +182,8 @@ Buffer
 FilterParametricEqualizer::
 filter(const Buffer & x, const Buffer & frequencies)
 {
+    M_PROFILE_SAMPLES("FilterParametricEqualizer::filter", x.getLength());
+
     reset();
 
     uint32 n_samples = x.getLength();
@@ -28,11 +28,13 @@
 
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
-#include <Nsound/FilterAllPass.h>
 #include <Nsound/FilterPhaser.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
 #include <Nsound/Sine.h>
 
+#include <algorithm>
+#include <cmath>
 #include <stdio.h>
 #include <iostream>
 
@@ -42,6 +44,12 @@ using std::cerr;
 using std::cout;
 using std::endl;
 
+// Number of samples the LFOs are rendered ahead.
+static const uint32 BLOCK_SIZE = 256;
+
+// The all pass gain of every stage.
+static const float64 GAIN = 0.5;
+
 //-----------------------------------------------------------------------------
 FilterPhaser::
 FilterPhaser(
@@ -54,10 +62,14 @@ FilterPhaser(
     Filter(sample_rate),
     n_stages_(n_stages),
     max_delay_(max_delay_time_seconds),
-    filters_(NULL),
     frequencies_(),
     waveform_(NULL),
-    waveform_position_()
+    waveform_position_(),
+    n_history_(0),
+    write_index_(0),
+    x_history_(),
+    y_history_(),
+    delays_()
 {
     M_ASSERT_VALUE(n_stages_, >, 0);
     M_ASSERT_VALUE(frequency, >, 0.0);
@@ -74,8 +86,6 @@ FilterPhaser(
 
     if(max_delay_ <= 0.0) max_delay_ = 0.1;
 
-    filters_= new FilterAllPass * [n_stages_];
-
     waveform_ = new Buffer(static_cast<uint32>(sample_rate_));
 
     Sine sin(sample_rate_);
@@ -84,10 +94,18 @@ FilterPhaser(
 
     for(uint32 i = 0; i < n_stages_; ++i)
     {
-        filters_[i] = new FilterAllPass(sample_rate_, max_delay_, 0.5);
         waveform_position_.push_back(0.0);
         frequencies_.push_back(f + fstep * static_cast<float64>(i));
     }
+
+    // Same length as a FilterDelay with this maximum delay.
+    n_history_ = static_cast<uint32>(std::ceil(sample_rate_ * max_delay_)) + 1;
+
+    x_history_.resize(n_history_);
+    y_history_.resize(n_stages_ * n_history_);
+    delays_.resize(n_stages_ * BLOCK_SIZE);
+
+    reset();
 }
 
 //-----------------------------------------------------------------------------
@@ -97,21 +115,17 @@ FilterPhaser(const FilterPhaser & copy)
     Filter(copy.sample_rate_),
     n_stages_(copy.n_stages_),
     max_delay_(copy.max_delay_),
-    filters_(NULL),
     frequencies_(),
     waveform_(NULL),
-    waveform_position_(copy.waveform_position_)
+    waveform_position_(),
+    n_history_(0),
+    write_index_(0),
+    x_history_(),
+    y_history_(),
+    delays_()
 {
-    filters_= new FilterAllPass * [n_stages_];
-
     waveform_ = new Buffer(static_cast<uint32>(sample_rate_));
 
-    for(uint32 i = 0; i < n_stages_; ++i)
-    {
-        filters_[i] = new FilterAllPass(sample_rate_, max_delay_, 0.5);
-        waveform_position_.push_back(0.0);
-    }
-
     *this = copy;
 }
 
@@ -119,13 +133,6 @@ FilterPhaser(const FilterPhaser & copy)
 FilterPhaser::
 ~FilterPhaser()
 {
-    for(uint32 i = 0; i < n_stages_; ++i)
-    {
-        delete filters_[i];
-    }
-
-    delete [] filters_;
-
     delete waveform_;
 }
 
@@ -133,14 +140,55 @@ AudioStream
 FilterPhaser::
 filter(const AudioStream & x)
 {
-    return Filter::filter(x);
+    if(!is_realtime_) reset();
+
+    uint32 n_channels = x.getNChannels();
+
+    if(is_realtime_ && n_channels > 1)
+    {
+        M_THROW("In real-time mode, a filter per audio channel must be used!");
+    }
+
+    AudioStream y(x.getSampleRate(), n_channels);
+
+    auto function = [](Filter & f, const Buffer & b)
+    {
+        return static_cast<FilterPhaser &>(f).filter(b);
+    };
+
+    if(filterChannels(x, y, function)) return y;
+
+    for(uint32 channel = 0; channel < n_channels; ++channel)
+    {
+        y[channel] = filter(x[channel]);
+    }
+
+    return y;
 }
 
 Buffer
 FilterPhaser::
 filter(const Buffer & x)
 {
-    return Filter::filter(x);
+    M_PROFILE_SAMPLES("FilterPhaser::filter", x.getLength());
+
+    if(!is_realtime_) reset();
+
+    uint32 n = x.getLength();
+
+    // Filtered in place, filterBlock() reads each sample before writing it.
+    Buffer y(x);
+
+    for(uint32 i = 0; i < n; i += BLOCK_SIZE)
+    {
+        uint32 n_block = std::min(BLOCK_SIZE, n - i);
+
+        renderDelays(n_block);
+
+        filterBlock(y.getPointer() + i, y.getPointer() + i, n_block);
+    }
+
+    return y;
 }
 
 float64
@@ -149,23 +197,85 @@ filter(const float64 & x)
 {
     float64 y = 0.0;
 
+    renderDelays(1);
+
+    filterBlock(&x, &y, 1);
+
+    return y;
+}
+
+void
+FilterPhaser::
+renderDelays(const uint32 n_samples)
+{
+    const float64 * waveform = waveform_->getPointer();
+
+    // Stage i of sample j lives at delays_[j * n_stages_ + i].
     for(uint32 i = 0; i < n_stages_; ++i)
     {
-        float64 pos = waveform_position_[i]
-                    + frequencies_[i];
+        float64 pos = waveform_position_[i];
+        const float64 freq = frequencies_[i];
 
-        if(pos >= sample_rate_) pos -= sample_rate_;
+        uint32 * d = delays_.data() + i;
 
-        waveform_position_[i] = pos;
+        for(uint32 j = 0; j < n_samples; ++j, d += n_stages_)
+        {
+            pos += freq;
+
+            if(pos >= sample_rate_) pos -= sample_rate_;
 
-        float64 f = (*waveform_)[static_cast<uint32>(pos)];
+            float64 delay = waveform[static_cast<uint32>(pos)] * max_delay_;
+
+            if(delay > max_delay_) delay = max_delay_;
+            else if(delay < 0.0)   delay = 0.0;
+
+            *d = static_cast<uint32>(sample_rate_ * delay);
+        }
 
-        y += filters_[i]->filter(x, f * max_delay_);
+        waveform_position_[i] = pos;
     }
+}
+
+void
+FilterPhaser::
+filterBlock(const float64 * x, float64 * y, const uint32 n_samples)
+{
+    const float64 n_stages = static_cast<float64>(n_stages_);
 
-    y /= static_cast<float64>(n_stages_);
+    float64 * x_hist = x_history_.data();
+
+    for(uint32 j = 0; j < n_samples; ++j)
+    {
+        const float64 xn = x[j];
+        const uint32 w = write_index_;
+        const uint32 * d = delays_.data() + j * n_stages_;
+
+        x_hist[w] = xn;
+
+        float64 sum = 0.0;
+
+        float64 * y_hist = y_history_.data();
+
+        // y[n] = g * x[n] + x[n - d] - g * y[n - 1 - d], one all pass per
+        // stage.  y[n - 1 - d] is read before y[n] overwrites the slot.
+        for(uint32 i = 0; i < n_stages_; ++i, y_hist += n_history_)
+        {
+            uint32 rx = w >= d[i] ? w - d[i] : w + n_history_ - d[i];
+            uint32 ry = rx > 0 ? rx - 1 : n_history_ - 1;
+
+            float64 yi = GAIN * xn + x_hist[rx] - GAIN * y_hist[ry];
+
+            y_hist[w] = yi;
+
+            sum += yi;
+        }
 
-    return (y+x) / 2.0;
+        sum /= n_stages;
+
+        y[j] = (sum + xn) / 2.0;
+
+        if(++write_index_ >= n_history_) write_index_ = 0;
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -179,34 +289,16 @@ operator=(const FilterPhaser & rhs)
     }
 
     sample_rate_       = rhs.sample_rate_;
+    n_stages_          = rhs.n_stages_;
     max_delay_         = rhs.max_delay_;
     *waveform_         = *rhs.waveform_;
     frequencies_       = rhs.frequencies_;
     waveform_position_ = rhs.waveform_position_;
-
-    if(n_stages_ != rhs.n_stages_)
-    {
-        for(uint32 i = 0; i < n_stages_; ++i)
-        {
-            delete filters_[i];
-        }
-
-        delete [] filters_;
-
-        n_stages_ = rhs.n_stages_;
-
-        filters_ = new FilterAllPass * [n_stages_];
-
-        for(uint32 i = 0; i < n_stages_; ++i)
-        {
-            filters_[i] = new FilterAllPass(sample_rate_, max_delay_, 0.5);
-        }
-    }
-
-    for(uint32 i = 0; i < n_stages_; ++i)
-    {
-        *filters_[i] = *rhs.filters_[i];
-    }
+    n_history_         = rhs.n_history_;
+    write_index_       = rhs.write_index_;
+    x_history_         = rhs.x_history_;
+    y_history_         = rhs.y_history_;
+    delays_            = rhs.delays_;
 
     return *this;
 }
@@ -246,9 +338,9 @@ void
 FilterPhaser::
 reset()
 {
-    for(uint32 i = 0; i < n_stages_; ++i)
-    {
-        filters_[i]->reset();
-        waveform_position_[i] = 0.0;
-    }
+    std::fill(x_history_.begin(), x_history_.end(), 0.0);
+    std::fill(y_history_.begin(), y_history_.end(), 0.0);
+    std::fill(waveform_position_.begin(), waveform_position_.end(), 0.0);
+
+    write_index_ = 0;
 }
@@ -41,11 +41,14 @@ namespace Nsound
 // Forward class declarations
 class AudioStream;
 class Buffer;
-class FilterAllPass;
-class Generator;
 
 //-----------------------------------------------------------------------------
 //! A class for filtering audio in the frequecy domain.
+//
+//! Each stage is an all pass filter whose delay is swept by its own LFO.
+//! All stages share one input history and keep their output histories in
+//! one contiguous array, the LFOs are rendered for a whole block of samples
+//! before the stages run.
 class FilterPhaser : public Filter
 {
     public:
@@ -59,6 +62,8 @@ class FilterPhaser : public Filter
 
     FilterPhaser(const FilterPhaser & copy);
 
+    Filter * clone() const { return new FilterPhaser(*this); }
+
     ~FilterPhaser();
 
     AudioStream
@@ -85,13 +90,32 @@ class FilterPhaser : public Filter
 
     protected:
 
+    //! Advances the LFOs n_samples, storing each stage's delay in samples.
+    void
+    renderDelays(const uint32 n_samples);
+
+    //! Filters n_samples using the delays from renderDelays().
+    void
+    filterBlock(const float64 * x, float64 * y, const uint32 n_samples);
+
     uint32               n_stages_;
     float64              max_delay_;
-    FilterAllPass **     filters_;
     std::vector<float64> frequencies_;
     Buffer *             waveform_;
     std::vector<float64> waveform_position_;
 
+    // Delay line length in samples, same for every stage.
+    uint32               n_history_;
+    uint32               write_index_;
+
+    // The stages all see the same input, so they share one input history.
+    std::vector<float64> x_history_;
+
+    // n_stages_ output histories of n_history_ samples each.
+    std::vector<float64> y_history_;
+
+    // Block scratch, n_stages_ delays per sample.
+    std::vector<uint32>  delays_;
 
 };
 
@@ -31,6 +31,7 @@
 #include <Nsound/FilterBandPassIIR.h>
 #include <Nsound/FilterDelay.h>
 #include <Nsound/FilterSlinky.h>
+#include <Nsound/Profiler.h>
 
 using namespace Nsound;
 
@@ -160,6 +161,8 @@ Buffer
 FilterSlinky::
 filter(const Buffer & x)
 {
+    M_PROFILE_SAMPLES("FilterSlinky::filter", x.getLength());
+
     Buffer y;
 
     uint32 n_samples = x.getLength();
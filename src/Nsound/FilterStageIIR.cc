@@ -29,6 +29,7 @@
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
 #include <Nsound/FilterStageIIR.h>
+#include <Nsound/Profiler.h>
 
 #include <cmath>
 #include <string.h>
@@ -61,7 +62,14 @@ FilterStageIIR(
     y_history_(NULL),
     y_ptr_(NULL),
     y_end_ptr_(NULL),
-    kernel_cache_()
+    frequency_resolution_(1.0),
+    is_interpolating_(false),
+    kernel_frequency_(0.0),
+    is_kernel_blended_(false),
+    kernel_low_(),
+    kernel_high_(),
+    a_interp_(),
+    b_interp_()
 {
     if(n_poles_ > 20)
     {
@@ -85,6 +93,9 @@ FilterStageIIR(
     y_ptr_     = y_history_;
     y_end_ptr_ = y_history_ + n_poles_ + 1;
 
+    a_interp_.resize(n_poles_ + 1);
+    b_interp_.resize(n_poles_ + 1);
+
     reset();
 }
 
@@ -94,7 +105,7 @@ FilterStageIIR(const FilterStageIIR & copy)
     :
     Filter(copy.sample_rate_),
     type_(copy.type_),
-    n_poles_(copy.n_poles_),
+    n_poles_(0), // So operator=() allocates the history.
     frequency_(copy.frequency_),
     percent_ripple_(copy.percent_ripple_),
     a_(NULL),
@@ -105,7 +116,14 @@ FilterStageIIR(const FilterStageIIR & copy)
     y_history_(NULL),
     y_ptr_(NULL),
     y_end_ptr_(NULL),
-    kernel_cache_()
+    frequency_resolution_(1.0),
+    is_interpolating_(false),
+    kernel_frequency_(0.0),
+    is_kernel_blended_(false),
+    kernel_low_(),
+    kernel_high_(),
+    a_interp_(),
+    b_interp_()
 {
     *this = copy;
 }
@@ -116,16 +134,6 @@ FilterStageIIR::
 {
     delete [] x_history_;
     delete [] y_history_;
-
-    FilterStageIIR::KernelCache::iterator itor = kernel_cache_.begin();
-    FilterStageIIR::KernelCache::iterator end = kernel_cache_.end();
-
-    while(itor != end)
-    {
-        delete [] itor->b_;
-        delete [] itor->a_;
-        ++itor;
-    }
 }
 
 AudioStream
@@ -161,6 +169,8 @@ Buffer
 FilterStageIIR::
 filter(const Buffer & x, const float64 & f)
 {
+    M_PROFILE_SAMPLES("FilterStageIIR::filter", x.getLength());
+
     // Instead of calling Filter::filter(x,f), we implement this function here
     // to avoid calling makeKernel(f) for each sample.
 
@@ -203,35 +213,15 @@ operator=(const FilterStageIIR & rhs)
     frequency_      = rhs.frequency_;
     percent_ripple_ = rhs.percent_ripple_;
 
-    // Clear the kernal cache.
-    KernelCache::iterator itor = kernel_cache_.begin();
+    frequency_resolution_ = rhs.frequency_resolution_;
+    is_interpolating_     = rhs.is_interpolating_;
 
-    while(itor != kernel_cache_.end())
-    {
-        delete [] itor->b_;
-        delete [] itor->a_;
-        ++itor;
-    }
+    // Kernels are shared through the cache, reset() will look them up again.
+    kernel_low_.reset();
+    kernel_high_.reset();
 
-    kernel_cache_.clear();
-
-    // Copy kernal cache.
-    itor = rhs.kernel_cache_.begin();
-    while(itor != rhs.kernel_cache_.end())
-    {
-        Kernel new_kernel(static_cast<uint32>(itor->frequency_));
-
-        // Allocate new kernel memory.
-        new_kernel.b_ = new float64 [n_poles_ + 1];
-        new_kernel.a_ = new float64 [n_poles_ + 1];
-
-        // Copy values.
-        memcpy(new_kernel.b_, itor->b_, sizeof(float64) * (n_poles_ + 1));
-        memcpy(new_kernel.a_, itor->a_, sizeof(float64) * (n_poles_ + 1));
-
-        // Insert into cache.
-        kernel_cache_.insert(new_kernel);
-    }
+    a_ = NULL;
+    b_ = NULL;
 
     // Setup history memory.
     if(n_poles_orig != rhs.n_poles_)
@@ -248,11 +238,30 @@ operator=(const FilterStageIIR & rhs)
         y_end_ptr_ = y_history_ + n_poles_ + 1;
     }
 
+    a_interp_.resize(n_poles_ + 1);
+    b_interp_.resize(n_poles_ + 1);
+
     reset();
 
     return *this;
 }
 
+bool
+FilterStageIIR::
+evaluateResponse(const Buffer & frequencies, Buffer & real, Buffer & imag)
+{
+    multiplyResponse(
+        frequencies,
+        b_,
+        n_poles_ + 1,
+        a_,
+        n_poles_ + 1,
+        real,
+        imag);
+
+    return true;
+}
+
 void
 FilterStageIIR::
 reset()
@@ -284,7 +293,7 @@ filter(const float64 & x)
 
     float64 y = 0.0;
     float64 * x_hist = x_ptr_;
-    for(float64 * b = b_; b != b_ + n_poles_ + 1; ++b)
+    for(const float64 * b = b_; b != b_ + n_poles_ + 1; ++b)
     {
         // When we enter this loop, x_hist is pointing at x[n + 1]
         --x_hist;
@@ -299,7 +308,7 @@ filter(const float64 & x)
     }
 
     float64 * y_hist = y_ptr_;
-    for(float64 * a = a_ + 1; a != a_ + n_poles_ + 1; ++a)
+    for(const float64 * a = a_ + 1; a != a_ + n_poles_ + 1; ++a)
     {
         // When we enter this loop, y_hist is pointing at y[n + 1]
         --y_hist;
@@ -341,61 +350,157 @@ void
 FilterStageIIR::
 makeKernel(const float64 & frequency)
 {
-    FilterStageIIR::
-    Kernel new_kernel(static_cast<uint32>(frequency));
+    bool is_current = a_ != NULL && !is_kernel_blended_;
 
-    // See if the kernel is in the cache.
+    if(is_current && frequency == kernel_frequency_) return;
 
-    FilterStageIIR::
-    KernelCache::const_iterator itor = kernel_cache_.find(new_kernel);
+    float64 f_low = frequency_resolution_
+        * std::floor(frequency / frequency_resolution_);
 
-    if(itor != kernel_cache_.end())
+    float64 t = (frequency - f_low) / frequency_resolution_;
+
+    bool is_same_low = is_current &&
+        f_low == frequency_resolution_
+            * std::floor(kernel_frequency_ / frequency_resolution_);
+
+    kernel_frequency_ = frequency;
+    is_kernel_blended_ = false;
+
+    if(!is_interpolating_ || t <= 0.0)
     {
-        b_ = itor->b_;
-        a_ = itor->a_;
+        // Snap down to the cached kernel, same as the old 1 Hz cache.
+        if(is_same_low && !kernel_high_) return;
+
+        kernel_low_ = getKernel(f_low);
+        kernel_high_.reset();
+
+        b_ = kernel_low_->b_.data();
+        a_ = kernel_low_->a_.data();
 
         return;
     }
 
-    // Allocate new kernel.
-    new_kernel.b_ = new float64 [n_poles_ + 1];
-    new_kernel.a_ = new float64 [n_poles_ + 1];
+    // Only go to the shared cache when crossing a resolution step.
+    if(!is_same_low || !kernel_high_)
+    {
+        kernel_low_  = getKernel(f_low);
+        kernel_high_ = getKernel(f_low + frequency_resolution_);
+    }
+
+    blendKernels(t);
+}
+
+void
+FilterStageIIR::
+blendKernels(const float64 & t)
+{
+    const float64 * b0 = kernel_low_->b_.data();
+    const float64 * a0 = kernel_low_->a_.data();
+    const float64 * b1 = kernel_high_->b_.data();
+    const float64 * a1 = kernel_high_->a_.data();
+
+    for(uint32 i = 0; i <= n_poles_; ++i)
+    {
+        b_interp_[i] = b0[i] + t * (b1[i] - b0[i]);
+        a_interp_[i] = a0[i] + t * (a1[i] - a0[i]);
+    }
+
+    b_ = b_interp_.data();
+    a_ = a_interp_.data();
+}
+
+bool
+FilterStageIIR::
+interpolateKernel(
+    const float64 & f_begin,
+    const float64 & f_end,
+    const float64 & t)
+{
+    // The cache is only consulted at the start of each control period.
+    if(t == 0.0)
+    {
+        kernel_low_ = getKernel(
+            frequency_resolution_
+                * std::floor(f_begin / frequency_resolution_));
+
+        kernel_high_ = getKernel(
+            frequency_resolution_
+                * std::floor(f_end / frequency_resolution_));
+
+        // a_ & b_ no longer match any single frequency, a later
+        // makeKernel() starts over from f_begin.
+        kernel_frequency_ = f_begin;
+        is_kernel_blended_ = true;
+
+        if(kernel_low_ == kernel_high_)
+        {
+            b_ = kernel_low_->b_.data();
+            a_ = kernel_low_->a_.data();
+        }
+    }
+
+    if(kernel_low_ != kernel_high_) blendKernels(t);
+
+    return true;
+}
 
-    b_ = new_kernel.b_;
-    a_ = new_kernel.a_;
+IIRKernelCache::KernelPtr
+FilterStageIIR::
+getKernel(const float64 & frequency)
+{
+    IIRKernelCache & cache = IIRKernelCache::getInstance();
 
-    // No kernel in cache, must make it.
+    IIRKernelCache::Key key(
+        static_cast<int32>(type_),
+        n_poles_,
+        percent_ripple_,
+        sample_rate_,
+        frequency);
+
+    IIRKernelCache::KernelPtr kernel = cache.find(key);
+
+    if(kernel) return kernel;
+
+    // Not in the cache, must make it.
+    std::shared_ptr<IIRKernelCache::Kernel> new_kernel(
+        new IIRKernelCache::Kernel());
+
+    new_kernel->b_.resize(n_poles_ + 1);
+    new_kernel->a_.resize(n_poles_ + 1);
+
+    float64 * b = new_kernel->b_.data();
+    float64 * a = new_kernel->a_.data();
 
     if(type_ == LOW_PASS && frequency < 1.0)
     {
         // create no pass filter
-        memset(new_kernel.b_, 0, sizeof(float64) * (n_poles_ + 1));
-        memset(new_kernel.a_, 0, sizeof(float64) * (n_poles_ + 1));
+        memset(b, 0, sizeof(float64) * (n_poles_ + 1));
+        memset(a, 0, sizeof(float64) * (n_poles_ + 1));
     }
 
     else if(type_ == LOW_PASS && frequency >= (sample_rate_ / 2.0))
     {
         // create all pass
-        memset(new_kernel.b_, 0, sizeof(float64) * (n_poles_ + 1));
-        memset(new_kernel.a_, 0, sizeof(float64) * (n_poles_ + 1));
+        memset(b, 0, sizeof(float64) * (n_poles_ + 1));
+        memset(a, 0, sizeof(float64) * (n_poles_ + 1));
 
-        b_[0] = 1.0;
+        b[0] = 1.0;
     }
 
     else if(type_ == HIGH_PASS && frequency < 1.0)
     {
         // create all pass
-        memset(new_kernel.b_, 0, sizeof(float64) * (n_poles_ + 1));
-        memset(new_kernel.a_, 0, sizeof(float64) * (n_poles_ + 1));
+        memset(b, 0, sizeof(float64) * (n_poles_ + 1));
+        memset(a, 0, sizeof(float64) * (n_poles_ + 1));
 
-        b_[0] = 1.0;
+        b[0] = 1.0;
     }
 
     else if(type_ == HIGH_PASS && frequency >= (sample_rate_ / 2.0))
     {
         // create no pass filter
-        memset(new_kernel.b_, 0, sizeof(float64) * (n_poles_ + 1));
-        memset(new_kernel.a_, 0, sizeof(float64) * (n_poles_ + 1));
+        memset(b, 0, sizeof(float64) * (n_poles_ + 1));
+        memset(a, 0, sizeof(float64) * (n_poles_ + 1));
     }
 
     else
@@ -461,12 +566,36 @@ makeKernel(const float64 & frequency)
             B[i] /= gain;
         }
 
-        memcpy(b_, B, sizeof(float64) * (n_poles_ + 1));
-        memcpy(a_, A, sizeof(float64) * (n_poles_ + 1));
+        memcpy(b, B, sizeof(float64) * (n_poles_ + 1));
+        memcpy(a, A, sizeof(float64) * (n_poles_ + 1));
     }
 
-    // Add the new kernel to the cache.
-    kernel_cache_.insert(new_kernel);
+    return cache.insert(key, new_kernel);
+}
+
+void
+FilterStageIIR::
+setFrequencyResolution(const float64 & resolution_Hz)
+{
+    M_ASSERT_VALUE(resolution_Hz, >, 0.0);
+
+    frequency_resolution_ = resolution_Hz;
+
+    // Force a new lookup.
+    a_ = NULL;
+
+    makeKernel(kernel_frequency_);
+}
+
+void
+FilterStageIIR::
+setInterpolation(bool flag)
+{
+    is_interpolating_ = flag;
+
+    a_ = NULL;
+
+    makeKernel(kernel_frequency_);
 }
 
 void
@@ -475,7 +604,7 @@ makeIIRKernelHelper(
     const float64 & frequency,
     float64 * b,
     float64 * a,
-    uint32 p)
+    uint32 p) const
 {
     float64 n_poles = static_cast<float64>(n_poles_);
 
@@ -591,22 +720,3 @@ makeIIRKernelHelper(
     */
 }
 
-//-----------------------------------------------------------------------------
-FilterStageIIR::
-Kernel::
-Kernel(const uint32 & frequency)
-    :
-    b_(NULL),
-    a_(NULL),
-    frequency_(frequency)
-{
-}
-
-bool
-FilterStageIIR::
-Kernel::
-operator<(const Kernel & rhs) const
-{
-    return frequency_ <  rhs.frequency_;
-}
-
@@ -34,8 +34,9 @@
 #define _NSOUND_FILTER_STAGE_IIR_H_
 
 #include <Nsound/Filter.h>
+#include <Nsound/IIRKernelCache.h>
 
-#include <set>
+#include <vector>
 
 namespace Nsound
 {
@@ -65,6 +66,8 @@ class FilterStageIIR : public Filter
 
     FilterStageIIR(const FilterStageIIR & copy);
 
+    Filter * clone() const { return new FilterStageIIR(*this); }
+
     virtual ~FilterStageIIR();
 
     AudioStream
@@ -94,6 +97,26 @@ class FilterStageIIR : public Filter
     void
     makeKernel(const float64 & frequency);
 
+    //! Returns the frequency quantization step of the kernel cache in Hz.
+    float64
+    getFrequencyResolution() const { return frequency_resolution_; };
+
+    //! Sets the frequency quantization step of the kernel cache in Hz.
+    //
+    //! Kernels are designed at multiples of the resolution and shared with
+    //! every other filter with the same type, poles, ripple and sample rate
+    //! through IIRKernelCache.  The default is 1 Hz.
+    void
+    setFrequencyResolution(const float64 & resolution_Hz);
+
+    //! Linearly interpolate the coefficients between cached kernels.
+    //
+    //! When enabled, frequencies between two multiples of the resolution
+    //! blend the neighboring kernels instead of snapping down to the lower
+    //! one, so a coarse resolution can still sweep smoothly.
+    void
+    setInterpolation(bool flag);
+
     FilterStageIIR &
     operator=(const FilterStageIIR & rhs);
 
@@ -102,20 +125,44 @@ class FilterStageIIR : public Filter
 
     protected:
 
+    friend class FilterBank;
+
+    bool
+    evaluateResponse(
+        const Buffer & frequencies,
+        Buffer & real,
+        Buffer & imag);
+
+    bool
+    interpolateKernel(
+        const float64 & f_begin,
+        const float64 & f_end,
+        const float64 & t);
+
+    //! Points a_ & b_ at kernel_low_ + t * (kernel_high_ - kernel_low_).
+    void
+    blendKernels(const float64 & t);
+
+    #ifndef SWIG
+    //! Returns the shared kernel designed at the quantized frequency.
+    IIRKernelCache::KernelPtr
+    getKernel(const float64 & frequency);
+    #endif
+
     void
     makeIIRKernelHelper(
         const float64 & frequency,
         float64 * a,
         float64 * b,
-        uint32 p);
+        uint32 p) const;
 
     Type    type_;
     uint32  n_poles_;
     float64 frequency_;
     float64 percent_ripple_;
 
-    float64 * a_;
-    float64 * b_;
+    const float64 * a_;
+    const float64 * b_;
 
     float64 * x_history_;
     float64 * x_ptr_;
@@ -125,23 +172,21 @@ class FilterStageIIR : public Filter
     float64 * y_ptr_;
     float64 * y_end_ptr_;
 
-    #ifndef SWIG
-    //! A class to store calculated kernels.
-    struct Kernel
-    {
-        Kernel(const uint32 & frequency);
+    float64 frequency_resolution_;
+    bool    is_interpolating_;
 
-        bool operator<(const Kernel & rhs) const;
+    // The last frequency a kernel was made for.
+    float64 kernel_frequency_;
 
-        float64 * b_;
-        float64 * a_;
+    // True when interpolateKernel() blended a_ & b_ between two frequencies.
+    bool is_kernel_blended_;
 
-        uint32 frequency_;
-    };
-
-    typedef std::set<Kernel> KernelCache;
+    #ifndef SWIG
+    IIRKernelCache::KernelPtr kernel_low_;
+    IIRKernelCache::KernelPtr kernel_high_;
 
-    KernelCache kernel_cache_;
+    std::vector<float64> a_interp_;
+    std::vector<float64> b_interp_;
     #endif
 };
 
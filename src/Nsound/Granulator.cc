@@ -35,15 +35,17 @@
 #include <Nsound/Buffer.h>
 #include <Nsound/Generator.h>
 #include <Nsound/Granulator.h>
-#include <Nsound/Sine.h>
+#include <Nsound/Profiler.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 
 using namespace Nsound;
 
 using std::cerr;
 using std::endl;
-
 ///////////////////////////////////////////////////////////////////////////
 Granulator::
 Granulator(
@@ -53,12 +55,11 @@ Granulator(
     const Buffer   * custom_envelope)
     :
     sample_rate_(sample_rate),
-    envelope_generator_(NULL)
-//     sine_(new Sine(sample_rate_)),
-//     current_time_(0.0),
-//     next_grain_time_(0.0),
-//     last_grain_time_(0.0),
-//     time_step_(1.0 / sample_rate_)
+    sine_(),
+    envelope_(),
+    pool_size_(0),
+    stream_(),
+    block_()
 {
     Generator gen(sample_rate_);
 
@@ -74,101 +75,88 @@ Granulator(
                      << ", length is "
                      << custom_envelope->getLength());
 
-                envelope_generator_ =
-                    new Generator(
-                        sample_rate_,
-                        gen.drawGaussian(1.0, 0.5, 0.33333)
-                          * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+                envelope_ = gen.drawGaussian(1.0, 0.5, 0.33333)
+                    * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             }
             else
             {
-                envelope_generator_ =
-                    new Generator(
-                        sample_rate_,
-                        (*custom_envelope)
-                            * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+                envelope_ = (*custom_envelope)
+                    * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             }
             break;
         }
 
         case Granulator::GAUSSIAN:
         {
-            envelope_generator_ = new Generator(
-                sample_rate_,
-                gen.drawGaussian(1.0, 0.5, 0.33333)
-                    * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+            envelope_ = gen.drawGaussian(1.0, 0.5, 0.33333)
+                * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             break;
         }
 
         case Granulator::GAUSSIAN_90:
         {
-            envelope_generator_ = new Generator(
-                sample_rate_,
-                gen.drawFatGaussian(1.0, 0.90)
-                    * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+            envelope_ = gen.drawFatGaussian(1.0, 0.90)
+                * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             break;
         }
 
         case Granulator::GAUSSIAN_70:
         {
-            envelope_generator_ = new Generator(
-                sample_rate_,
-                gen.drawFatGaussian(1.0, 0.70)
-                    * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+            envelope_ = gen.drawFatGaussian(1.0, 0.70)
+                * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             break;
         }
 
         case Granulator::GAUSSIAN_50:
         {
-            envelope_generator_ = new Generator(
-                sample_rate_,
-                gen.drawFatGaussian(1.0, 0.50)
-                    * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+            envelope_ = gen.drawFatGaussian(1.0, 0.50)
+                * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             break;
         }
 
         case Granulator::GAUSSIAN_30:
         {
-            envelope_generator_ = new Generator(
-                sample_rate_,
-                gen.drawFatGaussian(1.0, 0.30)
-                    * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+            envelope_ = gen.drawFatGaussian(1.0, 0.30)
+                * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             break;
         }
 
         case Granulator::GAUSSIAN_10:
         {
-            envelope_generator_ = new Generator(
-                sample_rate_,
-                gen.drawFatGaussian(1.0, 0.10)
-                    * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+            envelope_ = gen.drawFatGaussian(1.0, 0.10)
+                * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             break;
         }
 
         case Granulator::DECAY:
         {
-            Buffer waveform(static_cast<uint32>(sample_rate_));
-
-            waveform << gen.drawDecay(1.0);
-
-            Buffer noise = 1.0 + envelope_noise * gen.whiteNoise(1.0);
-
-            envelope_generator_ = new Generator(
-                sample_rate_,
-                gen.drawDecay(1.0)
-                    * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+            envelope_ = gen.drawDecay(1.0)
+                * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             break;
         }
 
         case Granulator::REVERSE_DECAY:
         {
-            envelope_generator_ = new Generator(
-                sample_rate_,
-                gen.drawDecay(1.0).getReverse()
-                    * (1.0 + envelope_noise * gen.whiteNoise(1.0)));
+            envelope_ = gen.drawDecay(1.0).getReverse()
+                * (1.0 + envelope_noise * gen.whiteNoise(1.0));
             break;
         }
     }
+
+    // The grains index both tables with the same one second period.
+    sine_ = gen.drawSine(1.0, 1.0);
+
+    if(envelope_.getLength() != sample_rate_
+        || sine_.getLength() != sample_rate_)
+    {
+        M_THROW("Granulator(): the envelope length must equal "
+             << sample_rate_
+             << ", length is "
+             << envelope_.getLength());
+    }
+
+    setGrainPoolSize(1024);
+    reset();
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -176,7 +164,11 @@ Granulator::
 Granulator(const Nsound::Granulator & gran)
     :
     sample_rate_(gran.sample_rate_),
-    envelope_generator_(NULL)
+    sine_(),
+    envelope_(),
+    pool_size_(0),
+    stream_(),
+    block_()
 {
     *this = gran;
 }
@@ -185,111 +177,345 @@ Granulator(const Nsound::Granulator & gran)
 Granulator::
 ~Granulator()
 {
-    delete envelope_generator_;
 }
 
-Buffer
+uint32
 Granulator::
-generate(
-    const float64 & duration,
-    const float64 & grain_frequency,
-    const float64 & waves_per_grain,
-    const float64 & grains_per_second)
+getNActiveGrains() const
+{
+    uint32 n = 0;
+
+    for(const auto & g : stream_.grains)
+    {
+        if(g.n_samples > 0) ++n;
+    }
+
+    return n;
+}
+
+void
+Granulator::
+setGrainPoolSize(const uint32 n_grains)
+{
+    M_ASSERT_VALUE(n_grains, >, 0);
+
+    pool_size_ = n_grains;
+
+    stream_.grains.reserve(pool_size_);
+}
+
+void
+Granulator::
+reset()
+{
+    stream_.grains.clear();
+    stream_.position = 0;
+    stream_.next_onset = 0.0;
+    stream_.n_grains = 0;
+    stream_.n_dropped = 0;
+}
+
+void
+Granulator::
+_renderGrain(Grain & g, float64 * y, const uint32 n_samples) const
 {
-    Sine sin(sample_rate_);
+    const uint32 n = std::min(n_samples, g.n_samples);
 
-    float64 time_step = 1.0 / sample_rate_;
+    const float64 * sine = sine_.getPointer();
+    const float64 * env = envelope_.getPointer();
 
-    Buffer y(4096);
+    const float64 sr = sample_rate_;
 
-    for(float64 last_g_time = 0.0, current_time = 0.0, next_grain_time = 0.0;
-        current_time < duration;
-        current_time += time_step)
+    float64 pos = g.position;
+    float64 base = g.base;
+    float64 env_pos = g.env_position;
+    float64 env_base = g.env_base;
+
+    // Same nearest sample lookup as Generator::generate(), the positions
+    // are never wrapped so the samples match it exactly, only the
+    // multiple of the table length subtracted from them is tracked.
+    for(uint32 i = 0; i < n; ++i)
     {
-        // Output a pulse.
-        if(next_grain_time - current_time < time_step)
+        float64 p = pos + 0.5 - base;
+        while(p >= sr)
+        {
+            p -= sr;
+            base += sr;
+        }
+
+        float64 e = env_pos + 0.5 - env_base;
+        while(e >= sr)
         {
-            float64 g_duration  = waves_per_grain / grain_frequency;
+            e -= sr;
+            env_base += sr;
+        }
+
+        y[i] += sine[static_cast<uint32>(p)] * env[static_cast<uint32>(e)];
 
-            Buffer grain(4096);
+        pos += g.frequency;
+        env_pos += g.env_frequency;
+    }
+
+    g.position = pos;
+    g.base = base;
+    g.env_position = env_pos;
+    g.env_base = env_base;
+    g.n_samples -= n;
+}
+
+void
+Granulator::
+_render(
+    Stream & s,
+    float64 * y,
+    const uint32 n_samples,
+    const bool spawn,
+    const float64 * grain_frequency,
+    const uint32 gf_length,
+    const float64 * waves_per_grain,
+    const uint32 wpg_length,
+    const float64 * grains_per_second,
+    const uint32 gps_length) const
+{
+    M_PROFILE_SAMPLES("Granulator::_render", n_samples);
 
-            grain <<  sin.generate(g_duration, grain_frequency)
-                    * envelope_generator_->generate(g_duration, 1.0 / g_duration);
+    std::memset(y, 0, sizeof(float64) * n_samples);
 
-            y.add(grain, static_cast<uint32>(current_time * sample_rate_));
+    // Continue the grains started in earlier blocks.
+    for(size_t i = 0; i < s.grains.size(); )
+    {
+        _renderGrain(s.grains[i], y, n_samples);
 
-            last_g_time = current_time;
+        if(s.grains[i].n_samples == 0)
+        {
+            s.grains[i] = s.grains.back();
+            s.grains.pop_back();
         }
+        else
+        {
+            ++i;
+        }
+    }
+
+    const uint64 end = s.position + n_samples;
+
+    // Jump from onset to onset, a grain starts at the first sample at or
+    // after its onset.
+    while(spawn && s.next_onset <= static_cast<float64>(end - 1))
+    {
+        uint64 onset = static_cast<uint64>(std::ceil(s.next_onset));
+
+        float64 gps = grains_per_second[onset % gps_length];
+
+        if(gps <= 0.0)
+        {
+            s.next_onset = static_cast<float64>(onset + 1);
+            continue;
+        }
+
+        s.next_onset += sample_rate_ / gps;
+
+        float64 gf  = grain_frequency[s.n_grains % gf_length];
+        float64 wpg = waves_per_grain[s.n_grains % wpg_length];
+
+        ++s.n_grains;
+
+        float64 duration = wpg / gf;
+
+        M_ASSERT_VALUE(duration, >, 0.0);
 
-        next_grain_time = last_g_time + (1.0 / grains_per_second);
+        Grain g;
+
+        g.position      = 0.0;
+        g.base          = 0.0;
+        g.frequency     = gf;
+        g.env_position  = 0.0;
+        g.env_base      = 0.0;
+        g.env_frequency = 1.0 / duration;
+        g.n_samples     = static_cast<uint32>(
+            std::ceil(duration * sample_rate_));
+
+        g.end           = onset + g.n_samples;
+
+        // A grain holds its slot until its last sample, so the same grains
+        // are dropped whatever the block size.
+        if(s.grains.size() >= pool_size_)
+        {
+            for(size_t i = 0; i < s.grains.size(); )
+            {
+                if(s.grains[i].end <= onset)
+                {
+                    s.grains[i] = s.grains.back();
+                    s.grains.pop_back();
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+
+            if(s.grains.size() >= pool_size_)
+            {
+                ++s.n_dropped;
+                continue;
+            }
+        }
+
+        uint32 offset = static_cast<uint32>(onset - s.position);
+
+        _renderGrain(g, y + offset, n_samples - offset);
+
+        s.grains.push_back(g);
     }
 
-    return y;
+    s.position = end;
 }
 
 Buffer
 Granulator::
-generate(
+_generate(
     const float64 & duration,
-    const Buffer & grain_frequency,
-    const Buffer & waves_per_grain,
-    const Buffer & grains_per_second) const
+    const float64 * grain_frequency,
+    const uint32 gf_length,
+    const float64 * waves_per_grain,
+    const uint32 wpg_length,
+    const float64 * grains_per_second,
+    const uint32 gps_length) const
 {
-    Sine sin(sample_rate_);
+    M_ASSERT_VALUE(duration, >, 0.0);
+    M_ASSERT_VALUE(gf_length, >, 0);
+    M_ASSERT_VALUE(wpg_length, >, 0);
+    M_ASSERT_VALUE(gps_length, >, 0);
 
-    uint32 gf_length  = grain_frequency.getLength();
-    uint32 wpg_length = waves_per_grain.getLength();
-    uint32 gps_length = grains_per_second.getLength();
+    Stream s;
 
-    uint32 gf_index = 0;
-    uint32 wpg_index = 0;
-    uint32 gps_index = 0;
+    s.grains.reserve(pool_size_);
+    s.position = 0;
+    s.next_onset = 0.0;
+    s.n_grains = 0;
+    s.n_dropped = 0;
 
-    float64 time_step = 1.0 / sample_rate_;
+    uint32 n_samples = static_cast<uint32>(std::ceil(duration * sample_rate_));
 
-    Buffer y;
+    FloatVector y(n_samples);
 
-    for(float64 last_g_time = 0.0, current_time = 0.0, next_grain_time = 0.0;
-        current_time < duration;
-        current_time += time_step)
+    if(n_samples > 0)
     {
+        _render(
+            s, &y[0], n_samples, true,
+            grain_frequency, gf_length,
+            waves_per_grain, wpg_length,
+            grains_per_second, gps_length);
+    }
 
-        float64 gps =
-            grains_per_second[gps_index++ % gps_length];
+    // Let the last grains ring out.
+    uint32 n_tail = 0;
 
-        // Output a pulse.
-        if(next_grain_time - current_time < time_step)
-        {
-            float64 g_frequency = grain_frequency[gf_index++  % gf_length];
-            float64 wpg         = waves_per_grain[wpg_index++ % wpg_length];
+    for(const auto & g : s.grains) n_tail = std::max(n_tail, g.n_samples);
 
-            float64 g_duration  = wpg / g_frequency;
+    if(n_tail > 0)
+    {
+        y.resize(n_samples + n_tail);
 
-            Buffer grain =
-                sin.generate(g_duration,g_frequency)
-                * envelope_generator_->generate(g_duration, 1.0 / g_duration);
+        _render(
+            s, &y[n_samples], n_tail, false,
+            grain_frequency, gf_length,
+            waves_per_grain, wpg_length,
+            grains_per_second, gps_length);
+    }
 
-            y.add(grain, static_cast<uint32>(current_time * sample_rate_));
+    return Buffer(y);
+}
 
-            last_g_time = current_time;
-        }
+Buffer
+Granulator::
+generate(
+    const float64 & duration,
+    const float64 & grain_frequency,
+    const float64 & waves_per_grain,
+    const float64 & grains_per_second)
+{
+    return _generate(
+        duration,
+        &grain_frequency, 1,
+        &waves_per_grain, 1,
+        &grains_per_second, 1);
+}
 
-        next_grain_time = last_g_time + (1.0 / gps);
-    }
+Buffer
+Granulator::
+generate(
+    const float64 & duration,
+    const Buffer & grain_frequency,
+    const Buffer & waves_per_grain,
+    const Buffer & grains_per_second) const
+{
+    return _generate(
+        duration,
+        grain_frequency.getPointer(), grain_frequency.getLength(),
+        waves_per_grain.getPointer(), waves_per_grain.getLength(),
+        grains_per_second.getPointer(), grains_per_second.getLength());
+}
+
+void
+Granulator::
+generateBlock(
+    float64 * y,
+    const uint32 n_samples,
+    const float64 & grain_frequency,
+    const float64 & waves_per_grain,
+    const float64 & grains_per_second)
+{
+    M_CHECK_PTR(y);
 
-    return y;
+    _render(
+        stream_, y, n_samples, true,
+        &grain_frequency, 1,
+        &waves_per_grain, 1,
+        &grains_per_second, 1);
 }
 
+const Buffer &
+Granulator::
+generateBlock(
+    const uint32 n_samples,
+    const float64 & grain_frequency,
+    const float64 & waves_per_grain,
+    const float64 & grains_per_second)
+{
+    if(block_.getLength() != n_samples)
+    {
+        block_ = Buffer(FloatVector(n_samples, 0.0));
+    }
+
+    if(n_samples > 0)
+    {
+        generateBlock(
+            block_.getPointer(),
+            n_samples,
+            grain_frequency,
+            waves_per_grain,
+            grains_per_second);
+    }
+
+    return block_;
+}
 
 ///////////////////////////////////////////////////////////////////////////
 Granulator &
 Granulator::
 operator=(const Granulator & rhs)
 {
-    delete envelope_generator_;
+    if(this == &rhs) return *this;
 
     sample_rate_ = rhs.sample_rate_;
-    envelope_generator_ = new Generator(*rhs.envelope_generator_);
+    sine_        = rhs.sine_;
+    envelope_    = rhs.envelope_;
+    pool_size_   = rhs.pool_size_;
+    stream_      = rhs.stream_;
+
+    // Copies don't keep the capacity.
+    stream_.grains.reserve(pool_size_);
 
     return *this;
 }
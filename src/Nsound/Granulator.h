@@ -34,19 +34,43 @@
 #define _NSOUND_GRANULATOR_H_
 
 #include <Nsound/Nsound.h>
+#include <Nsound/Buffer.h>
+
+#include <vector>
 
 namespace Nsound
 {
 
-// Forwared declarion of Nsound::Buffer
-class Buffer;
-class Generator;
-class Sine;
-
 //////////////////////////////////////////////////////////////////////////////
 //  Granulator Class
 //
-// DOXME
+//! Generates clouds of enveloped sine grains.
+//
+//! Grain onsets are scheduled directly from the grains per second rather
+//! than by stepping time one sample at a time, and every grain is read
+//! from one shared sine table and one shared envelope table straight into
+//! the output, so dense clouds of thousands of overlapping grains render
+//! without allocating memory per grain.  The grains that are still
+//! sounding live in a preallocated pool, see setGrainPoolSize().
+//!
+//! generateBlock() streams the cloud a block at a time, grains that
+//! overlap the end of a block continue in the next.
+//
+//! \par Example:
+//! \code
+//! // C++
+//! Granulator gran(44100.0, Granulator::GAUSSIAN_30);
+//!
+//! Buffer y = gran.generate(5.0, 180.0, 2.0, 1200.0);
+//!
+//! // Streaming
+//! gran.reset();
+//!
+//! for(uint32 i = 0; i < 100; ++i)
+//! {
+//!     pb.play(gran.generateBlock(512, 180.0 + i, 2.0, 1200.0));
+//! }
+//! \endcode
 //////////////////////////////////////////////////////////////////////////////
 class Granulator
 {
@@ -90,7 +114,10 @@ class Granulator
     //////////////////////////////////////////////////////////////////////////
     //  generate()
     //
-    // DOXME
+    //! Generates duration seconds of grains.
+    //
+    //! The first grain starts at sample 0.  The returned Buffer also holds
+    //! the tails of the grains still sounding at the end of duration.
     //////////////////////////////////////////////////////////////////////////
     Nsound::Buffer
     generate(
@@ -102,7 +129,11 @@ class Granulator
     //////////////////////////////////////////////////////////////////////////
     //  generate()
     //
-    // DOXME
+    //! Generates duration seconds of grains with dynamic parameters.
+    //
+    //! grain_frequency and waves_per_grain are read once per grain,
+    //! grains_per_second is read at each grain onset sample, all three
+    //! wrap around when they are shorter than needed.
     //////////////////////////////////////////////////////////////////////////
     Nsound::Buffer
     generate(
@@ -111,6 +142,68 @@ class Granulator
         const Nsound::Buffer & waves_per_grain,
         const Nsound::Buffer & grains_per_second) const;
 
+    //////////////////////////////////////////////////////////////////////////
+    //  generateBlock()
+    //
+    //! Generates the next n_samples of the grain stream.
+    //
+    //! The returned reference is valid until the next call.  The
+    //! parameters are held for the whole block.
+    //////////////////////////////////////////////////////////////////////////
+    const Nsound::Buffer &
+    generateBlock(
+        const uint32 n_samples,
+        const float64 & grain_frequency,
+        const float64 & waves_per_grain,
+        const float64 & grains_per_second);
+
+    #ifndef SWIG
+    //////////////////////////////////////////////////////////////////////////
+    //  generateBlock()
+    //
+    //! Writes the next n_samples of the grain stream into y.
+    //////////////////////////////////////////////////////////////////////////
+    void
+    generateBlock(
+        float64 * y,
+        const uint32 n_samples,
+        const float64 & grain_frequency,
+        const float64 & waves_per_grain,
+        const float64 & grains_per_second);
+    #endif
+
+    //////////////////////////////////////////////////////////////////////////
+    //! Returns the number of grains still sounding in the grain stream.
+    //////////////////////////////////////////////////////////////////////////
+    uint32
+    getNActiveGrains() const;
+
+    //////////////////////////////////////////////////////////////////////////
+    //! Returns the number of grains dropped from the grain stream since reset().
+    //////////////////////////////////////////////////////////////////////////
+    uint64
+    getNDroppedGrains() const { return stream_.n_dropped; }
+
+    //////////////////////////////////////////////////////////////////////////
+    //! Preallocates room for n_grains overlapping grains, the default is 1024.
+    //
+    //! The pool never grows while rendering, so call this before streaming.
+    //! A grain that starts while n_grains grains are sounding is dropped and
+    //! counted by getNDroppedGrains().  generate() uses a pool of the same
+    //! size.
+    //////////////////////////////////////////////////////////////////////////
+    void
+    setGrainPoolSize(const uint32 n_grains);
+
+    uint32
+    getGrainPoolSize() const { return pool_size_; }
+
+    //////////////////////////////////////////////////////////////////////////
+    //! Silences the grain stream, the next block starts with a grain.
+    //////////////////////////////////////////////////////////////////////////
+    void
+    reset();
+
     //////////////////////////////////////////////////////////////////////////
     //! Assignment operator.
     //////////////////////////////////////////////////////////////////////////
@@ -120,9 +213,70 @@ class Granulator
     protected:
     Granulator();
 
+    struct Grain
+    {
+        float64 position;      // Sine table position.
+        float64 base;          // Sine table wraps so far, times the length.
+        float64 frequency;
+        float64 env_position;
+        float64 env_base;
+        float64 env_frequency;
+        uint32  n_samples;     // Samples left to render.
+        uint64  end;           // The sample after the last, since reset.
+    };
+
+    struct Stream
+    {
+        std::vector<Grain> grains;
+        uint64  position;      // Samples rendered since reset.
+        float64 next_onset;    // In samples since reset.
+        uint64  n_grains;      // Grains started since reset.
+        uint64  n_dropped;     // Grains dropped since reset, the pool was full.
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Renders n_samples of the stream into y, new grains are only started
+    // when spawn is true.  The parameters are indexed circularly.
+    //////////////////////////////////////////////////////////////////////////
+    void
+    _render(
+        Stream & stream,
+        float64 * y,
+        const uint32 n_samples,
+        const bool spawn,
+        const float64 * grain_frequency,
+        const uint32 gf_length,
+        const float64 * waves_per_grain,
+        const uint32 wpg_length,
+        const float64 * grains_per_second,
+        const uint32 gps_length) const;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Adds up to n_samples of the grain to y.
+    //////////////////////////////////////////////////////////////////////////
+    void
+    _renderGrain(Grain & grain, float64 * y, const uint32 n_samples) const;
+
+    Nsound::Buffer
+    _generate(
+        const float64 & duration,
+        const float64 * grain_frequency,
+        const uint32 gf_length,
+        const float64 * waves_per_grain,
+        const uint32 wpg_length,
+        const float64 * grains_per_second,
+        const uint32 gps_length) const;
+
     float64 sample_rate_;
 
-    Generator * envelope_generator_;
+    Buffer sine_;
+    Buffer envelope_;
+
+    uint32 pool_size_;
+
+    Stream stream_;
+
+    Buffer block_;
 
 };//Granulators
 
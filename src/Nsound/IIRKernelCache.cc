@@ -0,0 +1,204 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: IIRKernelCache.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/IIRKernelCache.h>
+
+namespace Nsound
+{
+
+
+bool
+IIRKernelCache::Key::
+operator<(const Key & rhs) const
+{
+    if(type_ != rhs.type_) return type_ < rhs.type_;
+    if(n_poles_ != rhs.n_poles_) return n_poles_ < rhs.n_poles_;
+    if(percent_ripple_ != rhs.percent_ripple_)
+    {
+        return percent_ripple_ < rhs.percent_ripple_;
+    }
+    if(sample_rate_ != rhs.sample_rate_) return sample_rate_ < rhs.sample_rate_;
+
+    return frequency_ < rhs.frequency_;
+}
+
+
+IIRKernelCache::
+IIRKernelCache()
+    :
+    mutex_(),
+    capacity_(4096),
+    n_hits_(0),
+    n_misses_(0),
+    lru_(),
+    entries_()
+{
+}
+
+
+IIRKernelCache &
+IIRKernelCache::
+getInstance()
+{
+    // Leaked on purpose, filters with static storage may still release
+    // kernels after other static objects were destroyed.
+    static IIRKernelCache * instance = new IIRKernelCache();
+
+    return *instance;
+}
+
+
+IIRKernelCache::KernelPtr
+IIRKernelCache::
+find(const Key & key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    EntryMap::iterator itor = entries_.find(key);
+
+    if(itor == entries_.end())
+    {
+        ++n_misses_;
+        return KernelPtr();
+    }
+
+    ++n_hits_;
+
+    lru_.splice(lru_.begin(), lru_, itor->second.lru);
+
+    return itor->second.kernel;
+}
+
+
+IIRKernelCache::KernelPtr
+IIRKernelCache::
+insert(const Key & key, const KernelPtr & kernel)
+{
+    M_ASSERT_MSG(static_cast<bool>(kernel), "kernel is empty");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    EntryMap::iterator itor = entries_.find(key);
+
+    if(itor != entries_.end())
+    {
+        lru_.splice(lru_.begin(), lru_, itor->second.lru);
+        return itor->second.kernel;
+    }
+
+    lru_.push_front(key);
+
+    Entry & entry = entries_[key];
+
+    entry.kernel = kernel;
+    entry.lru = lru_.begin();
+
+    _evict();
+
+    return kernel;
+}
+
+
+void
+IIRKernelCache::
+clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    lru_.clear();
+    entries_.clear();
+    n_hits_ = 0;
+    n_misses_ = 0;
+}
+
+
+uint32
+IIRKernelCache::
+getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+
+void
+IIRKernelCache::
+setCapacity(const uint32 n_kernels)
+{
+    M_ASSERT_VALUE(n_kernels, >, 0);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    capacity_ = n_kernels;
+
+    _evict();
+}
+
+
+uint32
+IIRKernelCache::
+getSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<uint32>(entries_.size());
+}
+
+
+uint64
+IIRKernelCache::
+getNHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return n_hits_;
+}
+
+
+uint64
+IIRKernelCache::
+getNMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return n_misses_;
+}
+
+
+void
+IIRKernelCache::
+_evict()
+{
+    while(entries_.size() > capacity_)
+    {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+
+} // namespace
+
+// :mode=c++: jEdit modeline
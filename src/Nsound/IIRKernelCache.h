@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: IIRKernelCache.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_IIR_KERNEL_CACHE_H_
+#define _NSOUND_IIR_KERNEL_CACHE_H_
+
+#include <Nsound/Nsound.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Nsound
+{
+
+//-----------------------------------------------------------------------------
+//! A process wide, thread safe, least recently used cache of IIR kernels.
+//
+//! Filters that design their coefficients from a handful of parameters
+//! (FilterLowPassIIR, FilterHighPassIIR, FilterBandPassIIR) share their
+//! designs through this cache, so many voices using the same filter only
+//! design each kernel once.  Kernels are handed out as shared pointers, an
+//! evicted kernel stays alive until the last filter using it lets go.
+class IIRKernelCache
+{
+    public:
+
+    //! Returns the cache shared by all filters.
+    static
+    IIRKernelCache &
+    getInstance();
+
+    #ifndef SWIG
+
+    //! The cache key, the frequency is already quantized by the caller.
+    struct Key
+    {
+        Key(
+            const int32 type,
+            const uint32 n_poles,
+            const float64 & percent_ripple,
+            const float64 & sample_rate,
+            const float64 & frequency)
+            :
+            type_(type),
+            n_poles_(n_poles),
+            percent_ripple_(percent_ripple),
+            sample_rate_(sample_rate),
+            frequency_(frequency)
+        {}
+
+        bool operator<(const Key & rhs) const;
+
+        int32   type_;
+        uint32  n_poles_;
+        float64 percent_ripple_;
+        float64 sample_rate_;
+        float64 frequency_;
+    };
+
+    //! Feed forward and feedback coefficients.
+    struct Kernel
+    {
+        std::vector<float64> b_;
+        std::vector<float64> a_;
+    };
+
+    typedef std::shared_ptr<const Kernel> KernelPtr;
+
+    //! Returns the cached kernel or an empty pointer.
+    KernelPtr
+    find(const Key & key);
+
+    //! Adds the kernel, returns the kernel now cached under key.
+    //
+    //! If another thread inserted the same key first its kernel is kept and
+    //! returned, so every filter shares one copy.
+    KernelPtr
+    insert(const Key & key, const KernelPtr & kernel);
+
+    #endif
+
+    //! Removes all kernels.
+    void
+    clear();
+
+    //! The maximum number of kernels held, the least recently used are evicted.
+    uint32
+    getCapacity() const;
+
+    //! Sets the maximum number of kernels held, must be > 0.
+    void
+    setCapacity(const uint32 n_kernels);
+
+    uint32
+    getSize() const;
+
+    uint64
+    getNHits() const;
+
+    uint64
+    getNMisses() const;
+
+    private:
+
+    IIRKernelCache();
+    IIRKernelCache(const IIRKernelCache & copy);
+    IIRKernelCache & operator=(const IIRKernelCache & rhs);
+
+    #ifndef SWIG
+
+    void _evict();
+
+    typedef std::list<Key> LruList;
+
+    struct Entry
+    {
+        KernelPtr         kernel;
+        LruList::iterator lru;
+    };
+
+    typedef std::map<Key, Entry> EntryMap;
+
+    mutable std::mutex mutex_;
+
+    uint32 capacity_;
+    uint64 n_hits_;
+    uint64 n_misses_;
+
+    // Most recently used at the front.
+    LruList  lru_;
+    EntryMap entries_;
+
+    #endif
+
+}; // class IIRKernelCache
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -53,6 +53,8 @@ class Instrument
 
     Instrument(const float64 & sample_rate):sample_rate_(sample_rate){};
 
+    float64 getSampleRate() const { return sample_rate_; }
+
     virtual
     ~Instrument(){};
 
@@ -0,0 +1,447 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: KarplusStrong.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/Buffer.h>
+#include <Nsound/KarplusStrong.h>
+#include <Nsound/Profiler.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Nsound;
+
+// Strings rendered side by side.
+static const uint32 LANES = 4;
+
+// The loop's FilterDC feedback gain, as in Pluck.
+static const float64 DC_GAIN = 0.99;
+
+// A string below -140 dB for a whole period is freed.
+static const float64 SILENCE = 1e-7;
+
+//-----------------------------------------------------------------------------
+KarplusStrong::
+KarplusStrong(
+    const float64 & sample_rate,
+    const uint32 n_strings,
+    const float64 & lowest_frequency,
+    const uint32 n_smooth_samples)
+    :
+    sample_rate_(sample_rate),
+    release_time_(0.05),
+    n_strings_(n_strings),
+    n_padded_(0),
+    n_smooth_(n_smooth_samples),
+    max_period_(0),
+    mask_(0),
+    max_excitation_(0),
+    rng_(),
+    ring_(),
+    excitation_(),
+    period_(),
+    write_(),
+    position_(),
+    length_(),
+    tail_(),
+    tone_b_(),
+    tone_a_(),
+    tone_y_(),
+    dc_x_(),
+    dc_y_(),
+    damping_(),
+    peak_(),
+    n_quiet_(),
+    started_(),
+    active_(),
+    clock_(0)
+{
+    M_ASSERT_VALUE(sample_rate, >, 0.0);
+    M_ASSERT_VALUE(n_strings, >, 0);
+    M_ASSERT_VALUE(lowest_frequency, >, 0.0);
+
+    max_period_ = static_cast<uint32>(
+        sample_rate_ * (1.0 / lowest_frequency) + 0.5);
+
+    uint32 size = 1;
+
+    while(size < max_period_ + 1) size <<= 1;
+
+    mask_ = size - 1;
+
+    max_excitation_ = max_period_;
+
+    if(n_smooth_ >= 2) max_excitation_ += n_smooth_;
+
+    n_padded_ = (n_strings_ + LANES - 1) / LANES * LANES;
+
+    ring_.resize(n_padded_ * size, 0.0);
+
+    // One extra excitation holds the raw noise burst.
+    excitation_.resize((n_padded_ + 1) * max_excitation_, 0.0);
+
+    period_.resize(n_padded_, 1);
+    write_.resize(n_padded_, 0);
+    position_.resize(n_padded_, 0);
+    length_.resize(n_padded_, 0);
+    tail_.resize(n_padded_, 0.0);
+    tone_b_.resize(n_padded_, 0.0);
+    tone_a_.resize(n_padded_, 0.0);
+    tone_y_.resize(n_padded_, 0.0);
+    dc_x_.resize(n_padded_, 0.0);
+    dc_y_.resize(n_padded_, 0.0);
+    damping_.resize(n_padded_, 1.0);
+    peak_.resize(n_padded_, 0.0);
+    n_quiet_.resize(n_padded_, 0);
+    started_.resize(n_padded_, 0);
+    active_.resize(n_padded_, false);
+}
+
+void
+KarplusStrong::
+clear(const uint32 string)
+{
+    float64 * ring = ring_.data() + string * (mask_ + 1);
+
+    std::fill(ring, ring + mask_ + 1, 0.0);
+
+    write_[string] = 0;
+    position_[string] = 0;
+    length_[string] = 0;
+    tail_[string] = 0.0;
+    tone_y_[string] = 0.0;
+    dc_x_[string] = 0.0;
+    dc_y_[string] = 0.0;
+    damping_[string] = 1.0;
+    peak_[string] = 0.0;
+    n_quiet_[string] = 0;
+    active_[string] = false;
+}
+
+uint32
+KarplusStrong::
+getNActive() const
+{
+    return static_cast<uint32>(
+        std::count(active_.begin(), active_.end(), true));
+}
+
+bool
+KarplusStrong::
+isActive(const uint32 string) const
+{
+    M_ASSERT_VALUE(string, <, n_strings_);
+
+    return active_[string];
+}
+
+uint32
+KarplusStrong::
+noteOn(
+    const float64 & frequency,
+    const float64 & amplitude,
+    const float64 & sustain)
+{
+    M_ASSERT_VALUE(frequency, >, 0.0);
+    M_ASSERT_VALUE(sustain, >, 0.0);
+
+    uint32 period = static_cast<uint32>(
+        sample_rate_ * (1.0 / frequency) + 0.5);
+
+    // The excitation slots are only max_period_ long.
+    M_ASSERT_MSG(
+        period >= 1 && period <= max_period_,
+        "frequency " << frequency << " Hz is out of range, the lowest "
+        "frequency is " << sample_rate_ / max_period_ << " Hz");
+
+    // A free string, or steal the oldest.
+    uint32 s = 0;
+
+    for(uint32 i = 1; i < n_strings_; ++i)
+    {
+        if(active_[s] && (!active_[i] || started_[i] < started_[s])) s = i;
+    }
+
+    clear(s);
+
+    // The Pluck excitation: a noise burst one period long, smoothed and
+    // normalized.
+    uint32 length = period;
+
+    if(n_smooth_ >= 2) length += n_smooth_;
+
+    float64 * noise = excitation_.data() + n_padded_ * max_excitation_;
+    float64 * x = excitation_.data() + s * max_excitation_;
+
+    for(uint32 i = 0; i < length; ++i)
+    {
+        noise[i] = i < period ? rng_.get(-1.0, 1.0) * 2.0 : 0.0;
+    }
+
+    smooth(noise, x, length, n_smooth_);
+
+    float64 peak = x[0];
+
+    for(uint32 i = 0; i < length; ++i)
+    {
+        float64 t = std::fabs(x[i]);
+        if(t > peak) peak = t;
+    }
+
+    float64 scale = amplitude;
+
+    if(peak != 0.0) scale = amplitude / peak;
+
+    for(uint32 i = 0; i < length; ++i) x[i] *= scale;
+
+    // The smoothing leaves a small constant behind, it keeps exciting the
+    // string like it does in Pluck.
+    if(n_smooth_ >= 2) tail_[s] = x[length - 1];
+
+    // The loop's FilterTone.
+    float64 hp = 14.0 * frequency * sustain;
+
+    float64 temp = 2.0 - ::cos(2.0 * M_PI / sample_rate_ * hp);
+
+    tone_a_[s] = -1.0 * (temp - ::sqrt(temp * temp - 1.0));
+    tone_b_[s] = 1.0 + tone_a_[s];
+
+    period_[s] = period;
+    length_[s] = length;
+    started_[s] = clock_;
+    active_[s] = true;
+
+    // The first sample primes the delay line.
+    ring_[s * (mask_ + 1)] = x[0];
+    write_[s] = 1;
+
+    return s;
+}
+
+void
+KarplusStrong::
+noteOff(const uint32 string)
+{
+    M_ASSERT_VALUE(string, <, n_strings_);
+
+    if(!active_[string]) return;
+
+    // The signal passes the damping once per period.
+    float64 n_passes = release_time_ * sample_rate_ / period_[string];
+
+    damping_[string] = std::pow(10.0, -3.0 / n_passes);
+    position_[string] = length_[string];
+    tail_[string] = 0.0;
+}
+
+Buffer
+KarplusStrong::
+render(const uint32 n_samples)
+{
+    Buffer y(n_samples);
+
+    for(uint32 i = 0; i < n_samples; ++i) y << 0.0;
+
+    render(y.getPointer(), n_samples);
+
+    return y;
+}
+
+void
+KarplusStrong::
+render(float64 * y, const uint32 n_samples)
+{
+    M_PROFILE_SAMPLES("KarplusStrong::render", n_samples);
+
+    std::fill(y, y + n_samples, 0.0);
+
+    const uint32 size = mask_ + 1;
+    const uint32 mask = mask_;
+
+    for(uint32 g = 0; g < n_padded_; g += LANES)
+    {
+        bool any = false;
+
+        for(uint32 l = 0; l < LANES; ++l) any = any || active_[g + l];
+
+        if(!any) continue;
+
+        float64 * ring[LANES];
+        const float64 * x[LANES];
+
+        uint32  period[LANES];
+        uint32  write[LANES];
+        uint32  position[LANES];
+        uint32  length[LANES];
+        float64 tail[LANES];
+        float64 b[LANES];
+        float64 a[LANES];
+        float64 tone_y[LANES];
+        float64 dc_x[LANES];
+        float64 dc_y[LANES];
+        float64 damping[LANES];
+        float64 peak[LANES];
+
+        for(uint32 l = 0; l < LANES; ++l)
+        {
+            uint32 s = g + l;
+
+            ring[l]     = ring_.data() + s * size;
+            x[l]        = excitation_.data() + s * max_excitation_;
+            period[l]   = period_[s];
+            write[l]    = write_[s];
+            position[l] = position_[s];
+            length[l]   = length_[s];
+            tail[l]     = tail_[s];
+            b[l]        = tone_b_[s];
+            a[l]        = tone_a_[s];
+            tone_y[l]   = tone_y_[s];
+            dc_x[l]     = dc_x_[s];
+            dc_y[l]     = dc_y_[s];
+            damping[l]  = damping_[s];
+            peak[l]     = 0.0;
+        }
+
+        // Read, FilterTone, FilterDC, excite and write back, for every lane.
+        for(uint32 i = 0; i < n_samples; ++i)
+        {
+            float64 sum = 0.0;
+
+            for(uint32 l = 0; l < LANES; ++l)
+            {
+                float64 r = ring[l][(write[l] - period[l]) & mask];
+
+                float64 t = b[l] * r - a[l] * tone_y[l];
+
+                float64 d = t - dc_x[l] + DC_GAIN * dc_y[l];
+
+                tone_y[l] = t;
+                dc_x[l] = t;
+                dc_y[l] = d;
+
+                float64 e = tail[l];
+
+                if(position[l] < length[l]) e = x[l][position[l]++];
+
+                ring[l][write[l]] = e + damping[l] * d;
+
+                write[l] = (write[l] + 1) & mask;
+
+                sum += d;
+
+                peak[l] = std::max(peak[l], std::fabs(d));
+            }
+
+            y[i] += sum;
+        }
+
+        for(uint32 l = 0; l < LANES; ++l)
+        {
+            uint32 s = g + l;
+
+            write_[s]    = write[l];
+            position_[s] = position[l];
+            tone_y_[s]   = tone_y[l];
+            dc_x_[s]     = dc_x[l];
+            dc_y_[s]     = dc_y[l];
+
+            if(!active_[s]) continue;
+
+            // Free the string once it has been quiet for a whole period.
+            if(position[l] < length[l] || peak[l] >= SILENCE)
+            {
+                n_quiet_[s] = 0;
+                continue;
+            }
+
+            n_quiet_[s] += n_samples;
+
+            if(n_quiet_[s] >= period[l]) clear(s);
+        }
+    }
+
+    clock_ += n_samples;
+}
+
+void
+KarplusStrong::
+reset()
+{
+    for(uint32 s = 0; s < n_padded_; ++s) clear(s);
+
+    clock_ = 0;
+}
+
+void
+KarplusStrong::
+setReleaseTime(const float64 & seconds)
+{
+    M_ASSERT_VALUE(seconds, >, 0.0);
+
+    release_time_ = seconds;
+}
+
+void
+KarplusStrong::
+smooth(
+    const float64 * x,
+    float64 * y,
+    const uint32 n_samples,
+    const uint32 n_smooth_samples)
+{
+    if(n_smooth_samples < 2)
+    {
+        memcpy(y, x, sizeof(float64) * n_samples);
+        return;
+    }
+
+    // Same arithmetic as FilterMovingAverage, whose history starts out
+    // filled with the first sample.
+    const float64 n = static_cast<float64>(n_smooth_samples);
+
+    float64 sum = 0.0;
+
+    for(uint32 i = 0; i < n_samples; ++i)
+    {
+        if(i == 0)
+        {
+            sum += (n - 1.0) * x[0];
+            sum += x[0] - x[0];
+        }
+        else
+        {
+            float64 last = i >= n_smooth_samples ? x[i - n_smooth_samples]
+                                                 : x[0];
+            sum += x[i] - last;
+        }
+
+        y[i] = sum / n;
+    }
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,214 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: KarplusStrong.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_KARPLUS_STRONG_H_
+#define _NSOUND_KARPLUS_STRONG_H_
+
+#include <Nsound/Nsound.h>
+#include <Nsound/RngTausworthe.h>
+
+#include <vector>
+
+namespace Nsound
+{
+
+class Buffer;
+
+//-----------------------------------------------------------------------------
+//! Renders many Karplus-Strong plucked strings at once, one block at a time.
+//
+//! Every string is the Pluck string model: a noise burst one period long,
+//! smoothed and normalized, circulating through a delay line, a FilterTone
+//! and a FilterDC.  All memory is allocated by the constructor, plucking and
+//! rendering never allocate, so notes can be started and stopped in
+//! real-time between blocks.
+//!
+//! The strings are processed in groups of 4 lanes, every sample runs the
+//! fused loop filter chain of all 4 strings side by side.  The strings of a
+//! group are independent, so their recursions overlap instead of waiting
+//! on each other.
+//!
+//! When every string is busy noteOn() steals the oldest one.  A string is
+//! freed once its output stays below -140 dB for a whole period.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! KarplusStrong ks(44100.0, 16);
+//!
+//! ks.noteOn(82.41);
+//! ks.noteOn(123.47, 0.8);
+//!
+//! Buffer y = ks.render(44100);
+//!
+//! // Python
+//! ks = KarplusStrong(44100.0, 16)
+//! ks.noteOn(82.41)
+//! y = ks.render(44100)
+//! \endcode
+class KarplusStrong
+{
+    public:
+
+    //! Creates the strings.
+    //
+    //! \param sample_rate the sample rate
+    //! \param n_strings the maximum number of strings sounding at once
+    //! \param lowest_frequency the lowest frequency that can be plucked
+    //! \param n_smooth_samples the excitation moving average length, as in
+    //!        Pluck
+    KarplusStrong(
+        const float64 & sample_rate,
+        const uint32 n_strings,
+        const float64 & lowest_frequency = 20.0,
+        const uint32 n_smooth_samples = 0);
+
+    //! Plucks a string, returns the index of the string used.
+    //
+    //! \param frequency the frequency in Hz
+    //! \param amplitude the peak of the excitation
+    //! \param sustain sets the loop brightness like the duration of
+    //!        Pluck::generate(), longer notes ring brighter
+    uint32
+    noteOn(
+        const float64 & frequency,
+        const float64 & amplitude = 1.0,
+        const float64 & sustain = 1.0);
+
+    //! Damps the string so it dies away in the release time.
+    void
+    noteOff(const uint32 string);
+
+    //! Silences every string immediately.
+    void
+    reset();
+
+    uint32
+    getNActive() const;
+
+    uint32
+    getNStrings() const { return n_strings_; }
+
+    float64
+    getSampleRate() const { return sample_rate_; }
+
+    bool
+    isActive(const uint32 string) const;
+
+    //! Renders the next n_samples of the mix of all strings.
+    Buffer
+    render(const uint32 n_samples);
+
+    #ifndef SWIG
+    //! Renders the next n_samples of the mix of all strings into y.
+    void
+    render(float64 * y, const uint32 n_samples);
+    #endif
+
+    //! Sets the time for a released string to decay by 60 dB.
+    void
+    setReleaseTime(const float64 & seconds);
+
+    void
+    setSeed(const uint32 seed) { rng_.setSeed(seed); }
+
+    #ifndef SWIG
+    //! Moving average of x into y, exactly like Buffer::smooth(1, n).
+    //
+    //! x and y must not overlap.
+    static
+    void
+    smooth(
+        const float64 * x,
+        float64 * y,
+        const uint32 n_samples,
+        const uint32 n_smooth_samples);
+    #endif
+
+    protected:
+
+    //! Zeros the string's delay line and filter states.
+    void
+    clear(const uint32 string);
+
+    float64 sample_rate_;
+    float64 release_time_;
+
+    uint32 n_strings_;
+    uint32 n_padded_;
+    uint32 n_smooth_;
+
+    // Longest period, set by the lowest frequency.
+    uint32 max_period_;
+
+    // Every delay line is mask_ + 1 samples long.
+    uint32 mask_;
+
+    // Longest excitation, one period plus the smoothing tail.
+    uint32 max_excitation_;
+
+    RngTausworthe rng_;
+
+    // Delay lines and excitations, one after the other per string.
+    std::vector<float64> ring_;
+    std::vector<float64> excitation_;
+
+    // Per string state, n_padded_ long.
+    std::vector<uint32>  period_;
+    std::vector<uint32>  write_;
+    std::vector<uint32>  position_;
+    std::vector<uint32>  length_;
+    std::vector<float64> tail_;
+    std::vector<float64> tone_b_;
+    std::vector<float64> tone_a_;
+    std::vector<float64> tone_y_;
+    std::vector<float64> dc_x_;
+    std::vector<float64> dc_y_;
+    std::vector<float64> damping_;
+    std::vector<float64> peak_;
+    std::vector<uint32>  n_quiet_;
+    std::vector<uint64>  started_;
+    std::vector<bool>    active_;
+
+    uint64 clock_;
+
+    private:
+
+    KarplusStrong(const KarplusStrong & copy);
+    KarplusStrong & operator=(const KarplusStrong & rhs);
+
+}; // class KarplusStrong
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -30,6 +30,7 @@
 #include <Nsound/Buffer.h>
 #include <Nsound/Mixer.h>
 #include <Nsound/MixerNode.h>
+#include <Nsound/Profiler.h>
 #include <Nsound/Nsound.h>
 
 #include <iostream>
@@ -122,6 +123,8 @@ AudioStream
 Mixer::
 getStream(float64 start_time, float64 end_time)
 {
+    M_PROFILE("Mixer::getStream");
+
     M_ASSERT_VALUE(mixer_set_.size(), >, 0);
     M_ASSERT_VALUE(start_time, <, end_time);
 
@@ -40,6 +40,7 @@
 #include <Nsound/AudioStream.h>
 #include <Nsound/AudioStreamSelection.h>
 #include <Nsound/Buffer.h>
+#include <Nsound/BufferPyramid.h>
 #include <Nsound/BufferSelection.h>
 #include <Nsound/BufferWindowSearch.h>
 #include <Nsound/CircularBuffer.h>
@@ -58,6 +59,7 @@
 #include <Nsound/FilterBandPassVocoder.h>
 #include <Nsound/FilterBandRejectFIR.h>
 #include <Nsound/FilterBandRejectIIR.h>
+#include <Nsound/FilterBank.h>
 #include <Nsound/FilterCombLowPassFeedback.h>
 #include <Nsound/FilterDelay.h>
 #include <Nsound/FilterDC.h>
@@ -82,7 +84,9 @@
 #include <Nsound/Granulator.h>
 #include <Nsound/GuitarBass.h>
 #include <Nsound/Hat.h>
+#include <Nsound/IIRKernelCache.h>
 #include <Nsound/Instrument.h>
+#include <Nsound/KarplusStrong.h>
 #include <Nsound/Kernel.h>
 #include <Nsound/Mesh2D.h>
 #include <Nsound/MeshJunction.h>
@@ -90,20 +94,29 @@
 #include <Nsound/OrganPipe.h>
 #include <Nsound/Plotter.h>
 #include <Nsound/Pluck.h>
+#include <Nsound/Profiler.h>
 #include <Nsound/Pulse.h>
 #include <Nsound/RandomNumberGenerator.h>
+#include <Nsound/RenderScheduler.h>
+#include <Nsound/Resampler.h>
 #include <Nsound/ReverberationRoom.h>
 #include <Nsound/RngTausworthe.h>
 #include <Nsound/Sawtooth.h>
+#include <Nsound/Sequencer.h>
 #include <Nsound/Sine.h>
+#include <Nsound/SlidingWindow.h>
 #include <Nsound/Spectrogram.h>
+#include <Nsound/SpectrogramCache.h>
 #include <Nsound/Square.h>
 #include <Nsound/StreamOperators.h>
+#include <Nsound/StreamingSTFT.h>
 #include <Nsound/Stretcher.h>
+#include <Nsound/ThreadPool.h>
 #include <Nsound/TicToc.h>
 #include <Nsound/Triangle.h>
 #include <Nsound/Utils.h>
 #include <Nsound/Vocoder.h>
+#include <Nsound/VoicePool.h>
 #include <Nsound/Wavefile.h>
 #include <Nsound/WindowType.h>
 
@@ -28,6 +28,7 @@
 
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
+#include <Nsound/BufferPyramid.h>
 #include <Nsound/FFTChunk.h>
 #include <Nsound/FFTransform.h>
 #include <Nsound/Generator.h>
@@ -42,6 +43,7 @@
     #include <numpy/ufuncobject.h>
 #endif
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -59,6 +61,7 @@ Plotter::PyPlotTable Plotter::table_;
 
 Plotter::PlotterState Nsound::Plotter::state_ = Plotter::BOOTING;
 boolean Plotter::grid_is_on_ = true;
+uint32 Plotter::pixel_width_ = 2000;
 
 float64 Plotter::xmin_ =  1e300;
 float64 Plotter::xmax_ = -1e300;
@@ -655,24 +658,29 @@ imagesc(
             ymax = y_axis[M - 1] + 0.5 * dy;
         }
 
-        // Create python list of lists to represent the matrix
+        // Create a numpy array to represent the matrix
 
-        PyObject * matrix_list = PyList_New(M);
+        npy_intp dims[2] = {M, N};
 
-        M_CHECK_PY_PTR_RETURN(matrix_list, "PyList_New() failed");
+        PyObject * matrix = PyArray_SimpleNew(2, dims, NPY_FLOAT64);
+
+        M_CHECK_PY_PTR_RETURN(matrix, "PyArray_SimpleNew() failed");
+
+        float64 * data = static_cast<float64 *>(
+            PyArray_DATA(reinterpret_cast<PyArrayObject *>(matrix)));
 
         for(uint32 m = 0; m < M; ++m)
         {
-            PyObject * array = makePyListFromBuffer(Z[m]);
-
-            M_CHECK_PY_PTR_RETURN(array, "makePyListFromBuffer() failed");
+            M_ASSERT_VALUE(Z[m].getLength(), ==, N);
 
-            PyList_SET_ITEM(matrix_list, m, array);
+            std::memcpy(data + m * N, Z[m].getPointer(), sizeof(float64) * N);
         }
 
         // Now build imshow's arguments and keyword args
 
-        PyObject * args = Py_BuildValue("(O)", matrix_list);
+        PyObject * args = Py_BuildValue("(O)", matrix);
+
+        Py_DECREF(matrix);
 
         M_CHECK_PY_PTR_RETURN(args, "Py_BuildValue() failed");
 
@@ -771,17 +779,87 @@ plot(
 
         M_ASSERT_VALUE(y.getLength(), >, 0);
 
+        if(x.getLength() > 0)
+        {
+            M_ASSERT_VALUE(x.getLength(), ==, y.getLength());
+        }
+
+        if(y.getLength() <= 2 * pixel_width_)
+        {
+            _plot(x, y, fmt, kwargs);
+            return;
+        }
+
+        // Draw the envelope.
+        BufferPyramid pyramid(y);
+
+        Buffer index;
+        Buffer envelope;
+
+        pyramid.getPlotData(0, y.getLength(), pixel_width_, index, envelope);
+
+        if(x.getLength() == 0)
+        {
+            _plot(index, envelope, fmt, kwargs);
+            return;
+        }
+
+        Buffer xx(index.getLength());
+
+        for(auto i : index) xx << x[static_cast<uint32>(i)];
+
+        _plot(xx, envelope, fmt, kwargs);
+
+    #endif
+}
+
+void
+Plotter::
+plot(
+    const BufferPyramid & y,
+    const uint32 start,
+    const uint32 stop,
+    const std::string & fmt,
+    const std::string & kwargs)
+{
+    #ifdef NSOUND_C_PYLAB
+
+        if(Plotter::state_ != INITALIZED)
+        {
+            return;
+        }
+
+        Buffer index;
+        Buffer envelope;
+
+        y.getPlotData(start, stop, pixel_width_, index, envelope);
+
+        M_ASSERT_VALUE(index.getLength(), >, 0);
+
+        _plot(index, envelope, fmt, kwargs);
+
+    #endif
+}
+
+void
+Plotter::
+_plot(
+    const Buffer & x,
+    const Buffer & y,
+    const std::string & fmt,
+    const std::string & kwargs)
+{
+    #ifdef NSOUND_C_PYLAB
+
         PyObject * x_list = nullptr;
 
         // X may be empty here.
         if(x.getLength() > 0)
         {
-            M_ASSERT_VALUE(x.getLength(), ==, y.getLength());
-
-            x_list = makePyListFromBuffer(x);
+            x_list = makePyArrayFromBuffer(x);
         }
 
-        PyObject * y_list = makePyListFromBuffer(y);
+        PyObject * y_list = makePyArrayFromBuffer(y);
 
         // Put the list in a tuple.
         PyObject * args = nullptr;
@@ -974,6 +1052,15 @@ savefig(const std::string & filename, const std::string & kwargs)
     #endif
 }
 
+void
+Plotter::
+setPixelWidth(const uint32 width)
+{
+    M_ASSERT_VALUE(width, >, 0);
+
+    pixel_width_ = width;
+}
+
 void
 Plotter::
 set_xscale(const std::string & s)
@@ -1188,21 +1275,22 @@ ylabel(const std::string & label, const std::string & kwargs)
 #ifdef NSOUND_C_PYLAB
     PyObject *
     Plotter::
-    makePyListFromBuffer(const Buffer & buffer) const
+    makePyArrayFromBuffer(const Buffer & buffer) const
     {
-        uint32 n_samples = buffer.getLength();
+        npy_intp n_samples = buffer.getLength();
 
-        PyObject * py_list = PyList_New(n_samples);
+        PyObject * array = PyArray_SimpleNew(1, &n_samples, NPY_FLOAT64);
 
-        M_CHECK_PY_PTR(py_list, "PyList_New() failed");
+        M_CHECK_PY_PTR(array, "PyArray_SimpleNew() failed");
 
-        for(uint32 i = 0; i < n_samples; ++i)
-        {
-            PyList_SET_ITEM(py_list, i,
-                PyFloat_FromDouble(static_cast<float64>(buffer[i])));
-        }
+        if(array == nullptr) return nullptr;
+
+        std::memcpy(
+            PyArray_DATA(reinterpret_cast<PyArrayObject *>(array)),
+            buffer.getPointer(),
+            sizeof(float64) * n_samples);
 
-        return py_list;
+        return array;
     }
 
     PyObject *
@@ -44,6 +44,7 @@ namespace Nsound
 
 class AudioStream;
 class Buffer;
+class BufferPyramid;
 
 #if ! ( defined(NSOUND_C_PYLAB) || defined(NSOUND_IN_PYTHON_MODULE) )
     typedef void PyObject;
@@ -119,6 +120,9 @@ class Plotter
     void legend(const std::string & kwargs="");
 
     //! Plots the Buffer on the current figure.
+    //
+    //! Buffers longer than twice the pixel width are drawn as their min/max
+    //! envelope with a point per pixel, see BufferPyramid.
     void plot(
         const Buffer & y,
         const std::string & fmt = "",
@@ -138,6 +142,14 @@ class Plotter
         const std::string & fmt = "",
         const std::string & kwargs = "");
 
+    //! Plots the envelope of samples [start, stop) at the pixel width.
+    void plot(
+        const BufferPyramid & y,
+        const uint32 start,
+        const uint32 stop,
+        const std::string & fmt = "",
+        const std::string & kwargs = "");
+
     //! executes the python string
     void run_string(const std::string & command) const;
 
@@ -191,6 +203,15 @@ class Plotter
     void
     show();
 
+    //! Sets the number of points long signals are decimated to, default 2000.
+    static
+    void
+    setPixelWidth(const uint32 width);
+
+    static
+    uint32
+    getPixelWidth() { return pixel_width_; }
+
     //! SWIG helper function function to shadow.
     void _swig_shadow(){};
 
@@ -201,6 +222,13 @@ class Plotter
 
     PyObject * _make_kwargs(const std::string & kwargs) const;
 
+    //! Plots x vs y without decimating.
+    void _plot(
+        const Buffer & x,
+        const Buffer & y,
+        const std::string & fmt,
+        const std::string & kwargs);
+
     static int32 count_;
 
     static PyPlotTable table_;
@@ -216,6 +244,8 @@ class Plotter
 
     static boolean grid_is_on_;
 
+    static uint32 pixel_width_;
+
     static float64 xmin_;
     static float64 xmax_;
     static float64 ymin_;
@@ -230,8 +260,8 @@ class Plotter
     //! Assignment disabled.
     Plotter & operator=(const Plotter & rhs);
 
-    //! Create a PyList object from a buffer!
-    PyObject * makePyListFromBuffer(const Buffer & buffer) const;
+    //! Create a numpy array from a buffer!
+    PyObject * makePyArrayFromBuffer(const Buffer & buffer) const;
 
     //! Create a PyInt
     PyObject * makePyIntFromUint32(const uint32 & i) const;
@@ -28,10 +28,10 @@
 
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
-#include <Nsound/DelayLine.h>
-#include <Nsound/FilterDC.h>
-#include <Nsound/FilterTone.h>
+#include <Nsound/KarplusStrong.h>
 #include <Nsound/Pluck.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/RandomNumberGenerator.h>
 
 #include <cmath>
 
@@ -43,7 +43,10 @@ Pluck::
 Pluck(const float64 & sample_rate, uint32 n_smooth_samples)
     :
     Generator(sample_rate),
-    n_smooth_samples_(n_smooth_samples)
+    n_smooth_samples_(n_smooth_samples),
+    noise_(),
+    excitation_(),
+    ring_()
 {
 }
 
@@ -58,31 +61,100 @@ Buffer
 Pluck::
 generate(const float64 & duration, const float64 & frequency)
 {
-    DelayLine delay(sample_rate_, 1.0 / frequency);
-    FilterDC dc_filter(0.99);
-    FilterTone tone(sample_rate_, 14 * frequency * duration);
+    M_PROFILE_SAMPLES("Pluck::generate", duration * sample_rate_);
 
-    Buffer noise_env =  drawLine(1.0 / frequency, 1.0, 1.0)
-                     << drawLine(duration - (1.0 / frequency), 0.0, 0.0)
-                     << 0.0;
+    M_ASSERT_VALUE(frequency, >, 0.0);
+    M_ASSERT_VALUE(duration, >, 1.0 / frequency);
 
-    Buffer x = whiteNoise(duration) * noise_env * 2.0;
+    // The excitation: white noise for one period, then silence.
+    uint32 n_noise = static_cast<uint32>(std::ceil(duration * sample_rate_));
 
-    x.smooth(1, n_smooth_samples_);
-    x.normalize();
+    uint32 n_burst = static_cast<uint32>(
+        (1.0 / frequency) * sample_rate_ + 0.5);
+
+    uint32 n_envelope = n_burst + 1 + static_cast<uint32>(
+        (duration - (1.0 / frequency)) * sample_rate_ + 0.5);
+
+    noise_.resize(n_noise);
+    excitation_.resize(n_noise);
+
+    for(uint32 i = 0; i < n_noise; ++i)
+    {
+        float64 envelope = 1.0;
+
+        if(i >= n_burst && i < n_envelope) envelope = 0.0;
+
+        noise_[i] = rng_->get(-1.0f, 1.0f) * envelope * 2.0;
+    }
+
+    float64 * x = excitation_.data();
+
+    KarplusStrong::smooth(noise_.data(), x, n_noise, n_smooth_samples_);
+
+    float64 peak = x[0];
+
+    for(uint32 i = 0; i < n_noise; ++i)
+    {
+        float64 t = std::fabs(x[i]);
+        if(t > peak) peak = t;
+    }
+
+    float64 scale = 1.0;
+
+    if(peak != 0.0) scale = 1.0 / peak;
+
+    for(uint32 i = 0; i < n_noise; ++i) x[i] *= scale;
+
+    // The string's delay line, one period long.
+    uint32 period = static_cast<uint32>(
+        sample_rate_ * (1.0 / frequency) + 0.5);
+
+    uint32 size = 1;
+
+    while(size < period + 1) size <<= 1;
+
+    const uint32 mask = size - 1;
+
+    ring_.assign(size, 0.0);
+
+    float64 * ring = ring_.data();
+
+    // The loop filters, a FilterTone into a FilterDC.
+    float64 hp = 14 * frequency * duration;
+
+    float64 temp = 2.0 - ::cos(2.0 * M_PI / sample_rate_ * hp);
+
+    const float64 a = -1.0 * (temp - ::sqrt(temp * temp - 1.0));
+    const float64 b = 1.0 + a;
+
+    float64 tone_y = 0.0;
+    float64 dc_x = 0.0;
+    float64 dc_y = 0.0;
 
     uint32 n_samples = static_cast<int32>(duration * sample_rate_);
 
-    Buffer y;
+    Buffer y(n_samples);
+
+    ring[0] = x[0];
+
+    uint32 w = 1;
 
-    delay.write(x[0]);
     for(uint32 n = 0; n < n_samples; ++n)
     {
+        float64 t = b * ring[(w - period) & mask] - a * tone_y;
+        float64 d = t - dc_x + 0.99 * dc_y;
 
-        y << dc_filter.filter(tone.filter(delay.read()));
+        tone_y = t;
+        dc_x = t;
+        dc_y = d;
 
-        delay.write(x[n] + y[n]);
+        y << d;
+
+        ring[w] = x[n] + d;
+
+        w = (w + 1) & mask;
     }
+
     y.normalize();
 
     return y;
@@ -31,6 +31,8 @@
 
 #include <Nsound/Generator.h>
 
+#include <vector>
+
 namespace Nsound
 {
 
@@ -39,6 +41,9 @@ class Buffer;
 //-----------------------------------------------------------------------------
 //! Implements a simple Karplus-Strong String Synthesis algorithim.
 //
+//! The excitation, delay line and loop filters are kept in scratch memory
+//! that is reused from note to note.  See KarplusStrong for rendering many
+//! strings at once in real-time.
 class Pluck : public Generator
 {
     public:
@@ -83,6 +88,11 @@ class Pluck : public Generator
 
     uint32 n_smooth_samples_;
 
+    // Scratch reused by generate().
+    std::vector<float64> noise_;
+    std::vector<float64> excitation_;
+    std::vector<float64> ring_;
+
 };
 
 };
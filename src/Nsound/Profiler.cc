@@ -0,0 +1,571 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Profiler.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/Nsound.h>
+#include <Nsound/Profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <unordered_map>
+
+namespace Nsound
+{
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+struct Entry
+{
+    uint64 n_calls;
+    int64  total_ns;
+    int64  self_ns;
+    uint64 n_samples;
+    uint64 n_bytes;
+    uint64 n_allocs;
+};
+
+struct TraceEvent
+{
+    const char * name;
+    int64        start_ns;
+    int64        duration_ns;
+    uint64       n_samples;
+    uint64       n_bytes;
+};
+
+struct ThreadData
+{
+    ThreadData(uint32 id) : mutex(), table(), events(), tid(id) {}
+
+    std::mutex                              mutex;
+    std::unordered_map<const char *, Entry> table;
+    std::vector<TraceEvent>                 events;
+    uint32                                  tid;
+};
+
+struct Registry
+{
+    Registry()
+        :
+        mutex(),
+        threads(),
+        epoch(Clock::now()),
+        trace_capacity(100000),
+        output()
+    {}
+
+    std::mutex                mutex;
+    std::vector<ThreadData *> threads;
+    Clock::time_point         epoch;
+    std::atomic<uint32>       trace_capacity;
+    std::string               output;
+};
+
+// Never destroyed, scopes may still run during static destruction.
+Registry &
+registry()
+{
+    static Registry * r = new Registry();
+    return *r;
+}
+
+thread_local ThreadData *   tls_data = nullptr;
+thread_local ProfileScope * tls_scope = nullptr;
+thread_local uint64         tls_bytes = 0;
+thread_local uint64         tls_allocs = 0;
+
+std::atomic<uint64> total_bytes(0);
+std::atomic<uint64> total_allocs(0);
+
+ThreadData &
+thread_data()
+{
+    if(tls_data == nullptr)
+    {
+        Registry & r = registry();
+
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        tls_data = new ThreadData(static_cast<uint32>(r.threads.size()));
+
+        r.threads.push_back(tls_data);
+    }
+
+    return *tls_data;
+}
+
+int64
+now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - registry().epoch).count();
+}
+
+std::string
+json_escape(const char * str)
+{
+    std::string out;
+
+    for(const char * c = str; *c != '\0'; ++c)
+    {
+        if(*c == '"' || *c == '\\') out += '\\';
+        out += *c;
+    }
+
+    return out;
+}
+
+bool
+by_self_time(const ProfileStats & lhs, const ProfileStats & rhs)
+{
+    return lhs.self_sec > rhs.self_sec;
+}
+
+void
+write_at_exit()
+{
+    std::string filename;
+
+    {
+        Registry & r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        filename = r.output;
+    }
+
+    std::string ext = ".json";
+
+    try
+    {
+        if(filename.size() >= ext.size()
+            && filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0)
+        {
+            Profiler::writeChromeTrace(filename);
+        }
+        else
+        {
+            Profiler::writeFlatProfile(filename);
+        }
+    }
+    catch(std::exception & e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+#ifdef NSOUND_PROFILE
+
+    struct EnvironmentInit
+    {
+        EnvironmentInit()
+        {
+            const char * filename = std::getenv("NSOUND_PROFILE_OUTPUT");
+
+            if(filename != nullptr && *filename != '\0')
+            {
+                Profiler::writeAtExit(filename);
+            }
+        }
+    };
+
+    EnvironmentInit environment_init;
+
+#endif
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+ProfileScope::
+ProfileScope(const char * name, const uint64 n_samples)
+    :
+    name_(name),
+    n_samples_(n_samples),
+    start_ns_(0),
+    child_ns_(0),
+    start_bytes_(tls_bytes),
+    start_allocs_(tls_allocs),
+    parent_(tls_scope)
+{
+    tls_scope = this;
+    start_ns_ = now_ns();
+}
+
+
+ProfileScope::
+~ProfileScope()
+{
+    int64 duration = now_ns() - start_ns_;
+
+    uint64 n_bytes = tls_bytes - start_bytes_;
+    uint64 n_allocs = tls_allocs - start_allocs_;
+
+    tls_scope = parent_;
+
+    if(parent_ != nullptr) parent_->child_ns_ += duration;
+
+    // Allocations made by the bookkeeping below are not charged to anyone.
+    uint64 saved_bytes = tls_bytes;
+    uint64 saved_allocs = tls_allocs;
+
+    ThreadData & td = thread_data();
+
+    {
+        std::lock_guard<std::mutex> lock(td.mutex);
+
+        Entry & e = td.table[name_];
+
+        ++e.n_calls;
+        e.total_ns += duration;
+        e.self_ns += duration - child_ns_;
+        e.n_samples += n_samples_;
+        e.n_bytes += n_bytes;
+        e.n_allocs += n_allocs;
+
+        if(td.events.size() < registry().trace_capacity.load())
+        {
+            TraceEvent ev = {name_, start_ns_, duration, n_samples_, n_bytes};
+            td.events.push_back(ev);
+        }
+    }
+
+    tls_bytes = saved_bytes;
+    tls_allocs = saved_allocs;
+}
+
+
+//-----------------------------------------------------------------------------
+bool
+Profiler::
+isEnabled()
+{
+    #ifdef NSOUND_PROFILE
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+
+void
+Profiler::
+reset()
+{
+    Registry & r = registry();
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    for(auto td : r.threads)
+    {
+        std::lock_guard<std::mutex> td_lock(td->mutex);
+        td->table.clear();
+        td->events.clear();
+    }
+}
+
+
+std::vector<ProfileStats>
+Profiler::
+getStats()
+{
+    // The same literal may have different addresses in different
+    // translation units, merge by name.
+    std::map<std::string, ProfileStats> merged;
+
+    Registry & r = registry();
+
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        for(auto td : r.threads)
+        {
+            std::lock_guard<std::mutex> td_lock(td->mutex);
+
+            for(const auto & kv : td->table)
+            {
+                const Entry & e = kv.second;
+
+                ProfileStats & s = merged[kv.first];
+
+                s.n_calls += e.n_calls;
+                s.total_sec += 1e-9 * e.total_ns;
+                s.self_sec += 1e-9 * e.self_ns;
+                s.n_samples += e.n_samples;
+                s.n_bytes_allocated += e.n_bytes;
+                s.n_allocations += e.n_allocs;
+            }
+        }
+    }
+
+    std::vector<ProfileStats> stats;
+
+    for(auto & kv : merged)
+    {
+        kv.second.name = kv.first;
+        stats.push_back(kv.second);
+    }
+
+    std::stable_sort(stats.begin(), stats.end(), by_self_time);
+
+    return stats;
+}
+
+
+std::string
+Profiler::
+getFlatProfile()
+{
+    std::vector<ProfileStats> stats = getStats();
+
+    std::stringstream ss;
+
+    ss << "Nsound flat profile, sorted by self time\n\n"
+       << std::setw(11) << "self s"
+       << std::setw(11) << "total s"
+       << std::setw(11) << "calls"
+       << std::setw(14) << "samples"
+       << std::setw(12) << "Msamples/s"
+       << std::setw(11) << "alloc MB"
+       << std::setw(11) << "allocs"
+       << "  stage\n";
+
+    ss << std::fixed;
+
+    for(const auto & s : stats)
+    {
+        float64 rate = 0.0;
+
+        if(s.total_sec > 0.0) rate = 1e-6 * s.n_samples / s.total_sec;
+
+        ss << std::setprecision(6)
+           << std::setw(11) << s.self_sec
+           << std::setw(11) << s.total_sec
+           << std::setw(11) << s.n_calls
+           << std::setw(14) << s.n_samples
+           << std::setprecision(3)
+           << std::setw(12) << rate
+           << std::setw(11) << s.n_bytes_allocated / (1024.0 * 1024.0)
+           << std::setw(11) << s.n_allocations
+           << "  " << s.name << "\n";
+    }
+
+    if(!isEnabled())
+    {
+        ss << "\n(profiling was not compiled in, "
+           << "configure with 'scons --enable-profiling')\n";
+    }
+
+    return ss.str();
+}
+
+
+void
+Profiler::
+writeFlatProfile(const std::string & filename)
+{
+    std::ofstream fout(filename.c_str());
+
+    if(!fout.good())
+    {
+        M_THROW("Profiler::writeFlatProfile(): could not open the file '"
+            << filename << "'");
+    }
+
+    fout << getFlatProfile();
+}
+
+
+void
+Profiler::
+writeChromeTrace(const std::string & filename)
+{
+    std::ofstream fout(filename.c_str());
+
+    if(!fout.good())
+    {
+        M_THROW("Profiler::writeChromeTrace(): could not open the file '"
+            << filename << "'");
+    }
+
+    fout << "{\"traceEvents\":[\n" << std::fixed << std::setprecision(3);
+
+    bool first = true;
+
+    Registry & r = registry();
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    for(auto td : r.threads)
+    {
+        std::lock_guard<std::mutex> td_lock(td->mutex);
+
+        for(const auto & ev : td->events)
+        {
+            if(!first) fout << ",\n";
+            first = false;
+
+            fout
+                << "{\"name\":\"" << json_escape(ev.name) << "\""
+                << ",\"cat\":\"nsound\",\"ph\":\"X\",\"pid\":0"
+                << ",\"tid\":" << td->tid
+                << ",\"ts\":" << 1e-3 * ev.start_ns
+                << ",\"dur\":" << 1e-3 * ev.duration_ns
+                << ",\"args\":{\"samples\":" << ev.n_samples
+                << ",\"bytes\":" << ev.n_bytes << "}}";
+        }
+    }
+
+    fout << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+uint64
+Profiler::
+getNAllocations()
+{
+    return total_allocs.load();
+}
+
+
+uint64
+Profiler::
+getNBytesAllocated()
+{
+    return total_bytes.load();
+}
+
+
+void
+Profiler::
+setTraceCapacity(const uint32 n_events)
+{
+    registry().trace_capacity = n_events;
+}
+
+
+void
+Profiler::
+writeAtExit(const std::string & filename)
+{
+    Registry & r = registry();
+
+    bool first = false;
+
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        first = r.output.empty();
+        r.output = filename;
+    }
+
+    if(first) std::atexit(&write_at_exit);
+}
+
+
+} // namespace
+
+
+#ifdef NSOUND_PROFILE
+
+//-----------------------------------------------------------------------------
+// Replacing the global allocation functions lets every scope report the bytes
+// allocated while it was active.
+
+// GCC flags free() in the replacement operator delete as mismatched.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static
+void *
+profiled_malloc(std::size_t size)
+{
+    ++Nsound::tls_allocs;
+    Nsound::tls_bytes += size;
+
+    Nsound::total_allocs.fetch_add(1, std::memory_order_relaxed);
+    Nsound::total_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if(size == 0) size = 1;
+
+    while(true)
+    {
+        void * ptr = std::malloc(size);
+
+        if(ptr != nullptr) return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+
+        if(handler == nullptr) throw std::bad_alloc();
+
+        handler();
+    }
+}
+
+void * operator new(std::size_t size)
+{
+    return profiled_malloc(size);
+}
+
+void * operator new[](std::size_t size)
+{
+    return profiled_malloc(size);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try { return profiled_malloc(size); } catch(...) { return nullptr; }
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    try { return profiled_malloc(size); } catch(...) { return nullptr; }
+}
+
+void operator delete(void * ptr) noexcept { std::free(ptr); }
+void operator delete[](void * ptr) noexcept { std::free(ptr); }
+void operator delete(void * ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+
+#ifdef __cpp_sized_deallocation
+    void operator delete(void * ptr, std::size_t) noexcept { std::free(ptr); }
+    void operator delete[](void * ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+#endif
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,178 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Profiler.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_PROFILER_H_
+#define _NSOUND_PROFILER_H_
+
+#include <Nsound/Nsound.h>
+
+#include <string>
+#include <vector>
+
+namespace Nsound
+{
+
+//-----------------------------------------------------------------------------
+//! Accumulated statistics of one profiled stage.
+struct ProfileStats
+{
+    std::string name;
+    uint64  n_calls;
+    float64 total_sec;          //!< wall time, including nested stages
+    float64 self_sec;           //!< wall time, excluding nested stages
+    uint64  n_samples;          //!< samples processed
+    uint64  n_bytes_allocated;  //!< bytes allocated, including nested stages
+    uint64  n_allocations;
+};
+
+//-----------------------------------------------------------------------------
+//! Collects the measurements of every ProfileScope.
+//
+//! Profiling is opt-in: the library is only instrumented when it is
+//! configured with 'scons --enable-profiling', which defines NSOUND_PROFILE.
+//! Otherwise the M_PROFILE macros expand to nothing and the Profiler reports
+//! an empty profile.  Heap allocations are counted by replacing the global
+//! operator new, so they are only tracked when NSOUND_PROFILE is defined.
+//!
+//! Each thread records into its own table, the tables are merged when a
+//! profile is requested.  When the environment variable NSOUND_PROFILE_OUTPUT
+//! is set, the profile is written to that file at exit, see writeAtExit().
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! Buffer x = ...;
+//! FilterLowPassIIR lpf(44100.0, 6, 1000.0, 0.01);
+//!
+//! Buffer y = lpf.filter(x);
+//!
+//! cout << Profiler::getFlatProfile();
+//!
+//! Profiler::writeChromeTrace("trace.json"); // load in chrome://tracing
+//! \endcode
+class Profiler
+{
+    public:
+
+    //! Returns true if the library was compiled with NSOUND_PROFILE.
+    static bool isEnabled();
+
+    //! Discards everything recorded so far.
+    static void reset();
+
+    //! Returns the statistics of every stage, sorted by self time.
+    static std::vector<ProfileStats> getStats();
+
+    //! Returns a flat profile table, sorted by self time.
+    static std::string getFlatProfile();
+
+    //! Writes getFlatProfile() to the file.
+    static void writeFlatProfile(const std::string & filename);
+
+    //! Writes the recorded scopes in the Chrome trace event JSON format.
+    static void writeChromeTrace(const std::string & filename);
+
+    //! Sets the maximum number of trace events kept per thread.
+    //
+    //! Once full, scopes are still counted in the statistics but no longer
+    //! traced.  The default is 100000 events.  0 disables tracing.
+    static void setTraceCapacity(const uint32 n_events);
+
+    //! Returns the number of heap allocations made by the process.
+    //
+    //! Always 0 unless compiled with NSOUND_PROFILE.
+    static uint64 getNAllocations();
+
+    //! Returns the number of bytes allocated on the heap by the process.
+    static uint64 getNBytesAllocated();
+
+    //! Writes the profile to the file when the program exits.
+    //
+    //! If the filename ends with ".json" a Chrome trace is written,
+    //! otherwise a flat profile.
+    static void writeAtExit(const std::string & filename);
+};
+
+//-----------------------------------------------------------------------------
+//! Measures the enclosing scope, use the M_PROFILE macros.
+//
+//! The name must be a string literal (or otherwise outlive the Profiler).
+class ProfileScope
+{
+    public:
+
+    ProfileScope(const char * name, const uint64 n_samples = 0);
+
+    ~ProfileScope();
+
+    //! Adds to the number of samples processed by this scope.
+    void addSamples(const uint64 n_samples) { n_samples_ += n_samples; }
+
+    private:
+
+    ProfileScope(const ProfileScope & copy);
+    ProfileScope & operator=(const ProfileScope & rhs);
+
+    const char *   name_;
+    uint64         n_samples_;
+    int64          start_ns_;
+    int64          child_ns_;
+    uint64         start_bytes_;
+    uint64         start_allocs_;
+    ProfileScope * parent_;
+};
+
+} // namespace
+
+#ifdef NSOUND_PROFILE
+
+    #define M_PROFILE_CAT_(a, b) a ## b
+    #define M_PROFILE_CAT(a, b) M_PROFILE_CAT_(a, b)
+
+    //! Profiles the enclosing scope as the stage name.
+    #define M_PROFILE(name) \
+        ::Nsound::ProfileScope M_PROFILE_CAT(ns_profile_scope_, __LINE__)(name)
+
+    //! Profiles the enclosing scope as the stage name processing n samples.
+    #define M_PROFILE_SAMPLES(name, n_samples) \
+        ::Nsound::ProfileScope M_PROFILE_CAT(ns_profile_scope_, __LINE__)( \
+            name, static_cast< ::Nsound::uint64 >(n_samples))
+
+#else
+
+    #define M_PROFILE(name)
+    #define M_PROFILE_SAMPLES(name, n_samples)
+
+#endif
+
+// :mode=c++: jEdit modeline
+#endif
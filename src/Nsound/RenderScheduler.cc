@@ -0,0 +1,215 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: RenderScheduler.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioPlaybackRt.h>
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/RenderScheduler.h>
+#include <Nsound/ThreadPool.h>
+
+#include <algorithm>
+
+namespace Nsound
+{
+
+
+RenderScheduler::
+RenderScheduler(
+    const float64 & sample_rate,
+    const uint32 n_channels,
+    const uint32 samples_per_block)
+    :
+    sample_rate_(sample_rate),
+    n_channels_(n_channels),
+    samples_per_block_(samples_per_block),
+    branches_(),
+    mix_(sample_rate, n_channels),
+    error_mutex_(),
+    error_()
+{
+    M_ASSERT_VALUE(sample_rate, >, 0.0);
+    M_ASSERT_VALUE(n_channels, >, 0);
+    M_ASSERT_VALUE(samples_per_block, >, 0);
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        mix_[c] = Buffer::zeros(samples_per_block_);
+    }
+}
+
+
+RenderScheduler::
+~RenderScheduler()
+{
+    for(auto ptr : branches_) delete ptr;
+}
+
+
+uint32
+RenderScheduler::
+addBranch(const Branch & branch, const float64 & gain)
+{
+    M_ASSERT_MSG(static_cast<bool>(branch), "branch is empty");
+
+    BranchState * state = new BranchState();
+
+    state->branch = branch;
+    state->gain = gain;
+    state->block = AudioStream(sample_rate_, n_channels_);
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        state->block[c] = Buffer::zeros(samples_per_block_);
+    }
+
+    branches_.push_back(state);
+
+    return static_cast<uint32>(branches_.size() - 1);
+}
+
+
+void
+RenderScheduler::
+setGain(const uint32 index, const float64 & gain)
+{
+    M_ASSERT_VALUE(index, <, branches_.size());
+
+    branches_[index]->gain = gain;
+}
+
+
+void
+RenderScheduler::
+_runBranch(const uint32 index)
+{
+    BranchState & state = *branches_[index];
+
+    for(auto bptr : state.block)
+    {
+        std::fill(bptr->begin(), bptr->end(), 0.0);
+    }
+
+    try
+    {
+        state.branch(state.block);
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if(!error_) error_ = std::current_exception();
+    }
+}
+
+
+const AudioStream &
+RenderScheduler::
+renderBlock()
+{
+    // Every branch completes, errors are kept and rethrown below.
+    ThreadPool::getInstance().run(
+        getNBranches(),
+        [this](uint32 index) { _runBranch(index); });
+
+    if(error_)
+    {
+        std::exception_ptr e = error_;
+        error_ = std::exception_ptr();
+        std::rethrow_exception(e);
+    }
+
+    // Deterministic mixdown, always summed in branch order.
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        Buffer & y = mix_[c];
+
+        std::fill(y.begin(), y.end(), 0.0);
+
+        for(auto state : branches_)
+        {
+            const Buffer & x = state->block[c];
+            const float64 gain = state->gain;
+
+            for(uint32 i = 0; i < samples_per_block_; ++i)
+            {
+                y[i] += gain * x[i];
+            }
+        }
+    }
+
+    return mix_;
+}
+
+
+AudioStream
+RenderScheduler::
+render(const float64 & duration)
+{
+    M_ASSERT_VALUE(duration, >, 0.0);
+
+    uint32 n_samples = static_cast<uint32>(duration * sample_rate_ + 0.5);
+
+    AudioStream y(sample_rate_, n_channels_, n_samples);
+
+    while(n_samples > 0)
+    {
+        const AudioStream & block = renderBlock();
+
+        uint32 n = std::min(n_samples, samples_per_block_);
+
+        for(uint32 c = 0; c < n_channels_; ++c)
+        {
+            if(n == samples_per_block_) y[c] << block[c];
+            else                        y[c] << block[c].subbuffer(0, n);
+        }
+
+        n_samples -= n;
+    }
+
+    return y;
+}
+
+
+void
+RenderScheduler::
+render(AudioPlaybackRt & pb, const float64 & duration)
+{
+    M_ASSERT_VALUE(duration, >, 0.0);
+
+    uint32 n_blocks = static_cast<uint32>(
+        duration * sample_rate_ / samples_per_block_ + 0.5);
+
+    for(uint32 i = 0; i < n_blocks; ++i)
+    {
+        pb.play(renderBlock());
+    }
+}
+
+
+} // namespace
+
+// :mode=c++: jEdit modeline
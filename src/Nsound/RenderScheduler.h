@@ -0,0 +1,155 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: RenderScheduler.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_RENDER_SCHEDULER_H_
+#define _NSOUND_RENDER_SCHEDULER_H_
+
+#include <Nsound/Nsound.h>
+#include <Nsound/AudioStream.h>
+
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Nsound
+{
+
+class AudioPlaybackRt;
+
+//-----------------------------------------------------------------------------
+//! Renders independent processing branches concurrently, one block at a time.
+//
+//! Each branch is a callable that fills a preallocated, zeroed AudioStream
+//! block (e.g. a Generator -> Filter chain for one voice).  All branches of
+//! a block are rendered in parallel, then mixed down in branch order so the
+//! output is bit-for-bit identical regardless of the number of threads.
+//!
+//! The branches run on the shared ThreadPool, so the number of threads is
+//! set with ThreadPool::setNThreads().  With a single thread, the default,
+//! the branches are rendered one after another on the calling thread.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! ThreadPool::getInstance().setNThreads(0); // One per core.
+//!
+//! RenderScheduler rs(44100.0, 1, 512);
+//!
+//! Sine sine(44100.0);
+//!
+//! rs.addBranch(
+//!     [&sine](AudioStream & block)
+//!     {
+//!         for(auto & x : block[0]) x = sine.generate(440.0);
+//!     },
+//!     0.5);
+//!
+//! AudioStream out = rs.render(2.0);
+//! \endcode
+class RenderScheduler
+{
+    public:
+
+    typedef std::function<void (AudioStream & block)> Branch;
+
+    //! Creates the scheduler.
+    //
+    //! \param sample_rate the sample rate of every block
+    //! \param n_channels the number of channels of every block
+    //! \param samples_per_block the number of samples rendered per block
+    RenderScheduler(
+        const float64 & sample_rate,
+        const uint32 n_channels = 1,
+        const uint32 samples_per_block = 1024);
+
+    ~RenderScheduler();
+
+    //! Adds a branch, returns the branch index.
+    uint32
+    addBranch(const Branch & branch, const float64 & gain = 1.0);
+
+    //! Sets the mixdown gain of the branch.
+    void
+    setGain(const uint32 index, const float64 & gain);
+
+    uint32 getNBranches() const { return static_cast<uint32>(branches_.size()); }
+    uint32 getNChannels() const { return n_channels_; }
+    uint32 getSamplesPerBlock() const { return samples_per_block_; }
+    float64 getSampleRate() const { return sample_rate_; }
+
+    //! Renders all branches for the next block and returns the mixdown.
+    //
+    //! The returned reference is valid until the next call.  An exception
+    //! thrown by a branch is rethrown here after the block has completed.
+    const AudioStream &
+    renderBlock();
+
+    //! Renders duration seconds offline.
+    AudioStream
+    render(const float64 & duration);
+
+    //! Renders duration seconds into the real-time playback object.
+    void
+    render(AudioPlaybackRt & pb, const float64 & duration);
+
+    private:
+
+    RenderScheduler(const RenderScheduler & copy);
+    RenderScheduler & operator=(const RenderScheduler & rhs);
+
+    void _runBranch(const uint32 index);
+
+    struct BranchState
+    {
+        Branch      branch;
+        float64     gain;
+        AudioStream block;
+    };
+
+    float64 sample_rate_;
+    uint32  n_channels_;
+    uint32  samples_per_block_;
+
+    std::vector<BranchState *> branches_;
+
+    AudioStream mix_;
+
+    std::mutex         error_mutex_;
+    std::exception_ptr error_;
+
+}; // class RenderScheduler
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -0,0 +1,325 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Resampler.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterLeastSquaresFIR.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/Resampler.h>
+
+#include <algorithm>
+
+using namespace Nsound;
+
+namespace Nsound
+{
+    // Defined in Buffer.cc.
+    void
+    find_fraction(float64 fraction, float64 gamma, uint32 & a, uint32 & b);
+}
+
+//-----------------------------------------------------------------------------
+Resampler::
+Resampler(
+    const float64 & factor,
+    const uint32 N,
+    const float64 & beta)
+    :
+    L_(1),
+    M_(1),
+    kernel_(),
+    delay_(0),
+    n_taps_(0),
+    n_channels_(0),
+    sample_rate_(1.0),
+    history_(),
+    offset_(0),
+    n_input_(0),
+    n_output_(0)
+{
+    M_ASSERT_VALUE(factor, >, 0.0);
+
+    find_fraction(factor, 0.0001, L_, M_);
+
+    _init(N, beta);
+}
+
+//-----------------------------------------------------------------------------
+Resampler::
+Resampler(
+    const uint32 L,
+    const uint32 M,
+    const uint32 N,
+    const float64 & beta)
+    :
+    L_(L),
+    M_(M),
+    kernel_(),
+    delay_(0),
+    n_taps_(0),
+    n_channels_(0),
+    sample_rate_(1.0),
+    history_(),
+    offset_(0),
+    n_input_(0),
+    n_output_(0)
+{
+    _init(N, beta);
+}
+
+//-----------------------------------------------------------------------------
+void
+Resampler::
+_init(const uint32 N, const float64 & beta)
+{
+    M_ASSERT_VALUE(L_, !=, 0);
+    M_ASSERT_VALUE(M_, !=, 0);
+    M_ASSERT_VALUE(N, !=, 0);
+    M_ASSERT_VALUE(beta, >=, 0.0);
+
+    // The same filter as Buffer::_get_resample().
+    uint32 LMmax = (L_ > M_) ? L_ : M_;
+
+    float64 fc = 1.0 / 2.0 / static_cast<float64>(LMmax);
+
+    uint32 Lh = 2 * N * LMmax;
+
+    float64 sr = 1000.0;
+
+    Buffer f(4);
+    Buffer a(4);
+
+    f << 0.0 << sr * fc  << sr * fc  << sr * 0.5;
+    a << 1.0 << 1.0 << 0.0 << 0.0;
+
+    FilterLeastSquaresFIR lpf(sr, Lh, f, a, beta);
+
+    Buffer h = lpf.getKernel();
+
+    kernel_.resize(Lh);
+
+    for(uint32 i = 0; i < Lh; ++i)
+    {
+        kernel_[i] = h[i] * static_cast<float64>(L_);
+    }
+
+    delay_ = (Lh - 1) / 2;
+
+    n_taps_ = (Lh + L_ - 1) / L_;
+
+    reset();
+}
+
+//-----------------------------------------------------------------------------
+AudioStream
+Resampler::
+resampleBlock(const AudioStream & x)
+{
+    M_PROFILE_SAMPLES("Resampler::resampleBlock", x.getLength());
+
+    M_ASSERT_VALUE(x.getNChannels(), >, 0);
+
+    if(n_channels_ == 0)
+    {
+        n_channels_ = x.getNChannels();
+
+        history_.assign(n_channels_, std::vector<float64>(n_taps_, 0.0));
+    }
+
+    M_ASSERT_MSG(
+        n_channels_ == x.getNChannels(),
+        "the number of channels can't change during a stream, "
+        "call flush() or reset() first");
+
+    sample_rate_ = x.getSampleRate();
+
+    uint32 n = x.getLength();
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        const Buffer & b = x[c];
+
+        history_[c].insert(history_[c].end(), b.begin(), b.end());
+    }
+
+    n_input_ += n;
+
+    // One past the last output whose input has all arrived,
+    // (n * M + delay) / L < n_input_.
+    uint64 n_end = n_output_;
+
+    if(L_ == 1 && M_ == 1)
+    {
+        n_end = n_input_;
+    }
+    else if(n_input_ * L_ > delay_)
+    {
+        n_end = std::max(
+            n_end, (n_input_ * L_ - delay_ + M_ - 1) / M_);
+    }
+
+    AudioStream y(sample_rate_ * L_ / M_, n_channels_, 0);
+
+    _resample(n_end, y);
+
+    return y;
+}
+
+//-----------------------------------------------------------------------------
+Buffer
+Resampler::
+resampleBlock(const Buffer & x)
+{
+    AudioStream a(sample_rate_, 1, 0);
+
+    a[0] = x;
+
+    return resampleBlock(a)[0];
+}
+
+//-----------------------------------------------------------------------------
+AudioStream
+Resampler::
+flush()
+{
+    AudioStream y(sample_rate_ * L_ / M_, std::max<uint32>(n_channels_, 1), 0);
+
+    if(n_input_ == 0)
+    {
+        reset();
+        return y;
+    }
+
+    uint64 n_end = (n_input_ * L_ + M_ - 1) / M_;
+
+    // Like getResample(), the last input sample is held past the end.
+    if(!(L_ == 1 && M_ == 1))
+    {
+        uint64 n_needed = ((n_end - 1) * M_ + delay_) / L_ + 1;
+
+        for(uint32 c = 0; c < n_channels_; ++c)
+        {
+            std::vector<float64> & h = history_[c];
+
+            float64 last = h.back();
+
+            if(n_needed > n_input_) h.resize(h.size() + n_needed - n_input_, last);
+        }
+    }
+
+    _resample(n_end, y);
+
+    reset();
+
+    return y;
+}
+
+//-----------------------------------------------------------------------------
+void
+Resampler::
+reset()
+{
+    n_channels_ = 0;
+    history_.clear();
+    offset_ = -static_cast<int64>(n_taps_);
+    n_input_ = 0;
+    n_output_ = 0;
+}
+
+//-----------------------------------------------------------------------------
+void
+Resampler::
+_resample(const uint64 n_end, AudioStream & y)
+{
+    uint32 n_out = static_cast<uint32>(n_end - n_output_);
+
+    const uint32 Lh = static_cast<uint32>(kernel_.size());
+
+    FloatVector out(n_out);
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        const float64 * x = history_[c].data();
+
+        if(L_ == 1 && M_ == 1)
+        {
+            const float64 * xn = x + (static_cast<int64>(n_output_) - offset_);
+
+            std::copy(xn, xn + n_out, out.begin());
+        }
+        else
+        {
+            for(uint32 i = 0; i < n_out; ++i)
+            {
+                // Sample u of the up sampled stream is the sum of the kernel
+                // phase u % L times the inputs before u / L.
+                uint64 u = (n_output_ + i) * M_ + delay_;
+                uint32 p = static_cast<uint32>(u % L_);
+
+                const float64 * xn = x + (static_cast<int64>(u / L_) - offset_);
+
+                float64 sum = 0.0;
+
+                for(uint32 k = p, j = 0; k < Lh; k += L_, ++j)
+                {
+                    sum += kernel_[k] * *(xn - j);
+                }
+
+                out[i] = sum;
+            }
+        }
+
+        y[c] = Buffer(out);
+    }
+
+    n_output_ = n_end;
+
+    if(n_channels_ == 0) return;
+
+    // Drop the input no longer under the kernel.
+    int64 first = static_cast<int64>(n_output_);
+
+    if(!(L_ == 1 && M_ == 1))
+    {
+        first = static_cast<int64>((n_output_ * M_ + delay_) / L_)
+            - static_cast<int64>(n_taps_) + 1;
+    }
+
+    uint32 n_drop = static_cast<uint32>(
+        std::max<int64>(0, std::min<int64>(
+            first - offset_, static_cast<int64>(history_[0].size()))));
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        history_[c].erase(history_[c].begin(), history_[c].begin() + n_drop);
+    }
+
+    offset_ += n_drop;
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,145 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Resampler.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_RESAMPLER_H_
+#define _NSOUND_RESAMPLER_H_
+
+#include <Nsound/Nsound.h>
+
+#include <vector>
+
+namespace Nsound
+{
+
+class AudioStream;
+class Buffer;
+
+//-----------------------------------------------------------------------------
+//! Resamples a stream one block at a time.
+//
+//! Uses the same L / M low pass kernel as Buffer::getResample(), designed
+//! once, and keeps the last input samples and the position of the next
+//! output sample between blocks, so the blocks join without seams and any
+//! block sizes give the same output.  The output is lined up with the
+//! input, the filter delay is already removed.  Call flush() at the end of
+//! the stream for the last samples, a stream of n samples gives
+//! ceil(n * L / M) samples in all.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! Resampler r(48000.0 / 44100.0);
+//!
+//! AudioStream y = r.resampleBlock(block1);
+//! y << r.resampleBlock(block2);
+//! y << r.flush();
+//!
+//! // Python
+//! r = Resampler(48000.0 / 44100.0)
+//! y = r.resampleBlock(block1)
+//! y << r.resampleBlock(block2)
+//! y << r.flush()
+//! \endcode
+class Resampler
+{
+    public:
+
+    //! Resamples by factor, approximated by L / M like getResample().
+    Resampler(
+        const float64 & factor,
+        const uint32 N = 10,
+        const float64 & beta = 5.0);
+
+    //! Resamples by L / M.
+    Resampler(
+        const uint32 L,
+        const uint32 M,
+        const uint32 N = 10,
+        const float64 & beta = 5.0);
+
+    uint32 getL() const { return L_; }
+    uint32 getM() const { return M_; }
+
+    //! Resamples the next block of the stream.
+    //
+    //! Returns the output finished so far, the output lags the input by
+    //! about N samples.  The number of channels must stay the same until
+    //! flush() or reset().  The sample rate of the output is the input's
+    //! times L / M.
+    AudioStream
+    resampleBlock(const AudioStream & x);
+
+    Buffer
+    resampleBlock(const Buffer & x);
+
+    //! Ends the stream, returns the rest.
+    AudioStream
+    flush();
+
+    //! Forgets the stream.
+    void
+    reset();
+
+    private:
+
+    void _init(const uint32 N, const float64 & beta);
+
+    // Computes output samples n_output_ up to n_end into y.
+    void _resample(const uint64 n_end, AudioStream & y);
+
+    uint32 L_;
+    uint32 M_;
+
+    // The low pass kernel, scaled by L, and its delay in output samples of
+    // the L times up sampled stream.
+    std::vector<float64> kernel_;
+    uint32               delay_;
+
+    // The number of input samples under the kernel.
+    uint32 n_taps_;
+
+    uint32  n_channels_;
+    float64 sample_rate_;
+
+    // The input samples still needed, per channel, history_[c][0] is input
+    // sample offset_.  The stream starts with n_taps_ zeros.
+    std::vector< std::vector<float64> > history_;
+    int64                               offset_;
+
+    uint64 n_input_;
+    uint64 n_output_;
+};
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -28,44 +28,43 @@
 
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
-#include <Nsound/FilterAllPass.h>
-#include <Nsound/FilterCombLowPassFeedback.h>
+#include <Nsound/Profiler.h>
 #include <Nsound/ReverberationRoom.h>
 
-#include <ctime>
-#include <cstdlib>
+#include <algorithm>
+#include <cstring>
 
 using namespace Nsound;
 
-using std::cerr;
-using std::endl;
-
-#define CERR_HEADER __FILE__ << ":" << __LINE__ << ": "
-
 const
 float64
 ReverberationRoom::
-COMB_DELAY_TIME_SECONDS_[N_COMB_FILTERS_] =
+TUNING_SAMPLE_RATE_ = 44100.0;
+
+const
+uint32
+ReverberationRoom::
+COMB_DELAY_SAMPLES_[N_COMB_FILTERS_] =
 {
-    1116.0 / 44100.0,
-    1188.0 / 44100.0,
-    1277.0 / 44100.0,
-    1356.0 / 44100.0,
-    1422.0 / 44100.0,
-    1491.0 / 44100.0,
-    1557.0 / 44100.0,
-    1617.0 / 44100.0
+    1116,
+    1188,
+    1277,
+    1356,
+    1422,
+    1491,
+    1557,
+    1617
 };
 
 const
-float64
+uint32
 ReverberationRoom::
-ALL_PASS_DELAY_TIME_SECONDS_[N_ALL_PASS_FILTERS_] =
+ALL_PASS_DELAY_SAMPLES_[N_ALL_PASS_FILTERS_] =
 {
-    556.0 / 44100.0,
-    441.0 / 44100.0,
-    341.0 / 44100.0,
-    225.0 / 44100.0
+    556,
+    441,
+    341,
+    225
 };
 
 const
@@ -78,12 +77,46 @@ float64
 ReverberationRoom::
 ROOM_FEEDBACK_OFFSET_ = 0.7;
 
+// Added to the comb filter input, keeps the decaying feedback loops out of
+// the slow denormal range.
+static const float64 ANTI_DENORMAL = 1e-18;
+
+static const float64 COMB_INPUT_GAIN = 0.15;
+
+static const float64 ALL_PASS_GAIN = 0.5;
 
 //-----------------------------------------------------------------------------
-float64
-getRandom()
+// Copies n samples out of the ring buffer starting at index i.
+static
+void
+readRing(
+    const float64 * ring,
+    const uint32 size,
+    const uint32 i,
+    float64 * y,
+    const uint32 n)
+{
+    uint32 n1 = std::min(n, size - i);
+
+    std::memcpy(y, ring + i, sizeof(float64) * n1);
+    std::memcpy(y + n1, ring, sizeof(float64) * (n - n1));
+}
+
+//-----------------------------------------------------------------------------
+// Copies n samples into the ring buffer starting at index i.
+static
+void
+writeRing(
+    float64 * ring,
+    const uint32 size,
+    const uint32 i,
+    const float64 * x,
+    const uint32 n)
 {
-    return static_cast<float64>(rand() / (RAND_MAX + 1.0));
+    uint32 n1 = std::min(n, size - i);
+
+    std::memcpy(ring + i, x, sizeof(float64) * n1);
+    std::memcpy(ring, x + n1, sizeof(float64) * (n - n1));
 }
 
 //-----------------------------------------------------------------------------
@@ -99,11 +132,19 @@ ReverberationRoom(
     sample_rate_(sample_rate),
     wet_percent_(wet_percent),
     dry_percent_(dry_percent),
-    comb_left_(NULL),
-    comb_right_(NULL),
-    allpass_left_(NULL),
-    allpass_right_(NULL)
+    comb_feedback_(0.0),
+    damp1_(0.0),
+    damp2_(0.0),
+    block_size_(MAX_BLOCK_SIZE_),
+    comb_lines_(),
+    all_pass_lines_(),
+    delayed_(),
+    wet_(),
+    x_delayed_(),
+    y_delayed_()
 {
+    M_ASSERT_VALUE(sample_rate_, >, 0.0);
+
     // Bounds checks:
     if(wet_percent_ < 0.0)
     {
@@ -139,50 +180,84 @@ ReverberationRoom(
         stereo_spread = 0.0;
     }
 
-    // Convert the room size to a delay time.
-    float64 comb_feedback = ROOM_FEEDBACK_SCALE_ * room_feedback
-                          + ROOM_FEEDBACK_OFFSET_;
+    // Convert the room size to a feedback gain.
+    comb_feedback_ = ROOM_FEEDBACK_SCALE_ * room_feedback
+                   + ROOM_FEEDBACK_OFFSET_;
 
-    // Allocate filter pointers
-    comb_left_  = new FilterCombLowPassFeedback * [N_COMB_FILTERS_];
-    comb_right_ = new FilterCombLowPassFeedback * [N_COMB_FILTERS_];
+    if(comb_feedback_ < 0.0)
+    {
+        comb_feedback_ = 0.0;
+    }
 
-    for(uint32 i = 0; i < N_COMB_FILTERS_; ++i)
+    if(comb_feedback_ >= 1.0)
     {
-        comb_left_[i] = new FilterCombLowPassFeedback(
-            sample_rate_,
-            COMB_DELAY_TIME_SECONDS_[i],
-            comb_feedback,
-            lpf);
-
-        comb_right_[i] = new FilterCombLowPassFeedback(
-            sample_rate_,
-            COMB_DELAY_TIME_SECONDS_[i] + stereo_spread,
-            comb_feedback,
-            lpf);
+        comb_feedback_ = 0.999999;
     }
 
-    // Allocate filter pointers
-    allpass_left_  = new FilterAllPass * [N_ALL_PASS_FILTERS_];
-    allpass_right_ = new FilterAllPass * [N_ALL_PASS_FILTERS_];
+    // Same damping as FilterCombLowPassFeedback.
+    damp1_ = lpf / sample_rate_;
 
-    for(uint32 i = 0; i < N_ALL_PASS_FILTERS_; ++i)
+    if(damp1_ > 0.5)
     {
-        allpass_left_[i] = new FilterAllPass(
-            sample_rate_,
-            ALL_PASS_DELAY_TIME_SECONDS_[i],
-            0.5);
-
-        allpass_right_[i] = new FilterAllPass(
-            sample_rate_,
-            ALL_PASS_DELAY_TIME_SECONDS_[i] + stereo_spread,
-            0.5);
+        damp1_ = 0.5;
     }
 
-    ReverberationRoom::reset();
+    damp2_ = 1.0 - damp1_;
+
+    // Scale the delays to the sample rate.
+    const float64 scale = sample_rate_ / TUNING_SAMPLE_RATE_;
+
+    const uint32 spread = static_cast<uint32>(
+        stereo_spread * sample_rate_ + 0.5);
+
+    uint32 offset = 0;
+
+    for(uint32 k = 0; k < N_LANES_; ++k)
+    {
+        uint32 d = static_cast<uint32>(
+            COMB_DELAY_SAMPLES_[k % N_COMB_FILTERS_] * scale + 0.5);
+
+        d = std::max(d, 1u);
+
+        if(k >= N_COMB_FILTERS_) d += spread;
+
+        comb_offset_[k] = offset;
+        comb_delay_[k] = d;
+
+        offset += d;
 
-    // Init random number generator.
-    std::srand(static_cast<unsigned int>(std::time(0)));
+        block_size_ = std::min(block_size_, d);
+    }
+
+    comb_lines_.resize(offset);
+
+    offset = 0;
+
+    for(uint32 i = 0; i < 2 * N_ALL_PASS_FILTERS_; ++i)
+    {
+        uint32 d = static_cast<uint32>(
+            ALL_PASS_DELAY_SAMPLES_[i % N_ALL_PASS_FILTERS_] * scale + 0.5);
+
+        d = std::max(d, 1u);
+
+        if(i >= N_ALL_PASS_FILTERS_) d += spread;
+
+        all_pass_offset_[i] = offset;
+        all_pass_delay_[i] = d;
+
+        offset += 2 * d + 1;
+
+        block_size_ = std::min(block_size_, d);
+    }
+
+    all_pass_lines_.resize(offset);
+
+    delayed_.resize(N_LANES_ * block_size_);
+    wet_.resize(2 * block_size_);
+    x_delayed_.resize(block_size_);
+    y_delayed_.resize(block_size_);
+
+    ReverberationRoom::reset();
 }
 
 //-----------------------------------------------------------------------------
@@ -192,10 +267,16 @@ ReverberationRoom(const ReverberationRoom & copy)
     sample_rate_(copy.sample_rate_),
     wet_percent_(copy.wet_percent_),
     dry_percent_(copy.dry_percent_),
-    comb_left_(NULL),
-    comb_right_(NULL),
-    allpass_left_(NULL),
-    allpass_right_(NULL)
+    comb_feedback_(copy.comb_feedback_),
+    damp1_(copy.damp1_),
+    damp2_(copy.damp2_),
+    block_size_(copy.block_size_),
+    comb_lines_(),
+    all_pass_lines_(),
+    delayed_(),
+    wet_(),
+    x_delayed_(),
+    y_delayed_()
 {
     *this = copy;
 }
@@ -204,21 +285,6 @@ ReverberationRoom(const ReverberationRoom & copy)
 ReverberationRoom::
 ~ReverberationRoom()
 {
-    for(uint32 i = 0; i < N_COMB_FILTERS_; ++i)
-    {
-        delete comb_left_[i];
-        delete comb_right_[i];
-    }
-    delete [] comb_left_;
-    delete [] comb_right_;
-
-    for(uint32 i = 0; i < N_ALL_PASS_FILTERS_; ++i)
-    {
-        delete allpass_left_[i];
-        delete allpass_right_[i];
-    }
-    delete [] allpass_left_;
-    delete [] allpass_right_;
 }
 
 AudioStream
@@ -236,19 +302,21 @@ filter(const AudioStream & x)
 
     reset();
 
-    AudioStream y(sample_rate_, 2);
+    uint32 n_samples = std::min(x[0].getLength(), x[1].getLength());
 
-    uint32 n_samples = x.getLength();
+    AudioStream y(sample_rate_, 2);
 
-    float64 left;
-    float64 right;
+    y[0] = Buffer(FloatVector(n_samples, 0.0));
+    y[1] = Buffer(FloatVector(n_samples, 0.0));
 
-    for(uint32 n = 0; n < n_samples; ++n)
+    if(n_samples > 0)
     {
-        filter(left, right, x[0][n], x[1][n]);
-
-        y[0] << left;
-        y[1] << right;
+        filter(
+            y[0].getPointer(),
+            y[1].getPointer(),
+            x[0].getPointer(),
+            x[1].getPointer(),
+            n_samples);
     }
 
     return y;
@@ -259,19 +327,22 @@ ReverberationRoom::
 filter(const Buffer & x)
 {
     reset();
-    AudioStream y(sample_rate_, 2);
 
     uint32 n_samples = x.getLength();
 
-    float64 left;
-    float64 right;
+    AudioStream y(sample_rate_, 2);
 
-    for(uint32 n = 0; n < n_samples; ++n)
-    {
-        filter(left, right, x[n], x[n]);
+    y[0] = Buffer(FloatVector(n_samples, 0.0));
+    y[1] = Buffer(FloatVector(n_samples, 0.0));
 
-        y[0] << left;
-        y[1] << right;
+    if(n_samples > 0)
+    {
+        filter(
+            y[0].getPointer(),
+            y[1].getPointer(),
+            x.getPointer(),
+            x.getPointer(),
+            n_samples);
     }
 
     return y;
@@ -285,25 +356,165 @@ filter(
     const float64 & in_left,
     const float64 & in_right)
 {
-    out_left  = 0.0 + getRandom() * 1e-23;
-    out_right = 0.0 + getRandom() * 1e-23;
+    float64 x[2] = {in_left, in_right};
+
+    _filterBlock(&out_left, &out_right, &x[0], &x[1], 1);
+}
 
-    // Sum the comb filters in parallel
-    for(uint32 i = 0; i < N_COMB_FILTERS_; ++i)
+void
+ReverberationRoom::
+filter(
+    float64 * out_left,
+    float64 * out_right,
+    const float64 * in_left,
+    const float64 * in_right,
+    const uint32 n_samples)
+{
+    M_CHECK_PTR(out_left);
+    M_CHECK_PTR(out_right);
+    M_CHECK_PTR(in_left);
+    M_CHECK_PTR(in_right);
+
+    M_PROFILE_SAMPLES("ReverberationRoom::filter", n_samples);
+
+    for(uint32 pos = 0; pos < n_samples; pos += block_size_)
+    {
+        _filterBlock(
+            out_left + pos,
+            out_right + pos,
+            in_left + pos,
+            in_right + pos,
+            std::min(block_size_, n_samples - pos));
+    }
+}
+
+void
+ReverberationRoom::
+_filterBlock(
+    float64 * out_left,
+    float64 * out_right,
+    const float64 * in_left,
+    const float64 * in_right,
+    const uint32 n_samples)
+{
+    const uint32 L = N_LANES_;
+    const uint32 C = N_COMB_FILTERS_;
+
+    float64 * d = &delayed_[0];
+
+    // The comb filter outputs of the whole block were written at least one
+    // block ago, gather them lane by lane.
+    for(uint32 k = 0; k < L; ++k)
     {
-        out_left  += comb_left_[i]->filter(in_left * 0.15);
-        out_right += comb_right_[i]->filter(in_right * 0.15);
+        const float64 * line = &comb_lines_[comb_offset_[k]];
+        const uint32 size = comb_delay_[k];
+
+        const uint32 i = comb_index_[k];
+        const uint32 n1 = std::min(n_samples, size - i);
+
+        for(uint32 j = 0; j < n1; ++j) d[j * L + k] = line[i + j];
+
+        for(uint32 j = n1; j < n_samples; ++j) d[j * L + k] = line[j - n1];
     }
 
-    // Serilalize the all pass fitlers
-    for(uint32 i = 0; i < N_ALL_PASS_FILTERS_; ++i)
+    // Run the feedback loops of all lanes in lock step, sum each channel's
+    // comb filters and replace the delay line outputs with the new inputs.
+    float64 * wet[2] = {&wet_[0], &wet_[block_size_]};
+
+    float64 h[L];
+    float64 v[L];
+
+    std::memcpy(h, comb_history_, sizeof(h));
+
+    const float64 fb = comb_feedback_;
+    const float64 damp1 = damp1_;
+    const float64 damp2 = damp2_;
+
+    for(uint32 j = 0; j < n_samples; ++j)
     {
-        out_left  = allpass_left_[i]->filter(out_left);
-        out_right = allpass_right_[i]->filter(out_left);
+        const float64 xl = COMB_INPUT_GAIN * in_left[j] + ANTI_DENORMAL;
+        const float64 xr = COMB_INPUT_GAIN * in_right[j] + ANTI_DENORMAL;
+
+        float64 * dj = d + j * L;
+
+        for(uint32 k = 0; k < C; ++k) v[k]     = xl + h[k]     * fb;
+        for(uint32 k = 0; k < C; ++k) v[k + C] = xr + h[k + C] * fb;
+
+        for(uint32 k = 0; k < L; ++k) h[k] = dj[k] * damp2 + h[k] * damp1;
+
+        float64 left = 0.0;
+        float64 right = 0.0;
+
+        for(uint32 k = 0; k < C; ++k)
+        {
+            left  += dj[k];
+            right += dj[k + C];
+        }
+
+        wet[0][j] = left;
+        wet[1][j] = right;
+
+        std::memcpy(dj, v, sizeof(v));
     }
 
-    out_left  =  wet_percent_ * out_left  + dry_percent_ * in_left;
-    out_right =  wet_percent_ * out_right + dry_percent_ * in_right;
+    std::memcpy(comb_history_, h, sizeof(h));
+
+    // Scatter the new delay line inputs.
+    for(uint32 k = 0; k < L; ++k)
+    {
+        float64 * line = &comb_lines_[comb_offset_[k]];
+        const uint32 size = comb_delay_[k];
+
+        const uint32 i = comb_index_[k];
+        const uint32 n1 = std::min(n_samples, size - i);
+
+        for(uint32 j = 0; j < n1; ++j) line[i + j] = d[j * L + k];
+
+        for(uint32 j = n1; j < n_samples; ++j) line[j - n1] = d[j * L + k];
+
+        comb_index_[k] = (i + n_samples) % size;
+    }
+
+    // The all pass filters in series,
+    // y[n] = g * x[n] + x[n - D] - g * y[n - D - 1].
+    float64 * xd = &x_delayed_[0];
+    float64 * yd = &y_delayed_[0];
+
+    for(uint32 i = 0; i < 2 * N_ALL_PASS_FILTERS_; ++i)
+    {
+        float64 * y = wet[i / N_ALL_PASS_FILTERS_];
+
+        float64 * x_ring = &all_pass_lines_[all_pass_offset_[i]];
+        float64 * y_ring = x_ring + all_pass_delay_[i];
+
+        const uint32 x_size = all_pass_delay_[i];
+        const uint32 y_size = all_pass_delay_[i] + 1;
+
+        const uint32 index = all_pass_index_[i];
+        const uint32 x_index = index % x_size;
+        const uint32 y_index = index % y_size;
+
+        readRing(x_ring, x_size, x_index, xd, n_samples);
+        readRing(y_ring, y_size, y_index, yd, n_samples);
+
+        writeRing(x_ring, x_size, x_index, y, n_samples);
+
+        for(uint32 j = 0; j < n_samples; ++j)
+        {
+            y[j] = ALL_PASS_GAIN * y[j] + xd[j] - ALL_PASS_GAIN * yd[j];
+        }
+
+        writeRing(y_ring, y_size, y_index, y, n_samples);
+
+        // Counts samples modulo both ring sizes.
+        all_pass_index_[i] = (index + n_samples) % (x_size * y_size);
+    }
+
+    for(uint32 j = 0; j < n_samples; ++j)
+    {
+        out_left[j]  = wet_percent_ * wet[0][j] + dry_percent_ * in_left[j];
+        out_right[j] = wet_percent_ * wet[1][j] + dry_percent_ * in_right[j];
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -316,21 +527,32 @@ operator=(const ReverberationRoom & rhs)
         return *this;
     }
 
-    sample_rate_ = rhs.sample_rate_;
-    wet_percent_ = rhs.wet_percent_;
-    dry_percent_ = rhs.dry_percent_;
-
-    for(uint32 i = 0; i < N_COMB_FILTERS_; ++i)
-    {
-        *comb_left_[i] = *(rhs.comb_left_[i]);
-        *comb_right_[i] = *(rhs.comb_right_[i]);
-    }
-
-    for(uint32 i = 0; i < N_ALL_PASS_FILTERS_; ++i)
-    {
-        *allpass_left_[i] = *(rhs.allpass_left_[i]);
-        *allpass_right_[i] = *(rhs.allpass_right_[i]);
-    }
+    sample_rate_   = rhs.sample_rate_;
+    wet_percent_   = rhs.wet_percent_;
+    dry_percent_   = rhs.dry_percent_;
+    comb_feedback_ = rhs.comb_feedback_;
+    damp1_         = rhs.damp1_;
+    damp2_         = rhs.damp2_;
+    block_size_    = rhs.block_size_;
+
+    std::memcpy(comb_offset_, rhs.comb_offset_, sizeof(comb_offset_));
+    std::memcpy(comb_delay_, rhs.comb_delay_, sizeof(comb_delay_));
+    std::memcpy(comb_index_, rhs.comb_index_, sizeof(comb_index_));
+    std::memcpy(comb_history_, rhs.comb_history_, sizeof(comb_history_));
+
+    std::memcpy(
+        all_pass_offset_, rhs.all_pass_offset_, sizeof(all_pass_offset_));
+    std::memcpy(
+        all_pass_delay_, rhs.all_pass_delay_, sizeof(all_pass_delay_));
+    std::memcpy(
+        all_pass_index_, rhs.all_pass_index_, sizeof(all_pass_index_));
+
+    comb_lines_     = rhs.comb_lines_;
+    all_pass_lines_ = rhs.all_pass_lines_;
+    delayed_        = rhs.delayed_;
+    wet_            = rhs.wet_;
+    x_delayed_      = rhs.x_delayed_;
+    y_delayed_      = rhs.y_delayed_;
 
     return *this;
 }
@@ -339,16 +561,17 @@ void
 ReverberationRoom::
 reset()
 {
-     for(uint32 i = 0; i < N_COMB_FILTERS_; ++i)
+    std::fill(comb_lines_.begin(), comb_lines_.end(), 0.0);
+    std::fill(all_pass_lines_.begin(), all_pass_lines_.end(), 0.0);
+
+    for(uint32 k = 0; k < N_LANES_; ++k)
     {
-        comb_left_[i]->reset();
-        comb_right_[i]->reset();
+        comb_index_[k] = 0;
+        comb_history_[k] = 0.0;
     }
 
-    for(uint32 i = 0; i < N_ALL_PASS_FILTERS_; ++i)
+    for(uint32 i = 0; i < 2 * N_ALL_PASS_FILTERS_; ++i)
     {
-        allpass_left_[i]->reset();
-        allpass_right_[i]->reset();
+        all_pass_index_[i] = 0;
     }
 }
-
@@ -37,15 +37,28 @@
 
 #include <Nsound/Nsound.h>
 
+#include <vector>
+
 namespace Nsound
 {
 
 class AudioStream;
 class Buffer;
-class FilterAllPass;
-class FilterCombLowPassFeedback;
 
 //-----------------------------------------------------------------------------
+//! A Freeverb style stereo room reverb.
+//
+//! Eight parallel low pass feedback comb filters feed four serial all pass
+//! filters on each channel.  The sixteen comb filters of both channels are
+//! processed together as lanes of one block: their delay lines share one
+//! contiguous allocation, the feedback loops of all lanes are updated in
+//! one fixed width loop the compiler vectorizes, and the right channel's
+//! lanes carry the stereo spread in the same pass.  The all pass filters
+//! are processed a block at a time too, the blocks are never longer than
+//! the shortest delay so no sample depends on another in the same block.
+//!
+//! The delay lengths are tuned in samples at 44100 Hz and scaled to the
+//! sample rate.
 class ReverberationRoom
 {
     public:
@@ -84,6 +97,17 @@ class ReverberationRoom
         const float64 & in_left,
         const float64 & in_right);
 
+    #ifndef SWIG
+    //! Filters n_samples of stereo input, the output may overwrite the input.
+    void
+    filter(
+        float64 * out_left,
+        float64 * out_right,
+        const float64 * in_left,
+        const float64 * in_right,
+        const uint32 n_samples);
+    #endif
+
     float64
     getSampleRate() const { return sample_rate_; };
 
@@ -95,26 +119,65 @@ class ReverberationRoom
 
     protected:
 
+    void
+    _filterBlock(
+        float64 * out_left,
+        float64 * out_right,
+        const float64 * in_left,
+        const float64 * in_right,
+        const uint32 n_samples);
+
+    static const float64 ROOM_FEEDBACK_SCALE_;  //  = 0.28;
+    static const float64 ROOM_FEEDBACK_OFFSET_; // = 0.7;
+
+    static const uint32 N_COMB_FILTERS_     = 8;
+    static const uint32 N_ALL_PASS_FILTERS_ = 4;
+
+    // Comb filters of the left channel, then the right channel.
+    static const uint32 N_LANES_ = 2 * N_COMB_FILTERS_;
+
+    static const uint32 MAX_BLOCK_SIZE_ = 256;
+
+    // The delay lengths in samples at TUNING_SAMPLE_RATE_.
+    static const float64 TUNING_SAMPLE_RATE_;
+
+    static const uint32 COMB_DELAY_SAMPLES_[N_COMB_FILTERS_];
+
+    static const uint32 ALL_PASS_DELAY_SAMPLES_[N_ALL_PASS_FILTERS_];
+
     float64 sample_rate_;
 
     float64 wet_percent_;
     float64 dry_percent_;
 
-    FilterCombLowPassFeedback ** comb_left_;
-    FilterCombLowPassFeedback ** comb_right_;
+    float64 comb_feedback_;
+    float64 damp1_;
+    float64 damp2_;
 
-    FilterAllPass ** allpass_left_;
-    FilterAllPass ** allpass_right_;
+    uint32 block_size_;
 
-    static const float64 ROOM_FEEDBACK_SCALE_;  //  = 0.28;
-    static const float64 ROOM_FEEDBACK_OFFSET_; // = 0.7;
+    // Comb filter lanes, every delay line is a ring buffer in comb_lines_.
+    uint32  comb_offset_[N_LANES_];
+    uint32  comb_delay_[N_LANES_];
+    uint32  comb_index_[N_LANES_];
+    float64 comb_history_[N_LANES_];
 
-    static const uint32 N_COMB_FILTERS_     = 8;
-    static const uint32 N_ALL_PASS_FILTERS_ = 4;
+    std::vector<float64> comb_lines_;
+
+    // All pass filters, left channel then right channel.  Each holds a
+    // ring of its past inputs and a one sample longer ring of its past
+    // outputs in all_pass_lines_.
+    uint32 all_pass_offset_[2 * N_ALL_PASS_FILTERS_];
+    uint32 all_pass_delay_[2 * N_ALL_PASS_FILTERS_];
+    uint32 all_pass_index_[2 * N_ALL_PASS_FILTERS_];
 
-    static const float64 COMB_DELAY_TIME_SECONDS_[N_COMB_FILTERS_];
+    std::vector<float64> all_pass_lines_;
 
-    static const float64 ALL_PASS_DELAY_TIME_SECONDS_[N_ALL_PASS_FILTERS_];
+    // Block scratch, the comb filter lanes are interleaved sample by sample.
+    std::vector<float64> delayed_;
+    std::vector<float64> wet_;
+    std::vector<float64> x_delayed_;
+    std::vector<float64> y_delayed_;
 
 };
 
@@ -0,0 +1,440 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Sequencer.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioPlaybackRt.h>
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/Sequencer.h>
+#include <Nsound/VoicePool.h>
+#include <Nsound/Wavefile.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Nsound;
+
+Sequencer::
+Sequencer(
+    const float64 & sample_rate,
+    const uint32 n_channels,
+    const uint32 samples_per_block)
+    :
+    sample_rate_(sample_rate),
+    n_channels_(n_channels),
+    samples_per_block_(samples_per_block),
+    position_(0),
+    lookahead_(static_cast<uint64>(sample_rate + 0.5)),
+    tracks_(),
+    events_(),
+    block_(sample_rate, n_channels),
+    scratch_(sample_rate, n_channels),
+    channels_(n_channels, NULL),
+    scratch_channels_(n_channels, NULL)
+{
+    M_ASSERT_VALUE(sample_rate, >, 0.0);
+    M_ASSERT_VALUE(n_channels, >, 0);
+    M_ASSERT_VALUE(samples_per_block, >, 0);
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        block_[c] = Buffer::zeros(samples_per_block_);
+        scratch_[c] = Buffer::zeros(samples_per_block_);
+
+        channels_[c] = block_[c].getPointer();
+        scratch_channels_[c] = scratch_[c].getPointer();
+    }
+}
+
+uint32
+Sequencer::
+addTrack(VoicePool & pool, const float64 & gain)
+{
+    uint32 n_channels = pool.getNChannels();
+
+    M_ASSERT_MSG(
+        n_channels == 1 || n_channels == n_channels_,
+        "The pool has " << n_channels << " channels, the sequencer has "
+        << n_channels_);
+
+    Track t;
+
+    t.pool = &pool;
+    t.gain = gain;
+    t.target = gain;
+    t.step = 0.0;
+    t.n_ramp = 0;
+
+    tracks_.push_back(t);
+
+    return static_cast<uint32>(tracks_.size() - 1);
+}
+
+uint64
+Sequencer::
+_toSample(const float64 & time) const
+{
+    M_ASSERT_VALUE(time, >=, 0.0);
+
+    return static_cast<uint64>(time * sample_rate_ + 0.5);
+}
+
+void
+Sequencer::
+_schedule(const float64 & time, const Event & event)
+{
+    uint64 sample = _toSample(time);
+
+    // Events in the past fire before the next sample.
+    if(sample < position_) sample = position_;
+
+    events_.insert(std::make_pair(sample, event));
+}
+
+void
+Sequencer::
+addNote(
+    const uint32 track,
+    const float64 & time,
+    const float64 & duration,
+    const float64 & frequency,
+    const float64 & velocity)
+{
+    M_ASSERT_VALUE(track, <, tracks_.size());
+    M_ASSERT_VALUE(duration, >, 0.0);
+
+    Event e;
+
+    e.type = NOTE;
+    e.track = track;
+    e.a = frequency;
+    e.b = duration;
+    e.c = velocity;
+    e.prepared = false;
+
+    _schedule(time, e);
+}
+
+void
+Sequencer::
+addGain(
+    const uint32 track,
+    const float64 & time,
+    const float64 & gain,
+    const float64 & ramp_time)
+{
+    M_ASSERT_VALUE(track, <, tracks_.size());
+    M_ASSERT_VALUE(ramp_time, >=, 0.0);
+
+    Event e;
+
+    e.type = GAIN;
+    e.track = track;
+    e.a = gain;
+    e.b = ramp_time;
+    e.c = 0.0;
+    e.prepared = false;
+
+    _schedule(time, e);
+}
+
+void
+Sequencer::
+addEvent(const float64 & time, const Callback & callback)
+{
+    M_ASSERT_MSG(static_cast<bool>(callback), "callback is empty");
+
+    Event e;
+
+    e.type = CALLBACK;
+    e.track = 0;
+    e.a = 0.0;
+    e.b = 0.0;
+    e.c = 0.0;
+    e.prepared = false;
+    e.callback = callback;
+
+    _schedule(time, e);
+}
+
+void
+Sequencer::
+setLookahead(const float64 & seconds)
+{
+    M_ASSERT_VALUE(seconds, >=, 0.0);
+
+    lookahead_ = static_cast<uint64>(seconds * sample_rate_ + 0.5);
+}
+
+void
+Sequencer::
+_prepareNotes(const uint32 n_samples)
+{
+    uint64 horizon = position_ + n_samples + lookahead_;
+
+    for(auto i = events_.begin(); i != events_.end(); ++i)
+    {
+        if(i->first >= horizon) break;
+
+        Event & e = i->second;
+
+        if(e.type != NOTE || e.prepared) continue;
+
+        tracks_[e.track].pool->prepare(e.a, e.b);
+
+        e.prepared = true;
+    }
+}
+
+void
+Sequencer::
+clear()
+{
+    events_.clear();
+}
+
+void
+Sequencer::
+reset()
+{
+    events_.clear();
+
+    for(auto & t : tracks_)
+    {
+        t.pool->reset();
+        t.gain = t.target;
+        t.step = 0.0;
+        t.n_ramp = 0;
+    }
+
+    position_ = 0;
+}
+
+void
+Sequencer::
+_fire(const Event & event)
+{
+    switch(event.type)
+    {
+        case NOTE:
+        {
+            tracks_[event.track].pool->noteOn(event.a, event.b, event.c);
+            break;
+        }
+
+        case GAIN:
+        {
+            Track & t = tracks_[event.track];
+
+            uint64 n = static_cast<uint64>(event.b * sample_rate_ + 0.5);
+
+            t.target = event.a;
+
+            if(n == 0)
+            {
+                t.gain = event.a;
+                t.step = 0.0;
+                t.n_ramp = 0;
+            }
+            else
+            {
+                t.step = (event.a - t.gain) / static_cast<float64>(n);
+                t.n_ramp = n;
+            }
+
+            break;
+        }
+
+        case CALLBACK:
+        {
+            event.callback();
+            break;
+        }
+    }
+}
+
+void
+Sequencer::
+_renderBlock(const uint32 n_samples)
+{
+    M_PROFILE_SAMPLES("Sequencer::renderBlock", n_samples);
+
+    _prepareNotes(n_samples);
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        std::memset(block_[c].getPointer(), 0, sizeof(float64) * n_samples);
+    }
+
+    uint32 pos = 0;
+
+    while(pos < n_samples)
+    {
+        // Fire everything due at this sample.
+        while(!events_.empty() && events_.begin()->first <= position_ + pos)
+        {
+            Event e = events_.begin()->second;
+            events_.erase(events_.begin());
+            _fire(e);
+        }
+
+        uint32 end = n_samples;
+
+        if(!events_.empty())
+        {
+            uint64 next = events_.begin()->first - position_;
+
+            if(next < end) end = static_cast<uint32>(next);
+        }
+
+        const uint32 n = end - pos;
+
+        for(auto & t : tracks_)
+        {
+            const uint32 n_track_channels = t.pool->getNChannels();
+
+            for(uint32 c = 0; c < n_track_channels; ++c)
+            {
+                std::memset(scratch_channels_[c], 0, sizeof(float64) * n);
+            }
+
+            t.pool->mix(scratch_channels_.data(), n);
+
+            // The gain is constant after the ramp.
+            uint32 n_ramp = static_cast<uint32>(
+                std::min(t.n_ramp, static_cast<uint64>(n)));
+
+            for(uint32 c = 0; c < n_channels_; ++c)
+            {
+                const float64 * s =
+                    scratch_channels_[n_track_channels == 1 ? 0 : c];
+
+                float64 * y = block_[c].getPointer() + pos;
+
+                float64 gain = t.gain;
+
+                for(uint32 i = 0; i < n_ramp; ++i)
+                {
+                    y[i] += gain * s[i];
+                    gain += t.step;
+                }
+
+                if(n_ramp == t.n_ramp) gain = t.target;
+
+                for(uint32 i = n_ramp; i < n; ++i) y[i] += gain * s[i];
+            }
+
+            if(n_ramp > 0)
+            {
+                t.n_ramp -= n_ramp;
+
+                if(t.n_ramp == 0) t.gain = t.target;
+                else              t.gain += n_ramp * t.step;
+            }
+        }
+
+        pos = end;
+    }
+
+    position_ += n_samples;
+}
+
+const AudioStream &
+Sequencer::
+renderBlock()
+{
+    _renderBlock(samples_per_block_);
+
+    return block_;
+}
+
+AudioStream
+Sequencer::
+render(const float64 & duration)
+{
+    M_ASSERT_VALUE(duration, >, 0.0);
+
+    uint32 n_samples = static_cast<uint32>(duration * sample_rate_ + 0.5);
+
+    AudioStream y(sample_rate_, n_channels_, n_samples);
+
+    while(n_samples > 0)
+    {
+        uint32 n = std::min(n_samples, samples_per_block_);
+
+        _renderBlock(n);
+
+        for(uint32 c = 0; c < n_channels_; ++c)
+        {
+            if(n == samples_per_block_) y[c] << block_[c];
+            else                        y[c] << block_[c].subbuffer(0, n);
+        }
+
+        n_samples -= n;
+    }
+
+    return y;
+}
+
+void
+Sequencer::
+render(WavefileWriter & out, const float64 & duration)
+{
+    M_ASSERT_VALUE(duration, >, 0.0);
+    M_ASSERT_VALUE(out.getNChannels(), ==, n_channels_);
+
+    uint32 n_samples = static_cast<uint32>(duration * sample_rate_ + 0.5);
+
+    while(n_samples > 0)
+    {
+        uint32 n = std::min(n_samples, samples_per_block_);
+
+        _renderBlock(n);
+
+        out.write(channels_.data(), n);
+
+        n_samples -= n;
+    }
+}
+
+void
+Sequencer::
+render(AudioPlaybackRt & pb, const float64 & duration)
+{
+    M_ASSERT_VALUE(duration, >, 0.0);
+
+    uint32 n_blocks = static_cast<uint32>(
+        duration * sample_rate_ / samples_per_block_ + 0.5);
+
+    for(uint32 i = 0; i < n_blocks; ++i)
+    {
+        pb.play(renderBlock());
+    }
+}
+
+// :mode=c++: jEdit modeline
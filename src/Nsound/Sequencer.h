@@ -0,0 +1,266 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Sequencer.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_SEQUENCER_H_
+#define _NSOUND_SEQUENCER_H_
+
+#include <Nsound/Nsound.h>
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace Nsound
+{
+
+class AudioPlaybackRt;
+class VoicePool;
+class WavefileWriter;
+
+//-----------------------------------------------------------------------------
+//! Plays scheduled notes and automation with sample accurate timing.
+//
+//! Each track is a VoicePool with a gain.  Notes, gain ramps and callbacks
+//! are scheduled at times in seconds that are rounded to the nearest
+//! sample.  Rendering happens a block at a time, a block is split at the
+//! samples where events fire, so an event's timing never depends on the
+//! block size.
+//!
+//! Memory doesn't grow with the arrangement's length: fired events are
+//! dropped and rendering into a WavefileWriter or AudioPlaybackRt only
+//! holds one block.  Before each block, notes starting within the
+//! lookahead are rendered into the track's note cache (see
+//! VoicePool::prepare()), so a cache that holds the notes of one lookahead
+//! never renders a note twice.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! GuitarBass bass(44100.0);
+//! DrumBD01   kick(44100.0);
+//!
+//! VoicePool bass_voices(bass, 4);
+//! VoicePool kick_voices(kick, 2);
+//!
+//! Sequencer seq(44100.0, 2);
+//!
+//! uint32 b = seq.addTrack(bass_voices, 0.5);
+//! uint32 k = seq.addTrack(kick_voices);
+//!
+//! for(uint32 i = 0; i < 16; ++i)
+//! {
+//!     seq.addNote(k, 0.5 * i, 0.5, 60.0);
+//!     seq.addNote(b, 0.5 * i, 0.4, 61.734);
+//! }
+//!
+//! // Fade the bass out over the last two seconds.
+//! seq.addGain(b, 6.0, 0.0, 2.0);
+//!
+//! WavefileWriter out("song.wav", 44100.0, 2);
+//!
+//! seq.render(out, 8.5);
+//! \endcode
+class Sequencer
+{
+    public:
+
+    //! Creates the sequencer.
+    //
+    //! \param sample_rate the sample rate of the tracks
+    //! \param n_channels the number of channels, a track with one channel
+    //!        is mixed into every channel, others channel by channel
+    //! \param samples_per_block the number of samples rendered per block
+    Sequencer(
+        const float64 & sample_rate,
+        const uint32 n_channels = 1,
+        const uint32 samples_per_block = 512);
+
+    //! Adds a track, returns the track index.  The pool must outlive the
+    //! sequencer, use the same sample rate and have one channel or the
+    //! sequencer's number of channels.
+    uint32
+    addTrack(VoicePool & pool, const float64 & gain = 1.0);
+
+    //! Schedules a note on the track.
+    //
+    //! \param track the track index
+    //! \param time the note's start time in seconds
+    //! \param duration the note's duration in seconds
+    //! \param frequency the note's frequency in Hz
+    //! \param velocity the note's gain
+    void
+    addNote(
+        const uint32 track,
+        const float64 & time,
+        const float64 & duration,
+        const float64 & frequency,
+        const float64 & velocity = 1.0);
+
+    //! Schedules a change of the track's gain.
+    //
+    //! \param track the track index
+    //! \param time the time the change starts in seconds
+    //! \param gain the new gain
+    //! \param ramp_time the gain ramps linearly to the new gain over this
+    //!        many seconds, 0 jumps
+    void
+    addGain(
+        const uint32 track,
+        const float64 & time,
+        const float64 & gain,
+        const float64 & ramp_time = 0.0);
+
+    #ifndef SWIG
+    typedef std::function<void ()> Callback;
+
+    //! Schedules a callback, it runs before the sample at time is rendered.
+    void
+    addEvent(const float64 & time, const Callback & callback);
+    #endif
+
+    //! Drops every pending event.
+    void
+    clear();
+
+    //! Drops every pending event, silences the tracks and rewinds to 0.
+    void
+    reset();
+
+    //! Sets how far ahead notes are rendered into the note cache, default
+    //! 1 second.
+    void
+    setLookahead(const float64 & seconds);
+
+    float64
+    getLookahead() const { return lookahead_ / sample_rate_; }
+
+    uint32 getNChannels() const { return n_channels_; }
+    uint32 getNEvents() const { return static_cast<uint32>(events_.size()); }
+    uint32 getNTracks() const { return static_cast<uint32>(tracks_.size()); }
+    uint32 getSamplesPerBlock() const { return samples_per_block_; }
+    float64 getSampleRate() const { return sample_rate_; }
+
+    //! The number of samples rendered so far.
+    uint64
+    getPosition() const { return position_; }
+
+    //! Renders the next block.
+    //
+    //! The returned reference is valid until the next call.
+    const AudioStream &
+    renderBlock();
+
+    //! Renders duration seconds offline.
+    AudioStream
+    render(const float64 & duration);
+
+    //! Renders duration seconds into the open file.
+    void
+    render(WavefileWriter & out, const float64 & duration);
+
+    //! Renders duration seconds into the real-time playback object.
+    void
+    render(AudioPlaybackRt & pb, const float64 & duration);
+
+    private:
+
+    Sequencer(const Sequencer & copy);
+    Sequencer & operator=(const Sequencer & rhs);
+
+    enum EventType
+    {
+        NOTE,
+        GAIN,
+        CALLBACK
+    };
+
+    struct Event
+    {
+        EventType type;
+        uint32    track;
+        float64   a;
+        float64   b;
+        float64   c;
+        bool      prepared;
+
+        #ifndef SWIG
+        Callback  callback;
+        #endif
+    };
+
+    struct Track
+    {
+        VoicePool * pool;
+        float64     gain;
+        float64     target;
+        float64     step;
+        uint64      n_ramp;
+    };
+
+    uint64 _toSample(const float64 & time) const;
+
+    void _schedule(const float64 & time, const Event & event);
+
+    void _fire(const Event & event);
+
+    //! Renders the notes starting before position_ + n_samples + lookahead_.
+    void _prepareNotes(const uint32 n_samples);
+
+    //! Renders the next n_samples <= samples_per_block_ into block_.
+    void _renderBlock(const uint32 n_samples);
+
+    float64 sample_rate_;
+    uint32  n_channels_;
+    uint32  samples_per_block_;
+
+    uint64  position_;
+    uint64  lookahead_;
+
+    std::vector<Track> tracks_;
+
+    // Sorted by sample, equal samples fire in the order they were added.
+    std::multimap<uint64, Event> events_;
+
+    AudioStream block_;
+    AudioStream scratch_;
+
+    std::vector<const float64 *> channels_;
+    std::vector<float64 *>       scratch_channels_;
+
+}; // class Sequencer
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -0,0 +1,311 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: SlidingWindow.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/SlidingWindow.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace Nsound;
+
+static const float64 NEG_INF = -std::numeric_limits<float64>::infinity();
+
+//-----------------------------------------------------------------------------
+SlidingWindow::
+SlidingWindow(const Statistic statistic, const uint32 window_size)
+    :
+    statistic_(statistic),
+    window_size_(window_size),
+    n_(0),
+    window_(),
+    position_(0),
+    sum_(0.0),
+    deque_index_(),
+    deque_value_(),
+    front_(0),
+    size_(0)
+{
+    M_ASSERT_VALUE(window_size, >, 0);
+
+    if(statistic_ == MIN || statistic_ == MAX)
+    {
+        deque_index_.resize(window_size_, 0);
+        deque_value_.resize(window_size_, 0.0);
+    }
+    else
+    {
+        window_.resize(window_size_, 0.0);
+    }
+}
+
+void
+SlidingWindow::
+reset()
+{
+    n_ = 0;
+    position_ = 0;
+    sum_ = 0.0;
+    front_ = 0;
+    size_ = 0;
+
+    std::fill(window_.begin(), window_.end(), 0.0);
+}
+
+inline
+float64
+SlidingWindow::
+_push(const float64 & x)
+{
+    const uint32 N = window_size_;
+
+    if(statistic_ == MIN || statistic_ == MAX)
+    {
+        // Expire the front.
+        if(size_ > 0 && deque_index_[front_] + N <= n_)
+        {
+            if(++front_ == N) front_ = 0;
+            --size_;
+        }
+
+        // Pop the back while it can never be the answer again.
+        while(size_ > 0)
+        {
+            uint32 back = front_ + size_ - 1;
+
+            if(back >= N) back -= N;
+
+            float64 v = deque_value_[back];
+
+            if(statistic_ == MAX ? v > x : v < x) break;
+
+            --size_;
+        }
+
+        uint32 back = front_ + size_;
+
+        if(back >= N) back -= N;
+
+        deque_index_[back] = n_;
+        deque_value_[back] = x;
+        ++size_;
+
+        ++n_;
+
+        return deque_value_[front_];
+    }
+
+    float64 v = statistic_ == RMS ? x * x : x;
+
+    sum_ += v - window_[position_];
+
+    window_[position_] = v;
+
+    if(++position_ == N)
+    {
+        // Resynchronize.
+        position_ = 0;
+        sum_ = 0.0;
+        for(uint32 i = 0; i < N; ++i) sum_ += window_[i];
+    }
+
+    ++n_;
+
+    switch(statistic_)
+    {
+        case MEAN: return sum_ / static_cast<float64>(N);
+        case RMS:  return std::sqrt(std::max(sum_, 0.0) / N);
+        default:   return sum_;
+    }
+}
+
+float64
+SlidingWindow::
+filter(const float64 & x)
+{
+    return _push(x);
+}
+
+void
+SlidingWindow::
+filter(const float64 * x, float64 * y, const uint32 n_samples)
+{
+    M_PROFILE_SAMPLES("SlidingWindow::filter", n_samples);
+
+    for(uint32 i = 0; i < n_samples; ++i) y[i] = _push(x[i]);
+}
+
+Buffer
+SlidingWindow::
+filter(const Buffer & x)
+{
+    Buffer y(x);
+
+    filter(y.getPointer(), y.getPointer(), y.getLength());
+
+    return y;
+}
+
+AudioStream
+SlidingWindow::
+filter(const AudioStream & x)
+{
+    AudioStream y(x.getSampleRate(), x.getNChannels());
+
+    for(uint32 c = 0; c < x.getNChannels(); ++c)
+    {
+        y[c] = filter(x[c]);
+    }
+
+    return y;
+}
+
+//-----------------------------------------------------------------------------
+PeakFinder::
+PeakFinder(const uint32 window_size, const float64 & min_height)
+    :
+    is_strict_(window_size <= 2),
+    half_window_(window_size <= 2 ? 1 : window_size / 2),
+    min_height_(min_height),
+    n_(0),
+    max_(SlidingWindow::MAX, 2 * half_window_ + 1),
+    history_(half_window_ + 1, 0.0)
+{
+}
+
+void
+PeakFinder::
+reset()
+{
+    n_ = 0;
+    max_.reset();
+}
+
+inline
+void
+PeakFinder::
+_candidate(
+    const uint64 index,
+    const float64 & max,
+    Uint32Vector & peaks) const
+{
+    float64 x = history_[index % (half_window_ + 1)];
+
+    if(index >= 1 && x >= max && x > min_height_)
+    {
+        peaks.push_back(static_cast<uint32>(index));
+    }
+}
+
+void
+PeakFinder::
+find(const float64 * x, const uint32 n_samples, Uint32Vector & peaks)
+{
+    M_PROFILE_SAMPLES("PeakFinder::find", n_samples);
+
+    if(is_strict_)
+    {
+        for(uint32 i = 0; i < n_samples; ++i, ++n_)
+        {
+            float64 prev = history_[0];
+            float64 center = history_[1];
+
+            if(n_ >= 2 &&
+               center > prev &&
+               center > x[i] &&
+               center > min_height_)
+            {
+                peaks.push_back(static_cast<uint32>(n_ - 1));
+            }
+
+            history_[0] = center;
+            history_[1] = x[i];
+        }
+
+        return;
+    }
+
+    const uint32 w = half_window_;
+
+    for(uint32 i = 0; i < n_samples; ++i, ++n_)
+    {
+        // The first sample is never compared against, see findPeaks().
+        float64 max = max_.filter(n_ == 0 ? NEG_INF : x[i]);
+
+        history_[n_ % (w + 1)] = x[i];
+
+        if(n_ >= w) _candidate(n_ - w, max, peaks);
+    }
+}
+
+void
+PeakFinder::
+flush(Uint32Vector & peaks)
+{
+    const uint32 w = half_window_;
+
+    // The window is cut short at the end of the signal, the last sample
+    // is never a peak.
+    if(!is_strict_)
+    {
+        for(uint64 t = n_; t + 2 <= n_ + w; ++t)
+        {
+            float64 max = max_.filter(NEG_INF);
+
+            if(t >= w) _candidate(t - w, max, peaks);
+        }
+    }
+
+    reset();
+}
+
+Uint32Vector
+PeakFinder::
+find(const Buffer & x)
+{
+    Uint32Vector peaks;
+
+    find(x.getPointer(), x.getLength(), peaks);
+
+    return peaks;
+}
+
+Uint32Vector
+PeakFinder::
+flush()
+{
+    Uint32Vector peaks;
+
+    flush(peaks);
+
+    return peaks;
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,205 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: SlidingWindow.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_SLIDING_WINDOW_H_
+#define _NSOUND_SLIDING_WINDOW_H_
+
+#include <Nsound/Nsound.h>
+#include <Nsound/CircularIterators.h>
+
+#include <vector>
+
+namespace Nsound
+{
+
+class AudioStream;
+class Buffer;
+
+//-----------------------------------------------------------------------------
+//! A running statistic over the last N samples in O(1) per sample.
+//
+//! Sums are updated by adding the new sample and subtracting the oldest
+//! one, the sum is recomputed from the window every N samples so rounding
+//! errors don't accumulate over long signals.  The minimum and maximum are
+//! kept in a monotonic deque, each sample is pushed and popped at most once.
+//!
+//! The window is causal, output i covers samples i - N + 1 through i.
+//! Before N samples have been seen the sums are over the samples so far
+//! (as if preceded by zeros) and the minimum and maximum are over the
+//! samples so far.  State is carried across calls, so a long signal can be
+//! processed one block at a time with the same result.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! SlidingWindow loudness(SlidingWindow::RMS, 1024);
+//!
+//! Buffer rms = loudness.filter(x);
+//!
+//! // Python
+//! loudness = SlidingWindow(SlidingWindow.RMS, 1024)
+//! rms = loudness.filter(x)
+//! \endcode
+class SlidingWindow
+{
+    public:
+
+    enum Statistic
+    {
+        SUM,
+        MEAN,
+        RMS,
+        MIN,
+        MAX
+    };
+
+    //! Creates the window.
+    //
+    //! \param statistic the statistic to output
+    //! \param window_size the number of samples in the window
+    SlidingWindow(const Statistic statistic, const uint32 window_size);
+
+    AudioStream filter(const AudioStream & x);
+
+    Buffer filter(const Buffer & x);
+
+    float64 filter(const float64 & x);
+
+    #ifndef SWIG
+    //! Processes n_samples of x into y, x and y may be the same.
+    void filter(const float64 * x, float64 * y, const uint32 n_samples);
+    #endif
+
+    Statistic getStatistic() const { return statistic_; }
+
+    uint32 getWindowSize() const { return window_size_; }
+
+    //! Forgets every sample seen.
+    void reset();
+
+    private:
+
+    float64 _push(const float64 & x);
+
+    Statistic statistic_;
+    uint32    window_size_;
+
+    uint64    n_;
+
+    // SUM, MEAN, RMS: the samples (squared for RMS) in the window.
+    std::vector<float64> window_;
+    uint32               position_;
+    float64              sum_;
+
+    // MIN, MAX: a ring of (index, value) pairs, values are decreasing for
+    // MAX and increasing for MIN from the front.
+    std::vector<uint64>  deque_index_;
+    std::vector<float64> deque_value_;
+    uint32               front_;
+    uint32               size_;
+};
+
+//-----------------------------------------------------------------------------
+//! Finds peaks in a signal processed one block at a time.
+//
+//! Finds the same peaks as Buffer::findPeaks() in O(1) per sample.  A peak
+//! is only known window_size / 2 samples after it, so find() returns the
+//! peaks confirmed so far and flush() returns the rest once the signal
+//! ended.  The peaks are sample indices from the start of the signal.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! PeakFinder finder(1000, 0.1);
+//!
+//! Uint32Vector peaks = finder.find(block1);
+//! Uint32Vector more = finder.find(block2);
+//! Uint32Vector last = finder.flush();
+//!
+//! // Python
+//! finder = PeakFinder(1000, 0.1)
+//! peaks = finder.find(block1)
+//! peaks += finder.flush()
+//! \endcode
+class PeakFinder
+{
+    public:
+
+    //! Creates the peak finder.
+    //
+    //! \param window_size a peak is a sample no smaller than any sample
+    //!        within window_size / 2 samples, for window sizes <= 2 a peak
+    //!        is larger than both of its neighbors
+    //! \param min_height peaks must be larger than this
+    PeakFinder(const uint32 window_size = 0, const float64 & min_height = 0.0);
+
+    //! Processes the next block, returns the peaks confirmed so far.
+    Uint32Vector find(const Buffer & x);
+
+    #ifndef SWIG
+    //! Processes the next block, appends the peaks confirmed so far.
+    void find(const float64 * x, const uint32 n_samples, Uint32Vector & peaks);
+
+    //! Ends the signal, appends the remaining peaks.
+    void flush(Uint32Vector & peaks);
+    #endif
+
+    //! Ends the signal, returns the remaining peaks.
+    Uint32Vector flush();
+
+    //! Starts a new signal.
+    void reset();
+
+    private:
+
+    void _candidate(
+        const uint64 index,
+        const float64 & max,
+        Uint32Vector & peaks) const;
+
+    bool    is_strict_;
+    uint32  half_window_;
+    float64 min_height_;
+
+    uint64  n_;
+
+    // The centered maximum is the causal maximum half_window_ samples late.
+    SlidingWindow max_;
+
+    // The last half_window_ + 1 samples, the last 2 when strict.
+    std::vector<float64> history_;
+};
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
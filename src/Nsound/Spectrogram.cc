@@ -33,6 +33,7 @@
 #include <Nsound/Spectrogram.h>
 #include <Nsound/Plotter.h>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace Nsound;
@@ -231,6 +232,7 @@ Spectrogram(
 Spectrogram::
 Spectrogram(const Spectrogram & copy)
     :
+    sample_rate_(copy.sample_rate_),
     frequency_axis_(new Buffer(*copy.frequency_axis_)),
     time_axis_(new Buffer(*copy.time_axis_)),
     real_(new AudioStream(*copy.real_)),
@@ -308,6 +310,48 @@ plot(
     // Transpose so x is the time axis.
     mag.transpose();
 
+    Buffer time_axis = *time_axis_;
+
+    // Keep the loudest frame of each group of frames that share a pixel.
+    uint32 n_frames = mag.getLength();
+    uint32 width = Plotter::getPixelWidth();
+
+    if(n_frames > width)
+    {
+        uint32 k = (n_frames + width - 1) / width;
+        uint32 n = (n_frames + k - 1) / k;
+
+        AudioStream pooled(mag.getSampleRate(), mag.getNChannels());
+
+        for(uint32 c = 0; c < mag.getNChannels(); ++c)
+        {
+            const float64 * x = mag[c].getPointer();
+
+            Buffer y(n);
+
+            for(uint32 j = 0; j < n; ++j)
+            {
+                uint32 end = std::min(n_frames, (j + 1) * k);
+
+                y << *std::max_element(x + j * k, x + end);
+            }
+
+            pooled[c] = y;
+        }
+
+        mag = pooled;
+
+        // The time at the center of each group.
+        time_axis = Buffer(n);
+
+        for(uint32 j = 0; j < n; ++j)
+        {
+            uint32 end = std::min(n_frames, (j + 1) * k);
+
+            time_axis << 0.5 * ((*time_axis_)[j * k] + (*time_axis_)[end - 1]);
+        }
+    }
+
     if(use_dB)
     {
         mag += 1.0;
@@ -331,7 +375,7 @@ plot(
     Plotter pylab;
 
     pylab.figure();
-    pylab.imagesc(*time_axis_, *frequency_axis_, mag);
+    pylab.imagesc(time_axis, *frequency_axis_, mag);
     pylab.xlabel("Time (sec)");
     pylab.ylabel("Frequency (Hz)");
     pylab.title(title);
@@ -0,0 +1,416 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: SpectrogramCache.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/SpectrogramCache.h>
+#include <Nsound/StreamingSTFT.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef NSOUND_PLATFORM_OS_WINDOWS
+    #include <sys/mman.h>
+#endif
+
+using namespace Nsound;
+
+//-----------------------------------------------------------------------------
+SpectrogramCache::
+SpectrogramCache(
+    const float64 &    sample_rate,
+    const float64 &    time_window,
+    const float64 &    time_step,
+    const WindowType & type,
+    const boolean &    use_dB,
+    const uint32       frames_per_tile)
+    :
+    sample_rate_(sample_rate),
+    window_length_(static_cast<uint32>(time_window * sample_rate + 0.5)),
+    step_(static_cast<uint32>(time_step * sample_rate + 0.5)),
+    n_bins_(0),
+    n_fft_(0),
+    use_dB_(use_dB),
+    frames_per_tile_(frames_per_tile),
+    stft_(NULL),
+    n_frames_(0),
+    tiles_(),
+    current_(),
+    filename_(),
+    file_(NULL),
+    n_spilled_(0),
+    map_(NULL),
+    map_bytes_(0),
+    file_mutex_()
+{
+    M_ASSERT_VALUE(sample_rate, >, 0.0);
+    M_ASSERT_VALUE(window_length_, >, 0);
+    M_ASSERT_VALUE(step_, >, 0);
+    M_ASSERT_VALUE(step_, <=, window_length_);
+    M_ASSERT_VALUE(frames_per_tile, >, 0);
+
+    stft_ = new StreamingSTFT(window_length_, step_, type, 0, 64);
+
+    n_bins_ = stft_->getNBins();
+    n_fft_ = stft_->getNFFT();
+
+    current_.reserve(frames_per_tile_ * n_bins_);
+}
+
+SpectrogramCache::
+~SpectrogramCache()
+{
+    #ifndef NSOUND_PLATFORM_OS_WINDOWS
+        if(map_ != NULL) ::munmap(map_, map_bytes_);
+    #endif
+
+    if(file_ != NULL)
+    {
+        fclose(file_);
+        remove(filename_.c_str());
+    }
+
+    delete stft_;
+}
+
+void
+SpectrogramCache::
+setSpillFile(const std::string & filename)
+{
+    M_ASSERT_MSG(
+        n_frames_ == 0 && file_ == NULL,
+        "the spill file must be set once, before analyzing");
+
+    file_ = fopen(filename.c_str(), "w+b");
+
+    if(file_ == NULL)
+    {
+        M_THROW("SpectrogramCache::setSpillFile(): "
+            << "unable to open file '" << filename << "'");
+    }
+
+    filename_ = filename;
+}
+
+void
+SpectrogramCache::
+analyze(const Buffer & x)
+{
+    analyze(x.getPointer(), x.getLength());
+}
+
+void
+SpectrogramCache::
+analyze(const float64 * x, const uint32 n_samples)
+{
+    M_PROFILE_SAMPLES("SpectrogramCache::analyze", n_samples);
+
+    uint32 n_consumed = 0;
+
+    while(n_consumed < n_samples)
+    {
+        n_consumed += stft_->analyze(x + n_consumed, n_samples - n_consumed);
+
+        _storeFrames();
+    }
+}
+
+void
+SpectrogramCache::
+flush()
+{
+    // Until the last frame is centered past the last sample.
+    std::vector<float64> zeros(step_, 0.0);
+
+    uint32 n = window_length_ / 2 + step_ - 1;
+
+    while(n > 0)
+    {
+        uint32 m = std::min(n, step_);
+
+        analyze(zeros.data(), m);
+
+        n -= m;
+    }
+}
+
+void
+SpectrogramCache::
+_storeFrames()
+{
+    const uint32 tile_size = frames_per_tile_ * n_bins_;
+
+    while(stft_->getNFrames() > 0)
+    {
+        StreamingSTFT::Frame & frame = stft_->getFrame(0);
+
+        for(uint32 k = 0; k < n_bins_; ++k)
+        {
+            float64 m = std::sqrt(
+                frame.real[k] * frame.real[k] + frame.imag[k] * frame.imag[k]);
+
+            // Floors silence at -150 dB.
+            if(use_dB_) m = 20.0 * std::log10(std::max(m, 3.16227766e-8));
+
+            current_.push_back(static_cast<float32>(m));
+        }
+
+        stft_->popFrame();
+
+        ++n_frames_;
+
+        if(current_.size() < tile_size) continue;
+
+        if(file_ != NULL)
+        {
+            size_t n = fwrite(
+                current_.data(), sizeof(float32), tile_size, file_);
+
+            if(n != tile_size)
+            {
+                M_THROW("SpectrogramCache: failed to write to '"
+                    << filename_ << "'");
+            }
+
+            ++n_spilled_;
+
+            current_.clear();
+
+            _map();
+        }
+        else
+        {
+            tiles_.emplace_back();
+            tiles_.back().swap(current_);
+
+            current_.reserve(tile_size);
+        }
+    }
+}
+
+void
+SpectrogramCache::
+_map()
+{
+    fflush(file_);
+
+    #ifndef NSOUND_PLATFORM_OS_WINDOWS
+
+        const uint64 tile_size =
+            static_cast<uint64>(frames_per_tile_) * n_bins_;
+
+        uint64 n_bytes = n_spilled_ * tile_size * sizeof(float32);
+
+        if(map_ != NULL) ::munmap(map_, map_bytes_);
+
+        map_ = ::mmap(NULL, n_bytes, PROT_READ, MAP_SHARED, fileno(file_), 0);
+
+        if(map_ == MAP_FAILED)
+        {
+            map_ = NULL;
+            map_bytes_ = 0;
+
+            M_THROW("SpectrogramCache: failed to memory map '"
+                << filename_ << "'");
+        }
+
+        map_bytes_ = n_bytes;
+
+    #endif
+}
+
+const float32 *
+SpectrogramCache::
+_getTile(const uint64 tile, std::vector<float32> & buffer) const
+{
+    const uint64 tile_size = static_cast<uint64>(frames_per_tile_) * n_bins_;
+
+    if(file_ == NULL)
+    {
+        if(tile < tiles_.size()) return tiles_[tile].data();
+
+        return current_.data();
+    }
+
+    if(tile >= n_spilled_) return current_.data();
+
+    #ifndef NSOUND_PLATFORM_OS_WINDOWS
+
+        (void) buffer;
+
+        return static_cast<const float32 *>(map_) + tile * tile_size;
+
+    #else
+
+        buffer.resize(tile_size);
+
+        std::lock_guard<std::mutex> lock(file_mutex_);
+
+        _fseeki64(file_, tile * tile_size * sizeof(float32), SEEK_SET);
+
+        size_t n = fread(buffer.data(), sizeof(float32), tile_size, file_);
+
+        _fseeki64(file_, 0, SEEK_END);
+
+        if(n != tile_size)
+        {
+            M_THROW("SpectrogramCache: failed to read from '"
+                << filename_ << "'");
+        }
+
+        return buffer.data();
+
+    #endif
+}
+
+float64
+SpectrogramCache::
+getTime(const uint64 frame) const
+{
+    float64 center = static_cast<float64>(frame * step_ + step_)
+                   - window_length_ / 2.0;
+
+    return center / sample_rate_;
+}
+
+float64
+SpectrogramCache::
+getFrequency(const uint32 bin) const
+{
+    return bin * sample_rate_ / n_fft_;
+}
+
+void
+SpectrogramCache::
+getMagnitude(
+    const uint64 first_frame,
+    const uint32 n_frames,
+    const uint32 first_bin,
+    const uint32 n_bins,
+    float32 * y) const
+{
+    M_ASSERT_VALUE(first_frame + n_frames, <=, n_frames_);
+    M_ASSERT_VALUE(first_bin + n_bins, <=, n_bins_);
+
+    uint64 frame = first_frame;
+    uint64 stop = first_frame + n_frames;
+
+    std::vector<float32> buffer;
+
+    while(frame < stop)
+    {
+        // The frames of this tile.
+        uint64 tile = frame / frames_per_tile_;
+        uint64 end = std::min(stop, (tile + 1) * frames_per_tile_);
+
+        const float32 * src = _getTile(tile, buffer)
+                            + (frame - tile * frames_per_tile_) * n_bins_
+                            + first_bin;
+
+        for(; frame < end; ++frame)
+        {
+            std::memcpy(y, src, n_bins * sizeof(float32));
+
+            y += n_bins;
+            src += n_bins_;
+        }
+    }
+}
+
+AudioStream
+SpectrogramCache::
+getMagnitude(
+    const uint64 first_frame,
+    const uint32 n_frames,
+    const uint32 first_bin,
+    const uint32 n_bins) const
+{
+    M_ASSERT_VALUE(n_frames, >, 0);
+    M_ASSERT_VALUE(first_bin, <, n_bins_);
+
+    uint32 n = n_bins;
+
+    if(n == 0) n = n_bins_ - first_bin;
+
+    std::vector<float32> values(static_cast<size_t>(n_frames) * n);
+
+    getMagnitude(first_frame, n_frames, first_bin, n, values.data());
+
+    // Channels are frames, like Spectrogram::getMagnitude().
+    AudioStream y(1, n_frames, 1);
+
+    for(uint32 i = 0; i < n_frames; ++i)
+    {
+        const float32 * row = values.data() + static_cast<size_t>(i) * n;
+
+        y[i] = Buffer(FloatVector(row, row + n));
+    }
+
+    return y;
+}
+
+AudioStream
+SpectrogramCache::
+getWindow(
+    const float64 & start_time,
+    const float64 & duration,
+    const float64 & low_hz,
+    const float64 & high_hz) const
+{
+    // Frame i is centered on sample i * step + step - window / 2.
+    float64 offset = step_ - window_length_ / 2.0;
+
+    float64 first = std::ceil((start_time * sample_rate_ - offset) / step_);
+    float64 stop = std::ceil(
+        ((start_time + duration) * sample_rate_ - offset) / step_);
+
+    first = std::max(first, 0.0);
+    stop = std::min(stop, static_cast<float64>(n_frames_));
+
+    float64 low = std::ceil(low_hz * n_fft_ / sample_rate_);
+    float64 high = std::floor(high_hz * n_fft_ / sample_rate_);
+
+    low = std::max(low, 0.0);
+    high = std::min(high, n_bins_ - 1.0);
+
+    M_ASSERT_MSG(
+        stop > first && high >= low,
+        "no frames or bins in the window ("
+        << start_time << " s, " << duration << " s, "
+        << low_hz << " Hz, " << high_hz << " Hz)");
+
+    return getMagnitude(
+        static_cast<uint64>(first),
+        static_cast<uint32>(stop - first),
+        static_cast<uint32>(low),
+        static_cast<uint32>(high - low + 1.0));
+}
+
+// :mode=c++: jEdit modeline
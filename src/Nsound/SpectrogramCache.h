@@ -0,0 +1,217 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: SpectrogramCache.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_SPECTROGRAM_CACHE_H_
+#define _NSOUND_SPECTROGRAM_CACHE_H_
+
+#include <Nsound/Nsound.h>
+#include <Nsound/WindowType.h>
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Nsound
+{
+
+class AudioStream;
+class Buffer;
+class StreamingSTFT;
+
+//-----------------------------------------------------------------------------
+//! The STFT magnitudes of a long signal, computed once and stored as tiles.
+//
+//! Samples are pushed a block at a time with analyze().  Each frame's
+//! magnitude (or dB) is computed once and stored as float32, frames_per_tile
+//! frames to a tile.  By default the tiles stay in memory, with
+//! setSpillFile() every full tile is written to a file that is memory mapped
+//! for reading, so only the tile being filled stays in memory.
+//!
+//! getMagnitude() and getWindow() return any range of frames and bins,
+//! only the tiles holding the range are read.  Like Spectrogram, the
+//! result is an AudioStream with one channel per frame.
+//!
+//! Frame i is centered on sample i * step + step - window / 2, see
+//! getTime().
+//!
+//! The const methods may be called from several threads at once, but not
+//! while analyze() or flush() run.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! SpectrogramCache cache(44100.0, 0.040, 0.010, HANNING, true);
+//!
+//! cache.setSpillFile("long_recording.tiles");
+//!
+//! WavefileReader in("long_recording.wav");
+//! AudioStream block;
+//!
+//! while(in.read(block, 65536) > 0) cache.analyze(block[0]);
+//!
+//! cache.flush();
+//!
+//! // 10 seconds from the first hour, 0 to 4 kHz.
+//! AudioStream view = cache.getWindow(3600.0, 10.0, 0.0, 4000.0);
+//! \endcode
+class SpectrogramCache
+{
+    public:
+
+    //! Creates the cache.
+    //
+    //! \param sample_rate the sample rate of the signal
+    //! \param time_window the length of a frame in seconds
+    //! \param time_step the time between frames in seconds
+    //! \param type the window
+    //! \param use_dB store 20 * log10(magnitude), with a -150 dB floor
+    //! \param frames_per_tile the number of frames stored together
+    SpectrogramCache(
+        const float64 &    sample_rate,
+        const float64 &    time_window,
+        const float64 &    time_step,
+        const WindowType & type = HANNING,
+        const boolean &    use_dB = false,
+        const uint32       frames_per_tile = 256);
+
+    ~SpectrogramCache();
+
+    //! Writes full tiles to filename instead of keeping them in memory.
+    //
+    //! Must be called before any samples are analyzed, the file is
+    //! truncated and removed by the destructor.
+    void
+    setSpillFile(const std::string & filename);
+
+    //! Computes and stores the frames of the next block of samples.
+    void
+    analyze(const Buffer & x);
+
+    #ifndef SWIG
+    void
+    analyze(const float64 * x, const uint32 n_samples);
+    #endif
+
+    //! Ends the signal, stores the frames covering the last samples.
+    void
+    flush();
+
+    uint64  getNFrames() const { return n_frames_; }
+    uint32  getNBins() const { return n_bins_; }
+    uint32  getFramesPerTile() const { return frames_per_tile_; }
+    boolean isdB() const { return use_dB_; }
+
+    //! The time in seconds of the center of the frame.
+    float64
+    getTime(const uint64 frame) const;
+
+    //! The frequency in Hz of the bin.
+    float64
+    getFrequency(const uint32 bin) const;
+
+    //! Returns n_frames frames from first_frame, bins first_bin through
+    //! first_bin + n_bins - 1, n_bins = 0 means all bins from first_bin.
+    AudioStream
+    getMagnitude(
+        const uint64 first_frame,
+        const uint32 n_frames,
+        const uint32 first_bin = 0,
+        const uint32 n_bins = 0) const;
+
+    #ifndef SWIG
+    //! Copies the range into y, n_frames rows of n_bins values.
+    void
+    getMagnitude(
+        const uint64 first_frame,
+        const uint32 n_frames,
+        const uint32 first_bin,
+        const uint32 n_bins,
+        float32 * y) const;
+    #endif
+
+    //! Returns the frames centered from start_time for duration seconds,
+    //! and the bins from low_hz to high_hz.
+    AudioStream
+    getWindow(
+        const float64 & start_time,
+        const float64 & duration,
+        const float64 & low_hz,
+        const float64 & high_hz) const;
+
+    private:
+
+    SpectrogramCache(const SpectrogramCache & copy);
+    SpectrogramCache & operator=(const SpectrogramCache & rhs);
+
+    void _storeFrames();
+
+    // Maps the spilled tiles for reading.
+    void _map();
+
+    // Returns the first value of the tile, buffer may hold it.
+    const float32 *
+    _getTile(const uint64 tile, std::vector<float32> & buffer) const;
+
+    float64 sample_rate_;
+    uint32  window_length_;
+    uint32  step_;
+    uint32  n_bins_;
+    uint32  n_fft_;
+    boolean use_dB_;
+    uint32  frames_per_tile_;
+
+    StreamingSTFT * stft_;
+
+    uint64 n_frames_;
+
+    // The full tiles kept in memory, unless spilled.
+    std::vector< std::vector<float32> > tiles_;
+
+    // The tile being filled.
+    std::vector<float32> current_;
+
+    // The spill file and its memory map, updated after every spill.
+    std::string     filename_;
+    FILE *          file_;
+    uint64          n_spilled_;
+    void *          map_;
+    uint64          map_bytes_;
+
+    // Without mmap reads seek the shared file.
+    mutable std::mutex file_mutex_;
+};
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -77,4 +77,52 @@ operator&(std::istream & in, float32 & value) { return _read(in, value); }
 std::istream &
 operator&(std::istream & in, float64 & value) { return _read(in, value); }
 
+bool
+readBytes(std::istream & in, std::string & bytes, uint64 n_bytes)
+{
+    uint64 chunk = 1 << 20;
+
+    std::streampos here = in.tellg();
+
+    if(here != std::streampos(-1))
+    {
+        in.seekg(0, std::ios::end);
+
+        std::streampos end = in.tellg();
+
+        in.seekg(here);
+
+        if(!in || end == std::streampos(-1))
+        {
+            in.clear();
+            in.seekg(here);
+        }
+        else
+        {
+            if(static_cast<uint64>(end - here) < n_bytes) return false;
+
+            chunk = n_bytes;
+        }
+    }
+
+    std::size_t offset = bytes.size();
+
+    for(uint64 n_read = 0; n_read < n_bytes;)
+    {
+        std::size_t n = static_cast<std::size_t>(
+            std::min<uint64>(chunk, n_bytes - n_read));
+
+        bytes.resize(offset + n);
+
+        in.read(&bytes[offset], n);
+
+        if(!in) return false;
+
+        offset += n;
+        n_read += n;
+    }
+
+    return true;
+}
+
 } // namespace
\ No newline at end of file
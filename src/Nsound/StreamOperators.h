@@ -36,7 +36,10 @@
 
 #include <Nsound/Nsound.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 namespace Nsound
 {
@@ -69,6 +72,41 @@ T peek(std::istream & in)
     return tmp;
 }
 
+// Appends n_bytes read from in to bytes, returns false if the stream ends
+// first.  A seekable stream is checked against its remaining size before
+// anything is allocated, others are read a chunk at a time, so a corrupt
+// length can't ask for more memory than the stream holds.
+bool readBytes(std::istream & in, std::string & bytes, uint64 n_bytes);
+
+// Read/write little endian values to/from memory, returns the position
+// after the value.
+
+template <class T>
+char * writeLittleEndian(char * dst, T value)
+{
+    std::memcpy(dst, &value, sizeof(T));
+
+    #ifdef NSOUND_BIG_ENDIAN
+        std::reverse(dst, dst + sizeof(T));
+    #endif
+
+    return dst + sizeof(T);
+}
+
+template <class T>
+const char * readLittleEndian(const char * src, T & value)
+{
+    #ifdef NSOUND_BIG_ENDIAN
+        char tmp[sizeof(T)];
+        std::reverse_copy(src, src + sizeof(T), tmp);
+        std::memcpy(&value, tmp, sizeof(T));
+    #else
+        std::memcpy(&value, src, sizeof(T));
+    #endif
+
+    return src + sizeof(T);
+}
+
 } // namespace
 
 // :mode=c++: jEdit modeline
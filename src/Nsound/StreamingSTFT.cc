@@ -0,0 +1,407 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: StreamingSTFT.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/Buffer.h>
+#include <Nsound/FFTransform.h>
+#include <Nsound/Generator.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/StreamingSTFT.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Nsound;
+
+//-----------------------------------------------------------------------------
+StreamingSTFT::
+StreamingSTFT(
+    const uint32 window_length,
+    const uint32 hop,
+    const WindowType type,
+    const uint32 n_fft,
+    const uint32 n_frames)
+    :
+    window_length_(window_length),
+    hop_(hop),
+    n_fft_(n_fft),
+    n_bins_(0),
+    n_ring_(n_frames),
+    window_(),
+    norm_(),
+    input_(),
+    input_position_(0),
+    n_pending_(0),
+    spectra_(),
+    frames_(),
+    head_(0),
+    n_ready_(0),
+    n_analyzed_(0),
+    plan_(),
+    real_(),
+    imag_(),
+    output_(),
+    output_position_(0),
+    n_input_(0),
+    n_output_(0),
+    n_skip_(0)
+{
+    M_ASSERT_VALUE(window_length, >, 0);
+    M_ASSERT_VALUE(hop, >, 0);
+    M_ASSERT_VALUE(hop, <=, window_length);
+    M_ASSERT_VALUE(n_frames, >, 0);
+
+    if(n_fft_ == 0) n_fft_ = FFTransform::roundUp2(window_length_);
+
+    M_ASSERT_VALUE(n_fft_, >=, window_length_);
+    M_ASSERT_MSG(
+        FFTransform::roundUp2(n_fft_) == static_cast<int32>(n_fft_),
+        "n_fft must be a power of 2 (" << n_fft_ << ")");
+
+    n_bins_ = n_fft_ / 2 + 1;
+
+    plan_ = FFTransform::Plan(n_fft_);
+
+    Generator gen(1);
+
+    Buffer w = gen.drawWindow(window_length_, type);
+
+    window_.assign(w.begin(), w.end());
+
+    norm_.assign(hop_, 0.0);
+
+    for(uint32 i = 0; i < window_length_; ++i)
+    {
+        norm_[i % hop_] += window_[i] * window_[i];
+    }
+
+    for(auto & x : norm_)
+    {
+        x = x > 1e-12 ? 1.0 / x : 0.0;
+    }
+
+    input_.assign(window_length_, 0.0);
+    output_.assign(window_length_, 0.0);
+
+    real_.assign(n_fft_, 0.0);
+    imag_.assign(n_fft_, 0.0);
+
+    spectra_.assign(2 * n_ring_ * n_bins_, 0.0);
+    frames_.resize(n_ring_);
+
+    for(uint32 i = 0; i < n_ring_; ++i)
+    {
+        frames_[i].real = &spectra_[2 * i * n_bins_];
+        frames_[i].imag = &spectra_[(2 * i + 1) * n_bins_];
+        frames_[i].n_bins = n_bins_;
+        frames_[i].index = 0;
+    }
+
+    reset();
+}
+
+void
+StreamingSTFT::
+reset()
+{
+    std::fill(input_.begin(), input_.end(), 0.0);
+    std::fill(output_.begin(), output_.end(), 0.0);
+
+    // The stream starts with window_length - hop zeros already in the input.
+    input_position_ = window_length_ - hop_;
+    n_pending_ = 0;
+
+    head_ = 0;
+    n_ready_ = 0;
+    n_analyzed_ = 0;
+
+    output_position_ = 0;
+    n_input_ = 0;
+    n_output_ = 0;
+    n_skip_ = getLatency();
+}
+
+uint32
+StreamingSTFT::
+analyze(const Buffer & x)
+{
+    return analyze(x.getPointer(), x.getLength());
+}
+
+uint32
+StreamingSTFT::
+analyze(const float64 * x, const uint32 n_samples)
+{
+    M_PROFILE_SAMPLES("StreamingSTFT::analyze", n_samples);
+
+    uint32 n_consumed = 0;
+
+    while(n_consumed < n_samples && n_ready_ < n_ring_)
+    {
+        uint32 n = std::min(n_samples - n_consumed, hop_ - n_pending_);
+
+        n = std::min(n, window_length_ - input_position_);
+
+        std::copy(x + n_consumed, x + n_consumed + n, &input_[input_position_]);
+
+        input_position_ += n;
+
+        if(input_position_ == window_length_) input_position_ = 0;
+
+        n_pending_ += n;
+        n_consumed += n;
+
+        if(n_pending_ == hop_)
+        {
+            _transform();
+            n_pending_ = 0;
+        }
+    }
+
+    n_input_ += n_consumed;
+
+    return n_consumed;
+}
+
+void
+StreamingSTFT::
+_transform()
+{
+    // The oldest sample is at the write position.
+    uint32 n1 = window_length_ - input_position_;
+
+    const float64 * w = window_.data();
+    float64 * re = real_.data();
+    float64 * im = imag_.data();
+
+    for(uint32 i = 0; i < n1; ++i)
+    {
+        re[i] = input_[input_position_ + i] * w[i];
+    }
+
+    for(uint32 i = n1; i < window_length_; ++i)
+    {
+        re[i] = input_[i - n1] * w[i];
+    }
+
+    std::fill(re + window_length_, re + n_fft_, 0.0);
+    std::fill(im, im + n_fft_, 0.0);
+
+    FFTransform::radix2(plan_, re, im);
+
+    Frame & frame = frames_[(head_ + n_ready_) % n_ring_];
+
+    std::copy(re, re + n_bins_, frame.real);
+    std::copy(im, im + n_bins_, frame.imag);
+
+    frame.index = n_analyzed_++;
+
+    ++n_ready_;
+}
+
+StreamingSTFT::Frame &
+StreamingSTFT::
+getFrame(const uint32 i)
+{
+    M_ASSERT_VALUE(i, <, n_ready_);
+
+    return frames_[(head_ + i) % n_ring_];
+}
+
+Buffer
+StreamingSTFT::
+getMagnitude(const uint32 i) const
+{
+    M_ASSERT_VALUE(i, <, n_ready_);
+
+    const Frame & frame = frames_[(head_ + i) % n_ring_];
+
+    Buffer y(n_bins_);
+
+    for(uint32 k = 0; k < n_bins_; ++k)
+    {
+        y << std::sqrt(
+            frame.real[k] * frame.real[k] + frame.imag[k] * frame.imag[k]);
+    }
+
+    return y;
+}
+
+void
+StreamingSTFT::
+popFrame()
+{
+    M_ASSERT_VALUE(n_ready_, >, 0);
+
+    if(++head_ == n_ring_) head_ = 0;
+
+    --n_ready_;
+}
+
+uint32
+StreamingSTFT::
+synthesize(const Frame & frame, float64 * y)
+{
+    M_PROFILE_SAMPLES("StreamingSTFT::synthesize", hop_);
+
+    M_ASSERT_VALUE(frame.n_bins, ==, n_bins_);
+
+    float64 * re = real_.data();
+    float64 * im = imag_.data();
+
+    // Rebuild the full conjugate symmetric spectrum, the inverse is the
+    // forward transform of the conjugate.
+    for(uint32 k = 0; k < n_bins_; ++k)
+    {
+        re[k] = frame.real[k];
+        im[k] = -frame.imag[k];
+    }
+
+    for(uint32 k = n_bins_; k < n_fft_; ++k)
+    {
+        re[k] = frame.real[n_fft_ - k];
+        im[k] = frame.imag[n_fft_ - k];
+    }
+
+    FFTransform::radix2(plan_, re, im);
+
+    // Window and overlap add.
+    const float64 * w = window_.data();
+    const float64 scale = 1.0 / n_fft_;
+
+    uint32 n1 = window_length_ - output_position_;
+
+    for(uint32 i = 0; i < n1; ++i)
+    {
+        output_[output_position_ + i] += re[i] * w[i] * scale;
+    }
+
+    for(uint32 i = n1; i < window_length_; ++i)
+    {
+        output_[i - n1] += re[i] * w[i] * scale;
+    }
+
+    // The first hop samples have all their frames now.
+    uint32 n_out = 0;
+
+    for(uint32 i = 0; i < hop_; ++i)
+    {
+        float64 & x = output_[output_position_];
+
+        if(n_skip_ > 0) --n_skip_;
+        else            y[n_out++] = x * norm_[i];
+
+        x = 0.0;
+
+        if(++output_position_ == window_length_) output_position_ = 0;
+    }
+
+    n_output_ += n_out;
+
+    return n_out;
+}
+
+Buffer
+StreamingSTFT::
+process(const Buffer & x)
+{
+    return process(x, Effect());
+}
+
+Buffer
+StreamingSTFT::
+process(const Buffer & x, const Effect & effect)
+{
+    const float64 * ptr = x.getPointer();
+
+    uint32 n_samples = x.getLength();
+
+    Buffer y(n_samples + hop_);
+
+    std::vector<float64> block(hop_);
+
+    uint32 n_consumed = 0;
+
+    while(true)
+    {
+        while(n_ready_ > 0)
+        {
+            Frame & frame = getFrame();
+
+            if(effect) effect(frame);
+
+            uint32 n = synthesize(frame, block.data());
+
+            for(uint32 i = 0; i < n; ++i) y << block[i];
+
+            popFrame();
+        }
+
+        if(n_consumed == n_samples) break;
+
+        n_consumed += analyze(ptr + n_consumed, n_samples - n_consumed);
+    }
+
+    return y;
+}
+
+Buffer
+StreamingSTFT::
+flush()
+{
+    return flush(Effect());
+}
+
+Buffer
+StreamingSTFT::
+flush(const Effect & effect)
+{
+    uint64 n_target = n_input_;
+
+    Buffer y(getLatency() + hop_);
+
+    Buffer zeros(FloatVector(hop_, 0.0));
+
+    // Process anything left in the ring, then push zeros until the output
+    // caught up with the input.
+    y << process(Buffer(), effect);
+
+    while(n_output_ < n_target)
+    {
+        y << process(zeros.subbuffer(0, hop_ - n_pending_), effect);
+    }
+
+    uint32 n_extra = static_cast<uint32>(n_output_ - n_target);
+
+    reset();
+
+    if(n_extra > 0) return y.subbuffer(0, y.getLength() - n_extra);
+
+    return y;
+}
+
+// :mode=c++: jEdit modeline
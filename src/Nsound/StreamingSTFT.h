@@ -0,0 +1,236 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: StreamingSTFT.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_STREAMING_STFT_H_
+#define _NSOUND_STREAMING_STFT_H_
+
+#include <Nsound/Nsound.h>
+#include <Nsound/FFTransform.h>
+#include <Nsound/WindowType.h>
+
+#include <functional>
+#include <vector>
+
+namespace Nsound
+{
+
+class Buffer;
+
+//-----------------------------------------------------------------------------
+//! A short time Fourier transform and its inverse over a stream of samples.
+//
+//! Samples are pushed in blocks of any size with analyze(), every hop
+//! samples a windowed frame of the last window_length samples is
+//! transformed into the next free slot of a ring of preallocated spectra.
+//! The caller processes the frames in order, optionally passes them to
+//! synthesize() which inverse transforms, windows and overlap adds them,
+//! then releases them with popFrame().  Memory use does not depend on how
+//! many samples have been processed.
+//!
+//! Each frame holds the n_fft / 2 + 1 bins from DC to Nyquist.  The same
+//! window is used for analysis and synthesis, the output is divided by the
+//! overlapped sum of the squared window, so any hop <= window_length
+//! reconstructs the input (up to round off) where that sum is not 0.
+//!
+//! The stream is treated as if preceded by window_length - hop zeros so the
+//! first frames cover the first samples.  synthesize() drops these leading
+//! samples, output sample i lines up with input sample i.  Call flush() at
+//! the end of the stream for the last window_length - hop samples.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! StreamingSTFT stft(1024, 256, HANNING);
+//!
+//! // A brick wall low pass filter.
+//! auto lowpass = [](StreamingSTFT::Frame & frame)
+//! {
+//!     for(uint32 k = 100; k < frame.n_bins; ++k)
+//!     {
+//!         frame.real[k] = frame.imag[k] = 0.0;
+//!     }
+//! };
+//!
+//! Buffer y = stft.process(x, lowpass);
+//! y << stft.flush(lowpass);
+//! \endcode
+class StreamingSTFT
+{
+    public:
+
+    #ifndef SWIG
+    //! One frame of the spectra ring, bins 0 through n_fft / 2.
+    struct Frame
+    {
+        float64 * real;
+        float64 * imag;
+        uint32    n_bins;
+
+        //! The frame number since the start of the stream.
+        uint64    index;
+    };
+
+    typedef std::function<void (Frame & frame)> Effect;
+    #endif
+
+    //! Creates the transform.
+    //
+    //! \param window_length the number of samples in a frame
+    //! \param hop the number of samples between frames, 1 to window_length
+    //! \param type the analysis and synthesis window
+    //! \param n_fft the size of the FFT, 0 means the power of 2 >=
+    //!        window_length
+    //! \param n_frames the number of frames in the spectra ring
+    StreamingSTFT(
+        const uint32 window_length,
+        const uint32 hop,
+        const WindowType type = HANNING,
+        const uint32 n_fft = 0,
+        const uint32 n_frames = 16);
+
+    uint32 getWindowLength() const { return window_length_; }
+    uint32 getHop() const { return hop_; }
+    uint32 getNFFT() const { return n_fft_; }
+    uint32 getNBins() const { return n_bins_; }
+
+    //! The number of samples synthesize() delays the output by internally.
+    uint32 getLatency() const { return window_length_ - hop_; }
+
+    //! The number of frames ready in the ring.
+    uint32 getNFrames() const { return n_ready_; }
+
+    //! The number of frames the ring holds.
+    uint32 getRingSize() const { return n_ring_; }
+
+    //! Pushes samples, returns how many were consumed.
+    //
+    //! Stops early when the ring is full, pop frames and call again with
+    //! the rest.
+    uint32
+    analyze(const Buffer & x);
+
+    #ifndef SWIG
+    uint32
+    analyze(const float64 * x, const uint32 n_samples);
+
+    //! Returns the i'th oldest frame ready in the ring.
+    Frame &
+    getFrame(const uint32 i = 0);
+
+    //! Inverse transforms the frame and overlap adds it.
+    //
+    //! Frames must be synthesized in order.  Up to hop finished samples are
+    //! written to y, the number written is returned.
+    uint32
+    synthesize(const Frame & frame, float64 * y);
+
+    //! Runs every frame of x through effect and synthesizes them.
+    //
+    //! Returns the output samples finished so far, an empty effect passes
+    //! the frames through unchanged.
+    Buffer
+    process(const Buffer & x, const Effect & effect);
+
+    //! Ends the stream, returns the remaining output samples.
+    //
+    //! The transform is reset for a new stream afterwards.
+    Buffer
+    flush(const Effect & effect);
+    #endif
+
+    //! Runs x through the transform and its inverse.
+    Buffer
+    process(const Buffer & x);
+
+    //! Ends the stream, returns the remaining output samples.
+    Buffer
+    flush();
+
+    //! Returns the magnitude of the i'th oldest frame ready in the ring.
+    Buffer
+    getMagnitude(const uint32 i = 0) const;
+
+    //! Releases the oldest frame in the ring.
+    void
+    popFrame();
+
+    //! Forgets the stream, the settings are kept.
+    void
+    reset();
+
+    private:
+
+    StreamingSTFT(const StreamingSTFT & copy);
+    StreamingSTFT & operator=(const StreamingSTFT & rhs);
+
+    void _transform();
+
+    uint32 window_length_;
+    uint32 hop_;
+    uint32 n_fft_;
+    uint32 n_bins_;
+    uint32 n_ring_;
+
+    std::vector<float64> window_;
+
+    // 1 / the overlapped sum of window^2 for each sample of a hop.
+    std::vector<float64> norm_;
+
+    // The last window_length input samples.
+    std::vector<float64> input_;
+    uint32               input_position_;
+    uint32               n_pending_;
+
+    // The spectra ring, real and imaginary parts of each frame.
+    std::vector<float64> spectra_;
+    std::vector<Frame>   frames_;
+    uint32               head_;
+    uint32               n_ready_;
+    uint64               n_analyzed_;
+
+    // FFT scratch.
+    FFTransform::Plan    plan_;
+    std::vector<float64> real_;
+    std::vector<float64> imag_;
+
+    // The overlap add accumulator.
+    std::vector<float64> output_;
+    uint32               output_position_;
+    uint64               n_input_;
+    uint64               n_output_;
+    uint64               n_skip_;
+};
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -34,7 +34,9 @@
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
 #include <Nsound/Sine.h>
+#include <Nsound/StreamingSTFT.h>
 #include <Nsound/Stretcher.h>
+#include <Nsound/Profiler.h>
 
 #include <cstdio>
 #include <algorithm>
@@ -49,6 +51,162 @@ using std::cerr;
 using std::cout;
 using std::endl;
 
+//-----------------------------------------------------------------------------
+// The phase vocoder state of one stream.
+struct Stretcher::Vocoder
+{
+    Vocoder(
+        const uint32 window_length,
+        const float64 & f,
+        const uint32 channels)
+        :
+        factor(f),
+        n_channels(channels),
+        n_bins(0),
+        analysis_hop(1),
+        synthesis_hop(1),
+        analysis(),
+        synthesis(),
+        magnitude(),
+        phase(),
+        last_magnitude(),
+        last_phase(),
+        output_phase(),
+        rotation_real(),
+        rotation_imag(),
+        loudest(),
+        loudest_real(),
+        loudest_imag(),
+        peaks(),
+        block(),
+        first(true),
+        was_transient(false),
+        n_input(0),
+        n_output(0),
+        delay(0)
+    {
+        // The analysis hop is at most the window and the synthesis hop at
+        // least 1.
+        M_ASSERT_MSG(
+            factor * window_length >= 1.0,
+            "factor " << factor << " is below the smallest phase vocoder "
+            "factor, 1 / window length = " << 1.0 / window_length);
+
+        // The synthesis hop is at most 1/4 of the window and the analysis
+        // hop at least 1.
+        M_ASSERT_MSG(
+            factor <= std::max<uint32>(1, window_length / 4),
+            "factor " << factor << " is above the largest phase vocoder "
+            "factor, window length / 4 = "
+            << std::max<uint32>(1, window_length / 4));
+
+        // Pick the synthesis hop, 1/8 to 1/4 of the window, whose analysis
+        // hop gives the closest factor.
+        uint32 lo = std::max<uint32>(1, window_length / 8);
+        uint32 hi = std::max<uint32>(1, window_length / 4);
+
+        // Below 1/8 even an analysis hop of a whole window is too short, the
+        // synthesis hop shrinks instead.
+        if(factor * window_length < lo)
+        {
+            hi = std::max<uint32>(
+                1, static_cast<uint32>(factor * window_length));
+
+            lo = std::max<uint32>(1, hi / 2);
+        }
+
+        float64 best = 1.0e100;
+
+        for(uint32 hs = lo; hs <= hi; ++hs)
+        {
+            float64 ha = std::floor(hs / factor + 0.5);
+
+            ha = std::max(1.0, std::min<float64>(ha, window_length));
+
+            float64 error = std::fabs(hs / ha - factor);
+
+            if(error < best)
+            {
+                best = error;
+                analysis_hop = static_cast<uint32>(ha);
+                synthesis_hop = hs;
+            }
+        }
+
+        for(uint32 c = 0; c < n_channels; ++c)
+        {
+            analysis.push_back(
+                new StreamingSTFT(window_length, analysis_hop, HANNING, 0, 4));
+
+            synthesis.push_back(
+                new StreamingSTFT(window_length, synthesis_hop, HANNING, 0, 1));
+        }
+
+        n_bins = analysis[0]->getNBins();
+
+        magnitude.assign(n_bins, 0.0);
+        phase.assign(n_bins, 0.0);
+        last_magnitude.assign(n_bins, 0.0);
+        last_phase.assign(n_bins, 0.0);
+        output_phase.assign(n_bins, 0.0);
+        rotation_real.assign(n_bins, 0.0);
+        rotation_imag.assign(n_bins, 0.0);
+        loudest.assign(n_bins, 0.0);
+        loudest_real.assign(n_bins, 0.0);
+        loudest_imag.assign(n_bins, 0.0);
+        peaks.reserve(n_bins);
+        block.assign(synthesis_hop, 0.0);
+
+        // A frame's center moves from input sample t to about factor * t
+        // plus this many samples.
+        float64 actual = float64(synthesis_hop) / analysis_hop;
+
+        delay = static_cast<int32>(
+            std::floor((actual - 1.0) * window_length / 2.0 + 0.5));
+    }
+
+    ~Vocoder()
+    {
+        for(auto ptr : analysis) delete ptr;
+        for(auto ptr : synthesis) delete ptr;
+    }
+
+    float64 factor;
+    uint32  n_channels;
+    uint32  n_bins;
+    uint32  analysis_hop;
+    uint32  synthesis_hop;
+
+    std::vector<StreamingSTFT *> analysis;
+    std::vector<StreamingSTFT *> synthesis;
+
+    // The sum of the channel magnitudes and the loudest channel's phase.
+    std::vector<float64> magnitude;
+    std::vector<float64> phase;
+    std::vector<float64> last_magnitude;
+    std::vector<float64> last_phase;
+    std::vector<float64> output_phase;
+
+    // exp(i * (output_phase - phase)), applied to every channel.
+    std::vector<float64> rotation_real;
+    std::vector<float64> rotation_imag;
+
+    // The loudest channel of each bin.
+    std::vector<float64> loudest;
+    std::vector<float64> loudest_real;
+    std::vector<float64> loudest_imag;
+
+    std::vector<uint32>  peaks;
+    std::vector<float64> block;
+
+    bool first;
+    bool was_transient;
+
+    uint64 n_input;
+    uint64 n_output;
+    int32  delay;
+};
+
 //-----------------------------------------------------------------------------
 Stretcher::
 Stretcher(
@@ -61,7 +219,10 @@ Stretcher(
     window_(NULL),
     window_length_(0),
     max_delta_(0),
-    show_progress_(false)
+    show_progress_(false),
+    method_(WSOLA),
+    transient_threshold_(0.3),
+    vocoder_(NULL)
 {
     frames_ = new Buffer(1024);
     window_ = new Buffer(1024);
@@ -81,7 +242,10 @@ Stretcher(const Stretcher & copy)
     window_(NULL),
     window_length_(copy.window_length_),
     max_delta_(copy.max_delta_),
-    show_progress_(copy.show_progress_)
+    show_progress_(copy.show_progress_),
+    method_(copy.method_),
+    transient_threshold_(copy.transient_threshold_),
+    vocoder_(NULL)
 {
     frames_ = new Buffer(1024);
     window_ = new Buffer(window_length_);
@@ -95,6 +259,7 @@ Stretcher::
 {
     delete frames_;
     delete window_;
+    delete vocoder_;
 }
 
 //-----------------------------------------------------------------------------
@@ -110,6 +275,12 @@ operator=(const Stretcher & rhs)
     *frames_       = *rhs.frames_;
     *window_       = *rhs.window_;
     show_progress_ = rhs.show_progress_;
+    method_        = rhs.method_;
+
+    transient_threshold_ = rhs.transient_threshold_;
+
+    // A stream in progress is not copied.
+    reset();
 
     return *this;
 }
@@ -128,6 +299,8 @@ void
 Stretcher::
 analyize(const Buffer & input, const Buffer & factor)
 {
+    M_PROFILE_SAMPLES("Stretcher::analyze", input.getLength());
+
     // Always calculate time shift.
 
     Buffer::const_circular_iterator ifactor = factor.cbegin();
@@ -136,6 +309,9 @@ analyize(const Buffer & input, const Buffer & factor)
 
     uint32 input_length = input.getLength();
 
+    // Shorter inputs would underflow the frame loop below.
+    M_ASSERT_VALUE(input_length, >, window_length_);
+
     *frames_ = Buffer(256);
 
     uint32 i = 0;
@@ -280,6 +456,8 @@ Buffer
 Stretcher::
 overlapAdd(const Buffer & input) const
 {
+    M_PROFILE_SAMPLES("Stretcher::overlapAdd", input.getLength());
+
     Sine sin(sample_rate_);
 
     float64 half_window_seconds = (window_length_ / 2) / sample_rate_;
@@ -337,6 +515,11 @@ AudioStream
 Stretcher::
 pitchShift(const AudioStream & x, const float64 & factor)
 {
+    if(method_ == PHASE_VOCODER)
+    {
+        return _vocodeAll(x, factor).getResample(1.0 / factor);
+    }
+
     // Prepare for time shift.
     analyize(x.getMono()[0], factor);
 
@@ -371,6 +554,13 @@ Buffer
 Stretcher::
 pitchShift(const Buffer & x, const float64 & factor)
 {
+    M_PROFILE_SAMPLES("Stretcher::pitchShift", x.getLength());
+
+    if(method_ == PHASE_VOCODER)
+    {
+        return timeShift(x, factor).getResample(1.0 / factor);
+    }
+
     // Prepare for time shift.
     analyize(x, factor);
 
@@ -383,6 +573,8 @@ Buffer
 Stretcher::
 pitchShift(const Buffer & x, const Buffer & factor)
 {
+    M_PROFILE_SAMPLES("Stretcher::pitchShift", x.getLength());
+
     // Prepare for time shift.
     analyize(x, factor);
 
@@ -395,6 +587,8 @@ AudioStream
 Stretcher::
 timeShift(const AudioStream & x, const float64 & factor)
 {
+    if(method_ == PHASE_VOCODER) return _vocodeAll(x, factor);
+
     // Prepare for time shift.
     analyize(x.getMono()[0], factor);
 
@@ -429,6 +623,17 @@ Buffer
 Stretcher::
 timeShift(const Buffer & x, const float64 & factor)
 {
+    M_PROFILE_SAMPLES("Stretcher::timeShift", x.getLength());
+
+    if(method_ == PHASE_VOCODER)
+    {
+        AudioStream a(sample_rate_, 1, 0);
+
+        a[0] = x;
+
+        return _vocodeAll(a, factor)[0];
+    }
+
     // Prepare for time shift.
     analyize(x, factor);
 
@@ -441,6 +646,8 @@ Buffer
 Stretcher::
 timeShift(const Buffer & x, const Buffer & factor)
 {
+    M_PROFILE_SAMPLES("Stretcher::timeShift", x.getLength());
+
     // Prepare for time shift.
     analyize(x, factor);
 
@@ -449,3 +656,376 @@ timeShift(const Buffer & x, const Buffer & factor)
     return stretched;
 }
 
+
+void
+Stretcher::
+setMethod(const Method method)
+{
+    method_ = method;
+}
+
+void
+Stretcher::
+setTransientThreshold(const float64 & threshold)
+{
+    M_ASSERT_VALUE(threshold, >=, 0.0);
+
+    transient_threshold_ = threshold;
+}
+
+static
+inline
+float64
+wrapPhase(const float64 & x)
+{
+    return x - 2.0 * M_PI * std::floor(x / (2.0 * M_PI) + 0.5);
+}
+
+void
+Stretcher::
+_vocodeFrame(AudioStream & y)
+{
+    Vocoder & v = *vocoder_;
+
+    const uint32 n_bins = v.n_bins;
+
+    const float64 * re = NULL;
+    const float64 * im = NULL;
+
+    if(v.n_channels == 1)
+    {
+        re = v.analysis[0]->getFrame().real;
+        im = v.analysis[0]->getFrame().imag;
+    }
+    else
+    {
+        std::fill(v.magnitude.begin(), v.magnitude.end(), 0.0);
+        std::fill(v.loudest.begin(), v.loudest.end(), -1.0);
+
+        for(auto ptr : v.analysis)
+        {
+            const StreamingSTFT::Frame & frame = ptr->getFrame();
+
+            for(uint32 k = 0; k < n_bins; ++k)
+            {
+                float64 m = std::sqrt(
+                    frame.real[k] * frame.real[k] +
+                    frame.imag[k] * frame.imag[k]);
+
+                v.magnitude[k] += m;
+
+                if(m > v.loudest[k])
+                {
+                    v.loudest[k] = m;
+                    v.loudest_real[k] = frame.real[k];
+                    v.loudest_imag[k] = frame.imag[k];
+                }
+            }
+        }
+
+        re = v.loudest_real.data();
+        im = v.loudest_imag.data();
+    }
+
+    float64 * mag = v.magnitude.data();
+    float64 * ph = v.phase.data();
+
+    float64 total = 0.0;
+    float64 gained = 0.0;
+
+    for(uint32 k = 0; k < n_bins; ++k)
+    {
+        if(v.n_channels == 1)
+        {
+            mag[k] = std::sqrt(re[k] * re[k] + im[k] * im[k]);
+        }
+
+        ph[k] = std::atan2(im[k], re[k]);
+
+        total += mag[k];
+        gained += std::max(0.0, mag[k] - v.last_magnitude[k]);
+    }
+
+    // Only the first frame of a transient restarts the phases.
+    bool transient = gained > transient_threshold_ * (total + 1e-30);
+
+    float64 * out = v.output_phase.data();
+
+    if(v.first || (transient && !v.was_transient))
+    {
+        std::copy(ph, ph + n_bins, out);
+    }
+    else
+    {
+        // Peaks are larger than their two neighbors on either side.
+        v.peaks.clear();
+
+        for(uint32 k = 0; k < n_bins; ++k)
+        {
+            bool peak = mag[k] > 0.0;
+
+            for(uint32 j = 1; peak && j <= 2; ++j)
+            {
+                if(k >= j && mag[k - j] >= mag[k]) peak = false;
+                if(k + j < n_bins && mag[k + j] > mag[k]) peak = false;
+            }
+
+            if(peak) v.peaks.push_back(k);
+        }
+
+        const float64 omega_scale =
+            2.0 * M_PI * v.analysis_hop / v.analysis[0]->getNFFT();
+
+        const float64 ratio = float64(v.synthesis_hop) / v.analysis_hop;
+
+        uint32 start = 0;
+
+        for(uint32 p = 0; p < v.peaks.size(); ++p)
+        {
+            uint32 k = v.peaks[p];
+
+            // Propagate the peak by its instantaneous frequency.
+            float64 omega = omega_scale * k;
+
+            float64 delta = wrapPhase(ph[k] - v.last_phase[k] - omega);
+
+            out[k] = wrapPhase(out[k] + (omega + delta) * ratio);
+
+            // The peak's region ends at the smallest bin before the next.
+            uint32 stop = n_bins;
+
+            if(p + 1 < v.peaks.size())
+            {
+                uint32 next = v.peaks[p + 1];
+
+                stop = k + 1;
+
+                for(uint32 j = k + 1; j < next; ++j)
+                {
+                    if(mag[j] < mag[stop]) stop = j;
+                }
+            }
+
+            // Lock the region to the peak.
+            for(uint32 j = start; j < stop; ++j)
+            {
+                if(j != k) out[j] = out[k] + ph[j] - ph[k];
+            }
+
+            start = stop;
+        }
+
+        // Silence, keep the input phases.
+        if(v.peaks.empty()) std::copy(ph, ph + n_bins, out);
+    }
+
+    v.first = false;
+    v.was_transient = transient;
+
+    for(uint32 k = 0; k < n_bins; ++k)
+    {
+        float64 rotation = out[k] - ph[k];
+
+        v.rotation_real[k] = std::cos(rotation);
+        v.rotation_imag[k] = std::sin(rotation);
+    }
+
+    std::swap(v.magnitude, v.last_magnitude);
+    std::swap(v.phase, v.last_phase);
+
+    // Rotate and synthesize every channel.
+    for(uint32 c = 0; c < v.n_channels; ++c)
+    {
+        StreamingSTFT::Frame & frame = v.analysis[c]->getFrame();
+
+        for(uint32 k = 0; k < n_bins; ++k)
+        {
+            float64 a = frame.real[k];
+            float64 b = frame.imag[k];
+
+            frame.real[k] = a * v.rotation_real[k] - b * v.rotation_imag[k];
+            frame.imag[k] = a * v.rotation_imag[k] + b * v.rotation_real[k];
+        }
+
+        uint32 n = v.synthesis[c]->synthesize(frame, v.block.data());
+
+        Buffer & out_c = y[c];
+
+        for(uint32 i = 0; i < n; ++i) out_c << v.block[i];
+
+        if(c == 0) v.n_output += n;
+
+        v.analysis[c]->popFrame();
+    }
+}
+
+void
+Stretcher::
+_vocode(const AudioStream & x, AudioStream & y)
+{
+    Vocoder & v = *vocoder_;
+
+    uint32 n_samples = x.getLength();
+    uint32 n_consumed = 0;
+
+    while(true)
+    {
+        while(v.analysis[0]->getNFrames() > 0) _vocodeFrame(y);
+
+        if(n_consumed == n_samples) break;
+
+        // Every channel's transform is in the same state.
+        uint32 n = 0;
+
+        for(uint32 c = 0; c < v.n_channels; ++c)
+        {
+            n = v.analysis[c]->analyze(
+                x[c].getPointer() + n_consumed,
+                n_samples - n_consumed);
+        }
+
+        n_consumed += n;
+    }
+
+    v.n_input += n_samples;
+}
+
+AudioStream
+Stretcher::
+timeShiftBlock(const AudioStream & x, const float64 & factor)
+{
+    M_PROFILE_SAMPLES("Stretcher::timeShiftBlock", x.getLength());
+
+    M_ASSERT_VALUE(factor, >, 0.0);
+    M_ASSERT_VALUE(x.getNChannels(), >, 0);
+
+    if(vocoder_ == NULL)
+    {
+        vocoder_ = new Vocoder(window_length_, factor, x.getNChannels());
+    }
+
+    M_ASSERT_MSG(
+        vocoder_->factor == factor &&
+        vocoder_->n_channels == x.getNChannels(),
+        "the factor and number of channels can't change during a stream, "
+        "call flush() or reset() first");
+
+    AudioStream y(x.getSampleRate(), x.getNChannels(), 0);
+
+    _vocode(x, y);
+
+    return y;
+}
+
+Buffer
+Stretcher::
+timeShiftBlock(const Buffer & x, const float64 & factor)
+{
+    AudioStream a(sample_rate_, 1, 0);
+
+    a[0] = x;
+
+    return timeShiftBlock(a, factor)[0];
+}
+
+AudioStream
+Stretcher::
+flush()
+{
+    if(vocoder_ == NULL) return AudioStream(sample_rate_, 1, 0);
+
+    Vocoder & v = *vocoder_;
+
+    uint64 n_target = static_cast<uint64>(
+        std::floor(v.n_input * v.factor + 0.5) + std::max(0, v.delay));
+
+    AudioStream y(sample_rate_, v.n_channels, 0);
+
+    AudioStream zeros(sample_rate_, v.n_channels, 0);
+
+    for(uint32 c = 0; c < v.n_channels; ++c)
+    {
+        zeros[c] = Buffer(FloatVector(v.analysis_hop, 0.0));
+    }
+
+    while(v.n_output < n_target) _vocode(zeros, y);
+
+    uint32 n_extra = static_cast<uint32>(v.n_output - n_target);
+
+    reset();
+
+    if(n_extra > 0)
+    {
+        for(uint32 c = 0; c < y.getNChannels(); ++c)
+        {
+            y[c] = y[c].subbuffer(0, y[c].getLength() - n_extra);
+        }
+    }
+
+    return y;
+}
+
+void
+Stretcher::
+reset()
+{
+    delete vocoder_;
+    vocoder_ = NULL;
+}
+
+int32
+Stretcher::
+getDelay() const
+{
+    if(vocoder_ == NULL) return 0;
+
+    return vocoder_->delay;
+}
+
+AudioStream
+Stretcher::
+_vocodeAll(const AudioStream & x, const float64 & factor)
+{
+    M_PROFILE_SAMPLES("Stretcher::timeShift", x.getLength());
+
+    reset();
+
+    AudioStream y = timeShiftBlock(x, factor);
+
+    int32 delay = getDelay();
+
+    y << flush();
+
+    uint32 n_target = static_cast<uint32>(
+        std::floor(x.getLength() * factor + 0.5));
+
+    // Line up the output with the input.
+    for(uint32 c = 0; c < y.getNChannels(); ++c)
+    {
+        Buffer & b = y[c];
+
+        if(delay >= static_cast<int32>(b.getLength()))
+        {
+            b = Buffer();
+        }
+        else if(delay > 0)
+        {
+            b = b.subbuffer(delay);
+        }
+        else if(delay < 0)
+        {
+            b = Buffer(FloatVector(-delay, 0.0)) << b;
+        }
+
+        if(b.getLength() > n_target)
+        {
+            b = b.subbuffer(0, n_target);
+        }
+        else if(b.getLength() < n_target)
+        {
+            b << Buffer(FloatVector(n_target - b.getLength(), 0.0));
+        }
+    }
+
+    return y;
+}
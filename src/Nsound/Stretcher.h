@@ -45,11 +45,45 @@ class Buffer;
 class FFTChunk;
 
 //-----------------------------------------------------------------------------
-//! WSOLA
+//! Time stretching and pitch shifting.
+//
+//! Two methods are available.  WSOLA (the default) overlap adds windows of
+//! the input, each window is searched for the best match with the last.
+//! PHASE_VOCODER stretches a StreamingSTFT of the input, the phases are
+//! propagated from each spectral peak to the bins around it (phase locking)
+//! and restart from the input phases at transients, so the partials of an
+//! attack start in phase instead of inheriting the accumulated phases.
+//! Every channel of an AudioStream gets the same phase rotation, computed
+//! from the loudest channel of each bin, so the phase differences between
+//! channels are kept.
+//!
+//! The phase vocoder has no search, it is over 10x faster than WSOLA for
+//! factors of 1.5 and up, and it can stretch a stream one block at a time
+//! with timeShiftBlock().
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! Stretcher s(44100.0);
+//! s.setMethod(Stretcher::PHASE_VOCODER);
+//!
+//! AudioStream slow = s.timeShift(x, 2.0);
+//!
+//! // Python
+//! s = Stretcher(44100.0)
+//! s.setMethod(Stretcher.PHASE_VOCODER)
+//! slow = s.timeShift(x, 2.0)
+//! \endcode
 class Stretcher
 {
     public:
 
+    enum Method
+    {
+        WSOLA,
+        PHASE_VOCODER
+    };
+
     //! Default Constructor
     //
     //! sample_rate:      the sample rate
@@ -85,6 +119,29 @@ class Stretcher
     void
     showProgress(boolean flag){show_progress_ = flag;};
 
+    //! Selects the algorithm, WSOLA or PHASE_VOCODER.
+    //
+    //! The phase vocoder needs a constant factor, the versions of
+    //! timeShift() and pitchShift() taking a Buffer of factors always use
+    //! WSOLA.  Its factor must be at least 1 / the window length in samples
+    //! and at most the window length / 4.
+    void
+    setMethod(const Method method);
+
+    Method
+    getMethod() const { return method_; }
+
+    //! Sets the spectral flux that marks a phase vocoder frame a transient.
+    //
+    //! The flux is the magnitude gained since the last frame over the
+    //! frame's total magnitude, 0 to 1.  The default is 0.3, 1 disables
+    //! transient detection.
+    void
+    setTransientThreshold(const float64 & threshold);
+
+    float64
+    getTransientThreshold() const { return transient_threshold_; }
+
     AudioStream
     timeShift(const AudioStream & x, const float64 & factor);
 
@@ -97,8 +154,46 @@ class Stretcher
     Buffer
     timeShift(const Buffer & x, const Buffer & factor);
 
+    //! Phase vocoder time stretches the next block of a stream.
+    //
+    //! Returns the output finished so far, the output lags the input by
+    //! about a window.  The factor and number of channels must stay the
+    //! same until flush() or reset().
+    AudioStream
+    timeShiftBlock(const AudioStream & x, const float64 & factor);
+
+    Buffer
+    timeShiftBlock(const Buffer & x, const float64 & factor);
+
+    //! Ends the stream started by timeShiftBlock(), returns the rest.
+    AudioStream
+    flush();
+
+    //! Forgets the stream started by timeShiftBlock().
+    void
+    reset();
+
+    //! The number of samples the timeShiftBlock() output lags the stretched
+    //! input, negative if it leads, 0 before the stream starts.
+    //
+    //! Dropping these from the start of the stream and trimming it to
+    //! round(length * factor) gives the output of timeShift().
+    int32
+    getDelay() const;
+
     protected:
 
+    struct Vocoder;
+
+    void
+    _vocode(const AudioStream & x, AudioStream & y);
+
+    void
+    _vocodeFrame(AudioStream & y);
+
+    AudioStream
+    _vocodeAll(const AudioStream & x, const float64 & factor);
+
     void
     analyize(const Buffer & input, const float64 & factor);
 
@@ -121,6 +216,10 @@ class Stretcher
     uint32   max_delta_;
     boolean  show_progress_;
 
+    Method   method_;
+    float64  transient_threshold_;
+    Vocoder * vocoder_;
+
 };
 
 } // namespace
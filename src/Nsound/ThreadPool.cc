@@ -0,0 +1,283 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: ThreadPool.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/ThreadPool.h>
+
+using namespace Nsound;
+
+// True on a thread while it runs a task, nested work runs on that thread.
+static thread_local boolean in_task = false;
+
+//-----------------------------------------------------------------------------
+ThreadPool::
+ThreadPool()
+    :
+    n_threads_(1),
+    run_mutex_(),
+    error_mutex_(),
+    error_()
+    #ifndef NSOUND_OPENMP
+        ,
+        threads_(),
+        mutex_(),
+        start_cv_(),
+        done_cv_(),
+        task_(NULL),
+        n_tasks_(0),
+        generation_(0),
+        n_done_(0),
+        n_active_(0),
+        shutdown_(false),
+        next_(0)
+    #endif
+{
+}
+
+ThreadPool &
+ThreadPool::
+getInstance()
+{
+    // Leaked on purpose, the workers may outlive other static objects.
+    static ThreadPool * instance = new ThreadPool();
+
+    return *instance;
+}
+
+void
+ThreadPool::
+setNThreads(const uint32 n_threads)
+{
+    M_ASSERT_MSG(!in_task, "setNThreads() can't be called from a task");
+
+    std::lock_guard<std::mutex> lock(run_mutex_);
+
+    uint32 n = n_threads;
+
+    if(n == 0)
+    {
+        #ifdef NSOUND_OPENMP
+            n = static_cast<uint32>(omp_get_max_threads());
+        #else
+            n = std::thread::hardware_concurrency();
+        #endif
+    }
+
+    if(n == 0) n = 1;
+
+    #ifndef NSOUND_OPENMP
+        _stop();
+    #endif
+
+    n_threads_ = n;
+
+    #ifndef NSOUND_OPENMP
+        _start();
+    #endif
+}
+
+void
+ThreadPool::
+run(const uint32 n_tasks, const Task & task)
+{
+    std::unique_lock<std::mutex> lock(run_mutex_, std::defer_lock);
+
+    if(n_tasks < 2 || n_threads_ == 1 || in_task || !lock.try_lock())
+    {
+        for(uint32 i = 0; i < n_tasks; ++i) task(i);
+
+        return;
+    }
+
+    #ifdef NSOUND_OPENMP
+
+        int32 n = static_cast<int32>(n_tasks);
+        int32 n_threads = static_cast<int32>(n_threads_);
+
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(n_threads)
+        for(int32 i = 0; i < n; ++i)
+        {
+            _runTask(task, static_cast<uint32>(i));
+        }
+
+    #else
+
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+
+            task_ = &task;
+            n_tasks_ = n_tasks;
+            n_done_ = 0;
+            next_ = 0;
+            ++generation_;
+        }
+
+        start_cv_.notify_all();
+
+        uint32 n_done = _work(task, n_tasks);
+
+        {
+            std::unique_lock<std::mutex> guard(mutex_);
+
+            n_done_ += n_done;
+
+            // Workers still holding the job must let go of it too.
+            done_cv_.wait(
+                guard,
+                [&]{ return n_done_ == n_tasks_ && n_active_ == 0; });
+
+            task_ = NULL;
+            n_tasks_ = 0;
+        }
+
+    #endif
+
+    if(error_)
+    {
+        std::exception_ptr e = error_;
+        error_ = std::exception_ptr();
+        std::rethrow_exception(e);
+    }
+}
+
+void
+ThreadPool::
+_runTask(const Task & task, const uint32 index)
+{
+    in_task = true;
+
+    try
+    {
+        task(index);
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+
+        if(!error_) error_ = std::current_exception();
+    }
+
+    in_task = false;
+}
+
+#ifndef NSOUND_OPENMP
+
+void
+ThreadPool::
+_start()
+{
+    // The calling thread of run() is the first worker.
+    for(uint32 i = 1; i < n_threads_; ++i)
+    {
+        threads_.push_back(std::thread(&ThreadPool::_workerLoop, this));
+    }
+}
+
+void
+ThreadPool::
+_stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+
+    start_cv_.notify_all();
+
+    for(auto & t : threads_) t.join();
+
+    threads_.clear();
+
+    shutdown_ = false;
+}
+
+uint32
+ThreadPool::
+_work(const Task & task, const uint32 n_tasks)
+{
+    uint32 n_done = 0;
+
+    while(true)
+    {
+        uint32 index = next_++;
+
+        if(index >= n_tasks) break;
+
+        _runTask(task, index);
+
+        ++n_done;
+    }
+
+    return n_done;
+}
+
+void
+ThreadPool::
+_workerLoop()
+{
+    uint64 seen = 0;
+
+    while(true)
+    {
+        const Task * task = NULL;
+        uint32 n_tasks = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            start_cv_.wait(
+                lock,
+                [&]{ return shutdown_ || generation_ != seen; });
+
+            if(shutdown_) return;
+
+            seen = generation_;
+
+            if(task_ == NULL) continue;
+
+            task = task_;
+            n_tasks = n_tasks_;
+
+            ++n_active_;
+        }
+
+        uint32 n_done = _work(*task, n_tasks);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            n_done_ += n_done;
+            --n_active_;
+        }
+
+        done_cv_.notify_one();
+    }
+}
+
+#endif
+
+// :mode=c++: jEdit modeline
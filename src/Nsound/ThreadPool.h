@@ -0,0 +1,155 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: ThreadPool.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_THREAD_POOL_H_
+#define _NSOUND_THREAD_POOL_H_
+
+#include <Nsound/Nsound.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Nsound
+{
+
+//-----------------------------------------------------------------------------
+//! A process wide pool of worker threads for channel parallel processing.
+//
+//! AudioStream methods and Filter::filter(AudioStream) hand their channels,
+//! or chunks of a channel for element wise operations, to this pool, as do
+//! RenderScheduler and the FilterIIR kernel design.  The pool is opt-in, it
+//! starts with one thread and then runs all work on the calling thread
+//! exactly as before.
+//!
+//! Work submitted from inside a task, or while another thread is using the
+//! pool, runs on the calling thread, so nested calls never deadlock.
+//!
+//! When Nsound is compiled with OpenMP the tasks are distributed with a
+//! dynamic OpenMP schedule, otherwise persistent std::threads take the
+//! tasks in order from a shared counter.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! ThreadPool::getInstance().setNThreads(0); // One per core.
+//!
+//! AudioStream a("64_channels.wav");
+//!
+//! FilterLowPassIIR lpf(a.getSampleRate(), 6, 1000.0, 0.0);
+//!
+//! a = lpf.filter(a); // A copy of lpf filters each channel.
+//! a.normalize();
+//! \endcode
+class ThreadPool
+{
+    public:
+
+    #ifndef SWIG
+    typedef std::function<void (uint32 index)> Task;
+    #endif
+
+    //! Returns the pool shared by all of Nsound.
+    static
+    ThreadPool &
+    getInstance();
+
+    uint32 getNThreads() const { return n_threads_; }
+
+    //! Sets the number of threads, 0 means one per core, 1 turns it off.
+    //
+    //! Waits for work in progress, must not be called from a task.
+    void
+    setNThreads(const uint32 n_threads);
+
+    #ifndef SWIG
+    //! Runs task(i) for i in [0, n_tasks) and returns when all are done.
+    //
+    //! An exception thrown by a task is rethrown here after all tasks have
+    //! completed.
+    void
+    run(const uint32 n_tasks, const Task & task);
+    #endif
+
+    private:
+
+    ThreadPool();
+    ThreadPool(const ThreadPool & copy);
+    ThreadPool & operator=(const ThreadPool & rhs);
+
+    void _runTask(const Task & task, const uint32 index);
+
+    #ifndef NSOUND_OPENMP
+        void _start();
+        void _stop();
+        uint32 _work(const Task & task, const uint32 n_tasks);
+        void _workerLoop();
+    #endif
+
+    std::atomic<uint32> n_threads_;
+
+    // Held while the pool runs tasks, callers that find it taken run alone.
+    std::mutex run_mutex_;
+
+    std::mutex         error_mutex_;
+    std::exception_ptr error_;
+
+    #ifndef NSOUND_OPENMP
+
+        std::vector<std::thread> threads_;
+
+        std::mutex              mutex_;
+        std::condition_variable start_cv_;
+        std::condition_variable done_cv_;
+
+        // The current job, guarded by mutex_.
+        const Task * task_;
+        uint32       n_tasks_;
+        uint64       generation_;
+        uint32       n_done_;
+        uint32       n_active_;
+        bool         shutdown_;
+
+        std::atomic<uint32> next_;
+
+    #endif
+
+}; // class ThreadPool
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
@@ -28,12 +28,15 @@
 
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
+#include <Nsound/FFTransform.h>
 #include <Nsound/FilterBandPassIIR.h>
-#include <Nsound/FilterBandPassVocoder.h>
-#include <Nsound/FilterMovingAverage.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Profiler.h>
 #include <Nsound/Vocoder.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace Nsound;
 
 using std::cerr;
@@ -42,6 +45,13 @@ using std::endl;
 
 #define CERR_HEADER __FILE__ << ":" << __LINE__ << ": "
 
+// Number of samples filtered per pass when filtering a Buffer.
+static const uint32 BLOCK_SIZE = 256;
+
+// The band order and ripple of the filter bank.
+static const uint32  ORDER = 6;
+static const float64 RIPPLE = 0.01;
+
 // Convert Hz to mel scale.
 //
 // mels = 1127 * ln(1 + hz/700)
@@ -78,15 +88,25 @@ Vocoder(
     window_size_(static_cast<uint32>(window_length * sample_rate_)),
     n_bands_(n_bands),
     freq_max_(freq_max),
-    filters_input_(),
-    filters_output_(),
-    moving_average_()
+    band_low_(),
+    band_high_(),
+    voice_bank_(sample_rate),
+    carrier_bank_(sample_rate),
+    average_init_(true),
+    average_index_(0),
+    average_history_(),
+    average_sum_(),
+    voice_bands_(),
+    carrier_bands_(),
+    fft_size_(0),
+    fft_weights_()
 {
     M_ASSERT_VALUE(sample_rate_, >, 0.0);
 
     uint32 min_window_size = static_cast<uint32>(sample_rate_ * 0.005);
 
     M_ASSERT_VALUE(window_size_, >=, min_window_size);
+    M_ASSERT_VALUE(window_size_, >, 0);
 
     uint32 min_n_bands = 4;
 
@@ -128,11 +148,14 @@ Vocoder(
         }
     }
 
-    uint32 start = 0;
-    uint32 order = 6;
-    float64 ripple = 0.01;
+    if(plot_filter_bank)
+    {
+        Plotter pylab;
+
+        pylab.figure();
+    }
 
-    for(uint32 i = start; i < n_bands_; ++i)
+    for(uint32 i = 0; i < n_bands_; ++i)
     {
         float64 freq = freq_centers[i];
 
@@ -152,49 +175,29 @@ Vocoder(
             f_hi = (freq + freq_centers[i + 1]) / 2.0;
         }
 
-        FilterBandPassIIR * bp = new FilterBandPassIIR(
-            sample_rate_,
-            order,
-            f_lo,
-            f_hi,
-            ripple);
+        band_low_.push_back(f_lo);
+        band_high_.push_back(f_hi);
 
-        M_CHECK_PTR(bp);
+        FilterBandPassIIR bp(sample_rate_, ORDER, f_lo, f_hi, RIPPLE);
 
-        filters_input_.push_back(bp);
+        voice_bank_.addBand(bp);
+        carrier_bank_.addBand(bp);
 
-        bp = new FilterBandPassIIR(
-            sample_rate_,
-            order,
-            f_lo,
-            f_hi,
-            ripple);
-
-        M_CHECK_PTR(bp);
-
-        filters_output_.push_back(bp);
-
-        FilterMovingAverage * ma = new FilterMovingAverage(window_size_);
+        if(plot_filter_bank)
+        {
+            Plotter pylab;
 
-        M_CHECK_PTR(ma);
+            Buffer x = bp.getFrequencyAxis();
+            Buffer y = bp.getFrequencyResponse().getdB();
 
-        moving_average_.push_back(ma);
+            pylab.plot(x, y);
+        }
     }
 
     if(plot_filter_bank)
     {
         Plotter pylab;
 
-        pylab.figure();
-
-        for(size_t i = 0; i < filters_input_.size(); ++i)
-        {
-            Buffer x = filters_input_[i]->getFrequencyAxis();
-            Buffer y = filters_input_[i]->getFrequencyResponse().getdB();
-
-            pylab.plot(x, y);
-        }
-
         pylab.xlim(0.0, freq_max_);
         pylab.ylim(-40.0, 10.0);
         pylab.xlabel("Frequency (Hz)");
@@ -204,43 +207,44 @@ Vocoder(
 //~        pylab.show();
     }
 
+    average_history_.resize(window_size_ * n_bands_);
+    average_sum_.resize(n_bands_);
+
+    voice_bands_.resize(BLOCK_SIZE * n_bands_);
+    carrier_bands_.resize(BLOCK_SIZE * n_bands_);
+
+    reset();
 }
 
 //-----------------------------------------------------------------------------
 Vocoder::
 ~Vocoder()
 {
-    FilterVector::iterator fi = filters_input_.begin();
-    FilterVector::iterator fo = filters_output_.begin();
-    FilterVector::iterator ma = moving_average_.begin();
-
-    FilterVector::iterator end = filters_input_.end();
-
-    while(fi != end)
-    {
-        delete *fi;
-        delete *fo;
-        delete *ma;
-
-        ++fi;
-        ++fo;
-        ++ma;
-    }
 }
 
 Buffer
 Vocoder::
 filter(const Buffer & voice, const Buffer & x)
 {
-    Buffer y;
+    M_PROFILE_SAMPLES("Vocoder::filter", x.getLength());
 
-    Buffer::const_circular_iterator v = voice.cbegin();
+    if(fft_size_ > 0) return filterFFT(voice, x);
 
     uint32 n_samples = x.getLength();
 
-    for(uint32 n = 0; n < n_samples; ++n, ++v)
+    Buffer y = x;
+
+    float64 v[BLOCK_SIZE];
+
+    Buffer::const_circular_iterator vi = voice.cbegin();
+
+    for(uint32 n = 0; n < n_samples; n += BLOCK_SIZE)
     {
-        y << Vocoder::filter(*v, x[n]);
+        uint32 n_block = std::min(BLOCK_SIZE, n_samples - n);
+
+        for(uint32 i = 0; i < n_block; ++i, ++vi) v[i] = *vi;
+
+        filterBlock(v, y.getPointer() + n, y.getPointer() + n, n_block);
     }
 
     return y;
@@ -250,55 +254,238 @@ float64
 Vocoder::
 filter(const float64 & voice, const float64 & x)
 {
-    FilterVector::iterator fi = filters_input_.begin();
-    FilterVector::iterator fo = filters_output_.begin();
-    FilterVector::iterator ma = moving_average_.begin();
+    float64 y = 0.0;
 
-    FilterVector::iterator end = filters_input_.end();
+    filterBlock(&voice, &x, &y, 1);
 
-    float64 y = 0.0;
+    return y;
+}
+
+void
+Vocoder::
+filterBlock(
+    const float64 * voice,
+    const float64 * carrier,
+    float64 * y,
+    const uint32 n_samples)
+{
+    const uint32 nb = n_bands_;
+    const float64 window = static_cast<float64>(window_size_);
+
+    voice_bank_.filter(voice, voice_bands_.data(), n_samples);
+    carrier_bank_.filter(carrier, carrier_bands_.data(), n_samples);
 
-    while(fi != end)
+    float64 * sum = average_sum_.data();
+
+    for(uint32 i = 0; i < n_samples; ++i)
     {
-        // Filter the voice to use as an envelope..
-        float64 envelope = (*fi)->filter(voice);
+        float64 * env = voice_bands_.data() + i * nb;
+        const float64 * c = carrier_bands_.data() + i * nb;
+
+        // The moving average starts out full of the first envelope sample,
+        // exactly like FilterMovingAverage.
+        if(average_init_)
+        {
+            average_init_ = false;
 
-        // Use the abs of the envelope.
-        envelope = std::fabs(envelope);
+            for(uint32 j = 0; j < nb; ++j)
+            {
+                float64 e = std::fabs(env[j]);
 
-        // Smooth the filtered envelope.
-        envelope = (*ma)->filter(envelope);
+                for(uint32 k = 0; k < window_size_; ++k)
+                {
+                    average_history_[k * nb + j] = e;
+                }
 
-        // Shape the filtered input signal.
-        y += envelope * (*fo)->filter(x);
+                sum[j] += (window - 1.0) * e;
+            }
+        }
 
-        ++fi;
-        ++fo;
-        ++ma;
-    }
+        float64 * history = average_history_.data() + average_index_ * nb;
 
-    return y;
+        for(uint32 j = 0; j < nb; ++j)
+        {
+            float64 e = std::fabs(env[j]);
+
+            sum[j] += e - history[j];
+
+            history[j] = e;
+
+            env[j] = (sum[j] / window) * c[j];
+        }
+
+        if(++average_index_ >= window_size_) average_index_ = 0;
+
+        // Mixed in band order.
+        float64 out = 0.0;
+
+        for(uint32 j = 0; j < nb; ++j) out += env[j];
+
+        y[i] = out;
+    }
 }
 
 void
 Vocoder::
-reset()
+setFFTSize(const uint32 fft_size)
+{
+    fft_size_ = fft_size;
+
+    fft_weights_.clear();
+
+    if(fft_size_ == 0) return;
+
+    M_ASSERT_VALUE(fft_size_, >=, 16);
+    M_ASSERT_VALUE(
+        static_cast<uint32>(FFTransform::roundUp2(fft_size_)), ==, fft_size_);
+
+    const uint32 n_bins = fft_size_ / 2 + 1;
+
+    Buffer freqs(n_bins);
+
+    for(uint32 k = 0; k < n_bins; ++k)
+    {
+        freqs << k * sample_rate_ / static_cast<float64>(fft_size_);
+    }
+
+    fft_weights_.resize(n_bins * n_bands_);
+
+    for(uint32 j = 0; j < n_bands_; ++j)
+    {
+        FilterBandPassIIR bp(
+            sample_rate_, ORDER, band_low_[j], band_high_[j], RIPPLE);
+
+        Buffer h = bp.getFrequencyResponse(freqs);
+
+        for(uint32 k = 0; k < n_bins; ++k)
+        {
+            fft_weights_[k * n_bands_ + j] = h[k];
+        }
+    }
+}
+
+Buffer
+Vocoder::
+filterFFT(const Buffer & voice, const Buffer & x)
 {
-    FilterVector::iterator fi = filters_input_.begin();
-    FilterVector::iterator fo = filters_output_.begin();
-    FilterVector::iterator ma = moving_average_.begin();
+    const int32 N = static_cast<int32>(fft_size_);
+    const int32 hop = N / 2;
+    const uint32 n_bins = fft_size_ / 2 + 1;
+    const uint32 nb = n_bands_;
+
+    const int32 n_samples = static_cast<int32>(x.getLength());
+    const int32 n_voice = static_cast<int32>(voice.getLength());
 
-    FilterVector::iterator end = filters_input_.end();
+    M_ASSERT_VALUE(n_voice, >, 0);
 
-    while(fi != end)
+    // Periodic Hann, overlapped by 50% it sums to exactly 1.
+    std::vector<float64> window(N);
+
+    for(int32 i = 0; i < N; ++i)
+    {
+        window[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / N);
+    }
+
+    // Sum of the window squared is 3N/8.  The band RMS is scaled to the mean
+    // absolute value of a sinusoid, 2 sqrt(2) / pi, to match the filter bank.
+    const float64 scale = 2.0 * std::sqrt(2.0) / M_PI
+                        / std::sqrt(static_cast<float64>(N) * 3.0 * N / 8.0);
+
+    std::vector<float64> vr(N), vi(N), cr(N), ci(N);
+    std::vector<float64> energy(nb), gain(n_bins);
+
+    Buffer y = Buffer::zeros(n_samples);
+
+    float64 * out = y.getPointer();
+
+    const float64 * w = fft_weights_.data();
+
+    // The first frame starts a hop early so every sample is covered twice.
+    for(int32 start = -hop; start < n_samples; start += hop)
     {
-        (*fi)->reset();
-        (*fo)->reset();
-        (*ma)->reset();
+        for(int32 i = 0; i < N; ++i)
+        {
+            int32 t = start + i;
+
+            float64 v = 0.0;
+            float64 c = 0.0;
+
+            if(t >= 0 && t < n_samples)
+            {
+                v = voice[t % n_voice];
+                c = x[t];
+            }
+
+            vr[i] = window[i] * v;
+            cr[i] = window[i] * c;
+            vi[i] = 0.0;
+            ci[i] = 0.0;
+        }
+
+        FFTransform::radix2(vr.data(), vi.data(), N);
+        FFTransform::radix2(cr.data(), ci.data(), N);
+
+        std::fill(energy.begin(), energy.end(), 0.0);
 
-        ++fi;
-        ++fo;
-        ++ma;
+        for(uint32 k = 0; k < n_bins; ++k)
+        {
+            // The one sided spectrum counts the interior bins twice.
+            float64 p = vr[k] * vr[k] + vi[k] * vi[k];
+
+            if(k > 0 && k + 1 < n_bins) p *= 2.0;
+
+            const float64 * wk = w + k * nb;
+
+            for(uint32 j = 0; j < nb; ++j) energy[j] += wk[j] * wk[j] * p;
+        }
+
+        for(uint32 j = 0; j < nb; ++j)
+        {
+            energy[j] = std::sqrt(energy[j]) * scale;
+        }
+
+        for(uint32 k = 0; k < n_bins; ++k)
+        {
+            const float64 * wk = w + k * nb;
+
+            float64 g = 0.0;
+
+            for(uint32 j = 0; j < nb; ++j) g += energy[j] * wk[j];
+
+            gain[k] = g;
+        }
+
+        // Apply the real, symmetric gain and inverse transform.
+        for(int32 k = 0; k < N; ++k)
+        {
+            float64 g = gain[k < static_cast<int32>(n_bins) ? k : N - k];
+
+            cr[k] *= g;
+            ci[k] *= -g;
+        }
+
+        FFTransform::radix2(cr.data(), ci.data(), N);
+
+        for(int32 i = 0; i < N; ++i)
+        {
+            int32 t = start + i;
+
+            if(t >= 0 && t < n_samples) out[t] += cr[i] / N;
+        }
     }
+
+    return y;
 }
 
+void
+Vocoder::
+reset()
+{
+    voice_bank_.reset();
+    carrier_bank_.reset();
+
+    average_init_ = true;
+    average_index_ = 0;
+
+    std::fill(average_sum_.begin(), average_sum_.end(), 0.0);
+}
@@ -30,6 +30,8 @@
 
 #include <Nsound/Buffer.h>
 
+#include <Nsound/FilterBank.h>
+
 #include <vector>
 
 namespace Nsound
@@ -37,10 +39,18 @@ namespace Nsound
 
 class AudioStream;
 class Buffer;
-class Filter;
-class FilterMovingAverage;
 
 //-----------------------------------------------------------------------------
+//! A channel vocoder, shapes a carrier with the band envelopes of a voice.
+//
+//! The voice and the carrier each run through a FilterBank of band pass
+//! filters.  The envelope of each voice band is the moving average of its
+//! absolute value, the output is the sum of the carrier bands scaled by
+//! their envelopes.
+//!
+//! Alternatively setFFTSize() switches Vocoder::filter(voice, carrier) to
+//! analyze the bands in the frequency domain, trading the envelope's time
+//! resolution for speed with many bands.
 class Vocoder
 {
     public:
@@ -71,21 +81,63 @@ class Vocoder
     float64
     getSampleRate() const { return sample_rate_; };
 
+    uint32
+    getFFTSize() const { return fft_size_; };
+
+    //! Selects the frequency domain analysis for filtering Buffers.
+    //
+    //! With fft_size > 0, Vocoder::filter(voice, carrier) analyzes Hann
+    //! windowed frames of fft_size samples with 50% overlap.  Each band's
+    //! envelope is the voice's RMS through the band's magnitude response,
+    //! scaled to the mean absolute value, and applied to the carrier's
+    //! spectrum.  The envelope is then smoothed by the frame instead of by
+    //! window_length.  fft_size must be a power of 2, 0 (the default)
+    //! selects the filter bank.  Filtering one sample at a time always uses
+    //! the filter bank.
+    void
+    setFFTSize(const uint32 fft_size);
+
     void
     reset();
 
     protected:
 
+    //! Runs both filter banks over n_samples and mixes the bands.
+    void
+    filterBlock(
+        const float64 * voice,
+        const float64 * carrier,
+        float64 * y,
+        const uint32 n_samples);
+
+    Buffer
+    filterFFT(const Buffer & voice, const Buffer & carrier);
+
     float64 sample_rate_;
     uint32  window_size_;
     uint32  n_bands_;
     float64 freq_max_;
 
-    typedef std::vector< Filter * > FilterVector;
+    // The band edges, used to design the FFT weights.
+    std::vector<float64> band_low_;
+    std::vector<float64> band_high_;
+
+    FilterBank voice_bank_;
+    FilterBank carrier_bank_;
+
+    // The envelope moving averages, window_size_ x n_bands_ band-contiguous.
+    bool                 average_init_;
+    uint32               average_index_;
+    std::vector<float64> average_history_;
+    std::vector<float64> average_sum_;
+
+    // Block scratch, band-contiguous.
+    std::vector<float64> voice_bands_;
+    std::vector<float64> carrier_bands_;
 
-    FilterVector filters_input_;
-    FilterVector filters_output_;
-    FilterVector moving_average_;
+    // FFT mode, the band magnitude responses, (fft_size_ / 2 + 1) x n_bands_.
+    uint32               fft_size_;
+    std::vector<float64> fft_weights_;
 
 };
 
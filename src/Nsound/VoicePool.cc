@@ -0,0 +1,293 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: VoicePool.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/Instrument.h>
+#include <Nsound/Profiler.h>
+#include <Nsound/VoicePool.h>
+
+#include <algorithm>
+
+using namespace Nsound;
+
+//-----------------------------------------------------------------------------
+VoicePool::
+VoicePool(
+    Instrument & instrument,
+    const uint32 n_voices,
+    const uint32 n_cached_notes,
+    const uint32 n_channels)
+    :
+    instrument_(instrument),
+    sample_rate_(instrument.getSampleRate()),
+    release_time_(0.01),
+    n_cached_notes_(n_cached_notes),
+    n_channels_(n_channels),
+    voices_(n_voices),
+    lru_(),
+    cache_(),
+    clock_(0)
+{
+    M_ASSERT_VALUE(n_voices, >, 0);
+    M_ASSERT_VALUE(n_cached_notes, >, 0);
+    M_ASSERT_VALUE(n_channels, >, 0);
+
+    reset();
+}
+
+VoicePool::NotePtr
+VoicePool::
+getNote(const float64 & frequency, const float64 & duration)
+{
+    Key key(frequency, duration);
+
+    auto itor = cache_.find(key);
+
+    if(itor != cache_.end())
+    {
+        lru_.splice(lru_.begin(), lru_, itor->second.lru);
+        return itor->second.note;
+    }
+
+    NotePtr note(new AudioStream(instrument_.play(duration, frequency)));
+
+    uint32 n_channels = note->getNChannels();
+
+    M_ASSERT_MSG(
+        n_channels == 1 || n_channels == n_channels_,
+        "The instrument played " << n_channels << " channels, the pool has "
+        << n_channels_);
+
+    // Evict the least recently used, voices still playing it keep it alive.
+    while(cache_.size() >= n_cached_notes_)
+    {
+        cache_.erase(lru_.back());
+        lru_.pop_back();
+    }
+
+    lru_.push_front(key);
+
+    Entry & entry = cache_[key];
+
+    entry.note = note;
+    entry.lru = lru_.begin();
+
+    return note;
+}
+
+void
+VoicePool::
+prepare(const float64 & frequency, const float64 & duration)
+{
+    getNote(frequency, duration);
+}
+
+uint32
+VoicePool::
+noteOn(
+    const float64 & frequency,
+    const float64 & duration,
+    const float64 & velocity)
+{
+    M_ASSERT_VALUE(duration, >, 0.0);
+
+    // A free voice, else the oldest releasing voice, else the oldest.
+    uint32 index = 0;
+
+    for(uint32 i = 1; i < voices_.size(); ++i)
+    {
+        const Voice & best = voices_[index];
+        const Voice & v = voices_[i];
+
+        if(!best.active) break;
+
+        if(!v.active
+            || (v.releasing && !best.releasing)
+            || (v.releasing == best.releasing && v.started < best.started))
+        {
+            index = i;
+        }
+    }
+
+    Voice & v = voices_[index];
+
+    v.note = getNote(frequency, duration);
+
+    v.position = 0;
+    v.end = v.note->getLength();
+    v.gain = velocity;
+    v.release_step = 0.0;
+    v.active = v.end > 0;
+    v.releasing = false;
+    v.started = clock_;
+
+    return index;
+}
+
+void
+VoicePool::
+noteOff(const uint32 voice)
+{
+    M_ASSERT_VALUE(voice, <, voices_.size());
+
+    Voice & v = voices_[voice];
+
+    if(!v.active || v.releasing) return;
+
+    uint32 n_release = static_cast<uint32>(release_time_ * sample_rate_);
+
+    if(n_release < 1) n_release = 1;
+
+    v.releasing = true;
+    v.release_step = v.gain / n_release;
+    v.end = std::min(v.end, v.position + n_release);
+}
+
+void
+VoicePool::
+reset()
+{
+    for(auto & v : voices_)
+    {
+        v.note.reset();
+        v.position = 0;
+        v.end = 0;
+        v.gain = 0.0;
+        v.release_step = 0.0;
+        v.active = false;
+        v.releasing = false;
+        v.started = 0;
+    }
+
+    clock_ = 0;
+}
+
+uint32
+VoicePool::
+getNActive() const
+{
+    uint32 n = 0;
+
+    for(const auto & v : voices_) n += v.active;
+
+    return n;
+}
+
+bool
+VoicePool::
+isActive(const uint32 voice) const
+{
+    M_ASSERT_VALUE(voice, <, voices_.size());
+
+    return voices_[voice].active;
+}
+
+AudioStream
+VoicePool::
+render(const uint32 n_samples)
+{
+    AudioStream y(sample_rate_, n_channels_);
+
+    std::vector<float64 *> channels(n_channels_);
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        y[c] = Buffer::zeros(n_samples);
+        channels[c] = y[c].getPointer();
+    }
+
+    mix(channels.data(), n_samples);
+
+    return y;
+}
+
+void
+VoicePool::
+mix(float64 * const * y, const uint32 n_samples)
+{
+    M_PROFILE_SAMPLES("VoicePool::mix", n_samples);
+
+    for(auto & v : voices_)
+    {
+        if(!v.active) continue;
+
+        uint32 n = std::min(n_samples, v.end - v.position);
+
+        const AudioStream & note = *v.note;
+
+        const bool is_mono = note.getNChannels() == 1;
+
+        float64 gain = v.gain;
+
+        for(uint32 c = 0; c < n_channels_; ++c)
+        {
+            const float64 * x =
+                note[is_mono ? 0 : c].getPointer() + v.position;
+
+            float64 * out = y[c];
+
+            gain = v.gain;
+
+            if(v.releasing)
+            {
+                const float64 step = v.release_step;
+
+                for(uint32 i = 0; i < n; ++i)
+                {
+                    out[i] += gain * x[i];
+                    gain -= step;
+                }
+            }
+            else
+            {
+                for(uint32 i = 0; i < n; ++i) out[i] += gain * x[i];
+            }
+        }
+
+        v.gain = gain;
+        v.position += n;
+
+        // The note is kept until the voice is reused, so nothing is freed
+        // while rendering.
+        if(v.position >= v.end) v.active = false;
+    }
+
+    clock_ += n_samples;
+}
+
+void
+VoicePool::
+setReleaseTime(const float64 & seconds)
+{
+    M_ASSERT_VALUE(seconds, >, 0.0);
+
+    release_time_ = seconds;
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,218 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: VoicePool.h $
+//
+//  Nsound is a C++ library and Python module for audio synthesis featuring
+//  dynamic digital filters. Nsound lets you easily shape waveforms and write
+//  to disk or plot them. Nsound aims to be as powerful as Csound but easy to
+//  use.
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+#ifndef _NSOUND_VOICE_POOL_H_
+#define _NSOUND_VOICE_POOL_H_
+
+#include <Nsound/Nsound.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Nsound
+{
+
+class AudioStream;
+class Instrument;
+
+//-----------------------------------------------------------------------------
+//! Plays an Instrument polyphonically from note on and note off events.
+//
+//! The pool holds a fixed number of voices.  A voice plays a whole note
+//! rendered once by Instrument::play() and kept in a bounded, least
+//! recently used note cache, so repeated notes never construct the
+//! instrument's generators and filters again.  When every voice is busy
+//! noteOn() steals a voice, releasing voices first, then the oldest.
+//!
+//! Because notes are rendered whole, noteOn() needs the note's duration up
+//! front, noteOff() can only fade a note out before it ends.  Notes are
+//! cached by their exact frequency and duration.
+//!
+//! Rendering mixes every active voice into a shared accumulator a block at
+//! a time and never allocates.  noteOn() of a note that isn't cached calls
+//! Instrument::play() and allocates the note on the calling thread, use
+//! prepare() to render notes ahead of time, e.g. outside a real-time
+//! callback.
+//!
+//! A note with one channel plays on every channel of the pool, otherwise
+//! it must have the pool's number of channels.
+//!
+//! \par Example:
+//! \code
+//! // C++
+//! GuitarBass bass(44100.0);
+//!
+//! VoicePool pool(bass, 8);
+//!
+//! uint32 v = pool.noteOn(61.734, 2.0);
+//!
+//! AudioStream y = pool.render(22050);
+//!
+//! pool.noteOff(v);
+//!
+//! y << pool.render(22050);
+//!
+//! // Python
+//! bass = GuitarBass(44100.0)
+//! pool = VoicePool(bass, 8)
+//! v = pool.noteOn(61.734, 2.0)
+//! y = pool.render(22050)
+//! \endcode
+class VoicePool
+{
+    public:
+
+    //! Creates the pool, the instrument must outlive it.
+    //
+    //! \param instrument the instrument to play
+    //! \param n_voices the maximum number of notes sounding at once
+    //! \param n_cached_notes the number of rendered notes kept
+    //! \param n_channels the number of channels rendered
+    VoicePool(
+        Instrument & instrument,
+        const uint32 n_voices,
+        const uint32 n_cached_notes = 64,
+        const uint32 n_channels = 1);
+
+    //! Starts a note, returns the voice playing it.
+    //
+    //! \param frequency the note's frequency in Hz
+    //! \param duration the note's duration in seconds, noteOff() may end it
+    //!        earlier
+    //! \param velocity the note's gain
+    uint32
+    noteOn(
+        const float64 & frequency,
+        const float64 & duration,
+        const float64 & velocity = 1.0);
+
+    //! Fades the voice out over the release time.
+    void
+    noteOff(const uint32 voice);
+
+    //! Renders the note into the cache without playing it.
+    void
+    prepare(const float64 & frequency, const float64 & duration);
+
+    //! Silences every voice, the cached notes are kept.
+    void
+    reset();
+
+    uint32
+    getNActive() const;
+
+    uint32
+    getNCachedNotes() const { return static_cast<uint32>(cache_.size()); }
+
+    uint32
+    getNChannels() const { return n_channels_; }
+
+    uint32
+    getNVoices() const { return static_cast<uint32>(voices_.size()); }
+
+    bool
+    isActive(const uint32 voice) const;
+
+    //! Renders the next n_samples of the mix of all voices.
+    AudioStream
+    render(const uint32 n_samples);
+
+    #ifndef SWIG
+    //! Adds the next n_samples of the mix of all voices to y[0] through
+    //! y[getNChannels() - 1].
+    void
+    mix(float64 * const * y, const uint32 n_samples);
+    #endif
+
+    //! Sets the time a released voice takes to fade out, default 10 ms.
+    void
+    setReleaseTime(const float64 & seconds);
+
+    protected:
+
+    typedef std::shared_ptr<const AudioStream> NotePtr;
+
+    typedef std::pair<float64, float64> Key;
+
+    //! Returns the cached note, rendering it if needed.
+    NotePtr
+    getNote(const float64 & frequency, const float64 & duration);
+
+    struct Voice
+    {
+        NotePtr note;
+        uint32  position;
+        uint32  end;
+        float64 gain;
+        float64 release_step;
+        bool    active;
+        bool    releasing;
+        uint64  started;
+    };
+
+    typedef std::list<Key> LruList;
+
+    struct Entry
+    {
+        NotePtr           note;
+        LruList::iterator lru;
+    };
+
+    Instrument & instrument_;
+
+    float64 sample_rate_;
+    float64 release_time_;
+
+    uint32 n_cached_notes_;
+    uint32 n_channels_;
+
+    std::vector<Voice> voices_;
+
+    // Most recently used at the front.
+    LruList              lru_;
+    std::map<Key, Entry> cache_;
+
+    uint64 clock_;
+
+    private:
+
+    VoicePool(const VoicePool & copy);
+    VoicePool & operator=(const VoicePool & rhs);
+
+}; // class VoicePool
+
+} // namespace
+
+// :mode=c++: jEdit modeline
+#endif
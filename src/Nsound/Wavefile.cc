@@ -36,6 +36,9 @@
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
 #include <Nsound/Wavefile.h>
+#include <Nsound/Profiler.h>
+
+#include <algorithm>
 
 #include <math.h>
 #include <string.h>
@@ -402,6 +405,8 @@ read(
     AudioStream * as,
     std::stringstream * ss)
 {
+    M_PROFILE("Wavefile::read");
+
     FILE * fd;
     fd = fopen(filename.c_str(), "rb");
 
@@ -953,6 +958,8 @@ write(const string & filename,
       const AudioStream & as,
       uint32 bits_per_sample)
 {
+    M_PROFILE_SAMPLES("Wavefile::write", as.getLength() * as.getNChannels());
+
     if( bits_per_sample !=  8 &&
         bits_per_sample != 16 &&
         bits_per_sample != 24 &&
@@ -1135,6 +1142,8 @@ write(
     uint32 bits_per_sample,
     uint32 sample_rate)
 {
+    M_PROFILE_SAMPLES("Wavefile::write", buffer.getLength());
+
     if( bits_per_sample !=  8 &&
         bits_per_sample != 16 &&
         bits_per_sample != 24 &&
@@ -1514,6 +1523,571 @@ operator>>(const AudioStream & lhs, const char * rhs)
         Wavefile::getDefaultSampleSize());
 }
 
+//-----------------------------------------------------------------------------
+WavefileWriter::
+WavefileWriter()
+    :
+    output_(NULL),
+    filename_(),
+    n_channels_(0),
+    bits_per_sample_(0),
+    n_bytes_(0),
+    format_tag_(Wavefile::WAVE_FORMAT_PCM_),
+    data_scale_(0.0),
+    n_samples_(0),
+    bytes_(),
+    channels_()
+{
+}
+
+WavefileWriter::
+WavefileWriter(
+    const std::string & filename,
+    const float64 & sample_rate,
+    const uint32 n_channels,
+    const uint32 bits_per_sample)
+    :
+    output_(NULL),
+    filename_(),
+    n_channels_(0),
+    bits_per_sample_(0),
+    n_bytes_(0),
+    format_tag_(Wavefile::WAVE_FORMAT_PCM_),
+    data_scale_(0.0),
+    n_samples_(0),
+    bytes_(),
+    channels_()
+{
+    open(filename, sample_rate, n_channels, bits_per_sample);
+}
+
+WavefileWriter::
+~WavefileWriter()
+{
+    if(output_ != NULL) close();
+}
+
+void
+WavefileWriter::
+open(
+    const std::string & filename,
+    const float64 & sample_rate,
+    const uint32 n_channels,
+    const uint32 bits_per_sample)
+{
+    if(output_ != NULL) close();
+
+    M_ASSERT_VALUE(n_channels, >, 0);
+
+    format_tag_ = Wavefile::default_wave_format_;
+
+    switch(bits_per_sample)
+    {
+        case 64: data_scale_ = Wavefile::SIGNED_64_BIT_; break;
+        case 48: data_scale_ = Wavefile::SIGNED_48_BIT_; break;
+        case 32: data_scale_ = Wavefile::SIGNED_32_BIT_; break;
+        case 24: data_scale_ = Wavefile::SIGNED_24_BIT_; break;
+        case 16: data_scale_ = Wavefile::SIGNED_16_BIT_; break;
+        case 8:  data_scale_ = Wavefile::SIGNED_8_BIT_;  break;
+
+        default:
+            M_THROW("WavefileWriter::open(): "
+                << "bits per sample must be 8, 16, 24, 32, 48, 64");
+    }
+
+    if(format_tag_ == Wavefile::WAVE_FORMAT_IEEE_FLOAT_
+        && bits_per_sample != 32
+        && bits_per_sample != 64)
+    {
+        M_THROW("WavefileWriter::open(\""
+            << filename
+            << "\"): format is "
+            << "IEEE Float but bits_per_sample = "
+            << bits_per_sample);
+    }
+
+    output_ = fopen(filename.c_str(), "wb");
+
+    if(output_ == NULL)
+    {
+        M_THROW("WavefileWriter::open(): "
+            << "unable to open file '"
+            << filename);
+    }
+
+    filename_ = filename;
+    n_channels_ = n_channels;
+    bits_per_sample_ = bits_per_sample;
+    n_bytes_ = bits_per_sample / 8;
+    n_samples_ = 0;
+
+    channels_.resize(n_channels_);
+
+    uint32 block_alignment = n_channels_ * n_bytes_;
+    uint32 rate = static_cast<uint32>(sample_rate);
+
+    // The same header as Wavefile::write(), the lengths are filled in by
+    // close().
+    writeInt(output_,4,Wavefile::RIFF_);
+    writeInt(output_,4,36);
+    writeInt(output_,4,Wavefile::WAVE_);
+    writeInt(output_,4,Wavefile::FMT_);
+    writeInt(output_,4,16); // format_chunk_length = 16
+    writeInt(output_,2,format_tag_);
+    writeInt(output_,2,n_channels_);
+    writeInt(output_,4,rate);
+    writeInt(output_,4,rate * block_alignment);
+    writeInt(output_,2,block_alignment);
+    writeInt(output_,2,bits_per_sample_);
+
+    if(format_tag_ == Wavefile::WAVE_FORMAT_IEEE_FLOAT_)
+    {
+        writeInt(output_,4,Wavefile::FACT_);
+        writeInt(output_,4, 4);
+        writeInt(output_,4, 0);
+
+        writeInt(output_,4,Wavefile::PEAK_);
+        writeInt(output_,4, 16);
+        writeInt(output_,4, 0);
+        writeInt(output_,4, 0);
+        writeInt(output_,4, 0);
+        writeInt(output_,4, 0);
+    }
+
+    writeInt(output_,4,Wavefile::DATA_);
+    writeInt(output_,4,0);
+}
+
+void
+WavefileWriter::
+write(const AudioStream & block)
+{
+    M_ASSERT_VALUE(block.getNChannels(), ==, n_channels_);
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        M_ASSERT_VALUE(block[c].getLength(), ==, block.getLength());
+
+        channels_[c] = block[c].getPointer();
+    }
+
+    write(channels_.data(), block.getLength());
+}
+
+void
+WavefileWriter::
+write(const Buffer & block)
+{
+    M_ASSERT_VALUE(n_channels_, ==, 1);
+
+    channels_[0] = block.getPointer();
+
+    write(channels_.data(), block.getLength());
+}
+
+void
+WavefileWriter::
+write(const float64 * const * channels, const uint32 n_samples)
+{
+    M_ASSERT_MSG(output_ != NULL, "WavefileWriter: the file is not open");
+
+    M_PROFILE_SAMPLES("WavefileWriter::write", n_samples * n_channels_);
+
+    // The RIFF header stores the data length + 36 in 32 bits.
+    uint64 n_total = (n_samples_ + n_samples) * n_channels_ * n_bytes_;
+
+    if(n_total + 36 > 0xffffffffULL)
+    {
+        M_THROW("WavefileWriter::write(): "
+            << "'" << filename_ << "' would exceed the 4 GB wave file limit, "
+            << n_samples_ << " samples per channel were written");
+    }
+
+    bytes_.resize(static_cast<std::size_t>(n_samples) * n_channels_ * n_bytes_);
+
+    char * out = bytes_.data();
+
+    int64 positive_data_scale = static_cast<int64>(data_scale_);
+    int64 negitive_data_scale = static_cast<int64>(-1.0 * data_scale_);
+
+    // Little endian bytes, interleaved.
+    for(uint32 i = 0; i < n_samples; ++i)
+    {
+        for(uint32 ch = 0; ch < n_channels_; ++ch)
+        {
+            float64 x = channels[ch][i];
+
+            uint64 bits = 0;
+
+            if(format_tag_ == Wavefile::WAVE_FORMAT_PCM_)
+            {
+                int64 scaled = static_cast<int64>(x * data_scale_);
+
+                if(scaled > positive_data_scale)
+                {
+                    scaled = positive_data_scale;
+                }
+                else if(scaled < negitive_data_scale)
+                {
+                    scaled = negitive_data_scale;
+                }
+
+                bits = static_cast<uint64>(scaled);
+            }
+            else if(n_bytes_ == 4)
+            {
+                float32 f = static_cast<float32>(x);
+                uint32 b = 0;
+                memcpy(&b, &f, 4);
+                bits = b;
+            }
+            else
+            {
+                memcpy(&bits, &x, 8);
+            }
+
+            for(uint32 k = 0; k < n_bytes_; ++k)
+            {
+                *out++ = static_cast<char>((bits >> (8 * k)) & 0xff);
+            }
+        }
+    }
+
+    fwrite(bytes_.data(), 1, bytes_.size(), output_);
+
+    n_samples_ += n_samples;
+}
+
+void
+WavefileWriter::
+close()
+{
+    if(output_ == NULL) return;
+
+    uint32 data_length = static_cast<uint32>(
+        n_samples_ * n_channels_ * n_bytes_);
+
+    fseek(output_, 4, SEEK_SET);
+    writeInt(output_,4,data_length + 36);
+
+    if(format_tag_ == Wavefile::WAVE_FORMAT_IEEE_FLOAT_)
+    {
+        fseek(output_, 44, SEEK_SET);
+        writeInt(output_,4,n_samples_);
+
+        fseek(output_, 76, SEEK_SET);
+    }
+    else
+    {
+        fseek(output_, 40, SEEK_SET);
+    }
+
+    writeInt(output_,4,data_length);
+
+    fclose(output_);
+
+    output_ = NULL;
+}
+
+//-----------------------------------------------------------------------------
+WavefileReader::
+WavefileReader()
+    :
+    input_(NULL),
+    filename_(),
+    n_channels_(0),
+    bits_per_sample_(0),
+    n_bytes_(0),
+    format_tag_(Wavefile::WAVE_FORMAT_PCM_),
+    data_scale_(0.0),
+    sample_rate_(0.0),
+    n_samples_(0),
+    position_(0),
+    bytes_(),
+    channels_()
+{
+}
+
+WavefileReader::
+WavefileReader(const std::string & filename)
+    :
+    input_(NULL),
+    filename_(),
+    n_channels_(0),
+    bits_per_sample_(0),
+    n_bytes_(0),
+    format_tag_(Wavefile::WAVE_FORMAT_PCM_),
+    data_scale_(0.0),
+    sample_rate_(0.0),
+    n_samples_(0),
+    position_(0),
+    bytes_(),
+    channels_()
+{
+    open(filename);
+}
+
+WavefileReader::
+~WavefileReader()
+{
+    close();
+}
+
+void
+WavefileReader::
+open(const std::string & filename)
+{
+    close();
+
+    input_ = fopen(filename.c_str(), "rb");
+
+    if(input_ == NULL)
+    {
+        M_THROW("WavefileReader::open(): unable to open file '"
+            << filename << "'");
+    }
+
+    filename_ = filename;
+
+    // The same header parsing as Wavefile::read().
+    if(static_cast<uint32>(readInt(input_, 4)) != Wavefile::RIFF_)
+    {
+        close();
+        M_THROW("WavefileReader::open(): '" << filename
+            << "', could not read 'RIFF' from file");
+    }
+
+    readInt(input_, 4);
+
+    if(static_cast<uint32>(readInt(input_, 4)) != Wavefile::WAVE_)
+    {
+        close();
+        M_THROW("WavefileReader::open(): '" << filename
+            << "', could not read 'WAVE' from file");
+    }
+
+    long cur_pos = ftell(input_);
+    fseek(input_, 0, SEEK_END);
+    long end_pos = ftell(input_);
+    fseek(input_, cur_pos, SEEK_SET);
+
+    uint32 channels = 0;
+    uint32 sample_rate = 0;
+    uint32 bits_per_sample = 0;
+
+    format_tag_ = 0;
+
+    uint32 chunk_id = static_cast<uint32>(readInt(input_, 4));
+
+    while(chunk_id != Wavefile::DATA_)
+    {
+        uint32 chunk_size = static_cast<uint32>(readInt(input_, 4));
+
+        long pos = ftell(input_);
+
+        if(chunk_id == Wavefile::FMT_)
+        {
+            format_tag_     = static_cast<uint16>(readInt(input_, 2));
+            channels        = static_cast<uint32>(readInt(input_, 2));
+            sample_rate     = static_cast<uint32>(readInt(input_, 4));
+            readInt(input_, 4);
+            readInt(input_, 2);
+            bits_per_sample = static_cast<uint32>(readInt(input_, 2));
+        }
+
+        fseek(input_, pos + static_cast<long>(chunk_size), SEEK_SET);
+
+        chunk_id = static_cast<uint32>(readInt(input_, 4));
+
+        if(ftell(input_) >= end_pos)
+        {
+            close();
+            M_THROW("WavefileReader::open(): '" << filename
+                << "', reached end of file before finding the "
+                << "'data' chunk");
+        }
+    }
+
+    uint64 data_length = static_cast<uint32>(readInt(input_, 4));
+
+    // Only read what is really there if the file is truncated.
+    uint64 available = static_cast<uint64>(end_pos - ftell(input_));
+
+    if(data_length > available) data_length = available;
+
+    if(channels == 0 || bits_per_sample == 0)
+    {
+        close();
+        M_THROW("WavefileReader::open(): '" << filename
+            << "', channels or bits_per_sample is zero!");
+    }
+
+    if(format_tag_ != Wavefile::WAVE_FORMAT_PCM_ &&
+       format_tag_ != Wavefile::WAVE_FORMAT_IEEE_FLOAT_)
+    {
+        close();
+        M_THROW("WavefileReader::open(): '" << filename
+            << "', Nsound currently only supports PCM and IEEE Floating "
+            << "Point formats, not '"
+            << Wavefile::decodeFormatTag(format_tag_)
+            << "'");
+    }
+
+    switch(bits_per_sample)
+    {
+        case 64: data_scale_ = Wavefile::SIGNED_64_BIT_; break;
+        case 48: data_scale_ = Wavefile::SIGNED_48_BIT_; break;
+        case 32: data_scale_ = Wavefile::SIGNED_32_BIT_; break;
+        case 24: data_scale_ = Wavefile::SIGNED_24_BIT_; break;
+        case 16: data_scale_ = Wavefile::SIGNED_16_BIT_; break;
+        case 8:  data_scale_ = Wavefile::SIGNED_8_BIT_;  break;
+
+        default:
+            close();
+            M_THROW("WavefileReader::open(): bits_per_sample = "
+                << bits_per_sample);
+    }
+
+    if(format_tag_ == Wavefile::WAVE_FORMAT_IEEE_FLOAT_
+        && bits_per_sample != 32
+        && bits_per_sample != 64)
+    {
+        close();
+        M_THROW("WavefileReader::open(): format is "
+            << "IEEE Float but bits_per_sample = "
+            << bits_per_sample);
+    }
+
+    n_channels_ = channels;
+    bits_per_sample_ = bits_per_sample;
+    n_bytes_ = bits_per_sample / 8;
+    sample_rate_ = static_cast<float64>(sample_rate);
+    n_samples_ = data_length / (n_channels_ * n_bytes_);
+    position_ = 0;
+
+    channels_.resize(n_channels_);
+}
+
+uint32
+WavefileReader::
+read(AudioStream & block, const uint32 n_samples)
+{
+    M_ASSERT_MSG(input_ != NULL, "WavefileReader: the file is not open");
+
+    uint64 n_left = n_samples_ - position_;
+
+    uint32 n = n_left < n_samples ? static_cast<uint32>(n_left) : n_samples;
+
+    block.setSampleRate(sample_rate_);
+    block.setNChannels(n_channels_);
+
+    for(uint32 c = 0; c < n_channels_; ++c)
+    {
+        if(block[c].getLength() != n)
+        {
+            block[c] = Buffer(FloatVector(n, 0.0));
+        }
+
+        channels_[c] = n > 0 ? block[c].getPointer() : NULL;
+    }
+
+    if(n == 0) return 0;
+
+    return read(channels_.data(), n);
+}
+
+uint32
+WavefileReader::
+read(float64 * const * channels, const uint32 n_samples)
+{
+    M_ASSERT_MSG(input_ != NULL, "WavefileReader: the file is not open");
+
+    uint64 n_left = n_samples_ - position_;
+
+    uint32 n = n_left < n_samples ? static_cast<uint32>(n_left) : n_samples;
+
+    M_PROFILE_SAMPLES("WavefileReader::read", n * n_channels_);
+
+    bytes_.resize(static_cast<std::size_t>(n) * n_channels_ * n_bytes_);
+
+    std::size_t n_read = fread(bytes_.data(), 1, bytes_.size(), input_);
+
+    // A short read decodes as silence.
+    if(n_read < bytes_.size())
+    {
+        std::fill(bytes_.begin() + n_read, bytes_.end(), 0);
+    }
+
+    const unsigned char * in =
+        reinterpret_cast<const unsigned char *>(bytes_.data());
+
+    const uint32 shift = 64 - 8 * n_bytes_;
+
+    // Little endian bytes, interleaved.
+    for(uint32 i = 0; i < n; ++i)
+    {
+        for(uint32 ch = 0; ch < n_channels_; ++ch)
+        {
+            uint64 bits = 0;
+
+            for(uint32 k = 0; k < n_bytes_; ++k)
+            {
+                bits |= static_cast<uint64>(in[k]) << (8 * k);
+            }
+
+            in += n_bytes_;
+
+            float64 x = 0.0;
+
+            if(format_tag_ == Wavefile::WAVE_FORMAT_PCM_)
+            {
+                int64 sample = 0;
+
+                // 8 bit wavefiles are stored unsigned.
+                if(n_bytes_ == 1)
+                {
+                    sample = static_cast<int64>(bits) - 127;
+                }
+                else
+                {
+                    // Sign extend.
+                    sample = static_cast<int64>(bits << shift) >> shift;
+                }
+
+                x = static_cast<float64>(sample) / data_scale_;
+            }
+            else if(n_bytes_ == 4)
+            {
+                uint32 b = static_cast<uint32>(bits);
+                float32 f = 0.0f;
+                memcpy(&f, &b, 4);
+                x = static_cast<float64>(f);
+            }
+            else
+            {
+                memcpy(&x, &bits, 8);
+            }
+
+            channels[ch][i] = x;
+        }
+    }
+
+    position_ += n;
+
+    return n;
+}
+
+void
+WavefileReader::
+close()
+{
+    if(input_ == NULL) return;
+
+    fclose(input_);
+
+    input_ = NULL;
+}
+
 //-----------------------------------------------------------------------------
 typedef struct RawTag
 {
@@ -0,0 +1,363 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Benchmark.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <sstream>
+
+//-----------------------------------------------------------------------------
+// Allocation tracking, every allocation in the process is counted.  When the
+// library is built with profiling it already replaces operator new.
+
+#ifdef NSOUND_PROFILE
+
+#include <Nsound/Profiler.h>
+
+namespace benchmark
+{
+uint64 get_alloc_count() { return Nsound::Profiler::getNAllocations(); }
+uint64 get_alloc_bytes() { return Nsound::Profiler::getNBytesAllocated(); }
+}
+
+#else
+
+// GCC flags free() in the replacement operator delete as mismatched.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<unsigned long long> g_alloc_count(0);
+static std::atomic<unsigned long long> g_alloc_bytes(0);
+
+void *
+operator new(std::size_t size)
+{
+    ++g_alloc_count;
+    g_alloc_bytes += size;
+
+    void * ptr = std::malloc(size == 0 ? 1 : size);
+
+    if(ptr == nullptr) throw std::bad_alloc();
+
+    return ptr;
+}
+
+void *
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void * ptr) noexcept { std::free(ptr); }
+void operator delete[](void * ptr) noexcept { std::free(ptr); }
+void operator delete(void * ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void * ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace benchmark
+{
+uint64 get_alloc_count() { return g_alloc_count.load(); }
+uint64 get_alloc_bytes() { return g_alloc_bytes.load(); }
+}
+
+#endif
+
+namespace benchmark
+{
+
+
+void
+Suite::
+add(const std::string & name,
+    const std::vector<uint32> & sizes,
+    const Setup & setup)
+{
+    Entry e;
+
+    e.name = name;
+    e.sizes = sizes;
+    e.setup = setup;
+
+    entries_.push_back(e);
+}
+
+
+void
+Suite::
+list(std::ostream & out) const
+{
+    for(const auto & e : entries_)
+    {
+        out << e.name << ":";
+
+        for(auto n : e.sizes) out << " " << n;
+
+        out << "\n";
+    }
+}
+
+
+ResultVector
+Suite::
+run(const std::string & filter, float64 min_seconds) const
+{
+    typedef std::chrono::steady_clock Clock;
+
+    ResultVector results;
+
+    for(const auto & e : entries_)
+    {
+        if(!filter.empty() && e.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        for(auto n : e.sizes)
+        {
+            Body body = e.setup(n);
+
+            // Warm up caches and any lazily built tables.
+            body();
+
+            uint64 n_iter = 0;
+            float64 elapsed = 0.0;
+
+            // Fastest batch, per iteration, least affected by other load.
+            float64 best = 1e300;
+
+            uint64 count0 = get_alloc_count();
+            uint64 bytes0 = get_alloc_bytes();
+
+            // Run batches that double in size until min_seconds is reached.
+            uint64 batch = 1;
+
+            while(elapsed < min_seconds || n_iter < 3)
+            {
+                Clock::time_point t0 = Clock::now();
+
+                for(uint64 i = 0; i < batch; ++i) body();
+
+                Clock::time_point t1 = Clock::now();
+
+                float64 dt = std::chrono::duration<float64>(t1 - t0).count();
+
+                best = std::min(best, dt / batch);
+
+                elapsed += dt;
+                n_iter += batch;
+
+                if(elapsed < min_seconds / 4.0) batch *= 2;
+            }
+
+            Result r;
+
+            r.name = e.name;
+            r.n_samples = n;
+            r.n_iterations = static_cast<uint32>(n_iter);
+
+            r.ns_per_sample = 1e9 * best / n;
+            r.samples_per_sec = n / best;
+
+            r.allocs_per_iteration =
+                static_cast<float64>(get_alloc_count() - count0) / n_iter;
+
+            r.bytes_per_iteration =
+                static_cast<float64>(get_alloc_bytes() - bytes0) / n_iter;
+
+            results.push_back(r);
+
+            std::cerr
+                << std::left << std::setw(32) << r.name
+                << std::right << std::setw(10) << r.n_samples
+                << std::setw(12) << std::fixed << std::setprecision(3)
+                << r.ns_per_sample << " ns/sample"
+                << std::setw(14) << std::setprecision(1)
+                << r.allocs_per_iteration << " allocs\n";
+        }
+    }
+
+    return results;
+}
+
+
+void
+write_tsv(std::ostream & out, const ResultVector & results)
+{
+    out << "# name\tn_samples\tn_iterations\tns_per_sample\t"
+        << "samples_per_sec\tallocs_per_iteration\tbytes_per_iteration\n";
+
+    out << std::setprecision(9);
+
+    for(const auto & r : results)
+    {
+        out << r.name << "\t"
+            << r.n_samples << "\t"
+            << r.n_iterations << "\t"
+            << r.ns_per_sample << "\t"
+            << r.samples_per_sec << "\t"
+            << r.allocs_per_iteration << "\t"
+            << r.bytes_per_iteration << "\n";
+    }
+}
+
+
+void
+write_json(std::ostream & out, const ResultVector & results)
+{
+    out << "[\n" << std::setprecision(9);
+
+    for(uint32 i = 0; i < results.size(); ++i)
+    {
+        const Result & r = results[i];
+
+        out << "    {"
+            << "\"name\": \"" << r.name << "\", "
+            << "\"n_samples\": " << r.n_samples << ", "
+            << "\"n_iterations\": " << r.n_iterations << ", "
+            << "\"ns_per_sample\": " << r.ns_per_sample << ", "
+            << "\"samples_per_sec\": " << r.samples_per_sec << ", "
+            << "\"allocs_per_iteration\": " << r.allocs_per_iteration << ", "
+            << "\"bytes_per_iteration\": " << r.bytes_per_iteration
+            << "}";
+
+        if(i + 1 < results.size()) out << ",";
+
+        out << "\n";
+    }
+
+    out << "]\n";
+}
+
+
+ResultVector
+read_tsv(std::istream & in)
+{
+    ResultVector results;
+
+    std::string line;
+
+    while(std::getline(in, line))
+    {
+        if(line.empty() || line[0] == '#') continue;
+
+        std::stringstream ss(line);
+
+        Result r;
+
+        std::getline(ss, r.name, '\t');
+
+        ss >> r.n_samples
+           >> r.n_iterations
+           >> r.ns_per_sample
+           >> r.samples_per_sec
+           >> r.allocs_per_iteration
+           >> r.bytes_per_iteration;
+
+        if(!ss.fail()) results.push_back(r);
+    }
+
+    return results;
+}
+
+
+uint32
+compare(
+    std::ostream & out,
+    const ResultVector & baseline,
+    const ResultVector & results,
+    float64 threshold)
+{
+    std::map<std::string, const Result *> lookup;
+
+    for(const auto & r : baseline)
+    {
+        std::stringstream key;
+        key << r.name << "/" << r.n_samples;
+        lookup[key.str()] = &r;
+    }
+
+    uint32 n_regressions = 0;
+
+    out << std::fixed;
+
+    for(const auto & r : results)
+    {
+        std::stringstream key;
+        key << r.name << "/" << r.n_samples;
+
+        out << std::left << std::setw(42) << key.str() << std::right;
+
+        auto itor = lookup.find(key.str());
+
+        if(itor == lookup.end())
+        {
+            out << "  (no baseline)\n";
+            continue;
+        }
+
+        const Result & b = *itor->second;
+
+        float64 change = r.ns_per_sample / b.ns_per_sample - 1.0;
+
+        out << std::setw(12) << std::setprecision(3) << b.ns_per_sample
+            << " -> "
+            << std::setw(12) << r.ns_per_sample
+            << " ns/sample "
+            << std::showpos << std::setw(8) << std::setprecision(1)
+            << 100.0 * change << "%" << std::noshowpos;
+
+        bool more_allocs =
+            r.allocs_per_iteration > b.allocs_per_iteration + 0.5;
+
+        if(change > threshold || more_allocs)
+        {
+            ++n_regressions;
+            out << "  REGRESSION";
+
+            if(more_allocs)
+            {
+                out << " (allocs " << b.allocs_per_iteration
+                    << " -> " << r.allocs_per_iteration << ")";
+            }
+        }
+
+        out << "\n";
+    }
+
+    return n_regressions;
+}
+
+} // namespace
+
+// :mode=c++: jEdit modeline
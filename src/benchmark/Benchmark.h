@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Benchmark.h $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _NSOUND_BENCHMARK_H_
+#define _NSOUND_BENCHMARK_H_
+
+#include <Nsound/Nsound.h>
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace benchmark
+{
+
+using Nsound::float64;
+using Nsound::uint32;
+using Nsound::uint64;
+
+//! One timed iteration of a benchmark.
+typedef std::function<void ()> Body;
+
+//! Builds the input data for a given size and returns the timed body.
+typedef std::function<Body (uint32 n_samples)> Setup;
+
+struct Result
+{
+    std::string name;
+    uint32      n_samples;
+    uint32      n_iterations;
+    float64     ns_per_sample;
+    float64     samples_per_sec;
+    float64     allocs_per_iteration;
+    float64     bytes_per_iteration;
+};
+
+typedef std::vector<Result> ResultVector;
+
+class Suite
+{
+    public:
+
+    Suite() : entries_() {}
+
+    //! Registers a benchmark that is run once for every size.
+    void
+    add(const std::string & name,
+        const std::vector<uint32> & sizes,
+        const Setup & setup);
+
+    //! Runs every benchmark whose name contains filter.
+    ResultVector
+    run(const std::string & filter, float64 min_seconds) const;
+
+    //! Prints the names and sizes of all benchmarks.
+    void
+    list(std::ostream & out) const;
+
+    private:
+
+    struct Entry
+    {
+        std::string         name;
+        std::vector<uint32> sizes;
+        Setup               setup;
+    };
+
+    std::vector<Entry> entries_;
+};
+
+//! Tab separated results, one line per result, also the baseline format.
+void write_tsv(std::ostream & out, const ResultVector & results);
+
+void write_json(std::ostream & out, const ResultVector & results);
+
+ResultVector read_tsv(std::istream & in);
+
+//! Prints a comparison table, returns the number of regressions.
+uint32
+compare(
+    std::ostream & out,
+    const ResultVector & baseline,
+    const ResultVector & results,
+    float64 threshold);
+
+// Allocation counters, maintained by the global operator new in Benchmark.cc.
+uint64 get_alloc_count();
+uint64 get_alloc_bytes();
+
+// Registration functions, one per source file.
+void add_buffer_benchmarks(Suite & suite);
+void add_fft_benchmarks(Suite & suite);
+void add_filter_benchmarks(Suite & suite);
+void add_io_benchmarks(Suite & suite);
+
+} // namespace
+
+#endif
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: bench_buffer.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <Nsound/Buffer.h>
+
+#include "Benchmark.h"
+
+#include <memory>
+
+using namespace Nsound;
+
+namespace benchmark
+{
+
+static const std::vector<uint32> SIZES = {4096, 262144};
+
+void
+add_buffer_benchmarks(Suite & suite)
+{
+    suite.add("Buffer::operator+=", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<Buffer> a(new Buffer(Buffer::rand(n)));
+            std::shared_ptr<Buffer> b(new Buffer(Buffer::rand(n)));
+
+            return [a, b](){ *a += *b; };
+        });
+
+    suite.add("Buffer::operator*=(float64)", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<Buffer> a(new Buffer(Buffer::rand(n)));
+
+            // Flipping the sign keeps the data away from denormals.
+            return [a](){ *a *= -1.0; };
+        });
+
+    suite.add("Buffer::operator*", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<Buffer> a(new Buffer(Buffer::rand(n)));
+            std::shared_ptr<Buffer> b(new Buffer(Buffer::rand(n)));
+
+            return [a, b](){ Buffer c = *a * *b; };
+        });
+
+    suite.add("Buffer::getConvolve(256)", {4096, 65536},
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<Buffer> x(new Buffer(Buffer::rand(n)));
+            std::shared_ptr<Buffer> h(new Buffer(Buffer::rand(256)));
+
+            return [x, h](){ Buffer y = x->getConvolve(*h); };
+        });
+
+    suite.add("Buffer::getResample(0.75)", {4096, 65536},
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<Buffer> x(new Buffer(Buffer::rand(n)));
+
+            return [x](){ Buffer y = x->getResample(0.75); };
+        });
+
+    suite.add("Buffer::getResample(3, 2)", {4096, 65536},
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<Buffer> x(new Buffer(Buffer::rand(n)));
+
+            return [x](){ Buffer y = x->getResample(3u, 2u); };
+        });
+}
+
+} // namespace
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: bench_fft.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <Nsound/Buffer.h>
+#include <Nsound/FFTChunk.h>
+#include <Nsound/FFTransform.h>
+
+#include "Benchmark.h"
+
+#include <memory>
+
+using namespace Nsound;
+
+namespace benchmark
+{
+
+static const std::vector<uint32> SIZES = {1024, 8192, 65536};
+
+void
+add_fft_benchmarks(Suite & suite)
+{
+    suite.add("FFTransform::fft", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<FFTransform> t(new FFTransform(44100.0));
+            std::shared_ptr<Buffer> x(new Buffer(Buffer::rand(n)));
+
+            return [t, x, n](){ FFTChunkVector v = t->fft(*x, n); };
+        });
+
+    suite.add("FFTransform::ifft", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<FFTransform> t(new FFTransform(44100.0));
+            Buffer x = Buffer::rand(n);
+            std::shared_ptr<FFTChunkVector> v(
+                new FFTChunkVector(t->fft(x, n)));
+
+            return [t, v](){ Buffer y = t->ifft(*v); };
+        });
+}
+
+} // namespace
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: bench_filters.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterIIR.h>
+#include <Nsound/FilterLowPassFIR.h>
+#include <Nsound/FilterLowPassIIR.h>
+#include <Nsound/FilterMedian.hpp>
+
+#include "Benchmark.h"
+
+#include <memory>
+
+using namespace Nsound;
+
+namespace benchmark
+{
+
+static const std::vector<uint32> SIZES = {4096, 262144};
+
+static const float64 SR = 44100.0;
+
+void
+add_filter_benchmarks(Suite & suite)
+{
+    suite.add("FilterIIR::filter(6 poles)", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<FilterIIR> f(new FilterIIR(SR, 6));
+            std::shared_ptr<Buffer> x(new Buffer(Buffer::rand(n)));
+
+            return [f, x](){ Buffer y = f->filter(*x); };
+        });
+
+    suite.add("FilterLowPassIIR::filter(6 poles)", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<FilterLowPassIIR> f(
+                new FilterLowPassIIR(SR, 6, 1000.0, 0.01));
+            std::shared_ptr<Buffer> x(new Buffer(Buffer::rand(n)));
+
+            return [f, x](){ Buffer y = f->filter(*x); };
+        });
+
+    suite.add("FilterLowPassFIR::filter(64 taps)", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<FilterLowPassFIR> f(
+                new FilterLowPassFIR(SR, 64, 1000.0));
+            std::shared_ptr<Buffer> x(new Buffer(Buffer::rand(n)));
+
+            return [f, x](){ Buffer y = f->filter(*x); };
+        });
+
+    suite.add("FilterMedian::filter(4097)", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<FilterMedian> f(new FilterMedian(4097));
+            std::shared_ptr<Buffer> x(new Buffer(Buffer::rand(n)));
+
+            return [f, x](){ Buffer y = f->filter(*x); };
+        });
+}
+
+} // namespace
+
+// :mode=c++: jEdit modeline
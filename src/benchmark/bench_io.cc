@@ -0,0 +1,123 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: bench_io.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/Mixer.h>
+#include <Nsound/StreamOperators.h>
+#include <Nsound/Wavefile.h>
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace Nsound;
+
+namespace benchmark
+{
+
+static const std::vector<uint32> SIZES = {44100, 441000};
+
+static const char * FILENAME = "ns_benchmark_tmp.wav";
+
+void
+add_io_benchmarks(Suite & suite)
+{
+    suite.add("Wavefile write 16 bit stereo", SIZES,
+        [](uint32 n) -> Body
+        {
+            std::shared_ptr<AudioStream> a(new AudioStream(44100.0, 2));
+
+            (*a)[0] = Buffer::rand(n) * 0.9;
+            (*a)[1] = Buffer::rand(n) * 0.9;
+
+            return [a]()
+            {
+                // The sample size is process wide, put it back afterwards.
+                uint32 previous = Wavefile::getDefaultSampleSize();
+
+                Wavefile::setDefaultSampleSize(16);
+                *a >> FILENAME;
+                Wavefile::setDefaultSampleSize(previous);
+            };
+        });
+
+    suite.add("Wavefile read 16 bit stereo", SIZES,
+        [](uint32 n) -> Body
+        {
+            AudioStream a(44100.0, 2);
+
+            a[0] = Buffer::rand(n) * 0.9;
+            a[1] = Buffer::rand(n) * 0.9;
+
+            uint32 previous = Wavefile::getDefaultSampleSize();
+
+            Wavefile::setDefaultSampleSize(16);
+            a >> FILENAME;
+            Wavefile::setDefaultSampleSize(previous);
+
+            return []()
+            {
+                AudioStream b(FILENAME);
+            };
+        });
+
+    suite.add("Mixer::getStream(16 streams)", SIZES,
+        [](uint32 n) -> Body
+        {
+            // Mixer only keeps pointers, the streams must outlive it.
+            std::shared_ptr< std::vector<AudioStream> > streams(
+                new std::vector<AudioStream>(16, AudioStream(44100.0, 2)));
+
+            std::shared_ptr<Mixer> m(new Mixer());
+
+            for(uint32 i = 0; i < 16; ++i)
+            {
+                AudioStream & a = (*streams)[i];
+
+                a[0] = Buffer::rand(n / 4);
+                a[1] = Buffer::rand(n / 4);
+
+                m->add(i * 0.75 * n / 44100.0 / 16.0, 0.0, a);
+            }
+
+            float64 end_time = n / 44100.0;
+
+            return [streams, m, end_time]()
+            {
+                AudioStream y = m->getStream(end_time);
+            };
+        });
+}
+
+} // namespace
+
+// :mode=c++: jEdit modeline
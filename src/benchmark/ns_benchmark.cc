@@ -0,0 +1,163 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: ns_benchmark.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+//
+// ns_benchmark, micro-benchmarks for the DSP hot paths.
+//
+// Usage:
+//
+//     ns_benchmark [options]
+//
+//     --filter NAME        only run benchmarks whose name contains NAME
+//     --min-time SECONDS   minimum time spent per benchmark (default 0.25)
+//     --output FILE        write the results as TSV to FILE
+//     --json               print the results as JSON to stdout
+//     --baseline FILE      compare against a previously saved TSV file
+//     --threshold PERCENT  allowed ns/sample increase (default 10)
+//     --list               list the benchmarks and exit
+//
+// The exit status is 1 if any regression against the baseline is found.
+//
+//-----------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+static void usage()
+{
+    cerr
+        << "usage: ns_benchmark [--filter NAME] [--min-time SECONDS] "
+        << "[--output FILE] [--json]\n"
+        << "                    [--baseline FILE] [--threshold PERCENT] "
+        << "[--list]\n";
+}
+
+int main(int argc, char ** argv)
+{
+    std::string filter;
+    std::string output;
+    std::string baseline;
+
+    double min_time = 0.25;
+    double threshold = 10.0;
+
+    bool as_json = false;
+    bool list_only = false;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        bool has_value = i + 1 < argc;
+
+        if(arg == "--filter" && has_value)         filter = argv[++i];
+        else if(arg == "--output" && has_value)    output = argv[++i];
+        else if(arg == "--baseline" && has_value)  baseline = argv[++i];
+        else if(arg == "--min-time" && has_value)  min_time = std::atof(argv[++i]);
+        else if(arg == "--threshold" && has_value) threshold = std::atof(argv[++i]);
+        else if(arg == "--json")                   as_json = true;
+        else if(arg == "--list")                   list_only = true;
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    benchmark::Suite suite;
+
+    benchmark::add_buffer_benchmarks(suite);
+    benchmark::add_fft_benchmarks(suite);
+    benchmark::add_filter_benchmarks(suite);
+    benchmark::add_io_benchmarks(suite);
+
+    if(list_only)
+    {
+        suite.list(cout);
+        return 0;
+    }
+
+    benchmark::ResultVector results = suite.run(filter, min_time);
+
+    std::remove("ns_benchmark_tmp.wav");
+
+    if(as_json) benchmark::write_json(cout, results);
+    else        benchmark::write_tsv(cout, results);
+
+    if(!output.empty())
+    {
+        std::ofstream fout(output.c_str());
+
+        if(!fout)
+        {
+            cerr << "ns_benchmark: could not open " << output << endl;
+            return 2;
+        }
+
+        benchmark::write_tsv(fout, results);
+    }
+
+    if(baseline.empty()) return 0;
+
+    std::ifstream fin(baseline.c_str());
+
+    if(!fin)
+    {
+        cerr << "ns_benchmark: could not open " << baseline << endl;
+        return 2;
+    }
+
+    benchmark::ResultVector base = benchmark::read_tsv(fin);
+
+    cerr << "\nComparing against " << baseline << ":\n";
+
+    Nsound::uint32 n = benchmark::compare(cerr, base, results, threshold / 100.0);
+
+    if(n > 0)
+    {
+        cerr << n << " regression(s) found" << endl;
+        return 1;
+    }
+
+    cerr << "No regressions" << endl;
+
+    return 0;
+}
+
+// :mode=c++: jEdit modeline
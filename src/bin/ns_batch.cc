@@ -0,0 +1,869 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: ns_batch.cc $
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/NsoundAll.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Nsound;
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+//-----------------------------------------------------------------------------
+void
+printUsage()
+{
+    cout << endl
+         << "usage: ns_batch OPTIONS manifest" << endl
+         << endl
+         << "Runs every wavefile listed in the manifest through the processing chain." << endl
+         << endl
+         << "Options are:" << endl
+         << endl
+         << "    -h|--help        Prints this message" << endl
+         << "    -v|--verbose     Verbose" << endl
+         << "    -c|--chain C     Comma separated processing steps, see below" << endl
+         << "    -j|--jobs N      The number of files processed at once, default one per core" << endl
+         << "    -b|--block N     The number of samples per channel read at a time, default 65536" << endl
+         << "    -o|--outdir D    Output directory for manifest lines without an output file" << endl
+         << "    -s|--bits N      Output bits per sample, default 16" << endl
+         << endl
+         << "Processing steps are:" << endl
+         << endl
+         << "    gain:G           Multiply by G" << endl
+         << "    lowpass:F[:P]    P pole low pass IIR filter at F Hz, default 6 poles" << endl
+         << "    highpass:F[:P]   P pole high pass IIR filter at F Hz, default 6 poles" << endl
+         << "    resample:R       Resample to R Hz" << endl
+         << "    stretch:S        Stretch time by the factor S" << endl
+         << "    normalize[:P]    Scale so the peak is P, default 1.0" << endl
+         << endl
+         << "The manifest lists one file per line, 'input.wav [output.wav]'.  Blank" << endl
+         << "lines and lines starting with '#' are skipped." << endl
+         << endl
+         << "Files are read, processed and written a block at a time so memory use" << endl
+         << "does not depend on the file size.  resample and stretch carry their" << endl
+         << "state across blocks, the output does not depend on the block size." << endl
+         << "Each normalize step costs one extra pass over the file to find the peak." << endl
+         << endl;
+}
+
+//-----------------------------------------------------------------------------
+// A parsed processing step, e.g. "lowpass:4000:4".
+struct StepSpec
+{
+    std::string          name;
+    std::vector<float64> args;
+};
+
+//-----------------------------------------------------------------------------
+// A processing step built for one file, processes a block in place.
+class Step
+{
+    public:
+
+    virtual ~Step() {}
+
+    virtual void process(AudioStream & block) = 0;
+
+    // Ends the stream, appends any output still held by the step to tail.
+    virtual void flush(AudioStream &) {}
+};
+
+//-----------------------------------------------------------------------------
+class GainStep : public Step
+{
+    public:
+
+    GainStep(const float64 & gain) : gain_(gain) {}
+
+    void process(AudioStream & block) { block *= gain_; }
+
+    private:
+
+    float64 gain_;
+};
+
+//-----------------------------------------------------------------------------
+// One filter per channel, in real-time mode so the state carries across
+// blocks.
+class FilterStep : public Step
+{
+    public:
+
+    FilterStep(
+        const std::string & name,
+        const float64 & sample_rate,
+        const uint32 n_channels,
+        const float64 & frequency,
+        const uint32 n_poles)
+        :
+        filters_()
+    {
+        for(uint32 c = 0; c < n_channels; ++c)
+        {
+            Filter * f = NULL;
+
+            if(name == "lowpass")
+            {
+                f = new FilterLowPassIIR(
+                    sample_rate, n_poles, frequency, 0.01);
+            }
+            else
+            {
+                f = new FilterHighPassIIR(
+                    sample_rate, n_poles, frequency, 0.01);
+            }
+
+            f->setRealtime(true);
+
+            filters_.push_back(std::shared_ptr<Filter>(f));
+        }
+    }
+
+    void
+    process(AudioStream & block)
+    {
+        for(uint32 c = 0; c < block.getNChannels(); ++c)
+        {
+            block[c] = filters_[c]->filter(block[c]);
+        }
+    }
+
+    private:
+
+    std::vector< std::shared_ptr<Filter> > filters_;
+};
+
+//-----------------------------------------------------------------------------
+// The filter history and the position of the next output sample carry
+// across blocks, the output matches resampling the whole file at once.
+class ResampleStep : public Step
+{
+    public:
+
+    ResampleStep(const float64 & sample_rate, const float64 & new_rate)
+        :
+        resampler_(new_rate / sample_rate),
+        new_rate_(new_rate)
+    {}
+
+    // The Resampler's L / M only approximates the rate.
+    void
+    process(AudioStream & block)
+    {
+        block = resampler_.resampleBlock(block);
+        block.setSampleRate(new_rate_);
+    }
+
+    void flush(AudioStream & tail) { tail << resampler_.flush(); }
+
+    private:
+
+    Resampler resampler_;
+    float64   new_rate_;
+};
+
+static const float64 STRETCH_WINDOW_SECONDS = 0.08;
+
+//-----------------------------------------------------------------------------
+// A phase vocoder stream, all channels share the phase rotation so they stay
+// aligned.  The stream's delay is dropped and the end trimmed so the output
+// matches Stretcher::timeShift() of the whole file.
+class StretchStep : public Step
+{
+    public:
+
+    StretchStep(const float64 & sample_rate, const float64 & factor)
+        :
+        stretcher_(sample_rate, STRETCH_WINDOW_SECONDS),
+        factor_(factor),
+        n_input_(0),
+        n_output_(0),
+        n_skip_(0),
+        started_(false)
+    {
+        stretcher_.setMethod(Stretcher::PHASE_VOCODER);
+    }
+
+    void
+    process(AudioStream & block)
+    {
+        n_input_ += block.getLength();
+
+        block = stretcher_.timeShiftBlock(block, factor_);
+
+        if(!started_)
+        {
+            started_ = true;
+
+            int32 delay = stretcher_.getDelay();
+
+            if(delay > 0)
+            {
+                n_skip_ = delay;
+            }
+            else if(delay < 0)
+            {
+                AudioStream lead(block.getSampleRate(), block.getNChannels(), 0);
+
+                lead << Buffer(FloatVector(-delay, 0.0));
+
+                block = lead << block;
+            }
+        }
+
+        _skip(block);
+    }
+
+    void
+    flush(AudioStream & tail)
+    {
+        if(!started_) return;
+
+        AudioStream rest = stretcher_.flush();
+
+        _skip(rest);
+
+        uint64 n_target = static_cast<uint64>(
+            std::floor(n_input_ * factor_ + 0.5));
+
+        uint64 n_rest = n_target > n_output_ ? n_target - n_output_ : 0;
+
+        uint32 n = static_cast<uint32>(n_rest);
+
+        for(uint32 c = 0; c < rest.getNChannels(); ++c)
+        {
+            Buffer & b = rest[c];
+
+            if(b.getLength() > n)
+            {
+                b = b.subbuffer(0, n);
+            }
+            else if(b.getLength() < n)
+            {
+                b << Buffer(FloatVector(n - b.getLength(), 0.0));
+            }
+        }
+
+        n_output_ += n;
+
+        tail << rest;
+    }
+
+    private:
+
+    // Drops the first n_skip_ samples of the stream.
+    void
+    _skip(AudioStream & block)
+    {
+        uint32 n = block.getLength();
+
+        uint32 n_drop = static_cast<uint32>(std::min<uint64>(n_skip_, n));
+
+        if(n_drop > 0)
+        {
+            for(uint32 c = 0; c < block.getNChannels(); ++c)
+            {
+                block[c] = block[c].subbuffer(n_drop, n - n_drop);
+            }
+
+            n_skip_ -= n_drop;
+        }
+
+        n_output_ += n - n_drop;
+    }
+
+    Stretcher stretcher_;
+    float64   factor_;
+    uint64    n_input_;
+    uint64    n_output_;
+    uint64    n_skip_;
+    bool      started_;
+};
+
+//-----------------------------------------------------------------------------
+// Records the peak of everything it sees, used to measure the input of a
+// normalize step.
+class PeakStep : public Step
+{
+    public:
+
+    PeakStep() : peak_(0.0) {}
+
+    void
+    process(AudioStream & block)
+    {
+        for(uint32 c = 0; c < block.getNChannels(); ++c)
+        {
+            const Buffer & b = block[c];
+
+            for(uint32 i = 0; i < b.getLength(); ++i)
+            {
+                float64 x = std::fabs(b[i]);
+                if(x > peak_) peak_ = x;
+            }
+        }
+    }
+
+    float64 getPeak() const { return peak_; }
+
+    private:
+
+    float64 peak_;
+};
+
+typedef std::vector< std::shared_ptr<Step> > Chain;
+
+//-----------------------------------------------------------------------------
+// Parses "gain:0.5,lowpass:4000" into steps, returns false on errors.
+bool
+parseChain(const std::string & text, std::vector<StepSpec> & specs)
+{
+    std::stringstream steps(text);
+    std::string step;
+
+    while(std::getline(steps, step, ','))
+    {
+        if(step.empty()) continue;
+
+        std::stringstream fields(step);
+        std::string field;
+
+        StepSpec spec;
+
+        std::getline(fields, spec.name, ':');
+
+        while(std::getline(fields, field, ':'))
+        {
+            std::stringstream ss(field);
+            float64 value = 0.0;
+
+            if(!(ss >> value))
+            {
+                cerr << "ns_batch: bad value '" << field
+                     << "' in step '" << step << "'" << endl;
+                return false;
+            }
+
+            spec.args.push_back(value);
+        }
+
+        uint32 n_args = static_cast<uint32>(spec.args.size());
+
+        bool ok = false;
+
+        if(spec.name == "gain" || spec.name == "resample" ||
+           spec.name == "stretch")
+        {
+            ok = n_args == 1 && spec.args[0] > 0.0;
+        }
+        else if(spec.name == "lowpass" || spec.name == "highpass")
+        {
+            ok = (n_args == 1 || n_args == 2) && spec.args[0] > 0.0;
+        }
+        else if(spec.name == "normalize")
+        {
+            ok = n_args == 0 || (n_args == 1 && spec.args[0] > 0.0);
+        }
+
+        if(!ok)
+        {
+            cerr << "ns_batch: bad processing step '" << step << "'" << endl;
+            return false;
+        }
+
+        specs.push_back(spec);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Builds the chain for a file.  gains holds the measured gain of the first
+// normalize steps, the chain stops with a PeakStep at the first normalize
+// step without one.
+Chain
+buildChain(
+    const std::vector<StepSpec> & specs,
+    float64 sample_rate,
+    const uint32 n_channels,
+    const std::vector<float64> & gains,
+    std::shared_ptr<PeakStep> & peak)
+{
+    Chain chain;
+
+    uint32 n_normalize = 0;
+
+    for(const auto & spec : specs)
+    {
+        const std::string & name = spec.name;
+
+        if(name == "gain")
+        {
+            chain.push_back(std::make_shared<GainStep>(spec.args[0]));
+        }
+        else if(name == "lowpass" || name == "highpass")
+        {
+            uint32 n_poles = 6;
+
+            if(spec.args.size() > 1)
+            {
+                n_poles = static_cast<uint32>(spec.args[1]);
+            }
+
+            chain.push_back(std::make_shared<FilterStep>(
+                name, sample_rate, n_channels, spec.args[0], n_poles));
+        }
+        else if(name == "resample")
+        {
+            chain.push_back(
+                std::make_shared<ResampleStep>(sample_rate, spec.args[0]));
+
+            sample_rate = spec.args[0];
+        }
+        else if(name == "stretch")
+        {
+            chain.push_back(
+                std::make_shared<StretchStep>(sample_rate, spec.args[0]));
+        }
+        else if(name == "normalize")
+        {
+            if(n_normalize == gains.size())
+            {
+                peak = std::make_shared<PeakStep>();
+                chain.push_back(peak);
+                return chain;
+            }
+
+            chain.push_back(std::make_shared<GainStep>(gains[n_normalize]));
+
+            ++n_normalize;
+        }
+    }
+
+    peak.reset();
+
+    return chain;
+}
+
+//-----------------------------------------------------------------------------
+struct Job
+{
+    std::string input;
+    std::string output;
+};
+
+//-----------------------------------------------------------------------------
+struct Options
+{
+    std::vector<StepSpec> specs;
+    uint32                block_size;
+    uint32                bits;
+    bool                  verbose;
+};
+
+//-----------------------------------------------------------------------------
+// Writes a block of output, opens the output file on the first block since
+// the output sample rate is only known then.
+void
+writeBlock(
+    const Job & job,
+    const Options & options,
+    const AudioStream & block,
+    std::unique_ptr<WavefileWriter> & out)
+{
+    if(!out)
+    {
+        out.reset(new WavefileWriter(
+            job.output,
+            block.getSampleRate(),
+            block.getNChannels(),
+            options.bits));
+    }
+
+    if(block.getLength() > 0) out->write(block);
+}
+
+//-----------------------------------------------------------------------------
+// Runs the file through the chain, the result is only written if write is
+// true.  Returns the number of samples per channel read.
+uint64
+runPass(
+    const Job & job,
+    const Options & options,
+    const std::vector<float64> & gains,
+    std::shared_ptr<PeakStep> & peak,
+    const bool write)
+{
+    WavefileReader in(job.input);
+
+    Chain chain = buildChain(
+        options.specs,
+        in.getSampleRate(),
+        in.getNChannels(),
+        gains,
+        peak);
+
+    std::unique_ptr<WavefileWriter> out;
+
+    AudioStream block;
+
+    while(in.getPosition() < in.getLength())
+    {
+        uint64 n_left = in.getLength() - in.getPosition();
+
+        uint32 n = options.block_size;
+
+        if(n_left < n) n = static_cast<uint32>(n_left);
+
+        in.read(block, n);
+
+        for(auto & step : chain) step->process(block);
+
+        if(write) writeBlock(job, options, block, out);
+    }
+
+    // The end of the stream, the output still held by each step runs
+    // through the steps after it.
+    AudioStream tail(in.getSampleRate(), in.getNChannels(), 0);
+
+    for(auto & step : chain)
+    {
+        step->process(tail);
+        step->flush(tail);
+    }
+
+    if(write && in.getLength() > 0) writeBlock(job, options, tail, out);
+
+    if(write && !out)
+    {
+        M_THROW("'" << job.input << "' has no samples");
+    }
+
+    if(out) out->close();
+
+    return in.getLength();
+}
+
+//-----------------------------------------------------------------------------
+// Processes one file, returns the number of samples per channel read.
+uint64
+processFile(const Job & job, const Options & options, float64 & sample_rate)
+{
+    std::vector<float64> gains;
+
+    std::shared_ptr<PeakStep> peak;
+
+    // Measure the input of each normalize step.
+    while(true)
+    {
+        buildChain(options.specs, 1.0, 1, gains, peak);
+
+        if(!peak) break;
+
+        runPass(job, options, gains, peak, false);
+
+        uint32 i = static_cast<uint32>(gains.size());
+
+        float64 target = 1.0;
+
+        uint32 n = 0;
+
+        for(const auto & spec : options.specs)
+        {
+            if(spec.name != "normalize") continue;
+
+            if(n++ == i && !spec.args.empty()) target = spec.args[0];
+        }
+
+        gains.push_back(peak->getPeak() > 0.0 ? target / peak->getPeak() : 1.0);
+    }
+
+    WavefileReader header(job.input);
+
+    sample_rate = header.getSampleRate();
+
+    header.close();
+
+    return runPass(job, options, gains, peak, true);
+}
+
+//-----------------------------------------------------------------------------
+bool
+readManifest(
+    const std::string & filename,
+    const std::string & outdir,
+    std::vector<Job> & jobs)
+{
+    std::ifstream manifest(filename.c_str());
+
+    if(!manifest)
+    {
+        cerr << "ns_batch: can't read the manifest \"" << filename
+             << "\"" << endl;
+        return false;
+    }
+
+    std::string line;
+    uint32 line_number = 0;
+
+    while(std::getline(manifest, line))
+    {
+        ++line_number;
+
+        std::stringstream ss(line);
+
+        Job job;
+
+        if(!(ss >> job.input) || job.input[0] == '#') continue;
+
+        if(!(ss >> job.output))
+        {
+            if(outdir.empty())
+            {
+                cerr << "ns_batch: " << filename << ":" << line_number
+                     << ": no output file and no --outdir" << endl;
+                return false;
+            }
+
+            std::string::size_type slash = job.input.find_last_of("/\\");
+
+            if(slash == std::string::npos) slash = 0;
+            else                           ++slash;
+
+            job.output = outdir + "/" + job.input.substr(slash);
+        }
+
+        if(job.output == job.input)
+        {
+            cerr << "ns_batch: " << filename << ":" << line_number
+                 << ": the output would overwrite the input" << endl;
+            return false;
+        }
+
+        jobs.push_back(job);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+int
+main(int argc, char ** argv)
+{
+    if(argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<std::string> args;
+
+    for(int32 i = 1; i < argc; ++i)
+    {
+        args.push_back(argv[i]);
+    }
+
+    Options options;
+
+    options.block_size = 65536;
+    options.bits = 16;
+    options.verbose = false;
+
+    uint32 n_jobs = 0;
+
+    std::string chain;
+    std::string outdir;
+
+    std::vector<std::string> files;
+
+    for(auto itor = args.begin(); itor != args.end(); ++itor)
+    {
+        bool has_value = itor + 1 != args.end();
+
+        if(*itor == "-h" || *itor == "--help")
+        {
+            printUsage();
+            return 0;
+        }
+        else
+        if(*itor == "-v" || *itor == "--verbose")
+        {
+            options.verbose = true;
+        }
+        else
+        if((*itor == "-c" || *itor == "--chain") && has_value)
+        {
+            chain = *(++itor);
+        }
+        else
+        if((*itor == "-j" || *itor == "--jobs") && has_value)
+        {
+            std::stringstream ss(*(++itor));
+            ss >> n_jobs;
+        }
+        else
+        if((*itor == "-b" || *itor == "--block") && has_value)
+        {
+            std::stringstream ss(*(++itor));
+            ss >> options.block_size;
+        }
+        else
+        if((*itor == "-o" || *itor == "--outdir") && has_value)
+        {
+            outdir = *(++itor);
+        }
+        else
+        if((*itor == "-s" || *itor == "--bits") && has_value)
+        {
+            std::stringstream ss(*(++itor));
+            ss >> options.bits;
+        }
+        else
+        {
+            files.push_back(*itor);
+        }
+    }
+
+    if(files.size() != 1)
+    {
+        cerr << "Wrong number of arguments!\n";
+        return 1;
+    }
+
+    if(options.block_size == 0)
+    {
+        cerr << "ns_batch: the block size must be > 0" << endl;
+        return 1;
+    }
+
+    if(!parseChain(chain, options.specs)) return 1;
+
+    std::vector<Job> jobs;
+
+    if(!readManifest(files[0], outdir, jobs)) return 1;
+
+    if(n_jobs == 0) n_jobs = std::thread::hardware_concurrency();
+    if(n_jobs == 0) n_jobs = 1;
+    if(n_jobs > jobs.size()) n_jobs = static_cast<uint32>(jobs.size());
+
+    if(options.verbose)
+    {
+        cout << "manifest    = " << files[0] << endl
+             << "files       = " << jobs.size() << endl
+             << "chain       = " << chain << endl
+             << "jobs        = " << n_jobs << endl
+             << "block size  = " << options.block_size << endl
+             << "bits        = " << options.bits << endl;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point start = Clock::now();
+
+    std::atomic<uint32> next(0);
+    std::mutex          mutex;
+
+    uint32  n_done = 0;
+    uint32  n_failed = 0;
+    float64 total_seconds = 0.0;
+
+    // A bounded pool of workers, each takes the next file in the manifest.
+    auto worker = [&]()
+    {
+        while(true)
+        {
+            uint32 i = next++;
+
+            if(i >= jobs.size()) return;
+
+            const Job & job = jobs[i];
+
+            Clock::time_point t0 = Clock::now();
+
+            std::string error;
+            uint64 n_samples = 0;
+            float64 sample_rate = 1.0;
+
+            try
+            {
+                n_samples = processFile(job, options, sample_rate);
+            }
+            catch(const std::exception & e)
+            {
+                error = e.what();
+            }
+
+            float64 wall = std::chrono::duration<float64>(
+                Clock::now() - t0).count();
+
+            float64 seconds = n_samples / sample_rate;
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            ++n_done;
+
+            cout << "[" << n_done << "/" << jobs.size() << "] "
+                 << job.input << " -> " << job.output << ": ";
+
+            if(!error.empty())
+            {
+                ++n_failed;
+
+                cout << "FAILED" << endl;
+                cerr << "ns_batch: " << job.input << ": " << error << endl;
+
+                continue;
+            }
+
+            total_seconds += seconds;
+
+            cout << std::fixed << std::setprecision(2)
+                 << seconds << " s of audio in " << wall << " s, "
+                 << seconds / wall << "x real time, "
+                 << n_samples / wall / 1e6 << " M samples/s per channel"
+                 << endl;
+
+            cout.unsetf(std::ios::floatfield);
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for(uint32 i = 1; i < n_jobs; ++i) threads.push_back(std::thread(worker));
+
+    worker();
+
+    for(auto & t : threads) t.join();
+
+    float64 wall = std::chrono::duration<float64>(Clock::now() - start).count();
+
+    cout << std::fixed << std::setprecision(2)
+         << jobs.size() - n_failed << " files, "
+         << total_seconds << " s of audio in " << wall << " s, "
+         << total_seconds / wall << "x real time";
+
+    if(n_failed > 0) cout << ", " << n_failed << " FAILED";
+
+    cout << endl;
+
+    return n_failed > 0 ? 1 : 0;
+}
@@ -49,6 +49,7 @@ printUsage()
          << "    -n|--bands N     The number of frequency bands to use" << endl
          << "    -w|--window S    The window duration in seconds for calculating the envelope" << endl
          << "    -m|--fmax F      The maximum frequency in the filter bank" << endl
+         << "    -f|--fft N       Analyze the bands with N point FFTs instead" << endl
          << endl;
 }
 
@@ -72,6 +73,7 @@ main(int argc, char ** argv)
     float64 specific_window = 0;
     uint32  specific_n_bands = 0;
     float64 specific_fmax = 0;
+    uint32  fft_size = 0;
 
     boolean verbose = false;
 
@@ -109,6 +111,13 @@ main(int argc, char ** argv)
             ++itor;
         }
         else
+        if(*itor == "-f" || *itor == "--fft")
+        {
+            std::stringstream ss(*(itor + 1));
+            ss >> fft_size;
+            ++itor;
+        }
+        else
         if(*itor == "-v" || *itor == "--verbose")
         {
             verbose = true;
@@ -195,32 +204,32 @@ main(int argc, char ** argv)
              << "output wav  = " << output_file << endl
              << "n bands     = " << n_bands << endl
              << "window sec  = " << window << endl
-             << "fmax        = " << fmax << endl;
+             << "fmax        = " << fmax << endl
+             << "fft size    = " << fft_size << endl;
     }
 
     Vocoder vocoder(sr, window, n_bands, fmax);
 
+    vocoder.setFFTSize(fft_size);
+
     AudioStream output(sr, carrier.getNChannels());
 
+    uint32 n_samples = voice.getLength();
+
     for(uint32 i = 0; i < carrier.getNChannels(); ++i)
     {
-        Buffer::iterator v = voice[0].begin();
-        Buffer::iterator end = voice[0].end();
-
-		// Using a circulator iterator incase the carrier isn't the same length as the
-        // voice signal.
+        // Using a circulator iterator incase the carrier isn't the same
+        // length as the voice signal.
         Buffer::circular_iterator c = carrier[i].cbegin();
 
-        Buffer temp;
+        Buffer temp(n_samples);
 
-        while(v != end)
+        for(uint32 n = 0; n < n_samples; ++n, ++c)
         {
-            temp << vocoder.filter(*v, *c);
-            ++v;
-            ++c;
+            temp << *c;
         }
 
-        output[i] = temp;
+        output[i] = vocoder.filter(voice[0], temp);
 
         vocoder.reset();
     }
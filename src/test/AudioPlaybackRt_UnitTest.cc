@@ -0,0 +1,306 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: AudioPlaybackRt_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioPlaybackRt.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifdef NSOUND_CPP11
+    #include <atomic>
+    #include <thread>
+#endif
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "AudioPlaybackRt_UnitTest.cc";
+
+static const float64 GAMMA = 1e-6;
+
+// None of this needs portaudio, the timing statistics and their summary are
+// compiled into every build.
+
+void AudioPlaybackRt_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    AudioPlaybackRtDebug info = AudioPlaybackRtDebug();
+
+    #ifdef NSOUND_CPP11
+
+    cout << TEST_HEADER << "Testing AudioPlaybackRtTiming::snapshot() ...";
+
+    // A 1000 ns period, the histogram bins are 2000 / 32 = 62.5 ns wide.
+    AudioPlaybackRtTiming timing;
+
+    timing.reset(4, 1000);
+
+    // Callback i takes 100 * i ns, the last one overruns past the histogram.
+    for(uint32 i = 0; i < 6; ++i)
+    {
+        int64 duration = i < 5 ? 100 * i : 5000;
+
+        timing.recordCallback(duration, 1000, static_cast<int64>(i) - 2, i);
+    }
+
+    for(uint32 i = 1; i <= 3; ++i) timing.recordProducerWait(1000 * i);
+
+    timing.snapshot(info);
+
+    // Only the last 4 callbacks are kept, oldest first.
+    boolean history_ok =
+        info.n_history.size() == 4 &&
+        info.callback_us.size() == 4 &&
+        info.margin_us.size() == 4 &&
+        info.jitter_us.size() == 4 &&
+        info.producer_wait_us.size() == 3;
+
+    for(uint32 i = 0; history_ok && i < 4; ++i)
+    {
+        uint32 j = i + 2;
+
+        float64 duration = j < 5 ? 0.1 * j : 5.0;
+
+        if(info.n_history[i] != j ||
+           std::fabs(info.callback_us[i] - duration) > GAMMA ||
+           std::fabs(info.margin_us[i] - (1.0 - duration)) > GAMMA ||
+           std::fabs(info.jitter_us[i] - 1e-3 * (j - 2.0)) > GAMMA)
+        {
+            history_ok = false;
+        }
+    }
+
+    for(uint32 i = 0; history_ok && i < 3; ++i)
+    {
+        if(std::fabs(info.producer_wait_us[i] - (i + 1.0)) > GAMMA)
+        {
+            history_ok = false;
+        }
+    }
+
+    if(!history_ok)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The history did not hold the last entries, oldest first"
+             << endl;
+
+        exit(1);
+    }
+
+    // The statistics cover every callback, not just the history.
+    if(info.n_callbacks != 6 ||
+       std::fabs(info.callback_us_mean - 1.0) > GAMMA ||
+       std::fabs(info.callback_us_max - 5.0) > GAMMA ||
+       std::fabs(info.margin_us_min - -4.0) > GAMMA ||
+       std::fabs(info.jitter_us_max - 3e-3) > GAMMA ||
+       std::fabs(info.producer_wait_us_total - 6.0) > GAMMA ||
+       std::fabs(info.producer_wait_us_max - 3.0) > GAMMA)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Unexpected statistics:" << endl
+             << info.summary()
+             << endl;
+
+        exit(1);
+    }
+
+    // 0, 100, 200, 300 and 400 ns land in bins 0, 1, 3, 4 and 6.
+    uint32 expected[AudioPlaybackRtTiming::N_HISTOGRAM_BINS] = {0};
+
+    expected[0] = 1;
+    expected[1] = 1;
+    expected[3] = 1;
+    expected[4] = 1;
+    expected[6] = 1;
+    expected[AudioPlaybackRtTiming::N_HISTOGRAM_BINS - 1] = 1;
+
+    if(info.callback_histogram.size() != AudioPlaybackRtTiming::N_HISTOGRAM_BINS)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Expected " << AudioPlaybackRtTiming::N_HISTOGRAM_BINS
+             << " histogram bins, got " << info.callback_histogram.size()
+             << endl;
+
+        exit(1);
+    }
+
+    for(uint32 i = 0; i < AudioPlaybackRtTiming::N_HISTOGRAM_BINS; ++i)
+    {
+        if(info.callback_histogram[i] != expected[i])
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Histogram bin " << i << " counted "
+                 << info.callback_histogram[i] << ", expected " << expected[i]
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    timing.reset(4, 1000);
+    timing.snapshot(info);
+
+    if(info.n_callbacks != 0 ||
+       !info.n_history.empty() ||
+       !info.producer_wait_us.empty() ||
+       info.margin_us_min != 0.0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "reset() did not clear the statistics"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing AudioPlaybackRtTiming concurrent snapshot ...";
+
+    // The callback thread keeps wrapping the ring while snapshots are taken,
+    // every snapshot must be consecutive callbacks.
+    timing.reset(64, 1000);
+
+    std::atomic<bool> done(false);
+
+    std::thread writer(
+        [&]()
+        {
+            for(uint32 i = 0; i < 200000; ++i)
+            {
+                timing.recordCallback(500, 1000, 0, i);
+            }
+
+            done = true;
+        });
+
+    boolean consecutive = true;
+    uint32 n_snapshots = 0;
+
+    while(consecutive && (!done || n_snapshots == 0))
+    {
+        AudioPlaybackRtDebug s = AudioPlaybackRtDebug();
+
+        timing.snapshot(s);
+
+        ++n_snapshots;
+
+        if(s.n_history.size() > 64) consecutive = false;
+
+        for(uint32 i = 1; i < s.n_history.size(); ++i)
+        {
+            if(s.n_history[i] != s.n_history[i - 1] + 1) consecutive = false;
+        }
+    }
+
+    writer.join();
+
+    timing.snapshot(info);
+
+    if(!consecutive ||
+       info.n_callbacks != 200000 ||
+       info.n_history.size() != 64 ||
+       info.n_history.back() != 199999)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "A snapshot taken while recording was not consecutive"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    #endif
+
+    cout << TEST_HEADER << "Testing AudioPlaybackRtDebug::summary() ...";
+
+    AudioPlaybackRtDebug empty = AudioPlaybackRtDebug();
+
+    if(empty.summary() != "AudioPlaybackRt timing: instrumentation disabled\n")
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Unexpected summary: " << empty.summary()
+             << endl;
+
+        exit(1);
+    }
+
+    info.is_instrumented = true;
+
+    std::stringstream ss(info.summary());
+
+    std::string line;
+
+    std::getline(ss, line);
+
+    // Every "    label = value" line lines up on the '='.
+    std::string::size_type column = std::string::npos;
+
+    while(std::getline(ss, line))
+    {
+        if(line.compare(0, 5, "     ") == 0) continue;
+
+        std::string::size_type equals = line.find(" = ");
+
+        if(equals == std::string::npos) continue;
+
+        if(column == std::string::npos) column = equals;
+
+        if(equals != column)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Misaligned summary line '" << line << "'"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    if(column == std::string::npos)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The summary had no statistics"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
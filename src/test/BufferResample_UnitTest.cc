@@ -26,8 +26,10 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
 #include <Nsound/Plotter.h>
+#include <Nsound/Resampler.h>
 #include <Nsound/Sine.h>
 #include <Nsound/Wavefile.h>
 
@@ -134,6 +136,43 @@ void BufferResample_UnitTest()
 
     }
 
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Resampler::resampleBlock() ...";
+
+    static const uint32 STREAM_LM[4][2] = { {2,1}, {3,2}, {1,3}, {2,3} };
+
+    for(uint32 i = 0; i < 4; ++i)
+    {
+        uint32 L = STREAM_LM[i][0];
+        uint32 M = STREAM_LM[i][1];
+
+        gold = input.getResample(L, M);
+
+        // Blocks of 1 to 7 samples join without seams.
+        Resampler resampler(L, M);
+
+        data = Buffer();
+
+        for(uint32 j = 0, n = 1; j < input.getLength(); j += n, n = n % 7 + 1)
+        {
+            data << resampler.resampleBlock(input.subbuffer(j, n));
+        }
+
+        data << resampler.flush()[0];
+
+        if(gold.getLength() != data.getLength() ||
+           (data - gold).getAbs().getMax() > GAMMA)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "The stream did not match getResample("
+                 << L << ", " << M << ")!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
     cout << SUCCESS << endl;
 }
 
@@ -30,7 +30,9 @@
 #include "UnitTest.h"
 
 #include <stdlib.h>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 
 using namespace Nsound;
 
@@ -44,6 +46,106 @@ static const float64 GAMMA = 1.5e-12;
 
 void testBufferAdd();
 
+namespace buffer_unit_test
+{
+
+// The O(length * window_size) implementations.
+
+Uint32Vector
+findPeaks(const Buffer & x, uint32 window_size, float64 min_height)
+{
+    Uint32Vector peaks;
+
+    uint32 h_window_size = window_size / 2 + 1;
+
+    uint32 n_samples = x.getLength();
+
+    for(uint32 i = 1; i + 1 < n_samples; ++i)
+    {
+        boolean is_peak = true;
+
+        float64 sample = x[i];
+
+        if(window_size <= 2)
+        {
+            is_peak = sample > x[i - 1] && sample > x[i + 1];
+        }
+        else
+        {
+            for(uint32 j = 1; j < h_window_size; ++j)
+            {
+                if((j < i && x[i - j] > sample) ||
+                   (i + j < n_samples && x[i + j] > sample))
+                {
+                    is_peak = false;
+                    break;
+                }
+            }
+        }
+
+        if(is_peak && sample > min_height) peaks.push_back(i);
+    }
+
+    return peaks;
+}
+
+Buffer
+getSignalEnergy(const Buffer & x, uint32 N)
+{
+    Buffer y;
+
+    uint32 length = x.getLength();
+
+    for(uint32 i = 0; i < length; ++i)
+    {
+        float64 sum = 0.0;
+
+        for(uint32 j = 0; j < N; ++j)
+        {
+            if(i + j < length - 1) sum += ::fabs(x[i + j]);
+        }
+
+        y << sum / static_cast<float64>(N);
+    }
+
+    return y;
+}
+
+Buffer
+getMoving(const Buffer & x, SlidingWindow::Statistic stat, uint32 N)
+{
+    Buffer y;
+
+    for(uint32 i = 0; i < x.getLength(); ++i)
+    {
+        uint32 start = i + 1 >= N ? i + 1 - N : 0;
+
+        float64 sum = 0.0;
+        float64 min = x[start];
+        float64 max = x[start];
+
+        for(uint32 j = start; j <= i; ++j)
+        {
+            sum += stat == SlidingWindow::RMS ? x[j] * x[j] : x[j];
+            min = std::min(min, x[j]);
+            max = std::max(max, x[j]);
+        }
+
+        switch(stat)
+        {
+            case SlidingWindow::SUM:  y << sum; break;
+            case SlidingWindow::MEAN: y << sum / N; break;
+            case SlidingWindow::RMS:  y << ::sqrt(sum / N); break;
+            case SlidingWindow::MIN:  y << min; break;
+            case SlidingWindow::MAX:  y << max; break;
+        }
+    }
+
+    return y;
+}
+
+} // namespace
+
 //-----------------------------------------------------------------------------
 void Buffer_UnitTest()
 {
@@ -751,6 +853,379 @@ void Buffer_UnitTest()
         exit(1);
     }
 
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Buffer::getMoving*() ...";
+
+    RngTausworthe rng;
+
+    rng.setSeed(6447);
+
+    // Quantized so there are ties.
+    Buffer noise;
+
+    for(uint32 i = 0; i < 3000; ++i)
+    {
+        noise << ::round(rng.get(-1.0, 1.0) * 20.0) / 20.0;
+    }
+
+    {
+        const SlidingWindow::Statistic stats[5] =
+        {
+            SlidingWindow::SUM,
+            SlidingWindow::MEAN,
+            SlidingWindow::RMS,
+            SlidingWindow::MIN,
+            SlidingWindow::MAX
+        };
+
+        const uint32 sizes[4] = {1, 2, 17, 1000};
+
+        for(uint32 s = 0; s < 5; ++s)
+        {
+            for(uint32 n = 0; n < 4; ++n)
+            {
+                Buffer gold = buffer_unit_test::getMoving(
+                    noise, stats[s], sizes[n]);
+
+                // Odd block sizes carry the state across calls.
+                SlidingWindow window(stats[s], sizes[n]);
+
+                Buffer blocks;
+
+                for(uint32 i = 0; i < noise.getLength(); i += 77)
+                {
+                    blocks << window.filter(noise.subbuffer(i, 77));
+                }
+
+                Buffer data;
+
+                switch(stats[s])
+                {
+                    case SlidingWindow::SUM:
+                        data = noise.getMovingSum(sizes[n]); break;
+                    case SlidingWindow::MEAN:
+                        data = noise.getMovingMean(sizes[n]); break;
+                    case SlidingWindow::RMS:
+                        data = noise.getMovingRms(sizes[n]); break;
+                    case SlidingWindow::MIN:
+                        data = noise.getMovingMin(sizes[n]); break;
+                    case SlidingWindow::MAX:
+                        data = noise.getMovingMax(sizes[n]); break;
+                }
+
+                if(data.getLength() != gold.getLength() ||
+                   (data - gold).getAbs().getMax() > GAMMA ||
+                   blocks != data)
+                {
+                    cerr << TEST_ERROR_HEADER
+                         << "Statistic " << stats[s]
+                         << " with window size " << sizes[n]
+                         << " did not match gold!"
+                         << endl;
+
+                    exit(1);
+                }
+            }
+        }
+
+        for(uint32 n = 0; n < 4; ++n)
+        {
+            Buffer gold = buffer_unit_test::getSignalEnergy(noise, sizes[n]);
+
+            Buffer data = noise.getSignalEnergy(sizes[n]);
+
+            if(data.getLength() != gold.getLength() ||
+               (data - gold).getAbs().getMax() > GAMMA)
+            {
+                cerr << TEST_ERROR_HEADER
+                     << "getSignalEnergy(" << sizes[n]
+                     << ") did not match gold!"
+                     << endl;
+
+                exit(1);
+            }
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Buffer::findPeaks() ...";
+
+    {
+        const uint32 sizes[8] = {0, 2, 3, 4, 5, 10, 101, 5000};
+
+        for(uint32 n = 0; n < 8; ++n)
+        {
+            for(uint32 len = 0; len < 6; ++len)
+            {
+                Buffer x = noise.subbuffer(0, len == 5 ? 3000 : len);
+
+                if(len == 0) x = Buffer();
+
+                Uint32Vector gold = buffer_unit_test::findPeaks(
+                    x, sizes[n], -0.5);
+
+                Uint32Vector data = x.findPeaks(sizes[n], -0.5);
+
+                PeakFinder finder(sizes[n], -0.5);
+
+                Uint32Vector blocks;
+
+                for(uint32 i = 0; i < x.getLength(); i += 77)
+                {
+                    Uint32Vector v = finder.find(x.subbuffer(i, 77));
+                    blocks.insert(blocks.end(), v.begin(), v.end());
+                }
+
+                Uint32Vector v = finder.flush();
+                blocks.insert(blocks.end(), v.begin(), v.end());
+
+                if(data != gold || blocks != gold)
+                {
+                    cerr << TEST_ERROR_HEADER
+                         << "findPeaks(" << sizes[n] << ") of "
+                         << x.getLength() << " samples did not match gold!"
+                         << endl;
+
+                    exit(1);
+                }
+            }
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Buffer::write(), read() ...";
+
+    {
+        Buffer x = noise.subbuffer(0, 1001);
+
+        for(uint32 flags = 0; flags < 4; ++flags)
+        {
+            std::string bytes = x.write(flags);
+
+            std::stringstream ss;
+
+            x.write(ss, flags);
+
+            Buffer y;
+            Buffer z;
+
+            y.read(bytes.data(), bytes.size());
+            z.read(ss);
+
+            Buffer gold = x;
+
+            if(flags & Buffer::FLOAT32)
+            {
+                for(auto & g : gold) g = static_cast<float32>(g);
+            }
+
+            if(bytes.size() != x.getSerializedSize(flags) ||
+               ss.str() != bytes ||
+               y != gold ||
+               z != gold)
+            {
+                cerr << TEST_ERROR_HEADER
+                     << "Round trip with flags " << flags << " failed!"
+                     << endl;
+
+                exit(1);
+            }
+        }
+
+        // A corrupt sample is detected.
+        std::string bytes = x.write(Buffer::CHECKSUM);
+
+        bytes[100] ^= 1;
+
+        bool caught = false;
+
+        try
+        {
+            Buffer y;
+            y.read(bytes.data(), bytes.size());
+        }
+        catch(const Nsound::Exception &)
+        {
+            caught = true;
+        }
+
+        // The legacy format is still read.
+        std::string legacy("buff");
+
+        uint32 n = x.getLength();
+
+        legacy.append(reinterpret_cast<const char *>(&n), 4);
+        legacy.append(
+            reinterpret_cast<const char *>(x.getPointer()),
+            sizeof(float64) * n);
+
+        Buffer y;
+
+        y.read(legacy.data(), legacy.size());
+
+        if(!caught || y != x)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Checksum or legacy read failed!"
+                 << endl;
+
+            exit(1);
+        }
+
+        // A corrupt header throws before sizing anything: a huge length,
+        // a bad version and unknown flags.
+        for(uint32 i = 0; i < 3; ++i)
+        {
+            bytes = x.write();
+
+            if(i == 0) bytes[15] = 0x40;
+            if(i == 1) bytes[4] = 9;
+            if(i == 2) bytes[6] = 4;
+
+            std::stringstream ss(bytes);
+
+            caught = false;
+
+            try
+            {
+                Buffer z;
+                z.read(ss);
+            }
+            catch(const Nsound::Exception &)
+            {
+                caught = true;
+            }
+
+            if(!caught)
+            {
+                cerr << TEST_ERROR_HEADER
+                     << "Corrupt header " << i << " was not detected!"
+                     << endl;
+
+                exit(1);
+            }
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing AudioStream::write(), read() ...";
+
+    {
+        AudioStream as(44100.0, 3);
+
+        as[0] = noise.subbuffer(0, 100);
+        as[1] = noise.subbuffer(100, 100);
+        as[2] = noise.subbuffer(200, 100);
+
+        for(uint32 flags = 0; flags < 4; ++flags)
+        {
+            std::string bytes = as.write(flags);
+
+            std::stringstream ss(bytes);
+
+            AudioStream y(8000.0, 1);
+            AudioStream z(8000.0, 1);
+
+            y.read(bytes.data(), bytes.size());
+            z.read(ss);
+
+            AudioStream gold = as;
+
+            if(flags & Buffer::FLOAT32)
+            {
+                for(auto * ptr : gold)
+                {
+                    for(auto & g : *ptr) g = static_cast<float32>(g);
+                }
+            }
+
+            if(bytes.size() != as.getSerializedSize(flags) ||
+               y.getSampleRate() != 44100.0 ||
+               z.getSampleRate() != 44100.0 ||
+               y != gold ||
+               z != gold)
+            {
+                cerr << TEST_ERROR_HEADER
+                     << "Round trip with flags " << flags << " failed!"
+                     << endl;
+
+                exit(1);
+            }
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing BufferPyramid::getEnvelope() ...";
+
+    {
+        BufferPyramid pyramid(noise, 3);
+
+        const uint32 ranges[4][3] =
+        {
+            {   0, 3000, 10},
+            {  17, 2999, 25},
+            { 501,  733,  7},
+            {1000, 1020, 50}
+        };
+
+        for(uint32 r = 0; r < 4; ++r)
+        {
+            const uint32 start = ranges[r][0];
+            const uint32 stop  = ranges[r][1];
+
+            Buffer x;
+            Buffer lo;
+            Buffer hi;
+
+            pyramid.getEnvelope(start, stop, ranges[r][2], x, lo, hi);
+
+            bool ok = x.getLength() >= std::min(ranges[r][2], stop - start)
+                && x.getLength() == lo.getLength()
+                && x.getLength() == hi.getLength()
+                && x[0] == start;
+
+            for(uint32 i = 0; ok && i < x.getLength(); ++i)
+            {
+                uint32 a = static_cast<uint32>(x[i]);
+                uint32 b = i + 1 < x.getLength()
+                    ? static_cast<uint32>(x[i + 1]) : stop;
+
+                Buffer gold = noise.subbuffer(a, b - a);
+
+                ok = gold.getMin() == lo[i] && gold.getMax() == hi[i];
+            }
+
+            Buffer px;
+            Buffer py;
+
+            pyramid.getPlotData(start, stop, ranges[r][2], px, py);
+
+            if(stop - start <= ranges[r][2])
+            {
+                ok = ok && py == noise.subbuffer(start, stop - start);
+            }
+            else
+            {
+                ok = ok && py.getLength() == 2 * x.getLength();
+            }
+
+            if(!ok)
+            {
+                cerr << TEST_ERROR_HEADER
+                     << "Envelope of [" << start << ", " << stop
+                     << ") does not match the samples!"
+                     << endl;
+
+                exit(1);
+            }
+        }
+    }
+
     cout << SUCCESS << endl;
 }
 
@@ -51,6 +51,43 @@ static const char * THIS_FILE = "DelayLine_UnitTest.cc";
 
 static const float64 GAMMA = 1.5e-14;
 
+namespace delay_line_unit_test
+{
+
+const DelayLine::Interpolation INTERPOLATIONS[] =
+{
+    DelayLine::NEAREST,
+    DelayLine::LINEAR,
+    DelayLine::LAGRANGE,
+    DelayLine::ALLPASS,
+    DelayLine::SINC
+};
+
+const char * NAMES[] = {"NEAREST", "LINEAR", "LAGRANGE", "ALLPASS", "SINC"};
+
+// Worst case error delaying a sine by a fractional number of samples.
+const float64 SINE_ERROR[] = {0.0, 2e-2, 1e-3, 5e-3, 1e-3};
+
+// Delays the input one sample at a time.
+Buffer
+delaySamples(
+    const Buffer & x,
+    DelayLine::Interpolation type,
+    float64 delay)
+{
+    DelayLine dl(1000.0, 0.1);
+
+    dl.setInterpolation(type);
+
+    Buffer y;
+
+    for(float64 sample : x) y << dl.delay(sample, delay);
+
+    return y;
+}
+
+} // namespace
+
 void
 DelayLine_UnitTest()
 {
@@ -100,5 +137,90 @@ DelayLine_UnitTest()
         exit(1);
     }
 
-    cout << SUCCESS << endl;
+    cout << SUCCESS;
+
+    using namespace delay_line_unit_test;
+
+    Sine sine2(1000.0);
+
+    input = sine2.whiteNoise(1.0);
+
+    for(uint32 i = 0; i < 5; ++i)
+    {
+        cout << TEST_HEADER << "Testing DelayLine::delay() block, "
+             << NAMES[i] << " ...";
+
+        DelayLine dl2(1000.0, 0.1);
+
+        dl2.setInterpolation(INTERPOLATIONS[i]);
+
+        for(float64 delay : {0.0123456, 0.003, 0.0001, 0.0987654})
+        {
+            gold = delaySamples(input, INTERPOLATIONS[i], delay);
+
+            // The Buffer version resets and runs the block path.
+            data = dl2.delay(input, Buffer(1) << delay);
+
+            if(data != gold)
+            {
+                cerr << TEST_ERROR_HEADER
+                     << "Block output did not match per sample output, "
+                     << "delay = " << delay
+                     << endl;
+
+                exit(1);
+            }
+        }
+
+        // A whole number of samples is an exact shift.
+        if(INTERPOLATIONS[i] != DelayLine::ALLPASS)
+        {
+            data = delaySamples(input, INTERPOLATIONS[i], 0.011);
+
+            for(uint32 n = 10; n < input.getLength(); ++n)
+            {
+                if(data[n] != input[n - 10])
+                {
+                    cerr << TEST_ERROR_HEADER
+                         << "Integer delay is not exact at " << n
+                         << endl;
+
+                    exit(1);
+                }
+            }
+        }
+
+        // A fractional delay of a sine, 10.37 samples.
+        if(INTERPOLATIONS[i] != DelayLine::NEAREST)
+        {
+            Buffer x;
+
+            gold = Buffer();
+
+            for(uint32 n = 0; n < 1000; ++n)
+            {
+                x    << ::sin(2.0 * M_PI * 50.0 * n / 1000.0);
+                gold << ::sin(2.0 * M_PI * 50.0 * (n - 10.37) / 1000.0);
+            }
+
+            data = delaySamples(x, INTERPOLATIONS[i], 0.01137);
+
+            diff = (data - gold).subbuffer(100);
+            diff.abs();
+
+            if(diff.getMax() > SINE_ERROR[i])
+            {
+                cerr << TEST_ERROR_HEADER
+                     << "Fractional delay error too large: "
+                     << diff.getMax()
+                     << endl;
+
+                exit(1);
+            }
+        }
+
+        cout << SUCCESS;
+    }
+
+    cout << endl;
 }
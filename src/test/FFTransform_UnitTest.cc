@@ -350,5 +350,36 @@ FFTransform_UnitTest()
         exit(1);
     }
 
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing FFTransform::radix2() Plan ..." << flush;
+
+    for(int32 N = 1; N <= 512; N *= 2)
+    {
+        FFTransform::Plan plan(N);
+
+        Buffer real1 = input.subbuffer(0, N);
+        Buffer imag1 = real1.getReverse();
+
+        Buffer real2 = real1;
+        Buffer imag2 = imag1;
+
+        FFTransform::radix2(real1.getPointer(), imag1.getPointer(), N);
+        FFTransform::radix2(plan, real2.getPointer(), imag2.getPointer());
+
+        float64 error = (real1 - real2).getAbs().getMax()
+                      + (imag1 - imag2).getAbs().getMax();
+
+        if(error > GAMMA)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Output did not match radix2() for N = " << N
+                 << ", error = " << error
+                 << endl;
+
+            exit(1);
+        }
+    }
+
     cout << SUCCESS << endl;
 }
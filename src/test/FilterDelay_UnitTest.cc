@@ -28,7 +28,11 @@
 
 #include <Nsound/AudioStream.h>
 #include <Nsound/Buffer.h>
+#include <Nsound/FilterAllPass.h>
 #include <Nsound/FilterDelay.h>
+#include <Nsound/FilterFlanger.h>
+#include <Nsound/FilterPhaser.h>
+#include <Nsound/Generator.h>
 #include <Nsound/Plotter.h>
 #include <Nsound/Sine.h>
 #include <Nsound/Wavefile.h>
@@ -49,6 +53,87 @@ static const char * THIS_FILE = "FilterDelay_UnitTest.cc";
 
 static const float64 GAMMA = 1.5e-14;
 
+namespace filter_delay_unit_test
+{
+
+// The phaser as a bank of FilterAllPass stages, one sample at a time.
+Buffer
+phaser(
+    const Buffer & x,
+    const float64 & sr,
+    const uint32 n_stages,
+    const float64 & f,
+    const float64 & fstep,
+    const float64 & max_delay)
+{
+    Sine sin(sr);
+
+    Buffer waveform = (1.0 + sin.generate(1.0, 1.0)) / 2.0;
+
+    std::vector<FilterAllPass *> stages;
+    std::vector<float64> position(n_stages, 0.0);
+
+    for(uint32 i = 0; i < n_stages; ++i)
+    {
+        stages.push_back(new FilterAllPass(sr, max_delay, 0.5));
+    }
+
+    Buffer y;
+
+    for(float64 sample : x)
+    {
+        float64 sum = 0.0;
+
+        for(uint32 i = 0; i < n_stages; ++i)
+        {
+            position[i] += f + fstep * i;
+
+            if(position[i] >= sr) position[i] -= sr;
+
+            float64 d = waveform[static_cast<uint32>(position[i])];
+
+            sum += stages[i]->filter(sample, d * max_delay);
+        }
+
+        sum /= static_cast<float64>(n_stages);
+
+        y << (sum + sample) / 2.0;
+    }
+
+    for(auto ptr : stages) delete ptr;
+
+    return y;
+}
+
+// The flanger as a FilterDelay driven by a Generator.
+Buffer
+flanger(
+    const Buffer & x,
+    const float64 & sr,
+    const float64 & f,
+    const float64 & delay,
+    const float64 & max_delay)
+{
+    Sine sin(sr);
+
+    Generator lfo(sr, (1.0 + sin.generate(1.0, 1.0)) / 2.0);
+
+    FilterDelay fd(sr, max_delay);
+
+    Buffer y;
+
+    for(float64 sample : x)
+    {
+        float64 d = fd.filter(sample, lfo.generate(f) * delay);
+
+        y << (d + sample) / 2.0;
+    }
+
+    return y;
+}
+
+} // namespace
+
 void FilterDelay_UnitTest()
 {
     cout << endl << THIS_FILE;
@@ -150,7 +235,101 @@ void FilterDelay_UnitTest()
     }
 
 
-    cout << SUCCESS << endl;
-}
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing FilterDelay::filter(input) blocks ...";
+
+    {
+        Generator gen(1000.0);
+
+        Buffer x = gen.whiteNoise(0.5);
+
+        FilterDelay per_sample(1000.0, 0.1);
+        FilterDelay block(1000.0, 0.1);
 
+        block.setRealtime(true);
 
+        // Blocks shorter and longer than the delay line, the ring must carry
+        // over between them exactly like one sample at a time.
+        uint32 n = 0;
+
+        for(uint32 length : {7, 64, 101, 3, 250, 75})
+        {
+            float64 delay = 0.001 * (length % 97);
+
+            Buffer y = block.filter(x.subbuffer(n, length), delay);
+
+            for(uint32 i = 0; i < length; ++i)
+            {
+                if(y[i] != per_sample.filter(x[n + i], delay))
+                {
+                    cerr << TEST_ERROR_HEADER
+                         << "Block output did not match per sample output!"
+                         << endl;
+
+                    exit(1);
+                }
+            }
+
+            n += length;
+        }
+    }
+
+    cout << SUCCESS;
+
+    using namespace filter_delay_unit_test;
+
+    cout << TEST_HEADER << "Testing FilterPhaser::filter(input) ...";
+
+    Generator gen(1000.0);
+
+    gen.setSeed(6);
+
+    Buffer noise = gen.whiteNoise(3.0);
+
+    FilterPhaser phs(1000.0, 5, 0.7, 0.13, 0.05);
+
+    Buffer phs_gold = phaser(noise, 1000.0, 5, 0.7, 0.13, 0.05);
+
+    // The block engine must reproduce the per stage filters exactly.
+    Buffer phs_data = phs.filter(noise);
+
+    phs.reset();
+
+    Buffer phs_rt;
+
+    for(float64 sample : noise) phs_rt << phs.filter(sample);
+
+    if(phs_data != phs_gold || phs_rt != phs_gold)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output did not match the FilterAllPass stages!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing FilterFlanger::filter(input) ...";
+
+    // 3000 Hz wraps the LFO many times over.
+    FilterFlanger flg(1000.0, 3000.3, 0.02);
+
+    Buffer flg_data = flg.filter(noise);
+    Buffer flg_gold = flanger(noise, 1000.0, 3000.3, 0.02, 0.02);
+
+    Buffer flg_data2 = flg.filter(noise, 2.5, 0.01);
+    Buffer flg_gold2 = flanger(noise, 1000.0, 2.5, 0.01, 0.02);
+
+    if(flg_data != flg_gold || flg_data2 != flg_gold2)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output did not match FilterDelay and Generator!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
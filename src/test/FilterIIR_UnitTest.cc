@@ -0,0 +1,276 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: FilterIIR_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterBandPassIIR.h>
+#include <Nsound/FilterIIR.h>
+#include <Nsound/FilterLowPassFIR.h>
+#include <Nsound/FilterLowPassIIR.h>
+#include <Nsound/Generator.h>
+#include <Nsound/Kernel.h>
+#include <Nsound/ThreadPool.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "FilterIIR_UnitTest.cc";
+
+static const float64 GAMMA = 1.5e-12;
+
+namespace filter_iir_unit_test
+{
+
+// Exposes the protected scoring methods.
+struct FilterIIRTester : public FilterIIR
+{
+    FilterIIRTester(uint32 n_poles) : FilterIIR(8000.0, n_poles) {}
+
+    using FilterIIR::SignalType;
+    using FilterIIR::FREQUENCY_RESSPONSE;
+    using FilterIIR::IMPULSE_RESPONSE;
+    using FilterIIR::DesignScratch;
+    using FilterIIR::getRMS;
+};
+
+// Brute force DTFT magnitude of the impulse response.
+Buffer
+dtft(const Buffer & h, const Buffer & freqs, const float64 & sr)
+{
+    Buffer y;
+
+    for(uint32 i = 0; i < freqs.getLength(); ++i)
+    {
+        float64 w = 2.0 * M_PI * freqs[i] / sr;
+        float64 r = 0.0;
+        float64 im = 0.0;
+
+        for(uint32 n = 0; n < h.getLength(); ++n)
+        {
+            r  += h[n] * std::cos(w * n);
+            im -= h[n] * std::sin(w * n);
+        }
+
+        y << std::sqrt(r * r + im * im);
+    }
+
+    return y;
+}
+
+void
+checkResponse(Filter & f, const char * name)
+{
+    Buffer freqs = f.getFrequencyAxisLog(20.0, 3999.0, 64);
+
+    Buffer gold = dtft(f.getImpulseResponse(), freqs, f.getSampleRate());
+
+    Buffer data = f.getFrequencyResponse(freqs);
+
+    if(data.getLength() != 64 || (data - gold).getAbs().getMax() > 1e-9)
+    {
+        cerr << TEST_ERROR_HEADER
+             << name << " response did not match the DTFT!"
+             << endl;
+
+        exit(1);
+    }
+}
+
+Buffer
+reference()
+{
+    Generator g(256);
+
+    Buffer ref;
+
+    ref << g.drawLine(0.25, 0.0, 0.8)
+        << g.drawLine(0.25, 0.8, 0.8)
+        << g.drawLine(0.50, 0.8, 0.0);
+
+    while(ref.getLength() < 256) ref << 0.0;
+
+    return ref.subbuffer(0, 256);
+}
+
+} // namespace
+
+void FilterIIR_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace filter_iir_unit_test;
+
+    cout << TEST_HEADER << "Testing FilterIIR::getRMS() scratch version ...";
+
+    Buffer ref = reference();
+
+    FilterIIRTester f(6);
+
+    FilterIIRTester::DesignScratch scratch;
+
+    Kernel k(6, 6);
+
+    for(uint32 i = 0; i < 20; ++i)
+    {
+        k.randomize(-0.2, 0.2);
+
+        float64 fr_gold = f.getRMS(k, ref, FilterIIRTester::FREQUENCY_RESSPONSE);
+        float64 fr = f.getRMS(k, ref, FilterIIRTester::FREQUENCY_RESSPONSE, scratch);
+
+        float64 ir_gold = f.getRMS(k, ref, FilterIIRTester::IMPULSE_RESPONSE);
+        float64 ir = f.getRMS(k, ref, FilterIIRTester::IMPULSE_RESPONSE, scratch);
+
+        if(std::fabs(fr - fr_gold) > GAMMA || std::fabs(ir - ir_gold) > GAMMA)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "RMS mismatch: " << fr << " != " << fr_gold
+                 << " or " << ir << " != " << ir_gold
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing FilterIIR::designFrequencyResponse() seed ...";
+
+    FilterIIR f1(8000.0, 6);
+    FilterIIR f2(8000.0, 6);
+
+    f1.setSeed(1234);
+    f2.setSeed(1234);
+
+    // The candidates are scored on the ThreadPool, the result must not
+    // depend on the number of threads.
+    ThreadPool::getInstance().setNThreads(4);
+
+    Buffer h1 = f1.designFrequencyResponse(ref, 0.0, 50);
+
+    ThreadPool::getInstance().setNThreads(1);
+
+    Buffer h2 = f2.designFrequencyResponse(ref, 0.0, 50);
+
+    if(h1 != h2 || h1.getLength() != 51)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The same seed designed different kernels!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing FilterIIR::setDesignCallback() ...";
+
+    uint32 n_calls = 0;
+
+    f1.setDesignCallback(
+        [&n_calls](uint32 generation, float64)
+        {
+            ++n_calls;
+            return generation < 5;
+        });
+
+    h1 = f1.designImpulseResponse(ref, 0.0, 50);
+
+    if(n_calls != 5 || h1.getLength() != 6)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The design did not stop early!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Filter::getFrequencyResponse(frequencies) ...";
+
+    FilterLowPassIIR lpf(8000.0, 6, 1000.0, 0.01);
+    FilterLowPassFIR fir(8000.0, 64, 1500.0);
+    FilterBandPassIIR bpf(8000.0, 4, 500.0, 1500.0, 0.01);
+
+    checkResponse(f1, "FilterIIR");
+    checkResponse(lpf, "FilterLowPassIIR");
+    checkResponse(fir, "FilterLowPassFIR");
+    checkResponse(bpf, "FilterBandPassIIR");
+
+    Buffer freqs = lpf.getFrequencyAxisLog(20.0, 3999.0, 64);
+
+    Buffer phase = lpf.getPhaseResponse(freqs);
+
+    if(phase.getLength() != 64 || std::fabs(phase[0]) > 0.1)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Phase response is wrong!"
+             << endl;
+
+        exit(1);
+    }
+
+    // Evaluating the response must not disturb a running filter.
+    FilterLowPassIIR lpf2(8000.0, 6, 1000.0, 0.01);
+
+    lpf.setRealtime(true);
+    lpf2.setRealtime(true);
+
+    Buffer noise = Generator(8000.0).whiteNoise(0.1);
+
+    Buffer y1 = lpf.filter(noise.subbuffer(0, 400));
+    Buffer y2 = lpf2.filter(noise.subbuffer(0, 400));
+
+    lpf.getFrequencyResponse(freqs);
+
+    y1 << lpf.filter(noise.subbuffer(400));
+    y2 << lpf2.filter(noise.subbuffer(400));
+
+    if(y1 != y2)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Filter state was modified!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,282 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: FilterLowPassIIR_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterLowPassIIR.h>
+#include <Nsound/Generator.h>
+#include <Nsound/IIRKernelCache.h>
+#include <Nsound/Sine.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "FilterLowPassIIR_UnitTest.cc";
+
+static const float64 SR = 8000.0;
+
+namespace filter_low_pass_iir_unit_test
+{
+
+Buffer
+sweep(const Buffer & x)
+{
+    FilterLowPassIIR f(SR, 6, 1000.0, 0.01);
+
+    f.setRealtime(true);
+
+    Buffer y;
+
+    for(uint32 i = 0; i < x.getLength(); ++i)
+    {
+        y << f.filter(x[i], 200.0 + 0.5 * i);
+    }
+
+    return y;
+}
+
+} // namespace
+
+void FilterLowPassIIR_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace filter_low_pass_iir_unit_test;
+
+    IIRKernelCache & cache = IIRKernelCache::getInstance();
+
+    cout << TEST_HEADER << "Testing shared kernel cache ...";
+
+    cache.clear();
+
+    FilterLowPassIIR f1(SR, 6, 1000.0, 0.01);
+
+    uint32 n_kernels = cache.getSize();
+
+    FilterLowPassIIR f2(SR, 6, 1000.0, 0.01);
+    FilterLowPassIIR f3(SR, 6, 1000.0, 0.02);
+
+    Buffer noise = Generator(SR).whiteNoise(0.25);
+
+    if(n_kernels != 1 ||
+       cache.getSize() != 2 ||
+       cache.getNHits() == 0 ||
+       f1.filter(noise) != f2.filter(noise))
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Kernels were not shared!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing kernel cache eviction ...";
+
+    cache.setCapacity(8);
+
+    Buffer gold = sweep(noise);
+
+    Buffer data = f1.filter(noise);
+
+    if(cache.getSize() != 8 || data != f2.filter(noise))
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Cache size = " << cache.getSize() << ", expected 8"
+             << endl;
+
+        exit(1);
+    }
+
+    cache.setCapacity(4096);
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing kernel cache threaded ...";
+
+    cache.clear();
+
+    std::vector<Buffer> results(4);
+    std::vector<std::thread> threads;
+
+    for(uint32 i = 0; i < results.size(); ++i)
+    {
+        threads.push_back(
+            std::thread([&results, &noise, i]{ results[i] = sweep(noise); }));
+    }
+
+    for(auto & t : threads) t.join();
+
+    for(auto & y : results)
+    {
+        if(y != gold)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Threaded output differs!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing kernel interpolation ...";
+
+    FilterLowPassIIR exact(SR, 6, 1050.0, 0.01);
+    FilterLowPassIIR coarse(SR, 6, 1050.0, 0.01);
+
+    coarse.setFrequencyResolution(100.0);
+
+    Buffer freqs = exact.getFrequencyAxisLog(20.0, 3999.0, 128);
+
+    Buffer h_exact = exact.getFrequencyResponse(freqs);
+    Buffer h_snap  = coarse.getFrequencyResponse(freqs);
+
+    coarse.setInterpolation(true);
+
+    Buffer h_interp = coarse.getFrequencyResponse(freqs);
+
+    float64 snap_error = (h_snap - h_exact).getAbs().getMax();
+    float64 interp_error = (h_interp - h_exact).getAbs().getMax();
+
+    if(interp_error >= 0.5 * snap_error)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Interpolation error " << interp_error
+             << " not smaller than snapping error " << snap_error
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Filter::setControlPeriod() ...";
+
+    FilterLowPassIIR lpf1(SR, 6, 1000.0, 0.01);
+    FilterLowPassIIR lpf2(SR, 6, 1000.0, 0.01);
+
+    lpf2.setControlPeriod(32);
+
+    // A constant frequency must not change the output at all.
+    Buffer constant = 1234.5 * Buffer::ones(noise.getLength());
+
+    if(lpf1.filter(noise, constant) != lpf2.filter(noise, constant))
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Control rate output differs for a constant frequency!"
+             << endl;
+
+        exit(1);
+    }
+
+    // A slow sweep with a fine resolution designs a kernel every sample
+    // unless the control rate is used.
+    lpf1.setFrequencyResolution(0.001);
+    lpf2.setFrequencyResolution(0.001);
+
+    Buffer lfo = 1000.0 + 500.0 * Sine(SR).generate(0.25, 0.25);
+
+    cache.clear();
+
+    data = lpf2.filter(noise, lfo);
+
+    uint64 n_control = cache.getNMisses();
+
+    cache.clear();
+
+    gold = lpf1.filter(noise, lfo);
+
+    uint64 n_per_sample = cache.getNMisses();
+
+    float64 error = (data - gold).getAbs().getMax();
+
+    if(error > 1e-3 || n_control * 4 > n_per_sample)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "error = " << error
+             << ", kernels designed = " << n_control
+             << " vs " << n_per_sample
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing setFrequencyResolution() after a sweep ...";
+
+    // The sweep leaves blended coefficients that match no single frequency,
+    // the new kernels must still come from a real one.
+    lpf2.setFrequencyResolution(1.0);
+
+    Buffer h = lpf2.getFrequencyResponse(freqs);
+
+    lpf2.setInterpolation(true);
+
+    h << lpf2.getFrequencyResponse(freqs);
+
+    for(auto v : h)
+    {
+        if(!std::isfinite(v))
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "The redesigned kernel is not finite!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    if(std::fabs(h[0] - 1.0) > 0.1)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Passband gain = " << h[0] << " != 1"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
@@ -30,6 +30,8 @@
 
 #include "UnitTest.h"
 
+#include <algorithm>
+
 
 using std::cerr;
 using std::cout;
@@ -77,6 +79,27 @@ check_close_func(
 #define check_close(gold, data) filter_median_unit_test::check_close_func(__LINE__, (gold), (data))
 
 
+// Brute force sliding window percentile, same edge handling as FilterMedian.
+Buffer
+brute_force(const Buffer & x, uint32 n_window, uint32 rank)
+{
+    std::vector<float64> window(n_window, x[0]);
+    std::vector<float64> sorted(n_window);
+
+    Buffer y;
+
+    for(uint32 i = 0; i < x.getLength(); ++i)
+    {
+        window[i % n_window] = x[i];
+        sorted = window;
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        y << sorted[rank];
+    }
+
+    return y;
+}
+
+
 } // namespace
 
 
@@ -147,5 +170,36 @@ void FilterMedian_UnitTest()
     gold = {6.0, 6.0, 6.0, 4.0, 4.0, 3.0, 3.0, 5.0, 5.0, 5.0, 5.0};
 
     check_close(gold, data);
-}
 
+    cout << TEST_HEADER << "Median w=1001, random input";
+
+    b1 = Buffer::rand(5000);
+
+    fm = FilterMedian(1001);
+
+    data = fm.filter(b1);
+
+    gold = filter_median_unit_test::brute_force(b1, 1001, 500);
+
+    check_close(gold, data);
+
+    cout << TEST_HEADER << "Percentile 10 w=257, random input";
+
+    fm = FilterMedian(256, 10.0);
+
+    data = fm.filter(b1);
+
+    gold = filter_median_unit_test::brute_force(b1, 257, 26);
+
+    check_close(gold, data);
+
+    cout << TEST_HEADER << "Percentile 100 w=33, random input";
+
+    fm = FilterMedian(33, 100.0);
+
+    data = fm.filter(b1);
+
+    gold = filter_median_unit_test::brute_force(b1, 33, 32);
+
+    check_close(gold, data);
+}
@@ -0,0 +1,268 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Granulator_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/Buffer.h>
+#include <Nsound/Generator.h>
+#include <Nsound/Granulator.h>
+#include <Nsound/Sine.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "Granulator_UnitTest.cc";
+
+static const float64 GAMMA = 1e-12;
+
+static const float64 SR = 8000.0;
+
+namespace granulator_unit_test
+{
+
+// Renders every grain with the Generators, one Buffer per grain.
+Buffer
+reference(
+    const float64 & duration,
+    const float64 & grain_frequency,
+    const float64 & waves_per_grain,
+    const float64 & grains_per_second)
+{
+    Generator gen(SR);
+    Generator envelope(SR, gen.drawFatGaussian(1.0, 0.30));
+    Sine sine(SR);
+
+    uint32 n_samples = static_cast<uint32>(std::ceil(duration * SR));
+
+    Buffer y;
+
+    float64 period = SR / grains_per_second;
+
+    for(float64 onset = 0.0; onset <= n_samples - 1; onset += period)
+    {
+        float64 g_duration = waves_per_grain / grain_frequency;
+
+        Buffer grain = sine.generate(g_duration, grain_frequency)
+            * envelope.generate(g_duration, 1.0 / g_duration);
+
+        y.add(grain, static_cast<uint32>(std::ceil(onset)));
+    }
+
+    return y;
+}
+
+} // namespace
+
+void Granulator_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace granulator_unit_test;
+
+    Granulator gran(SR, Granulator::GAUSSIAN_30);
+
+    cout << TEST_HEADER << "Testing Granulator::generate() ...";
+
+    // 7.3 grains per second overlap by a lot, each grain is 70 ms.
+    Buffer data = gran.generate(0.5, 100.0, 7.0, 370.0);
+    Buffer gold = reference(0.5, 100.0, 7.0, 370.0);
+
+    if(data.getLength() != gold.getLength()
+        || (data - gold).getAbs().getMax() > GAMMA)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output did not match gold!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Granulator::generateBlock() ...";
+
+    const uint32 block_sizes[3] = {1, 77, 512};
+
+    for(uint32 i = 0; i < 3; ++i)
+    {
+        gran.reset();
+
+        Buffer y;
+
+        while(y.getLength() < 4000)
+        {
+            y << gran.generateBlock(block_sizes[i], 100.0, 7.0, 370.0);
+        }
+
+        if((y.subbuffer(0, 4000) - data.subbuffer(0, 4000)).getAbs().getMax()
+            > GAMMA)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Blocks of " << block_sizes[i]
+                 << " samples did not match generate()!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Granulator::generate() dynamic ...";
+
+    Buffer gf;
+    gf << 100.0 << 150.0 << 200.0;
+
+    Buffer wpg;
+    wpg << 3.0 << 4.0;
+
+    // Silence in the middle, the grains start again after it.
+    Buffer gps = Buffer::ones(1000) * 250.0;
+    gps << Buffer::zeros(1000) << Buffer::ones(1000) * 100.0;
+
+    data = gran.generate(3000.0 / SR, gf, wpg, gps);
+
+    gold = Buffer();
+
+    {
+        Generator gen(SR);
+        Generator envelope(SR, gen.drawFatGaussian(1.0, 0.30));
+        Sine sine(SR);
+
+        uint32 n = 0;
+
+        for(float64 onset = 0.0; onset < 3000.0; ++n)
+        {
+            uint32 index = static_cast<uint32>(std::ceil(onset));
+
+            if(index >= 3000) break;
+
+            if(gps[index] <= 0.0)
+            {
+                onset = index + 1;
+                --n;
+                continue;
+            }
+
+            float64 f = gf[n % 3];
+            float64 g_duration = wpg[n % 2] / f;
+
+            Buffer grain = sine.generate(g_duration, f)
+                * envelope.generate(g_duration, 1.0 / g_duration);
+
+            gold.add(grain, index);
+
+            onset += SR / gps[index];
+        }
+    }
+
+    if(data.getLength() != gold.getLength()
+        || (data - gold).getAbs().getMax() > GAMMA
+        || data.subbuffer(1320, 680).getAbs().getMax() != 0.0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output did not match gold!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Granulator::setGrainPoolSize() ...";
+
+    // 70 ms grains every 50 ms, with room for one grain every other grain
+    // is dropped, leaving a grain every 100 ms.
+    gran.setGrainPoolSize(1);
+
+    data = gran.generate(0.5, 100.0, 7.0, 20.0);
+    gold = reference(0.5, 100.0, 7.0, 10.0);
+
+    if(data.getLength() != 4000
+        || (data.subbuffer(0, gold.getLength()) - gold).getAbs().getMax() > GAMMA
+        || data.subbuffer(gold.getLength()).getAbs().getMax() != 0.0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output did not match gold!"
+             << endl;
+
+        exit(1);
+    }
+
+    gran.reset();
+
+    Buffer y;
+
+    while(y.getLength() < 4000)
+    {
+        y << gran.generateBlock(77, 100.0, 7.0, 20.0);
+
+        if(gran.getNActiveGrains() > 1)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "The pool held " << gran.getNActiveGrains() << " grains!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    if(gran.getNDroppedGrains() != 5
+        || (y.subbuffer(0, 4000) - data).getAbs().getMax() > GAMMA)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Dropped " << gran.getNDroppedGrains()
+             << " grains, expected 5"
+             << endl;
+
+        exit(1);
+    }
+
+    gran.reset();
+
+    if(gran.getNDroppedGrains() != 0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "reset() did not clear the dropped grains"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
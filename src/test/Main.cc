@@ -56,8 +56,12 @@ int main(int argc, char ** argv)
 
     FilterCombLowPassFeedback_UnitTest();
 
+    FilterIIR_UnitTest();
+
     FilterLeastSquaresFIR_UnitTest();
 
+    FilterLowPassIIR_UnitTest();
+
     FilterMedian_UnitTest();
 
     FilterParametricEqualizer_UnitTest();
@@ -66,8 +70,34 @@ int main(int argc, char ** argv)
     Sine_UnitTest();
     Triangle_UnitTest();
 
+    Granulator_UnitTest();
+
     FFTransform_UnitTest();
 
+    SpectrogramCache_UnitTest();
+
+    StreamingSTFT_UnitTest();
+
+    Stretcher_UnitTest();
+
+    RenderScheduler_UnitTest();
+
+    ThreadPool_UnitTest();
+
+    ReverberationRoom_UnitTest();
+
+    Pluck_UnitTest();
+
+    Profiler_UnitTest();
+
+    Vocoder_UnitTest();
+
+    VoicePool_UnitTest();
+
+    Sequencer_UnitTest();
+
+    AudioPlaybackRt_UnitTest();
+
     Nsound::Plotter::show();
 
     cout << endl
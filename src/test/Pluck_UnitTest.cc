@@ -0,0 +1,250 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Pluck_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/Buffer.h>
+#include <Nsound/DelayLine.h>
+#include <Nsound/FilterDC.h>
+#include <Nsound/FilterTone.h>
+#include <Nsound/Generator.h>
+#include <Nsound/KarplusStrong.h>
+#include <Nsound/Pluck.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <iostream>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "Pluck_UnitTest.cc";
+
+static const float64 SR = 8000.0;
+
+namespace pluck_unit_test
+{
+
+// The original Pluck::generate(), built from the Nsound classes.
+Buffer
+pluck(
+    uint32 seed,
+    uint32 n_smooth,
+    const float64 & duration,
+    const float64 & frequency)
+{
+    Generator gen(SR);
+
+    gen.setSeed(seed);
+
+    DelayLine delay(SR, 1.0 / frequency);
+    FilterDC dc_filter(0.99);
+    FilterTone tone(SR, 14 * frequency * duration);
+
+    Buffer noise_env =  gen.drawLine(1.0 / frequency, 1.0, 1.0)
+                     << gen.drawLine(duration - (1.0 / frequency), 0.0, 0.0)
+                     << 0.0;
+
+    Buffer x = gen.whiteNoise(duration) * noise_env * 2.0;
+
+    x.smooth(1, n_smooth);
+    x.normalize();
+
+    uint32 n_samples = static_cast<int32>(duration * SR);
+
+    Buffer y;
+
+    delay.write(x[0]);
+    for(uint32 n = 0; n < n_samples; ++n)
+    {
+        y << dc_filter.filter(tone.filter(delay.read()));
+
+        delay.write(x[n] + y[n]);
+    }
+    y.normalize();
+
+    return y;
+}
+
+} // namespace
+
+void Pluck_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace pluck_unit_test;
+
+    cout << TEST_HEADER << "Testing Pluck::generate() ...";
+
+    Pluck p(SR, 16);
+
+    for(float64 f : {82.41, 246.94, 1234.5})
+    {
+        p.setSeed(1234);
+
+        Buffer data = p.generate(0.5, f);
+        Buffer gold = pluck(1234, 16, 0.5, f);
+
+        if(data != gold)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Output did not match the original at " << f << " Hz!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing KarplusStrong::noteOn() ...";
+
+    KarplusStrong ks(SR, 6, 50.0, 16);
+
+    for(float64 f : {82.41, 246.94, 1234.5})
+    {
+        // The same string as Pluck, before normalization.
+        p.setSeed(99);
+        ks.setSeed(99);
+
+        ks.reset();
+        ks.noteOn(f, 1.0, 0.5);
+
+        Buffer data = ks.render(4000);
+        Buffer gold = p.generate(0.5, f);
+
+        data.normalize();
+
+        if(data != gold)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "String did not match Pluck at " << f << " Hz!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing KarplusStrong::render() blocks ...";
+
+    const float64 notes[] = {82.41, 110.0, 146.83, 196.0, 246.94, 329.63};
+
+    ks.reset();
+    ks.setSeed(7);
+
+    for(uint32 i = 0; i < 6; ++i) ks.noteOn(notes[i], 1.0 / (i + 1));
+
+    Buffer gold = ks.render(3000);
+
+    ks.reset();
+    ks.setSeed(7);
+
+    for(uint32 i = 0; i < 6; ++i) ks.noteOn(notes[i], 1.0 / (i + 1));
+
+    Buffer data;
+
+    for(uint32 n : {1, 64, 500, 7, 1428, 1000}) data << ks.render(n);
+
+    if(data != gold)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Rendering in blocks did not match one render!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing KarplusStrong voice stealing ...";
+
+    // All 6 strings are busy, the oldest one gets stolen.
+    uint32 s = ks.noteOn(440.0);
+
+    if(s != 0 || ks.getNActive() != 6)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The oldest string was not stolen!"
+             << endl;
+
+        exit(1);
+    }
+
+    ks.setReleaseTime(0.01);
+
+    for(uint32 i = 0; i < 6; ++i) ks.noteOff(i);
+
+    for(uint32 i = 0; i < 10; ++i) ks.render(400);
+
+    if(ks.getNActive() != 0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Released strings were not freed!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing KarplusStrong lowest frequency ...";
+
+    // 87 Hz still fits the 128 sample delay line but not the excitation.
+    KarplusStrong low(SR, 4, 100.0, 0);
+
+    low.noteOn(100.0, 1.0, 1.0);
+
+    bool caught = false;
+
+    try
+    {
+        low.noteOn(87.0, 1.0, 1.0);
+    }
+    catch(const Nsound::Exception &)
+    {
+        caught = true;
+    }
+
+    if(!caught)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "A note below the lowest frequency did not throw!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
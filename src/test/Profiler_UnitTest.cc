@@ -0,0 +1,182 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Profiler_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterLowPassIIR.h>
+#include <Nsound/Profiler.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "Profiler_UnitTest.cc";
+
+namespace profiler_unit_test
+{
+
+const ProfileStats *
+find(const std::vector<ProfileStats> & stats, const std::string & name)
+{
+    for(const auto & s : stats)
+    {
+        if(s.name == name) return &s;
+    }
+
+    return nullptr;
+}
+
+void
+spin(uint32 n)
+{
+    volatile float64 x = 0.0;
+    for(uint32 i = 0; i < n; ++i) x = x + 1.0;
+}
+
+} // namespace
+
+void Profiler_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace profiler_unit_test;
+
+    cout << TEST_HEADER << "Testing ProfileScope nesting ...";
+
+    Profiler::reset();
+
+    for(uint32 i = 0; i < 3; ++i)
+    {
+        ProfileScope outer("test::outer", 100);
+
+        spin(10000);
+
+        {
+            ProfileScope inner("test::inner");
+            inner.addSamples(10);
+            spin(10000);
+        }
+    }
+
+    std::vector<ProfileStats> stats = Profiler::getStats();
+
+    const ProfileStats * outer = find(stats, "test::outer");
+    const ProfileStats * inner = find(stats, "test::inner");
+
+    if(outer == nullptr || inner == nullptr)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Scopes were not recorded!"
+             << endl;
+
+        exit(1);
+    }
+
+    if(outer->n_calls != 3 || inner->n_calls != 3
+        || outer->n_samples != 300 || inner->n_samples != 30)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Wrong call or sample counts!"
+             << endl;
+
+        exit(1);
+    }
+
+    // The inner scope's time is excluded from the outer self time.
+    float64 error = outer->total_sec - outer->self_sec - inner->total_sec;
+
+    if(std::fabs(error) > 1e-6 || inner->self_sec != inner->total_sec)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Self time is wrong!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Profiler instrumentation ...";
+
+    Profiler::reset();
+
+    FilterLowPassIIR lpf(8000.0, 4, 1000.0, 0.01);
+
+    Buffer y = lpf.filter(Buffer::ones(1000));
+
+    stats = Profiler::getStats();
+
+    const ProfileStats * filter = find(stats, "Filter::filter");
+
+    if(Profiler::isEnabled())
+    {
+        if(filter == nullptr
+            || filter->n_calls != 1
+            || filter->n_samples != 1000
+            || filter->n_allocations == 0)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Filter::filter was not profiled!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+    else if(!stats.empty())
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Profiling is compiled out but stages were recorded!"
+             << endl;
+
+        exit(1);
+    }
+
+    Profiler::reset();
+
+    if(!Profiler::getStats().empty())
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Profiler::reset() did not clear the stats!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,216 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: RenderScheduler_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterLowPassIIR.h>
+#include <Nsound/RenderScheduler.h>
+#include <Nsound/Sine.h>
+#include <Nsound/ThreadPool.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <iostream>
+#include <memory>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "RenderScheduler_UnitTest.cc";
+
+static const float64 GAMMA = 1.5e-14;
+
+static const float64 SR = 8000.0;
+static const uint32  N_VOICES = 7;
+
+namespace render_scheduler_unit_test
+{
+
+struct Voice
+{
+    Voice(float64 f)
+        : sine(SR), lpf(SR, 4, 1000.0, 0.01), freq(f) {}
+
+    Sine             sine;
+    FilterLowPassIIR lpf;
+    float64          freq;
+};
+
+AudioStream
+render(uint32 n_threads, float64 duration)
+{
+    std::vector< std::shared_ptr<Voice> > voices;
+
+    ThreadPool::getInstance().setNThreads(n_threads);
+
+    RenderScheduler rs(SR, 2, 100);
+
+    for(uint32 i = 0; i < N_VOICES; ++i)
+    {
+        std::shared_ptr<Voice> v(new Voice(110.0 * (i + 1)));
+
+        voices.push_back(v);
+
+        rs.addBranch(
+            [v](AudioStream & block)
+            {
+                for(uint32 j = 0; j < block.getLength(); ++j)
+                {
+                    float64 x = v->lpf.filter(v->sine.generate(v->freq));
+                    block[0][j] = x;
+                    block[1][j] = -x;
+                }
+            },
+            1.0 / (i + 1));
+    }
+
+    AudioStream y = rs.render(duration);
+
+    ThreadPool::getInstance().setNThreads(1);
+
+    return y;
+}
+
+} // namespace
+
+void RenderScheduler_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace render_scheduler_unit_test;
+
+    cout << TEST_HEADER << "Testing RenderScheduler::render() serial ...";
+
+    // Gold is rendered directly, one voice after the other.
+    AudioStream gold(SR, 2);
+
+    gold[0] = Buffer::zeros(1234);
+    gold[1] = Buffer::zeros(1234);
+
+    for(uint32 i = 0; i < N_VOICES; ++i)
+    {
+        Voice v(110.0 * (i + 1));
+
+        for(uint32 j = 0; j < 1234; ++j)
+        {
+            float64 x = v.lpf.filter(v.sine.generate(v.freq));
+            gold[0][j] += x / (i + 1);
+            gold[1][j] -= x / (i + 1);
+        }
+    }
+
+    AudioStream serial = render(1, 1234.0 / SR);
+
+    if(serial.getLength() != 1234 || (serial - gold).getAbs().getMax() > GAMMA)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output did not match gold!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing RenderScheduler::render() threaded ...";
+
+    for(uint32 n_threads = 2; n_threads <= 5; ++n_threads)
+    {
+        AudioStream data = render(n_threads, 1234.0 / SR);
+
+        // The mixdown order is fixed, results must be bit identical.
+        if(data != serial)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Output with " << n_threads << " threads differs!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    // Many short blocks, each one must wait for all of its branches.
+    AudioStream many = render(8, 0.5);
+
+    if(many.getLength() != 4000 || many[0] != render(1, 0.5)[0])
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output of many short blocks differs!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing RenderScheduler branch exception ...";
+
+    ThreadPool::getInstance().setNThreads(3);
+
+    RenderScheduler rs(SR, 1, 64);
+
+    for(uint32 i = 0; i < 4; ++i)
+    {
+        rs.addBranch(
+            [i](AudioStream &)
+            {
+                if(i == 2) M_THROW("branch " << i << " failed");
+            });
+    }
+
+    bool caught = false;
+
+    try
+    {
+        rs.renderBlock();
+    }
+    catch(const Nsound::Exception &)
+    {
+        caught = true;
+    }
+
+    ThreadPool::getInstance().setNThreads(1);
+
+    if(!caught)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Exception was not propagated!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,225 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: ReverberationRoom_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterAllPass.h>
+#include <Nsound/FilterCombLowPassFeedback.h>
+#include <Nsound/Generator.h>
+#include <Nsound/ReverberationRoom.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "ReverberationRoom_UnitTest.cc";
+
+static const float64 GAMMA = 1e-12;
+
+namespace reverberation_room_unit_test
+{
+
+// Delay seconds that FilterDelay truncates to the scaled delay in samples.
+float64
+delay(float64 sr, uint32 samples_44k, uint32 spread)
+{
+    uint32 d = static_cast<uint32>(samples_44k * sr / 44100.0 + 0.5);
+
+    return (d + spread + 0.5) / sr;
+}
+
+// The same network built from the Filter classes, one sample at a time.
+AudioStream
+reference(
+    float64 sr,
+    const Buffer & left,
+    const Buffer & right,
+    float64 room_feedback,
+    float64 wet,
+    float64 dry,
+    float64 lpf,
+    float64 spread_seconds)
+{
+    const uint32 combs[8] = {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617};
+    const uint32 allpasses[4] = {556, 441, 341, 225};
+
+    uint32 spread = static_cast<uint32>(spread_seconds * sr + 0.5);
+
+    float64 feedback = 0.28 * room_feedback + 0.7;
+
+    typedef std::shared_ptr<FilterCombLowPassFeedback> Comb;
+    typedef std::shared_ptr<FilterAllPass> AllPass;
+
+    std::vector<Comb> comb[2];
+    std::vector<AllPass> allpass[2];
+
+    for(uint32 c = 0; c < 2; ++c)
+    {
+        for(uint32 i = 0; i < 8; ++i)
+        {
+            comb[c].push_back(Comb(new FilterCombLowPassFeedback(
+                sr, delay(sr, combs[i], c * spread), feedback, lpf)));
+        }
+
+        for(uint32 i = 0; i < 4; ++i)
+        {
+            allpass[c].push_back(AllPass(new FilterAllPass(
+                sr, delay(sr, allpasses[i], c * spread), 0.5)));
+        }
+    }
+
+    AudioStream y(sr, 2);
+
+    for(uint32 n = 0; n < left.getLength(); ++n)
+    {
+        float64 x[2] = {left[n], right[n]};
+
+        for(uint32 c = 0; c < 2; ++c)
+        {
+            float64 out = 0.0;
+
+            for(uint32 i = 0; i < 8; ++i)
+            {
+                out += comb[c][i]->filter(x[c] * 0.15);
+            }
+
+            for(uint32 i = 0; i < 4; ++i)
+            {
+                out = allpass[c][i]->filter(out);
+            }
+
+            y[c] << wet * out + dry * x[c];
+        }
+    }
+
+    return y;
+}
+
+} // namespace
+
+void ReverberationRoom_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace reverberation_room_unit_test;
+
+    Generator gen(1.0);
+
+    gen.setSeed(2718);
+
+    cout << TEST_HEADER << "Testing ReverberationRoom::filter() ...";
+
+    const float64 rates[2] = {44100.0, 8000.0};
+
+    for(uint32 r = 0; r < 2; ++r)
+    {
+        const float64 sr = rates[r];
+
+        // An impulse followed by noise, long enough to feed back a few times.
+        Buffer left = Buffer::zeros(1);
+        left[0] = 1.0;
+        left << gen.whiteNoise(0.25 * sr);
+        left << Buffer::zeros(static_cast<uint32>(0.25 * sr));
+
+        Buffer right = gen.whiteNoise(left.getLength());
+
+        AudioStream x(sr, 2);
+        x[0] = left;
+        x[1] = right;
+
+        ReverberationRoom room(sr, 0.9, 0.6, 0.8, 3000.0, 0.001);
+
+        AudioStream data = room.filter(x);
+        AudioStream gold =
+            reference(sr, left, right, 0.9, 0.6, 0.8, 3000.0, 0.001);
+
+        if(data.getLength() != gold.getLength()
+            || (data - gold).getAbs().getMax() > GAMMA)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Output at " << sr << " Hz did not match gold!"
+                 << endl;
+
+            exit(1);
+        }
+
+        // One sample at a time and a copy in blocks must agree.
+        ReverberationRoom copy(room);
+
+        copy.reset();
+        room.reset();
+
+        AudioStream y1(sr, 2);
+        AudioStream y2(sr, 2);
+
+        y1[0] = left;
+        y1[1] = right;
+        y2[0] = left;
+        y2[1] = right;
+
+        for(uint32 n = 0; n < left.getLength(); ++n)
+        {
+            room.filter(y1[0][n], y1[1][n], left[n], right[n]);
+        }
+
+        for(uint32 n = 0; n < left.getLength(); n += 1000)
+        {
+            uint32 m = std::min(1000u, left.getLength() - n);
+
+            copy.filter(
+                y2[0].getPointer() + n,
+                y2[1].getPointer() + n,
+                y2[0].getPointer() + n,
+                y2[1].getPointer() + n,
+                m);
+        }
+
+        if(y1 != data || y2 != data)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Streaming output at " << sr << " Hz did not match!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
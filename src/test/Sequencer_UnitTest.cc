@@ -0,0 +1,330 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Sequencer_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/Generator.h>
+#include <Nsound/Instrument.h>
+#include <Nsound/Sequencer.h>
+#include <Nsound/VoicePool.h>
+#include <Nsound/Wavefile.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <iostream>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "Sequencer_UnitTest.cc";
+
+static const float64 GAMMA = 1e-12;
+
+static const float64 SR = 8000.0;
+
+namespace sequencer_unit_test
+{
+
+// Plays a line from frequency down to 0.
+class Line : public Instrument
+{
+    public:
+
+    Line() : Instrument(SR), n_plays(0) {}
+
+    AudioStream play() { return play(1.0, 1.0); }
+
+    AudioStream
+    play(const float64 & duration, const float64 & frequency)
+    {
+        ++n_plays;
+
+        Generator gen(SR);
+
+        AudioStream y(SR, 1);
+
+        y << gen.drawLine(duration, frequency, 0.0);
+
+        return y;
+    }
+
+    std::string getInfo() { return "Line"; }
+
+    uint32 n_plays;
+};
+
+// Adds gain * note to y starting at sample offset.
+void
+addNote(Buffer & y, uint32 offset, float64 duration, float64 gain)
+{
+    Line line;
+
+    Buffer note = line.play(duration, 1.0)[0];
+
+    for(uint32 i = 0; i < note.getLength() && offset + i < y.getLength(); ++i)
+    {
+        y[offset + i] += gain * note[i];
+    }
+}
+
+Buffer
+zeros(uint32 n)
+{
+    Buffer y(n);
+
+    for(uint32 i = 0; i < n; ++i) y << 0.0;
+
+    return y;
+}
+
+} // namespace
+
+void Sequencer_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace sequencer_unit_test;
+
+    Line line;
+
+    cout << TEST_HEADER << "Testing Sequencer::addNote() ...";
+
+    Buffer gold = zeros(4000);
+
+    addNote(gold, 0, 0.05, 0.5);
+    addNote(gold, 987, 0.1, 0.5 * 0.25);
+    addNote(gold, 1001, 0.02, 0.5);
+    addNote(gold, 3999, 0.1, 0.5);
+
+    for(uint32 block = 1; block <= 1000; block *= 10)
+    {
+        VoicePool pool(line, 4);
+
+        Sequencer seq(SR, 2, block);
+
+        uint32 t = seq.addTrack(pool, 0.5);
+
+        seq.addNote(t, 987.0 / SR, 0.1, 1.0, 0.25);
+        seq.addNote(t, 0.0, 0.05, 1.0);
+        seq.addNote(t, 1001.0 / SR, 0.02, 1.0);
+        seq.addNote(t, 3999.0 / SR, 0.1, 1.0);
+
+        AudioStream y = seq.render(4000.0 / SR);
+
+        if(y.getLength() != 4000 ||
+           (y[0] - gold).getAbs().getMax() > GAMMA ||
+           y[0] != y[1] ||
+           seq.getNEvents() != 0)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Output did not match gold with "
+                 << block << " samples per block!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Sequencer::addEvent() ...";
+
+    {
+        VoicePool pool(line, 4);
+
+        Sequencer seq(SR, 1, 64);
+
+        seq.addTrack(pool);
+
+        uint32 n_calls = 0;
+
+        // Starting a note from the callback lands on the exact sample.
+        seq.addEvent(
+            777.0 / SR,
+            [&]()
+            {
+                ++n_calls;
+                pool.noteOn(1.0, 0.05);
+            });
+
+        AudioStream y = seq.render(0.25);
+
+        gold = zeros(2000);
+
+        addNote(gold, 777, 0.05, 1.0);
+
+        if(n_calls != 1 || (y[0] - gold).getAbs().getMax() > GAMMA)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "The callback didn't fire at the scheduled sample!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Sequencer::addGain() ...";
+
+    {
+        VoicePool pool(line, 4);
+
+        Sequencer seq(SR, 1, 100);
+
+        uint32 t = seq.addTrack(pool);
+
+        seq.addNote(t, 0.0, 0.5, 1.0);
+
+        // Ramp to 0.25 over 250 samples from sample 1234, then jump to 2.
+        seq.addGain(t, 1234.0 / SR, 0.25, 250.0 / SR);
+        seq.addGain(t, 3000.0 / SR, 2.0);
+
+        AudioStream y = seq.render(0.5);
+
+        gold = zeros(4000);
+
+        addNote(gold, 0, 0.5, 1.0);
+
+        for(uint32 i = 1234; i < 4000; ++i)
+        {
+            float64 gain = 0.25;
+
+            if(i < 1234 + 250)  gain = 1.0 - 0.75 * (i - 1234) / 250.0;
+            if(i >= 3000)       gain = 2.0;
+
+            gold[i] *= gain;
+        }
+
+        if((y[0] - gold).getAbs().getMax() > GAMMA)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "The gain automation did not match gold!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Sequencer::render(WavefileWriter) ...";
+
+    {
+        AudioStream gold_out;
+
+        Wavefile::setIEEEFloat(true);
+
+        for(uint32 pass = 0; pass < 2; ++pass)
+        {
+            VoicePool pool(line, 4);
+
+            Sequencer seq(SR, 2, 128);
+
+            uint32 t = seq.addTrack(pool, 0.5);
+
+            for(uint32 i = 0; i < 20; ++i)
+            {
+                seq.addNote(t, 0.1 * i, 0.15, 1.0 / (i + 1));
+            }
+
+            seq.addGain(t, 1.0, 0.0, 1.0);
+
+            if(pass == 0)
+            {
+                gold_out = seq.render(2.0);
+            }
+            else
+            {
+                WavefileWriter out("test_sequencer.wav", SR, 2, 64);
+
+                seq.render(out, 2.0);
+
+                out.close();
+            }
+        }
+
+        Wavefile::setIEEEFloat(false);
+
+        AudioStream data("test_sequencer.wav");
+
+        if(data.getLength() != gold_out.getLength() || data != gold_out)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "The streamed file did not match the rendered output!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Sequencer::setLookahead() ...";
+
+    {
+        // Many more distinct notes than the cache holds.
+        Line counter;
+
+        VoicePool pool(counter, 4, 8);
+
+        Sequencer seq(SR, 1, 128);
+
+        seq.setLookahead(0.1);
+
+        uint32 t = seq.addTrack(pool);
+
+        for(uint32 i = 0; i < 100; ++i)
+        {
+            seq.addNote(t, 0.05 * i, 0.04, 1.0 + i);
+        }
+
+        uint32 n_added = counter.n_plays;
+
+        seq.render(5.1);
+
+        if(n_added != 0 || counter.n_plays != 100)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Notes rendered when added = " << n_added
+                 << ", in total = " << counter.n_plays << " != 100"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
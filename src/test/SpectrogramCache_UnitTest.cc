@@ -0,0 +1,249 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: SpectrogramCache_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/RngTausworthe.h>
+#include <Nsound/SpectrogramCache.h>
+#include <Nsound/StreamingSTFT.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "SpectrogramCache_UnitTest.cc";
+
+static const float64 GAMMA = 1.0e-4;
+
+void SpectrogramCache_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    RngTausworthe rng;
+
+    rng.setSeed(4321);
+
+    Buffer x(FloatVector(10000, 0.0));
+
+    for(auto & v : x) v = rng.get(-1.0, 1.0);
+
+    cout << TEST_HEADER << "Testing SpectrogramCache::analyze() ...";
+
+    // Sample rate 1000, 64 sample window, 16 sample step, 7 frames per tile.
+    SpectrogramCache memory(1000.0, 0.064, 0.016, HANNING, false, 7);
+    SpectrogramCache spilled(1000.0, 0.064, 0.016, HANNING, false, 7);
+
+    spilled.setSpillFile("SpectrogramCache_UnitTest.bin");
+
+    for(uint32 i = 0; i < x.getLength(); i += 333)
+    {
+        memory.analyze(x.subbuffer(i, 333));
+        spilled.analyze(x.subbuffer(i, 333));
+    }
+
+    memory.flush();
+    spilled.flush();
+
+    // The last frame is centered past the last sample.
+    uint64 n_frames = memory.getNFrames();
+
+    if(n_frames != spilled.getNFrames() ||
+       memory.getNBins() != 33 ||
+       memory.getTime(n_frames - 1) < 9.999 ||
+       memory.getTime(n_frames - 2) >= 9.999)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Unexpected frame count " << n_frames
+             << " or bin count " << memory.getNBins()
+             << endl;
+
+        exit(1);
+    }
+
+    // The same frames from StreamingSTFT.
+    StreamingSTFT stft(64, 16, HANNING, 0, 16);
+
+    AudioStream gold(1, static_cast<uint32>(n_frames), 1);
+
+    Buffer padded(x);
+
+    padded << Buffer(FloatVector(32 + 15, 0.0));
+
+    uint32 k = 0;
+    uint32 n_consumed = 0;
+
+    while(n_consumed < padded.getLength())
+    {
+        n_consumed += stft.analyze(
+            padded.getPointer() + n_consumed,
+            padded.getLength() - n_consumed);
+
+        while(stft.getNFrames() > 0)
+        {
+            gold[k++] = stft.getMagnitude(0);
+
+            stft.popFrame();
+        }
+    }
+
+    AudioStream a = memory.getMagnitude(0, static_cast<uint32>(n_frames));
+    AudioStream b = spilled.getMagnitude(0, static_cast<uint32>(n_frames));
+
+    boolean spills_match = true;
+
+    for(uint32 i = 0; i < n_frames; ++i)
+    {
+        if((b[i] - a[i]).getAbs().getMax() != 0.0) spills_match = false;
+    }
+
+    if(k != n_frames || (a - gold).getAbs().getMax() > GAMMA || !spills_match)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Magnitudes did not match StreamingSTFT::getMagnitude()"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing SpectrogramCache::getWindow() ...";
+
+    // Frames centered in [2.0, 2.5) seconds, bins 100 Hz through 200 Hz.
+    AudioStream w = spilled.getWindow(2.0, 0.5, 100.0, 200.0);
+
+    uint32 first = 0;
+
+    while(spilled.getTime(first) < 2.0) ++first;
+
+    if(w.getNChannels() != 32 ||
+       w.getLength() != 6 ||
+       std::fabs(spilled.getFrequency(8) - 125.0) > 1e-12)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Window was " << w.getNChannels() << " frames by "
+             << w.getLength() << " bins"
+             << endl;
+
+        exit(1);
+    }
+
+    for(uint32 i = 0; i < w.getNChannels(); ++i)
+    {
+        if((w[i] - a[first + i].subbuffer(7, 6)).getAbs().getMax() != 0.0)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Window frame " << i << " did not match"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing SpectrogramCache concurrent reads ...";
+
+    // Readers of a const cache share the spill file's mapping.
+    std::vector<std::thread> readers;
+    std::vector<boolean> matches(4, true);
+
+    const SpectrogramCache & view = spilled;
+
+    for(uint32 t = 0; t < 4; ++t)
+    {
+        readers.push_back(std::thread(
+            [&, t]()
+            {
+                for(uint32 i = t; i < n_frames; i += 3)
+                {
+                    AudioStream f = view.getMagnitude(i, 1);
+
+                    if(f[0] != a[i]) matches[t] = false;
+                }
+            }));
+    }
+
+    for(auto & r : readers) r.join();
+
+    for(auto m : matches)
+    {
+        if(!m)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "A concurrent read did not match"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing SpectrogramCache dB ...";
+
+    SpectrogramCache decibels(1000.0, 0.064, 0.016, HANNING, true, 7);
+
+    decibels.analyze(x);
+    decibels.flush();
+
+    AudioStream d = decibels.getMagnitude(10, 20);
+
+    for(uint32 i = 0; i < 20; ++i)
+    {
+        for(uint32 j = 0; j < 33; ++j)
+        {
+            float64 db = 20.0 * std::log10(a[10 + i][j]);
+
+            if(std::fabs(d[i][j] - db) > 1.0e-3)
+            {
+                cerr << TEST_ERROR_HEADER
+                     << "Expected " << db << " dB, got " << d[i][j]
+                     << endl;
+
+                exit(1);
+            }
+        }
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
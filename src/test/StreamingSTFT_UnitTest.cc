@@ -0,0 +1,188 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: StreamingSTFT_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/Buffer.h>
+#include <Nsound/FFTChunk.h>
+#include <Nsound/FFTransform.h>
+#include <Nsound/Generator.h>
+#include <Nsound/RngTausworthe.h>
+#include <Nsound/StreamingSTFT.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <iostream>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "StreamingSTFT_UnitTest.cc";
+
+static const float64 GAMMA = 1.0e-12;
+
+void StreamingSTFT_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    RngTausworthe rng;
+
+    rng.setSeed(6789);
+
+    Buffer x(FloatVector(20000, 0.0));
+
+    for(auto & v : x) v = rng.get(-1.0, 1.0);
+
+    cout << TEST_HEADER
+         << "Testing StreamingSTFT::process() reconstruction ...";
+
+    struct Config
+    {
+        uint32     window_length;
+        uint32     hop;
+        WindowType type;
+        uint32     block_size;
+    };
+
+    Config configs[] =
+    {
+        {1024, 256, HANNING,     777},
+        {1000, 250, HAMMING,     1},
+        {256,  256, RECTANGULAR, 4096},
+        {37,   5,   BLACKMAN,    100},
+        {512,  300, NUTTALL,     20000},
+    };
+
+    for(const auto & c : configs)
+    {
+        // A small ring, so analyze() has to stop early.
+        StreamingSTFT stft(c.window_length, c.hop, c.type, 0, 2);
+
+        Buffer y;
+
+        for(uint32 i = 0; i < x.getLength(); i += c.block_size)
+        {
+            y << stft.process(x.subbuffer(i, c.block_size));
+        }
+
+        y << stft.flush();
+
+        if(y.getLength() != x.getLength() || (y - x).getAbs().getMax() > GAMMA)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Output did not match the input for window_length = "
+                 << c.window_length << ", hop = " << c.hop
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing StreamingSTFT::analyze() frames ...";
+
+    StreamingSTFT stft(64, 16, HANNING, 128, 4);
+
+    uint32 n = stft.analyze(x);
+
+    // Each frame needs 16 new samples, the ring holds 4 frames.
+    if(n != 64 || stft.getNFrames() != 4 || stft.getNBins() != 65)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Expected 64 samples and 4 frames, got "
+             << n << " and " << stft.getNFrames()
+             << endl;
+
+        exit(1);
+    }
+
+    // Frame 3 holds samples 0 through 63, zero padded to 128.
+    Generator gen(1);
+
+    FFTransform transform(1);
+
+    FFTChunkVector vec = transform.fft(
+        x.subbuffer(0, 64) * gen.drawWindow(64, HANNING), 128);
+
+    Buffer gold = vec[0].getMagnitude();
+
+    StreamingSTFT::Frame & frame = stft.getFrame(3);
+
+    if(frame.index != 3 ||
+       (stft.getMagnitude(3) - gold).getAbs().getMax() > GAMMA)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Frame 3 did not match FFTransform::fft()"
+             << endl;
+
+        exit(1);
+    }
+
+    stft.popFrame();
+
+    if(stft.getNFrames() != 3 || stft.getFrame().index != 1)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "popFrame() did not release the oldest frame"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing StreamingSTFT::process() effect ...";
+
+    StreamingSTFT silence(128, 32);
+
+    auto zero = [](StreamingSTFT::Frame & f)
+    {
+        for(uint32 k = 0; k < f.n_bins; ++k) f.real[k] = f.imag[k] = 0.0;
+    };
+
+    Buffer y = silence.process(x, zero);
+
+    y << silence.flush(zero);
+
+    if(y.getLength() != x.getLength() || y.getAbs().getMax() != 0.0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The effect was not applied"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
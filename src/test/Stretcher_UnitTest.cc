@@ -0,0 +1,348 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Stretcher_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FFTransform.h>
+#include <Nsound/Sine.h>
+#include <Nsound/Stretcher.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "Stretcher_UnitTest.cc";
+
+static const float64 SR = 8000.0;
+
+namespace stretcher_unit_test
+{
+
+// The frequency of the largest FFT bin.
+float64
+peakFrequency(const Buffer & x)
+{
+    FFTransform transform(SR);
+
+    Buffer spectrum = transform.fft(x);
+
+    uint32 peak = 0;
+
+    for(uint32 i = 0; i < spectrum.getLength(); ++i)
+    {
+        if(spectrum[i] > spectrum[peak]) peak = i;
+    }
+
+    // FFTransform::fft() returns SR / 2 samples.
+    return peak * SR / 2.0 / spectrum.getLength();
+}
+
+float64
+rms(const Buffer & x)
+{
+    return std::sqrt((x * x).getMean());
+}
+
+} // namespace
+
+void Stretcher_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace stretcher_unit_test;
+
+    Sine sine(SR);
+
+    Buffer x = 0.5 * sine.generate(1.0, 440.0)
+             + 0.25 * sine.generate(1.0, 1234.0);
+
+    Stretcher stretcher(SR);
+
+    stretcher.setMethod(Stretcher::PHASE_VOCODER);
+
+    cout << TEST_HEADER << "Testing Stretcher::timeShift() phase vocoder ...";
+
+    // A factor of 1 is the STFT and its inverse.
+    Buffer y = stretcher.timeShift(x, 1.0);
+
+    if(y.getLength() != x.getLength() || (y - x).getAbs().getMax() > 1e-12)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "A factor of 1 did not reconstruct the input!"
+             << endl;
+
+        exit(1);
+    }
+
+    float64 factors[] = {0.5, 1.5, 2.0, 3.7};
+
+    for(auto factor : factors)
+    {
+        y = stretcher.timeShift(x, factor);
+
+        uint32 n = static_cast<uint32>(x.getLength() * factor + 0.5);
+
+        // The middle of the output, away from the edges.
+        Buffer middle = y.subbuffer(n / 4, n / 2);
+
+        if(y.getLength() != n ||
+           std::fabs(peakFrequency(middle) - 440.0) > 5.0 ||
+           std::fabs(rms(middle) - rms(x)) > 0.01)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "factor = " << factor
+                 << ", length = " << y.getLength() << " != " << n
+                 << ", peak = " << peakFrequency(middle) << " Hz != 440 Hz"
+                 << ", rms = " << rms(middle) << " != " << rms(x)
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Stretcher::timeShift() below 1/8 ...";
+
+    // The synthesis hop drops below 1/8 of the window.  The last quarter of
+    // the input is an octave up, it must reach the end of the output.
+    Buffer x4 = 0.5 * sine.generate(6.0, 440.0);
+
+    x4 << 0.5 * sine.generate(2.0, 880.0);
+
+    for(auto factor : {0.1, 0.05})
+    {
+        y = stretcher.timeShift(x4, factor);
+
+        uint32 n = static_cast<uint32>(x4.getLength() * factor + 0.5);
+
+        Buffer low = y.subbuffer(n / 4, n / 4);
+        Buffer high = y.subbuffer(n * 4 / 5, n * 3 / 20);
+
+        if(y.getLength() != n ||
+           std::fabs(peakFrequency(low) - 440.0) > 20.0 ||
+           std::fabs(peakFrequency(high) - 880.0) > 20.0)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "factor = " << factor
+                 << ", length = " << y.getLength() << " != " << n
+                 << ", peaks = " << peakFrequency(low) << " Hz, "
+                 << peakFrequency(high) << " Hz != 440 Hz, 880 Hz"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    // 1 / 640 is the smallest factor of the 640 sample window.
+    bool caught = false;
+
+    try
+    {
+        stretcher.timeShift(x4, 0.001);
+    }
+    catch(const Nsound::Exception &)
+    {
+        caught = true;
+    }
+
+    if(!caught)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "A factor below 1 / window length did not throw!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Stretcher::timeShift() up to window / 4 ...";
+
+    // 640 / 4 = 160 is the largest factor, the stretched tone must last to
+    // the end of the output.
+    Buffer x5 = 0.9 * sine.generate(0.05, 440.0);
+
+    y = stretcher.timeShift(x5, 150.0);
+
+    uint32 n5 = static_cast<uint32>(x5.getLength() * 150.0 + 0.5);
+
+    Buffer last = y.subbuffer(n5 * 3 / 4, n5 / 8);
+
+    if(y.getLength() != n5 || last.getAbs().getMax() < 0.5)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "length = " << y.getLength() << " != " << n5
+             << ", last quarter peak = " << last.getAbs().getMax()
+             << endl;
+
+        exit(1);
+    }
+
+    caught = false;
+
+    try
+    {
+        stretcher.timeShift(x5, 300.0);
+    }
+    catch(const Nsound::Exception &)
+    {
+        caught = true;
+    }
+
+    if(!caught)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "A factor above window length / 4 did not throw!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Stretcher::pitchShift() phase vocoder ...";
+
+    y = stretcher.pitchShift(x, 1.5);
+
+    if(std::fabs(peakFrequency(y.subbuffer(2000, 4000)) - 660.0) > 5.0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The pitch did not shift to 660 Hz!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Stretcher::timeShift() channel phase ...";
+
+    AudioStream stereo(SR, 2);
+
+    stereo[0] = x;
+    stereo[1] = -0.5 * x;
+
+    AudioStream out = stretcher.timeShift(stereo, 1.7);
+
+    // Every channel gets the same phase rotation.
+    if((out[0] * -0.5 - out[1]).getAbs().getMax() > 1e-12 ||
+       std::fabs(rms(out[0].subbuffer(3400, 6800)) - rms(x)) > 0.01)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The channels are no longer in phase!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Stretcher::timeShiftBlock() ...";
+
+    // Streaming in blocks computes the same frames.
+    Buffer streamed;
+
+    for(uint32 i = 0; i < x.getLength(); i += 333)
+    {
+        streamed << stretcher.timeShiftBlock(x.subbuffer(i, 333), 1.5);
+    }
+
+    streamed << stretcher.flush()[0];
+
+    y = stretcher.timeShift(x, 1.5);
+
+    // timeShift() also drops the delay of the stream.
+    Buffer tail = streamed.subbuffer(streamed.getLength() - y.getLength());
+
+    if(streamed.getLength() < y.getLength() ||
+       (tail - y).getAbs().getMax() > 1e-12)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The stream did not match timeShift()!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Stretcher::getDelay() ...";
+
+    // Dropping the delay and trimming lines the stream up with timeShift().
+    for(float64 factor : {0.7, 2.0})
+    {
+        streamed = Buffer();
+
+        int32 delay = 0;
+
+        for(uint32 i = 0; i < x.getLength(); i += 1000)
+        {
+            streamed << stretcher.timeShiftBlock(x.subbuffer(i, 1000), factor);
+
+            if(i == 0) delay = stretcher.getDelay();
+        }
+
+        streamed << stretcher.flush()[0];
+
+        y = stretcher.timeShift(x, factor);
+
+        if(delay > 0)
+        {
+            streamed = streamed.subbuffer(delay);
+        }
+        else if(delay < 0)
+        {
+            streamed = Buffer(FloatVector(-delay, 0.0)) << streamed;
+        }
+
+        if(streamed.getLength() < y.getLength() ||
+           (streamed.subbuffer(0, y.getLength()) - y).getAbs().getMax() > 1e-12)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "The aligned stream did not match timeShift("
+                 << factor << ")!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
@@ -0,0 +1,267 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: ThreadPool_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterDelay.h>
+#include <Nsound/FilterFlanger.h>
+#include <Nsound/FilterLowPassFIR.h>
+#include <Nsound/FilterLowPassIIR.h>
+#include <Nsound/FilterPhaser.h>
+#include <Nsound/RngTausworthe.h>
+#include <Nsound/ThreadPool.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "ThreadPool_UnitTest.cc";
+
+static const float64 SR = 8000.0;
+static const uint32  N_CHANNELS = 16;
+
+namespace thread_pool_unit_test
+{
+
+// Runs the operations on a copy of x, with n_threads.
+AudioStream
+process(const AudioStream & x, const uint32 n_threads)
+{
+    ThreadPool::getInstance().setNThreads(n_threads);
+
+    AudioStream y(x);
+
+    y *= 0.5;
+    y += 0.25;
+    y.abs();
+    y.limit(0.0, 0.6);
+    y.smooth(1, 5);
+    y.resample(0.7);
+    y.normalize();
+
+    FilterLowPassIIR lpf(SR, 4, 1000.0, 0.0);
+
+    Buffer sweep(FloatVector(y.getLength(), 0.0));
+
+    for(uint32 i = 0; i < sweep.getLength(); ++i)
+    {
+        sweep[i] = 500.0 + 0.1 * i;
+    }
+
+    lpf.setControlPeriod(32);
+
+    y = lpf.filter(y, sweep);
+
+    // These have their own AudioStream overloads.
+    FilterDelay delay(SR, 0.01);
+
+    y = delay.filter(y, 0.005);
+
+    FilterPhaser phaser(SR, 4, 0.5, 0.1, 0.005);
+
+    y = phaser.filter(y);
+
+    FilterFlanger flanger(SR, 0.5, 0.005);
+
+    y = flanger.filter(y);
+
+    // Can't be copied, the channels run one after another.
+    FilterLowPassFIR fir(SR, 33, 1000.0);
+
+    y = fir.filter(y);
+
+    ThreadPool::getInstance().setNThreads(1);
+
+    return y;
+}
+
+// Filters x with n_threads, then returns what the filter's state produces.
+template <class F>
+Buffer
+tail(F & f, const AudioStream & x, const uint32 n_threads)
+{
+    ThreadPool::getInstance().setNThreads(n_threads);
+
+    f.filter(x);
+
+    ThreadPool::getInstance().setNThreads(1);
+
+    Buffer y;
+
+    for(uint32 i = 0; i < 64; ++i) y << f.filter(0.0);
+
+    return y;
+}
+
+bool
+same(const AudioStream & a, const AudioStream & b)
+{
+    if(a.getNChannels() != b.getNChannels()) return false;
+
+    for(uint32 c = 0; c < a.getNChannels(); ++c)
+    {
+        if(a[c].getLength() != b[c].getLength()) return false;
+
+        for(uint32 i = 0; i < a[c].getLength(); ++i)
+        {
+            if(a[c][i] != b[c][i]) return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+using namespace thread_pool_unit_test;
+
+void ThreadPool_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    ThreadPool & pool = ThreadPool::getInstance();
+
+    cout << TEST_HEADER << "Testing ThreadPool::run() ...";
+
+    pool.setNThreads(4);
+
+    std::vector<uint32> counts(1000, 0);
+
+    pool.run(
+        1000,
+        [&](uint32 i)
+        {
+            ++counts[i];
+
+            // Nested work runs on this thread.
+            pool.run(3, [&](uint32 j) { counts[i] += j; });
+        });
+
+    for(uint32 i = 0; i < 1000; ++i)
+    {
+        if(counts[i] != 4)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Task " << i << " ran " << counts[i] << " times"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    bool caught = false;
+
+    try
+    {
+        pool.run(
+            10,
+            [](uint32 i)
+            {
+                if(i == 7) M_THROW("task " << i << " failed");
+            });
+    }
+    catch(const Nsound::Exception &)
+    {
+        caught = true;
+    }
+
+    pool.setNThreads(1);
+
+    if(!caught)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Exception was not propagated!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing parallel AudioStream processing ...";
+
+    RngTausworthe rng;
+
+    rng.setSeed(1357);
+
+    // Long enough to split the element wise math into chunks.
+    AudioStream x(SR, N_CHANNELS);
+
+    for(uint32 c = 0; c < N_CHANNELS; ++c)
+    {
+        Buffer b(FloatVector(70000 + 1000 * c, 0.0));
+
+        for(auto & v : b) v = rng.get(-1.0, 1.0);
+
+        x[c] = b;
+    }
+
+    AudioStream serial = process(x, 1);
+    AudioStream parallel = process(x, 4);
+
+    if(!same(serial, parallel))
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The parallel output did not match the serial output"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing parallel filter state ...";
+
+    // Both paths leave the filter in the state after the last channel.
+    FilterLowPassIIR lpf(SR, 4, 1000.0, 0.0);
+    FilterDelay delay(SR, 0.01);
+
+    if(tail(lpf, x, 1) != tail(lpf, x, 4) ||
+       tail(delay, x, 1) != tail(delay, x, 4) ||
+       tail(lpf, x, 4).getAbs().getMax() == 0.0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The parallel filter state did not match the serial state"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
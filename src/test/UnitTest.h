@@ -44,6 +44,7 @@
 
 // The unit tests.
 
+void AudioPlaybackRt_UnitTest();
 void Buffer_UnitTest();
 void BufferResample_UnitTest();
 void DelayLine_UnitTest();
@@ -56,14 +57,27 @@ void FilterCombLowPassFeedback_UnitTest();
 void FilterDelay_UnitTest();
 void FilterHighPassFIR_UnitTest();
 void FilterHighPassIIR_UnitTest();
+void FilterIIR_UnitTest();
 void FilterLeastSquaresFIR_UnitTest();
 void FilterLowPassFIR_UnitTest();
 void FilterLowPassIIR_UnitTest();
 void FilterMedian_UnitTest();
 void FilterParametricEqualizer_UnitTest();
 void Generator_UnitTest();
+void Granulator_UnitTest();
+void Pluck_UnitTest();
+void Profiler_UnitTest();
+void RenderScheduler_UnitTest();
+void ReverberationRoom_UnitTest();
 void Sine_UnitTest();
+void SpectrogramCache_UnitTest();
+void StreamingSTFT_UnitTest();
+void Stretcher_UnitTest();
+void ThreadPool_UnitTest();
 void Triangle_UnitTest();
+void Vocoder_UnitTest();
+void Sequencer_UnitTest();
+void VoicePool_UnitTest();
 void Wavefile_UnitTest();
 
 #endif
@@ -0,0 +1,285 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: Vocoder_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/FilterBandPassIIR.h>
+#include <Nsound/FilterBandPassVocoder.h>
+#include <Nsound/FilterBank.h>
+#include <Nsound/FilterMovingAverage.h>
+#include <Nsound/Generator.h>
+#include <Nsound/Sawtooth.h>
+#include <Nsound/Sine.h>
+#include <Nsound/Vocoder.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "Vocoder_UnitTest.cc";
+
+static const float64 SR = 8000.0;
+
+namespace vocoder_unit_test
+{
+
+// The vocoder built from one filter object per band.
+struct Band
+{
+    Band(float64 f_lo, float64 f_hi, uint32 window)
+        :
+        input(SR, 6, f_lo, f_hi, 0.01),
+        output(SR, 6, f_lo, f_hi, 0.01),
+        average(window)
+    {}
+
+    FilterBandPassIIR   input;
+    FilterBandPassIIR   output;
+    FilterMovingAverage average;
+};
+
+Buffer
+vocode(
+    const Buffer & voice,
+    const Buffer & carrier,
+    const std::vector<float64> & edges,
+    uint32 window)
+{
+    std::vector<Band *> bands;
+
+    for(uint32 i = 0; i + 1 < edges.size(); ++i)
+    {
+        bands.push_back(new Band(edges[i], edges[i + 1], window));
+    }
+
+    Buffer y;
+
+    for(uint32 n = 0; n < carrier.getLength(); ++n)
+    {
+        float64 sum = 0.0;
+
+        for(auto b : bands)
+        {
+            float64 env = std::fabs(b->input.filter(voice[n]));
+
+            sum += b->average.filter(env) * b->output.filter(carrier[n]);
+        }
+
+        y << sum;
+    }
+
+    for(auto b : bands) delete b;
+
+    return y;
+}
+
+} // namespace
+
+void Vocoder_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace vocoder_unit_test;
+
+    Generator gen(SR);
+
+    gen.setSeed(9);
+
+    Buffer noise = gen.whiteNoise(0.5);
+
+    cout << TEST_HEADER << "Testing FilterBank::filter() ...";
+
+    FilterBank iir_bank(SR);
+    FilterBank svf_bank(SR);
+
+    std::vector<float64> edges = {0.0, 150.0, 400.0, 700.0, 1100.0, 1600.0,
+                                  2200.0, 3000.0};
+
+    for(uint32 i = 0; i + 1 < edges.size(); ++i)
+    {
+        FilterBandPassIIR     iir(SR, 6, edges[i], edges[i + 1], 0.01);
+        // The state variable filter is only stable well below Nyquist.
+        FilterBandPassVocoder svf(SR, edges[i] / 4.0, edges[i + 1] / 4.0);
+
+        iir_bank.addBand(iir);
+        svf_bank.addBand(svf);
+    }
+
+    AudioStream iir_bands = iir_bank.filter(noise);
+    AudioStream svf_bands = svf_bank.filter(noise);
+
+    // Every band must match its own filter exactly.
+    for(uint32 i = 0; i + 1 < edges.size(); ++i)
+    {
+        FilterBandPassIIR     iir(SR, 6, edges[i], edges[i + 1], 0.01);
+        FilterBandPassVocoder svf(SR, edges[i] / 4.0, edges[i + 1] / 4.0);
+
+        if(iir_bands[i] != iir.filter(noise) ||
+           svf_bands[i] != svf.filter(noise))
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Band " << i << " did not match its filter!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Vocoder::filter(voice, carrier) ...";
+
+    Sawtooth saw(SR, 8);
+
+    Buffer carrier = saw.generate(0.5, 110.0);
+
+    Vocoder vocoder(SR, 0.010, 6, 3000.0, false);
+
+    // Linear spacing, band centers at (i + 0.5) * 500 Hz.
+    std::vector<float64> voc_edges = {0.0, 500.0, 1000.0, 1500.0, 2000.0,
+                                      2500.0, 3000.0};
+
+    Buffer gold = vocode(noise, carrier, voc_edges, 80);
+
+    Buffer data = vocoder.filter(noise, carrier);
+
+    vocoder.reset();
+
+    Buffer data_rt;
+
+    for(uint32 n = 0; n < carrier.getLength(); ++n)
+    {
+        data_rt << vocoder.filter(noise[n], carrier[n]);
+    }
+
+    if(data != gold || data_rt != gold)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output did not match the per band filters!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing Vocoder::setFFTSize() ...";
+
+    // Tones at the centers of bands 0, 2 and 4 only, the carrier has a tone
+    // in every band.
+    Sine sine(SR);
+
+    Buffer voice = 1.00 * sine.generate(0.5,  250.0)
+                 + 0.50 * sine.generate(0.5, 1250.0)
+                 + 0.25 * sine.generate(0.5, 2250.0);
+
+    Buffer tones = Buffer::zeros(voice.getLength());
+
+    for(uint32 i = 0; i + 1 < voc_edges.size(); ++i)
+    {
+        tones += 0.2 * sine.generate(0.5, 250.0 + 500.0 * i);
+    }
+
+    vocoder.reset();
+
+    Buffer iir_out = vocoder.filter(voice, tones);
+
+    vocoder.reset();
+    vocoder.setFFTSize(256);
+
+    Buffer fft_out = vocoder.filter(voice, tones);
+
+    if(fft_out.getLength() != iir_out.getLength())
+    {
+        cerr << TEST_ERROR_HEADER
+             << "FFT mode length differs, "
+             << fft_out.getLength() << " != " << iir_out.getLength()
+             << endl;
+
+        exit(1);
+    }
+
+    // Per band RMS after the onset transients.
+    std::vector<float64> iir_rms;
+    std::vector<float64> fft_rms;
+
+    for(uint32 i = 0; i + 1 < voc_edges.size(); ++i)
+    {
+        FilterBandPassIIR bp(SR, 6, voc_edges[i], voc_edges[i + 1], 0.01);
+
+        Buffer b = bp.filter(iir_out).subbuffer(1000);
+
+        bp.reset();
+
+        Buffer f = bp.filter(fft_out).subbuffer(1000);
+
+        iir_rms.push_back(std::sqrt((b * b).getMean()));
+        fft_rms.push_back(std::sqrt((f * f).getMean()));
+    }
+
+    for(uint32 i = 0; i < fft_rms.size(); ++i)
+    {
+        float64 ratio = fft_rms[i] / iir_rms[i];
+
+        // The voiced bands must match the IIR bank.
+        if(i % 2 == 0 && (ratio < 0.8 || ratio > 1.25))
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Band " << i << " energy differs from the IIR bank, "
+                 << "ratio = " << ratio
+                 << endl;
+
+            exit(1);
+        }
+
+        // The unvoiced bands must stay quiet.
+        if(i % 2 == 1 && fft_rms[i] > 0.2 * fft_rms[0])
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "Band " << i << " leaked, rms = " << fft_rms[i]
+                 << " vs " << fft_rms[0]
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
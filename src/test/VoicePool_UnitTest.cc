@@ -0,0 +1,319 @@
+//-----------------------------------------------------------------------------
+//
+//  $Id: VoicePool_UnitTest.cc $
+//
+//  Copyright (c) 2026 to Present Nick Hilton
+//
+//  weegreenblobbie2_gmail_com (replace '_' with '@' and '.')
+//
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+//-----------------------------------------------------------------------------
+
+#include <Nsound/AudioStream.h>
+#include <Nsound/Buffer.h>
+#include <Nsound/Generator.h>
+#include <Nsound/Instrument.h>
+#include <Nsound/VoicePool.h>
+
+#include "UnitTest.h"
+
+#include <stdlib.h>
+#include <iostream>
+
+using namespace Nsound;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+// The __FILE__ macro includes the path, I don't want the whole path.
+static const char * THIS_FILE = "VoicePool_UnitTest.cc";
+
+static const float64 SR = 8000.0;
+
+namespace voice_pool_unit_test
+{
+
+// Counts how many notes were rendered.
+class Counter : public Instrument
+{
+    public:
+
+    Counter() : Instrument(SR), n_plays(0) {}
+
+    AudioStream play() { return play(1.0, 100.0); }
+
+    AudioStream
+    play(const float64 & duration, const float64 & frequency)
+    {
+        ++n_plays;
+
+        Generator gen(SR);
+
+        AudioStream y(SR, 1);
+
+        y << gen.drawLine(duration, frequency, 0.0);
+
+        return y;
+    }
+
+    std::string getInfo() { return "Counter"; }
+
+    uint32 n_plays;
+};
+
+// Plays the note on the left and its negative on the right.
+class Stereo : public Instrument
+{
+    public:
+
+    Stereo() : Instrument(SR) {}
+
+    AudioStream play() { return play(1.0, 100.0); }
+
+    AudioStream
+    play(const float64 & duration, const float64 & frequency)
+    {
+        Generator gen(SR);
+
+        AudioStream y(SR, 2);
+
+        y[0] = gen.drawLine(duration, frequency, 0.0);
+        y[1] = -1.0 * y[0];
+
+        return y;
+    }
+
+    std::string getInfo() { return "Stereo"; }
+};
+
+} // namespace
+
+void VoicePool_UnitTest()
+{
+    cout << endl << THIS_FILE;
+
+    using namespace voice_pool_unit_test;
+
+    cout << TEST_HEADER << "Testing VoicePool::render() ...";
+
+    Counter line;
+
+    VoicePool lines(line, 4);
+
+    Buffer gold = line.play(0.5, 60.0)[0];
+
+    lines.noteOn(60.0, 0.5);
+
+    Buffer data = lines.render(gold.getLength() + 100)[0];
+
+    if(data.subbuffer(0, gold.getLength()) != gold
+        || data.subbuffer(gold.getLength()).getAbs().getMax() != 0.0
+        || lines.getNActive() != 0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Output did not match Instrument::play()!"
+             << endl;
+
+        exit(1);
+    }
+
+    // Overlapping notes started between blocks.
+    Counter counter;
+
+    VoicePool pool(counter, 3, 2);
+
+    Buffer note1 = counter.play(0.05, 1.0)[0];
+    Buffer note2 = counter.play(0.02, 2.0)[0];
+
+    counter.n_plays = 0;
+
+    data = Buffer();
+
+    pool.noteOn(1.0, 0.05, 0.5);
+    data << pool.render(100)[0];
+
+    pool.noteOn(2.0, 0.02, 0.25);
+    data << pool.render(60)[0];
+
+    pool.noteOn(1.0, 0.05, 0.5);
+    data << pool.render(840)[0];
+
+    gold = Buffer(1000);
+
+    for(uint32 i = 0; i < 1000; ++i) gold << 0.0;
+
+    for(uint32 i = 0; i < note1.getLength(); ++i) gold[i] += 0.5 * note1[i];
+
+    for(uint32 i = 0; i < note2.getLength(); ++i)
+    {
+        gold[i + 100] += 0.25 * note2[i];
+    }
+
+    for(uint32 i = 0; i < note1.getLength(); ++i)
+    {
+        gold[i + 160] += 0.5 * note1[i];
+    }
+
+    if((data - gold).getAbs().getMax() > 1e-15)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Mixed voices did not match!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing VoicePool note cache ...";
+
+    // The repeated note came from the cache.
+    if(counter.n_plays != 2 || pool.getNCachedNotes() != 2)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Notes were rendered " << counter.n_plays << " times!"
+             << endl;
+
+        exit(1);
+    }
+
+    pool.prepare(3.0, 0.01);
+
+    // The least recently used note was evicted.
+    pool.noteOn(2.0, 0.02);
+
+    if(counter.n_plays != 4 || pool.getNCachedNotes() != 2)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "The least recently used note was not evicted!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing VoicePool voice stealing ...";
+
+    pool.reset();
+
+    uint32 v0 = pool.noteOn(1.0, 0.05);
+    uint32 v1 = pool.noteOn(1.0, 0.05);
+
+    pool.render(10);
+
+    uint32 v2 = pool.noteOn(1.0, 0.05);
+
+    pool.noteOff(v1);
+
+    // All voices are busy, the releasing voice is stolen before the oldest.
+    uint32 v3 = pool.noteOn(1.0, 0.05);
+    uint32 v4 = pool.noteOn(1.0, 0.05);
+
+    if(v0 != 0 || v1 != 1 || v2 != 2 || v3 != v1 || v4 != v0)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Wrong voices were stolen!"
+             << endl;
+
+        exit(1);
+    }
+
+    // A released note fades out over the release time.
+    pool.reset();
+    pool.setReleaseTime(0.005);
+
+    uint32 v = pool.noteOn(1.0, 0.05);
+
+    pool.render(10);
+    pool.noteOff(v);
+
+    data = pool.render(100)[0];
+
+    if(!(data[0] > data[20] && data[20] > data[39])
+        || data.subbuffer(40).getAbs().getMax() != 0.0
+        || pool.isActive(v))
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Released voice did not fade out!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing VoicePool channels ...";
+
+    // Every channel of the note is kept, a mono note plays on all of them.
+    Stereo stereo;
+
+    VoicePool stereo_pool(stereo, 2, 4, 2);
+    VoicePool mixed_pool(counter, 2, 4, 2);
+
+    stereo_pool.noteOn(1.0, 0.01, 0.5);
+    mixed_pool.noteOn(1.0, 0.01, 0.5);
+
+    AudioStream y = stereo_pool.render(100);
+    AudioStream y_mono = mixed_pool.render(100);
+
+    Buffer half = 0.5 * stereo.play(0.01, 1.0)[0];
+
+    if(y.getNChannels() != 2
+        || (y[0].subbuffer(0, 80) - half).getAbs().getMax() > 1e-15
+        || (y[1] + y[0]).getAbs().getMax() != 0.0
+        || y_mono[0] != y_mono[1]
+        || (y_mono[0].subbuffer(0, 80) - half).getAbs().getMax() > 1e-15)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "Channels were not kept!"
+             << endl;
+
+        exit(1);
+    }
+
+    // A stereo note doesn't fit a mono pool.
+    VoicePool mono_pool(stereo, 2);
+
+    bool caught = false;
+
+    try
+    {
+        mono_pool.noteOn(1.0, 0.01);
+    }
+    catch(const Nsound::Exception &)
+    {
+        caught = true;
+    }
+
+    if(!caught)
+    {
+        cerr << TEST_ERROR_HEADER
+             << "A stereo note in a mono pool did not throw!"
+             << endl;
+
+        exit(1);
+    }
+
+    cout << SUCCESS << endl;
+}
+
+// :mode=c++: jEdit modeline
@@ -37,7 +37,10 @@
 #include "UnitTest.h"
 
 #include <stdlib.h>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <string>
 
 using namespace Nsound;
 
@@ -50,6 +53,17 @@ static const char * THIS_FILE = "Wavefile_UnitTest.cc";
 
 static const float64 GAMMA = 1.5e-14;
 
+static
+std::string
+readBytes(const char * filename)
+{
+    std::ifstream fin(filename, std::ios::binary);
+
+    return std::string(
+        (std::istreambuf_iterator<char>(fin)),
+        std::istreambuf_iterator<char>());
+}
+
 void
 Wavefile_UnitTest()
 {
@@ -146,5 +160,84 @@ Wavefile_UnitTest()
         }
     }
 
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing WavefileWriter::write() blocks ..." << flush;
+
+    for(uint32 n = 0; n < 3; ++n)
+    {
+        const uint32 bits[3] = {16, 24, 32};
+
+        Wavefile::setIEEEFloat(n == 2);
+
+        Wavefile::write("test_wavefile3.wav", data1, bits[n]);
+
+        WavefileWriter out("test_wavefile4.wav", 100, 3, bits[n]);
+
+        // Uneven block sizes.
+        for(uint32 i = 0; i < data1.getLength(); i += 7)
+        {
+            uint32 len = data1.getLength() - i;
+
+            if(len > 7) len = 7;
+
+            out.write(data1.substream(i, len));
+        }
+
+        out.close();
+
+        if(out.getLength() != data1.getLength() ||
+           readBytes("test_wavefile3.wav") != readBytes("test_wavefile4.wav"))
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "WavefileWriter output differs from Wavefile::write() "
+                 << "for " << bits[n] << " bits!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    Wavefile::setIEEEFloat(false);
+
+    cout << SUCCESS;
+
+    cout << TEST_HEADER << "Testing WavefileReader::read() blocks ..." << flush;
+
+    for(uint32 n = 0; n < 5; ++n)
+    {
+        const uint32 bits[5] = {8, 16, 24, 32, 64};
+
+        Wavefile::setIEEEFloat(n >= 3);
+
+        Wavefile::write("test_wavefile3.wav", data1, bits[n]);
+
+        AudioStream gold("test_wavefile3.wav");
+
+        WavefileReader in("test_wavefile3.wav");
+
+        AudioStream data(in.getSampleRate(), in.getNChannels());
+        AudioStream block;
+
+        // Uneven block sizes.
+        while(in.read(block, 7) > 0) data << block;
+
+        if(in.getLength() != gold.getLength() ||
+           in.getPosition() != gold.getLength() ||
+           data.getSampleRate() != gold.getSampleRate() ||
+           data.getNChannels() != gold.getNChannels() ||
+           data != gold)
+        {
+            cerr << TEST_ERROR_HEADER
+                 << "WavefileReader output differs from Wavefile::read() "
+                 << "for " << bits[n] << " bits!"
+                 << endl;
+
+            exit(1);
+        }
+    }
+
+    Wavefile::setIEEEFloat(false);
+
     cout << SUCCESS << endl;
 }
@@ -77,3 +77,19 @@ class Test(unittest.TestCase):
         self.assertEqual(gold, data)
 
 
+
+
+    def test_04(self):
+        "FilterMedian percentile"
+
+        b1 = ns.Buffer([1, 2, 3, 4, 5, 6, 7])
+
+        data = ns.FilterMedian(3, 100.0).filter(b1)
+        data = [int(x) for x in data]
+
+        self.assertEqual([1, 2, 3, 4, 5, 6, 7], data)
+
+        data = ns.FilterMedian(3, 0.0).filter(b1)
+        data = [int(x) for x in data]
+
+        self.assertEqual([1, 1, 1, 2, 3, 4, 5], data)
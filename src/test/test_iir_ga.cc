@@ -71,6 +71,19 @@ int main(int argc, char ** argv)
     pylab.plot(ref_freq_axis, ref_response);
     pylab.title("desired frequency response");
 
+    // The library is quiet, print the progress here.
+    f.setDesignCallback(
+        [](uint32 generation, float64 rms_error)
+        {
+            if(generation % 200 == 0)
+            {
+                cout << "Generation " << generation
+                     << ", RMS = " << rms_error << endl;
+            }
+
+            return true;
+        });
+
     Buffer evolution = f.designFrequencyResponse(ref_response, 0.001, 10000);
 
     cout << "f = " << endl << f << endl;
@@ -91,6 +91,7 @@ namespace std
 %include "src/Nsound/AudioBackend.h"
 %include "src/Nsound/AudioPlayback.h"
 %include "src/Nsound/AudioPlaybackRt.h"
+%include "src/Nsound/BufferPyramid.h"
 %include "src/Nsound/BufferWindowSearch.h"
 %include "src/Nsound/CircularBuffer.h"
 %include "src/Nsound/Clarinet.h"
@@ -117,6 +118,7 @@ namespace std
 %include "src/Nsound/FilterBandRejectIIR.h"
 %include "src/Nsound/FilterBandPassFIR.h"
 %include "src/Nsound/FilterBandPassIIR.h"
+%include "src/Nsound/FilterBank.h"
 %include "src/Nsound/FilterMedian.hpp"
 %include "src/Nsound/FilterMovingAverage.h"
 %include "src/Nsound/FilterFlanger.h"
@@ -130,6 +132,8 @@ namespace std
 %include "src/Nsound/Granulator.h"
 %include "src/Nsound/GuitarBass.h"
 %include "src/Nsound/Hat.h"
+%include "src/Nsound/IIRKernelCache.h"
+%include "src/Nsound/KarplusStrong.h"
 //    %include "src/Nsound/Kernel.h"
 %include "src/Nsound/Mesh2D.h"
 //    %include "src/Nsound/MeshJunction.h"
@@ -137,20 +141,34 @@ namespace std
 %include "src/Nsound/OrganPipe.h"
 %include "src/Nsound/Plotter.h"
 %include "src/Nsound/Pluck.h"
+%include "src/Nsound/Profiler.h"
+
+namespace std
+{
+    %template(ProfileStatsVector) vector<Nsound::ProfileStats>;
+}
+
 %include "src/Nsound/Pulse.h"
 %include "src/Nsound/RandomNumberGenerator.h"
+%include "src/Nsound/Resampler.h"
 %include "src/Nsound/ReverberationRoom.h"
 %include "src/Nsound/RngTausworthe.h"
 %include "src/Nsound/Sawtooth.h"
+%include "src/Nsound/Sequencer.h"
 %include "src/Nsound/Sine.h"
+%include "src/Nsound/SlidingWindow.h"
 %include "src/Nsound/Spectrogram.h"
+%include "src/Nsound/SpectrogramCache.h"
 %include "src/Nsound/Cosine.h"
 %include "src/Nsound/Square.h"
+%include "src/Nsound/StreamingSTFT.h"
 %include "src/Nsound/Stretcher.h"
+%include "src/Nsound/ThreadPool.h"
 %include "src/Nsound/TicToc.h"
 %include "src/Nsound/Triangle.h"
 %include "src/Nsound/Utils.h"
 %include "src/Nsound/Vocoder.h"
+%include "src/Nsound/VoicePool.h"
 %include "src/Nsound/Wavefile.h"
 
 %pythoncode